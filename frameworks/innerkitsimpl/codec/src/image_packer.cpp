@@ -15,6 +15,9 @@
 
 #include "image_packer.h"
 
+#include <map>
+#include <mutex>
+
 #include "buffer_packer_stream.h"
 #include "file_packer_stream.h"
 #include "image/abs_image_encoder.h"
@@ -42,10 +45,94 @@ using namespace ImagePlugin;
 using namespace MultimediaPlugin;
 static constexpr uint8_t QUALITY_MAX = 100;
 const static std::string EXTENDED_ENCODER = "image/jpeg,image/png,image/webp";
+const static std::string ANIMATED_ENCODER_KEY_SUFFIX = ";animated";
 static constexpr size_t SIZE_ZERO = 0;
+static constexpr size_t MAX_POOLED_ENCODER_SETS = 4;  // per format
 
 PluginServer &ImagePacker::pluginServer_ = ImageUtils::GetPluginServer();
 
+using EncoderSet = std::vector<std::unique_ptr<AbsImageEncoder>>;
+
+// Process-wide store of idle encoder sets, so that short-lived packers do not pay for plugin lookup and
+// encoder construction on every pack. Only sets that have been Reset() are stored.
+class EncoderPool {
+public:
+    static EncoderPool &GetInstance()
+    {
+        static EncoderPool instance;
+        return instance;
+    }
+
+    void SetEnabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled_ = enabled;
+        if (!enabled_) {
+            pool_.clear();
+        }
+    }
+
+    bool IsEnabled()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return enabled_;
+    }
+
+    size_t GetIdleCount(const std::string &format)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = pool_.find(format);
+        return iter == pool_.end() ? 0 : iter->second.size();
+    }
+
+    bool Acquire(const std::string &format, EncoderSet &encoders)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = pool_.find(format);
+        if (!enabled_ || iter == pool_.end() || iter->second.empty()) {
+            return false;
+        }
+        encoders = std::move(iter->second.back());
+        iter->second.pop_back();
+        return true;
+    }
+
+    bool Release(const std::string &format, EncoderSet &encoders)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!enabled_ || format.empty() || encoders.empty()) {
+            return false;
+        }
+        std::vector<EncoderSet> &sets = pool_[format];
+        if (sets.size() >= MAX_POOLED_ENCODER_SETS) {
+            return false;
+        }
+        sets.emplace_back(std::move(encoders));
+        encoders.clear();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    bool enabled_ = false;
+    std::map<std::string, std::vector<EncoderSet>> pool_;
+};
+
+void ImagePacker::SetEncoderPoolEnabled(bool enabled)
+{
+    EncoderPool::GetInstance().SetEnabled(enabled);
+}
+
+bool ImagePacker::IsEncoderPoolEnabled()
+{
+    return EncoderPool::GetInstance().IsEnabled();
+}
+
+size_t ImagePacker::GetPooledEncoderSetCount(const std::string &format)
+{
+    return EncoderPool::GetInstance().GetIdleCount(format);
+}
+
 uint32_t ImagePacker::GetSupportedFormats(std::set<std::string> &formats)
 {
     formats.clear();
@@ -172,6 +259,23 @@ uint32_t ImagePacker::StartPacking(std::ostream &outputStream, const PackOption
     return StartPackingImpl(option);
 }
 
+uint32_t ImagePacker::StartPacking(std::unique_ptr<PackerStream> outputStream, const PackOption &option)
+{
+    ImageTrace imageTrace("ImagePacker::StartPacking by packerStream");
+    if (!IsPackOptionValid(option)) {
+        IMAGE_LOGE("packerStream startPacking option invalid %{public}s, %{public}u.", option.format.c_str(),
+            option.quality);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (outputStream == nullptr) {
+        IMAGE_LOGE("packer stream is null.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    FreeOldPackerStream();
+    packerStream_ = std::move(outputStream);
+    return StartPackingImpl(option);
+}
+
 // JNI adapter method, this method be called by jni and the outputStream be created by jni, here we manage the lifecycle
 // of the outputStream
 uint32_t ImagePacker::StartPackingAdapter(PackerStream &outputStream, const PackOption &option)
@@ -278,13 +382,31 @@ static ImagePlugin::AbsImageEncoder* GetEncoder(PluginServer &pluginServer, std:
 
 bool ImagePacker::GetEncoderPlugin(const PackOption &option)
 {
-    encoders_.clear();
-    IMAGE_LOGD("GetEncoderPlugin current encoder plugin size %{public}zu.", encoders_.size());
-    auto encoder = GetEncoder(pluginServer_, EXTENDED_ENCODER);
-    if (encoder != nullptr) {
-        encoders_.emplace_back(std::unique_ptr<ImagePlugin::AbsImageEncoder>(encoder));
-    } else {
-        IMAGE_LOGE("GetEncoderPlugin get ext_encoder plugin failed.");
+    // The extended encoder packs one image only, so animated webp goes to the webp plugin alone and the
+    // encoders are cached under their own key.
+    bool isAnimatedWebp = (option.format == IMAGE_WEBP_FORMAT) && (option.numberHint > 1);
+    std::string encoderKey = isAnimatedWebp ? option.format + ANIMATED_ENCODER_KEY_SUFFIX : option.format;
+    if (!encoders_.empty() && encoderFormat_ == encoderKey) {
+        IMAGE_LOGD("GetEncoderPlugin reuse %{public}zu encoder plugins.", encoders_.size());
+        for (auto &encoder : encoders_) {
+            encoder->Reset();
+        }
+        return true;
+    }
+    ReleaseEncoders();
+    if (EncoderPool::GetInstance().Acquire(encoderKey, encoders_)) {
+        IMAGE_LOGD("GetEncoderPlugin take %{public}s encoder plugins from pool.", encoderKey.c_str());
+        encoderFormat_ = encoderKey;
+        return true;
+    }
+    ImagePlugin::AbsImageEncoder *encoder = nullptr;
+    if (!isAnimatedWebp) {
+        encoder = GetEncoder(pluginServer_, EXTENDED_ENCODER);
+        if (encoder != nullptr) {
+            encoders_.emplace_back(std::unique_ptr<ImagePlugin::AbsImageEncoder>(encoder));
+        } else {
+            IMAGE_LOGE("GetEncoderPlugin get ext_encoder plugin failed.");
+        }
     }
     encoder = GetEncoder(pluginServer_, option.format);
     if (encoder != nullptr) {
@@ -293,9 +415,21 @@ bool ImagePacker::GetEncoderPlugin(const PackOption &option)
         IMAGE_LOGD("GetEncoderPlugin get %{public}s plugin failed, use ext_encoder plugin",
             option.format.c_str());
     }
+    encoderFormat_ = encoderKey;
     return encoders_.size() != SIZE_ZERO;
 }
 
+void ImagePacker::ReleaseEncoders()
+{
+    for (auto &encoder : encoders_) {
+        encoder->Reset();
+    }
+    if (!EncoderPool::GetInstance().Release(encoderFormat_, encoders_)) {
+        encoders_.clear();
+    }
+    encoderFormat_.clear();
+}
+
 void ImagePacker::CopyOptionsToPlugin(const PackOption &opts, PlEncodeOptions &plOpts)
 {
     plOpts.delayTimes = opts.delayTimes;
@@ -304,8 +438,11 @@ void ImagePacker::CopyOptionsToPlugin(const PackOption &opts, PlEncodeOptions &p
     plOpts.quality = opts.quality;
     plOpts.format = opts.format;
     plOpts.disposalTypes = opts.disposalTypes;
+    plOpts.optimizeFrames = opts.optimizeFrames;
     plOpts.needsPackProperties = opts.needsPackProperties;
     plOpts.desiredDynamicRange = opts.desiredDynamicRange;
+    plOpts.effort = opts.effort;
+    plOpts.multiThread = opts.multiThread;
 }
 
 void ImagePacker::FreeOldPackerStream()
@@ -331,8 +468,7 @@ uint32_t ImagePacker::DoEncodingFunc(std::function<uint32_t(ImagePlugin::AbsImag
     bool isSuccessOnce = false;
     for (size_t i = SIZE_ZERO; i < encoders_.size(); i++) {
         if (!forAll && isSuccessOnce) {
-            IMAGE_LOGD("DoEncodingFunc encoding successed, reset other encoder.");
-            encoders_.at(i).reset();
+            IMAGE_LOGD("DoEncodingFunc encoding successed, skip other encoder.");
             continue;
         }
         auto iterRes = func(encoders_.at(i).get());
@@ -355,6 +491,8 @@ ImagePacker::ImagePacker()
 {}
 
 ImagePacker::~ImagePacker()
-{}
+{
+    ReleaseEncoders();
+}
 } // namespace Media
 } // namespace OHOS
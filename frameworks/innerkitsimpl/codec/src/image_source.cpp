@@ -19,11 +19,18 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <charconv>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <dlfcn.h>
 #include <filesystem>
+#include <future>
+#include <list>
+#include <unistd.h>
 #include <vector>
 
 #include "auxiliary_generator.h"
@@ -144,6 +151,8 @@ static const uint8_t NUM_8 = 8;
 static const uint8_t NUM_16 = 16;
 static const uint8_t NUM_24 = 24;
 static const int DMA_SIZE = 512 * 512 * 4; // DMA limit size
+// Jpeg auxiliary pictures decoded at the same time, next to the main image.
+static const size_t MAX_JPEG_AUXILIARY_DECODE_TASKS = 2;
 static const uint32_t ASTC_MAGIC_ID = 0x5CA1AB13;
 static const int ASTC_SIZE = 512 * 512;
 static const size_t ASTC_HEADER_SIZE = 16;
@@ -152,6 +161,12 @@ static const uint8_t ASTC_HEADER_BLOCK_Y = 5;
 static const uint8_t ASTC_HEADER_DIM_X = 7;
 static const uint8_t ASTC_HEADER_DIM_Y = 10;
 static const int IMAGE_HEADER_SIZE = 12;
+static const uint32_t FILTER_COPY_CHUNK_SIZE = 64 * 1024;
+static constexpr uint64_t CACHE_HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t CACHE_HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint32_t CACHE_HASH_ROTATE = 31;
+static constexpr uint32_t CACHE_HASH_SHIFT = 29;
+static constexpr float FULL_TURN_DEGREES = 360.0f;
 #ifdef SUT_DECODE_ENABLE
 constexpr uint8_t ASTC_HEAD_BYTES = 16;
 constexpr uint8_t ASTC_MAGIC_0 = 0x13;
@@ -513,6 +528,262 @@ void ImageSource::Reset()
     mainDecoder_ = nullptr;
 }
 
+// Encoded bytes of a buffer source. The cache keeps a copy with each entry and compares it on lookup, so a
+// hit never depends on the key hash alone.
+struct DecodedImageCacheContent {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+};
+
+// Process-wide LRU of decoded pixel maps. Entries hold the pixels copy-on-write shared with the pixel map that
+// was returned for the miss, so a cached image costs no extra copy; hits hand out further clones of the entry.
+class DecodedImageCache {
+public:
+    static DecodedImageCache &GetInstance()
+    {
+        static DecodedImageCache instance;
+        return instance;
+    }
+
+    bool IsEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enabled, size_t maxBytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled_.store(enabled, std::memory_order_relaxed);
+        maxBytes_ = enabled ? maxBytes : 0;
+        TrimLocked(maxBytes_);
+    }
+
+    unique_ptr<PixelMap> Find(const std::string &key, const DecodedImageCacheContent &content, bool editable)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = index_.find(key);
+        if (iter == index_.end() || !iter->second->MatchesContent(content)) {
+            stats_.misses++;
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, iter->second);
+        unique_ptr<PixelMap> clone = Clone(*iter->second->pixelMap, editable);
+        if (clone == nullptr) {
+            stats_.misses++;
+            return nullptr;
+        }
+        stats_.hits++;
+        return clone;
+    }
+
+    void Insert(const std::string &key, const DecodedImageCacheContent &content, PixelMap &pixelMap)
+    {
+        size_t pixelBytes = static_cast<size_t>(pixelMap.GetByteCount());
+        if (!IsEnabled() || pixelBytes == 0) {
+            return;
+        }
+        size_t cost = pixelBytes + content.size;
+        unique_ptr<PixelMap> entry = Clone(pixelMap, false);
+        // only keep entries that share the pixels, a private copy would double the memory of every miss
+        if (entry == nullptr || !entry->IsPixelsShared()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!IsEnabled() || cost > maxBytes_) {
+            return;
+        }
+        auto iter = index_.find(key);
+        if (iter != index_.end()) {
+            usedBytes_ -= iter->second->cost;
+            entries_.erase(iter->second);
+            index_.erase(iter);
+        }
+        TrimLocked(maxBytes_ - cost);
+        CacheEntry cacheEntry;
+        cacheEntry.key = key;
+        if (content.data != nullptr) {
+            cacheEntry.content.assign(content.data, content.data + content.size);
+        }
+        cacheEntry.pixelMap = std::move(entry);
+        cacheEntry.cost = cost;
+        entries_.push_front(std::move(cacheEntry));
+        index_[key] = entries_.begin();
+        usedBytes_ += cost;
+    }
+
+    void Trim(size_t targetBytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TrimLocked(targetBytes);
+    }
+
+    DecodedImageCacheStats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DecodedImageCacheStats stats = stats_;
+        stats.entryCount = static_cast<uint32_t>(entries_.size());
+        stats.usedBytes = usedBytes_;
+        stats.maxBytes = maxBytes_;
+        return stats;
+    }
+
+private:
+    DecodedImageCache() = default;
+    ~DecodedImageCache() = default;
+    DISALLOW_COPY_AND_MOVE(DecodedImageCache);
+
+    static unique_ptr<PixelMap> Clone(PixelMap &source, bool editable)
+    {
+        InitializationOptions opts;
+        opts.size = {source.GetWidth(), source.GetHeight()};
+        opts.pixelFormat = source.GetPixelFormat();
+        opts.alphaType = source.GetAlphaType();
+        opts.editable = editable;
+        int32_t errorCode = SUCCESS;
+        unique_ptr<PixelMap> clone = PixelMap::Create(source, Rect(), opts, errorCode);
+        if (clone == nullptr) {
+            return nullptr;
+        }
+        if (source.GetExifMetadata() != nullptr) {
+            std::shared_ptr<ExifMetadata> exifMetadata = source.GetExifMetadata()->Clone();
+            clone->SetExifMetadata(exifMetadata);
+        }
+        clone->SetToSdrColorSpaceIsSRGB(source.GetToSdrColorSpaceIsSRGB());
+        return clone;
+    }
+
+    void TrimLocked(size_t targetBytes)
+    {
+        while (!entries_.empty() && usedBytes_ > targetBytes) {
+            usedBytes_ -= entries_.back().cost;
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+            stats_.evictions++;
+        }
+    }
+
+    struct CacheEntry {
+        std::string key;
+        // empty for file sources, whose key is the file identity rather than a content hash
+        std::vector<uint8_t> content;
+        unique_ptr<PixelMap> pixelMap;
+        size_t cost = 0;
+
+        bool MatchesContent(const DecodedImageCacheContent &other) const
+        {
+            if (other.data == nullptr) {
+                return content.empty();
+            }
+            return content.size() == other.size && memcmp(content.data(), other.data, other.size) == 0;
+        }
+    };
+    using EntryList = std::list<CacheEntry>;
+    std::atomic<bool> enabled_ {false};
+    std::mutex mutex_;
+    EntryList entries_;
+    std::map<std::string, EntryList::iterator> index_;
+    size_t usedBytes_ {0};
+    size_t maxBytes_ {0};
+    DecodedImageCacheStats stats_;
+};
+
+void ImageSource::SetDecodedImageCacheEnabled(bool enabled, size_t maxBytes)
+{
+    DecodedImageCache::GetInstance().SetEnabled(enabled, maxBytes);
+}
+
+DecodedImageCacheStats ImageSource::GetDecodedImageCacheStats()
+{
+    return DecodedImageCache::GetInstance().GetStats();
+}
+
+void ImageSource::TrimDecodedImageCache(size_t targetBytes)
+{
+    DecodedImageCache::GetInstance().Trim(targetBytes);
+}
+
+static inline uint64_t RotateLeft(uint64_t value, uint32_t bits)
+{
+    return (value << bits) | (value >> (sizeof(uint64_t) * NUM_8 - bits));
+}
+
+// Two independent 64-bit lanes over whole words, so buffer sources get a 128-bit content key at memory speed.
+// The key only picks the entry, DecodedImageCache compares the bytes before it reports a hit.
+static std::string HashSourceContent(const uint8_t *data, size_t size)
+{
+    uint64_t lane1 = CACHE_HASH_PRIME_1 ^ size;
+    uint64_t lane2 = CACHE_HASH_PRIME_2 + size;
+    size_t words = size / sizeof(uint64_t);
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+        lane1 = RotateLeft(lane1 ^ (word * CACHE_HASH_PRIME_2), CACHE_HASH_ROTATE) * CACHE_HASH_PRIME_1;
+        lane2 = (lane2 + word) * CACHE_HASH_PRIME_2;
+        lane2 ^= lane2 >> CACHE_HASH_SHIFT;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < size; i++) {
+        lane1 = (lane1 ^ data[i]) * CACHE_HASH_PRIME_1;
+        lane2 = (lane2 + data[i]) * CACHE_HASH_PRIME_2;
+    }
+    return std::to_string(lane1) + "-" + std::to_string(lane2) + "-" + std::to_string(size);
+}
+
+static std::string RectCacheKey(const Rect &rect)
+{
+    if (rect.width <= 0 || rect.height <= 0) {
+        return "0";
+    }
+    return std::to_string(rect.left) + "," + std::to_string(rect.top) + "," + std::to_string(rect.width) + "," +
+        std::to_string(rect.height);
+}
+
+bool ImageSource::GetDecodedImageCacheKey(uint32_t index, const DecodeOptions &opts, std::string &key)
+{
+    // color space objects and HDR outputs carry state a clone does not reproduce
+    if (!DecodedImageCache::GetInstance().IsEnabled() || isIncrementalSource_ || sourceStreamPtr_ == nullptr ||
+        opts.desiredColorSpaceInfo != nullptr || opts.desiredDynamicRange != DecodeDynamicRange::SDR) {
+        return false;
+    }
+    std::string source;
+    uint32_t streamType = sourceStreamPtr_->GetStreamType();
+    if (streamType == ImagePlugin::FILE_STREAM_TYPE) {
+        if (!static_cast<FileSourceStream *>(sourceStreamPtr_.get())->GetFileIdentity(source)) {
+            return false;
+        }
+        source = "f" + source;
+    } else if (streamType == ImagePlugin::BUFFER_SOURCE_TYPE) {
+        const uint8_t *data = sourceStreamPtr_->GetDataPtr();
+        if (data == nullptr) {
+            return false;
+        }
+        source = "b" + HashSourceContent(data, sourceStreamPtr_->GetStreamSize());
+    } else {
+        return false;
+    }
+    float rotate = std::fmod(opts.rotateDegrees, FULL_TURN_DEGREES);
+    if (rotate < 0) {
+        rotate += FULL_TURN_DEGREES;
+    }
+    key = source + "|" + sourceOptions_.formatHint + "|" + std::to_string(sourceOptions_.baseDensity) + "," +
+        std::to_string(static_cast<int32_t>(sourceOptions_.pixelFormat)) + "," +
+        std::to_string(sourceOptions_.size.width) + "x" + std::to_string(sourceOptions_.size.height) + "," +
+        std::to_string(static_cast<int32_t>(preference_)) + "|" + std::to_string(index) + "|" +
+        std::to_string(opts.fitDensity) + "|" + RectCacheKey(opts.CropRect) + "|" + RectCacheKey(opts.desiredRegion) +
+        "|" + std::to_string(opts.desiredSize.width) + "x" + std::to_string(opts.desiredSize.height) + "|" +
+        std::to_string(rotate) + "," + std::to_string(opts.rotateNewDegrees) + "|" + std::to_string(opts.sampleSize) +
+        "|" + std::to_string(static_cast<int32_t>(opts.desiredPixelFormat)) + "," +
+        std::to_string(static_cast<int32_t>(opts.allocatorType)) + "," +
+        std::to_string(static_cast<int32_t>(opts.desiredColorSpace)) + "," + std::to_string(opts.preferDma) + "," +
+        std::to_string(opts.allowPartialImage) + "," + std::to_string(static_cast<int32_t>(opts.preference)) + "," +
+        std::to_string(static_cast<int32_t>(opts.resolutionQuality)) + "," + std::to_string(opts.isAisr) + "," +
+        std::to_string(opts.preferExifThumbnail) + "|" + std::to_string(opts.SVGOpts.fillColor.isValidColor) + ":" +
+        std::to_string(opts.SVGOpts.fillColor.color) + "," + std::to_string(opts.SVGOpts.strokeColor.isValidColor) +
+        ":" + std::to_string(opts.SVGOpts.strokeColor.color) + "," +
+        std::to_string(opts.SVGOpts.SVGResize.isValidPercentage) + ":" +
+        std::to_string(opts.SVGOpts.SVGResize.resizePercentage);
+    return true;
+}
+
 unique_ptr<PixelMap> ImageSource::CreatePixelMapEx(uint32_t index, const DecodeOptions &opts, uint32_t &errorCode)
 {
     if (opts.desiredSize.width < 0 || opts.desiredSize.height < 0) {
@@ -544,6 +815,40 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMapEx(uint32_t index, const DecodeO
         return CreatePixelMapForYUV(errorCode);
     }
 
+    std::string cacheKey;
+    if (!GetDecodedImageCacheKey(index, opts, cacheKey)) {
+        return CreatePixelMapUncached(index, opts, errorCode);
+    }
+    DecodedImageCacheContent content;
+    if (sourceStreamPtr_->GetStreamType() == ImagePlugin::BUFFER_SOURCE_TYPE) {
+        content.data = sourceStreamPtr_->GetDataPtr();
+        content.size = sourceStreamPtr_->GetStreamSize();
+    }
+    unique_ptr<PixelMap> pixelMap = DecodedImageCache::GetInstance().Find(cacheKey, content, opts.editable);
+    if (pixelMap != nullptr) {
+        IMAGE_LOGD("CreatePixelMapEx decoded image cache hit");
+        errorCode = SUCCESS;
+        return pixelMap;
+    }
+    pixelMap = CreatePixelMapUncached(index, opts, errorCode);
+    if (pixelMap != nullptr && errorCode == SUCCESS && !pixelMap->IsHdr() && !pixelMap->IsAstc() &&
+        !IsYuvFormat(pixelMap->GetPixelFormat())) {
+        DecodedImageCache::GetInstance().Insert(cacheKey, content, *pixelMap);
+    }
+    return pixelMap;
+}
+
+unique_ptr<PixelMap> ImageSource::CreatePixelMapUncached(uint32_t index, const DecodeOptions &opts,
+    uint32_t &errorCode)
+{
+    if (opts.preferExifThumbnail) {
+        unique_ptr<PixelMap> thumbnail = CreatePixelMapFromExifThumbnail(index, opts);
+        if (thumbnail != nullptr) {
+            errorCode = SUCCESS;
+            return thumbnail;
+        }
+    }
+
     DumpInputData();
     return CreatePixelMap(index, opts, errorCode);
 }
@@ -568,6 +873,57 @@ static inline void CopySize(const Size &src, Size &dst)
     dst.height = src.height;
 }
 
+// The IFD1 thumbnail is stored in the same orientation as the main image, so it is only a stand-in when it has the
+// main image's aspect ratio (within one thumbnail pixel of rounding) and covers the desired size.
+static bool IsExifThumbnailSufficient(const Size &imageSize, const Size &thumbnailSize, const Size &desiredSize)
+{
+    if (!IsSizeVailed(imageSize) || thumbnailSize.width <= 0 || thumbnailSize.height <= 0 ||
+        thumbnailSize.width < desiredSize.width || thumbnailSize.height < desiredSize.height) {
+        return false;
+    }
+    int64_t expectedHeight = static_cast<int64_t>(thumbnailSize.width) * imageSize.height / imageSize.width;
+    return std::abs(expectedHeight - thumbnailSize.height) <= 1;
+}
+
+unique_ptr<PixelMap> ImageSource::CreatePixelMapFromExifThumbnail(uint32_t index, const DecodeOptions &opts)
+{
+    // crop rectangles are given in main image coordinates
+    bool hasCrop = opts.CropRect.width > INT_ZERO || opts.desiredRegion.width > INT_ZERO;
+    if (index != FIRST_FRAME || !IsSizeVailed(opts.desiredSize) || hasCrop ||
+        opts.desiredDynamicRange != DecodeDynamicRange::SDR || CreatExifMetadataByImageSource() != SUCCESS) {
+        return nullptr;
+    }
+    ExifData *exifData = exifMetadata_->GetExifData();
+    if (exifData == nullptr || exifData->data == nullptr || exifData->size == 0) {
+        return nullptr;
+    }
+    ImageInfo imageInfo;
+    if (GetImageInfo(index, imageInfo) != SUCCESS) {
+        return nullptr;
+    }
+    uint32_t errorCode = SUCCESS;
+    SourceOptions sourceOpts;
+    unique_ptr<ImageSource> thumbnailSource = CreateImageSource(exifData->data, exifData->size, sourceOpts, errorCode);
+    ImageInfo thumbnailInfo;
+    if (thumbnailSource == nullptr || thumbnailSource->GetImageInfo(FIRST_FRAME, thumbnailInfo) != SUCCESS ||
+        !IsExifThumbnailSufficient(imageInfo.size, thumbnailInfo.size, opts.desiredSize)) {
+        IMAGE_LOGD("CreatePixelMapFromExifThumbnail thumbnail unusable, decode the main image");
+        return nullptr;
+    }
+    ImageTrace imageTrace("ImageSource::CreatePixelMapFromExifThumbnail, thumbnail:(%d, %d)",
+        thumbnailInfo.size.width, thumbnailInfo.size.height);
+    DecodeOptions thumbnailOpts = opts;
+    thumbnailOpts.preferExifThumbnail = false;
+    unique_ptr<PixelMap> pixelMap = thumbnailSource->CreatePixelMapEx(FIRST_FRAME, thumbnailOpts, errorCode);
+    if (pixelMap == nullptr || errorCode != SUCCESS) {
+        IMAGE_LOGD("CreatePixelMapFromExifThumbnail decode thumbnail failed, ret:%{public}u.", errorCode);
+        return nullptr;
+    }
+    // the orientation of the main image applies to the thumbnail as well
+    pixelMap->SetExifMetadata(exifMetadata_->Clone());
+    return pixelMap;
+}
+
 static inline bool IsDensityChange(int32_t srcDensity, int32_t wantDensity)
 {
     return (srcDensity != 0 && wantDensity != 0 && srcDensity != wantDensity);
@@ -2550,6 +2906,115 @@ uint32_t ImageSource::GetFilterArea(const std::vector<std::string> &exifKeys,
     return metadataAccessor->GetFilterArea(exifKeys, ranges);
 }
 
+static bool WriteFully(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            IMAGE_LOGE("WriteFully failed, errno:%{public}d", errno);
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool WriteZeros(int fd, uint32_t size)
+{
+    static const uint8_t zeros[FILTER_COPY_CHUNK_SIZE] = {0};
+    while (size > 0) {
+        uint32_t chunk = std::min(size, FILTER_COPY_CHUNK_SIZE);
+        if (!WriteFully(fd, zeros, chunk)) {
+            return false;
+        }
+        size -= chunk;
+    }
+    return true;
+}
+
+// Sorted, merged and clamped to the stream, so the copy below is a single forward pass.
+static std::vector<std::pair<uint32_t, uint32_t>> NormalizeFilterRanges(
+    std::vector<std::pair<uint32_t, uint32_t>> ranges, uint32_t streamSize)
+{
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<uint32_t, uint32_t>> merged;
+    for (const auto &range : ranges) {
+        if (range.first >= streamSize || range.second == 0) {
+            continue;
+        }
+        uint32_t end = range.first + std::min(range.second, streamSize - range.first);
+        if (!merged.empty() && range.first <= merged.back().first + merged.back().second) {
+            uint32_t mergedEnd = std::max(merged.back().first + merged.back().second, end);
+            merged.back().second = mergedEnd - merged.back().first;
+            continue;
+        }
+        merged.emplace_back(range.first, end - range.first);
+    }
+    return merged;
+}
+
+bool ImageSource::CopySourceSpan(int dstFd, uint32_t offset, uint32_t length)
+{
+    if (length == 0) {
+        return true;
+    }
+    if (sourceStreamPtr_->GetStreamType() == ImagePlugin::FILE_STREAM_TYPE) {
+        uint32_t copied = 0;
+        if (static_cast<FileSourceStream *>(sourceStreamPtr_.get())->CopyRangeTo(dstFd, offset, length, copied)) {
+            return true;
+        }
+        offset += copied;
+        length -= copied;
+    }
+    uint8_t *data = sourceStreamPtr_->GetDataPtr();
+    if (data != nullptr) {
+        return WriteFully(dstFd, data + offset, length);
+    }
+    std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(FILTER_COPY_CHUNK_SIZE);
+    uint32_t savedPosition = sourceStreamPtr_->Tell();
+    bool ret = sourceStreamPtr_->Seek(offset);
+    while (ret && length > 0) {
+        uint32_t readSize = 0;
+        uint32_t chunk = std::min(length, FILTER_COPY_CHUNK_SIZE);
+        ret = sourceStreamPtr_->Read(chunk, buffer.get(), FILTER_COPY_CHUNK_SIZE, readSize) && readSize == chunk &&
+            WriteFully(dstFd, buffer.get(), readSize);
+        length -= chunk;
+    }
+    sourceStreamPtr_->Seek(savedPosition);
+    return ret;
+}
+
+uint32_t ImageSource::WriteFilteredCopy(const std::vector<std::string> &exifKeys, const int dstFd)
+{
+    ImageTrace imageTrace("ImageSource::WriteFilteredCopy");
+    if (dstFd < 0) {
+        IMAGE_LOGE("WriteFilteredCopy invalid fd.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    uint32_t ret = GetFilterArea(exifKeys, ranges);
+    if (ret != SUCCESS) {
+        return ret;
+    }
+    std::unique_lock<std::mutex> guard(decodingMutex_);
+    uint32_t streamSize = static_cast<uint32_t>(sourceStreamPtr_->GetStreamSize());
+    uint32_t position = 0;
+    for (const auto &range : NormalizeFilterRanges(std::move(ranges), streamSize)) {
+        if (!CopySourceSpan(dstFd, position, range.first - position) || !WriteZeros(dstFd, range.second)) {
+            return ERR_MEDIA_IO_ABNORMAL;
+        }
+        position = range.first + range.second;
+    }
+    if (!CopySourceSpan(dstFd, position, streamSize - position)) {
+        return ERR_MEDIA_IO_ABNORMAL;
+    }
+    return SUCCESS;
+}
+
 void ImageSource::SetIncrementalSource(const bool isIncrementalSource)
 {
     isIncrementalSource_ = isIncrementalSource;
@@ -4163,6 +4628,18 @@ std::unique_ptr<Picture> ImageSource::CreatePicture(const DecodingOptionsForPict
     dopts.desiredPixelFormat = PixelFormat::RGBA_8888;
     dopts.desiredDynamicRange = (ParseHdrType() && IsSingleHdrImage(sourceHdrType_)) ?
         DecodeDynamicRange::HDR : DecodeDynamicRange::SDR;
+    std::set<AuxiliaryPictureType> auxTypes = (opts.desireAuxiliaryPictures.size() > 0) ?
+            opts.desireAuxiliaryPictures : ImageUtils::GetAllAuxiliaryPictureType();
+
+    // Jpeg auxiliary pictures are independent MPF streams, decode them alongside the main image.
+    string format = GetExtendedCodecMimeType(mainDecoder_.get());
+    JpegAuxiliaryTasks jpegAuxTasks;
+    uint32_t jpegAuxErrorCode = SUCCESS;
+    bool jpegAuxParsed = false;
+    if (format == IMAGE_JPEG_FORMAT) {
+        jpegAuxParsed = CreateJpegAuxiliaryTasks(auxTypes, opts.deferAuxiliaryDecode, jpegAuxTasks, jpegAuxErrorCode);
+    }
+
     std::shared_ptr<PixelMap> mainPixelMap = CreatePixelMap(dopts, errorCode);
     std::unique_ptr<Picture> picture = Picture::Create(mainPixelMap);
     if (picture == nullptr) {
@@ -4171,19 +4648,23 @@ std::unique_ptr<Picture> ImageSource::CreatePicture(const DecodingOptionsForPict
         return nullptr;
     }
 
-    string format = GetExtendedCodecMimeType(mainDecoder_.get());
+    if (format.empty()) {
+        format = GetExtendedCodecMimeType(mainDecoder_.get());
+    }
     if (format != IMAGE_HEIF_FORMAT && format != IMAGE_JPEG_FORMAT) {
         IMAGE_LOGE("CreatePicture failed, unsupport format: %{public}s", format.c_str());
         errorCode = ERR_IMAGE_MISMATCHED_FORMAT;
         return nullptr;
     }
 
-    std::set<AuxiliaryPictureType> auxTypes = (opts.desireAuxiliaryPictures.size() > 0) ?
-            opts.desireAuxiliaryPictures : ImageUtils::GetAllAuxiliaryPictureType();
     if (format == IMAGE_HEIF_FORMAT) {
         DecodeHeifAuxiliaryPictures(auxTypes, picture, errorCode);
-    } else if (format == IMAGE_JPEG_FORMAT) {
+    } else if (!jpegAuxParsed && jpegAuxErrorCode == SUCCESS) {
         DecodeJpegAuxiliaryPicture(auxTypes, picture, errorCode);
+    } else if (!jpegAuxParsed) {
+        errorCode = jpegAuxErrorCode;
+    } else {
+        CollectJpegAuxiliaryTasks(jpegAuxTasks, picture, errorCode);
     }
 
     return picture;
@@ -4213,8 +4694,41 @@ void ImageSource::DecodeHeifAuxiliaryPictures(
     }
 }
 
-void ImageSource::DecodeJpegAuxiliaryPicture(
-    const std::set<AuxiliaryPictureType> &auxTypes, std::unique_ptr<Picture> &picture, uint32_t &errorCode)
+struct JpegAuxiliaryRange {
+    AuxiliaryPictureType type = AuxiliaryPictureType::NONE;
+    const uint8_t *data = nullptr;
+    uint32_t size = 0;
+};
+
+struct JpegAuxiliaryTasks {
+    // Decoded by Picture on first access instead of eagerly.
+    std::vector<std::pair<AuxiliaryPictureType, AuxiliaryPictureLoader>> loaders;
+    std::vector<JpegAuxiliaryRange> ranges;
+    std::vector<std::pair<std::shared_ptr<AuxiliaryPicture>, uint32_t>> results;
+    // Declared last so the workers are joined before the ranges and results they use are destroyed.
+    std::vector<std::future<void>> workers;
+};
+
+static std::shared_ptr<AuxiliaryPicture> DecodeJpegAuxiliaryData(ImageHdrType hdrType, AuxiliaryPictureType auxType,
+    const uint8_t *data, uint32_t size, uint32_t &errorCode)
+{
+    std::unique_ptr<InputDataStream> auxStream = BufferSourceStream::CreateSourceStream(data, size);
+    if (auxStream == nullptr) {
+        IMAGE_LOGE("Create auxiliary stream fail, auxiliary type is %{public}d", auxType);
+        return nullptr;
+    }
+    auto auxDecoder = std::unique_ptr<AbsImageDecoder>(DoCreateDecoder(InnerFormat::IMAGE_EXTENDED_CODEC,
+        ImageUtils::GetPluginServer(), *auxStream, errorCode));
+    auto auxPicture = AuxiliaryGenerator::GenerateAuxiliaryPicture(
+        hdrType, auxType, IMAGE_JPEG_FORMAT, auxDecoder, errorCode);
+    if (auxPicture == nullptr) {
+        IMAGE_LOGE("Generate jepg auxiliary picture failed!, errorCode: %{public}d", errorCode);
+    }
+    return auxPicture;
+}
+
+bool ImageSource::ParseJpegAuxiliaryRanges(const std::set<AuxiliaryPictureType> &auxTypes,
+    std::vector<JpegAuxiliaryRange> &ranges, uint32_t &errorCode)
 {
     uint8_t *streamBuffer = sourceStreamPtr_->GetDataPtr();
     uint32_t streamSize = sourceStreamPtr_->GetStreamSize();
@@ -4223,33 +4737,96 @@ void ImageSource::DecodeJpegAuxiliaryPicture(
     if (!jpegMpfParser->CheckMpfOffset(streamBuffer, streamSize, mpfOffset)) {
         IMAGE_LOGE("Jpeg calculate mpf offset failed! mpfOffset: %{public}u", mpfOffset);
         errorCode = ERR_IMAGE_DECODE_HEAD_ABNORMAL;
-        return;
+        return false;
     }
     if (!jpegMpfParser->Parsing(streamBuffer + mpfOffset, streamSize - mpfOffset)) {
         IMAGE_LOGE("Jpeg parse mpf data failed!");
         errorCode = ERR_IMAGE_DECODE_HEAD_ABNORMAL;
-        return;
+        return false;
     }
 
     uint32_t preOffset = mpfOffset + JPEG_MPF_IDENTIFIER_SIZE;
     for (auto &auxInfo : jpegMpfParser->images_) {
-        if (auxTypes.find(auxInfo.auxType) != auxTypes.end()) {
-            IMAGE_LOGI("Jpeg auxiliary picture has found. Type: %{public}d", auxInfo.auxType);
-            std::unique_ptr<InputDataStream> auxStream =
-                BufferSourceStream::CreateSourceStream((streamBuffer + preOffset + auxInfo.offset), auxInfo.size);
-            if (auxStream == nullptr) {
-                IMAGE_LOGE("Create auxiliary stream fail, auxiliary offset is %{public}u", auxInfo.offset);
-                continue;
-            }
-            auto auxDecoder = std::unique_ptr<AbsImageDecoder>(
-                DoCreateDecoder(InnerFormat::IMAGE_EXTENDED_CODEC, pluginServer_, *auxStream, errorCode));
-            auto auxPicture = AuxiliaryGenerator::GenerateAuxiliaryPicture(
-                sourceHdrType_, auxInfo.auxType, IMAGE_JPEG_FORMAT, auxDecoder, errorCode);
-            if (auxPicture == nullptr) {
-                IMAGE_LOGE("Generate jepg auxiliary picture failed!, errorCode: %{public}d", errorCode);
-            } else {
-                picture->SetAuxiliaryPicture(auxPicture);
+        if (auxTypes.find(auxInfo.auxType) == auxTypes.end()) {
+            continue;
+        }
+        IMAGE_LOGI("Jpeg auxiliary picture has found. Type: %{public}d", auxInfo.auxType);
+        if (preOffset > streamSize || auxInfo.offset > streamSize - preOffset ||
+            auxInfo.size > streamSize - preOffset - auxInfo.offset) {
+            IMAGE_LOGE("Auxiliary picture out of range, offset: %{public}u, size: %{public}u",
+                auxInfo.offset, auxInfo.size);
+            continue;
+        }
+        ranges.push_back({ auxInfo.auxType, streamBuffer + preOffset + auxInfo.offset, auxInfo.size });
+    }
+    return true;
+}
+
+bool ImageSource::CreateJpegAuxiliaryTasks(const std::set<AuxiliaryPictureType> &auxTypes, bool deferred,
+    JpegAuxiliaryTasks &tasks, uint32_t &errorCode)
+{
+    std::vector<JpegAuxiliaryRange> ranges;
+    if (!ParseJpegAuxiliaryRanges(auxTypes, ranges, errorCode)) {
+        return false;
+    }
+    ImageHdrType hdrType = sourceHdrType_;
+    for (auto &range : ranges) {
+        // The gainmap carries the HDR type and metadata of the main pixel map, so it is never deferred.
+        if (!deferred || range.type == AuxiliaryPictureType::GAINMAP) {
+            tasks.ranges.push_back(range);
+            continue;
+        }
+        // The source stream may be gone by the time the picture is queried, keep a copy of the sub-stream.
+        auto data = std::make_shared<std::vector<uint8_t>>(range.data, range.data + range.size);
+        AuxiliaryPictureType auxType = range.type;
+        tasks.loaders.emplace_back(auxType, [hdrType, auxType, data]() {
+            uint32_t errorCode = SUCCESS;
+            return DecodeJpegAuxiliaryData(hdrType, auxType, data->data(), data->size(), errorCode);
+        });
+    }
+    tasks.results.resize(tasks.ranges.size());
+    size_t workerCount = std::min(tasks.ranges.size(), MAX_JPEG_AUXILIARY_DECODE_TASKS);
+    for (size_t worker = 0; worker < workerCount; worker++) {
+        tasks.workers.push_back(std::async(std::launch::async, [hdrType, worker, workerCount, &tasks]() {
+            for (size_t i = worker; i < tasks.ranges.size(); i += workerCount) {
+                const JpegAuxiliaryRange &range = tasks.ranges[i];
+                uint32_t errorCode = SUCCESS;
+                auto auxPicture = DecodeJpegAuxiliaryData(hdrType, range.type, range.data, range.size, errorCode);
+                tasks.results[i] = std::make_pair(auxPicture, errorCode);
             }
+        }));
+    }
+    return true;
+}
+
+void ImageSource::CollectJpegAuxiliaryTasks(JpegAuxiliaryTasks &tasks, std::unique_ptr<Picture> &picture,
+    uint32_t &errorCode)
+{
+    for (auto &loader : tasks.loaders) {
+        picture->SetAuxiliaryPictureLoader(loader.first, std::move(loader.second));
+    }
+    for (auto &worker : tasks.workers) {
+        worker.get();
+    }
+    for (auto &result : tasks.results) {
+        errorCode = result.second;
+        if (result.first != nullptr) {
+            picture->SetAuxiliaryPicture(result.first);
+        }
+    }
+}
+
+void ImageSource::DecodeJpegAuxiliaryPicture(
+    const std::set<AuxiliaryPictureType> &auxTypes, std::unique_ptr<Picture> &picture, uint32_t &errorCode)
+{
+    std::vector<JpegAuxiliaryRange> ranges;
+    if (!ParseJpegAuxiliaryRanges(auxTypes, ranges, errorCode)) {
+        return;
+    }
+    for (auto &range : ranges) {
+        auto auxPicture = DecodeJpegAuxiliaryData(sourceHdrType_, range.type, range.data, range.size, errorCode);
+        if (auxPicture != nullptr) {
+            picture->SetAuxiliaryPicture(auxPicture);
         }
     }
 }
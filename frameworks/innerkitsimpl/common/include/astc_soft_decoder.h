@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_ASTC_SOFT_DECODER_H
+#define FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_ASTC_SOFT_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+struct AstcTextureInfo {
+    const uint8_t *blocks = nullptr; // first 128-bit block, right after the .astc file header
+    size_t blocksSize = 0;
+    uint32_t blockX = 0;
+    uint32_t blockY = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// CPU decoder for 2D LDR ASTC textures, used when no GPU is available to sample a PixelAstc.
+class AstcSoftDecoder {
+public:
+    static constexpr uint32_t RGBA_BYTES = 4;
+
+    // Decode one block into blockX * blockY tightly packed RGBA_8888 texels. Reserved encodings and HDR
+    // endpoints produce the ASTC error colour (opaque magenta) and return false.
+    static bool DecodeBlock(const uint8_t *block, uint32_t blockX, uint32_t blockY, uint8_t *rgba);
+
+    // Decode region of the texture into RGBA_8888 rows of dstStride bytes. Only the blocks covering
+    // region are decoded; large regions are split by block rows across worker threads.
+    static uint32_t DecodeRegion(const AstcTextureInfo &texture, const Rect &region, uint8_t *dst,
+        uint32_t dstStride);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_ASTC_SOFT_DECODER_H
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_ALPHA_KERNELS_H
+#define FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_ALPHA_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace OHOS {
+namespace Media {
+// Alpha kernels behind PixelMap::SetAlpha and PixelMap::ConvertAlphaFormat for 4-byte pixels with alpha in the last
+// byte (RGBA_8888 and BGRA_8888). The vector paths (NEON on aarch64, SSE2 on x86_64) perform the same float
+// operations in the same order as the scalar ones, so both produce identical bytes.
+class PixelAlphaKernels {
+public:
+    static constexpr uint32_t PIXEL_BYTES = 4;
+
+    // Scale the alpha of count pixels to percent, un- and re-premultiplying the colour channels when isPremul.
+    static void SetAlpha8888(uint8_t *pixels, size_t count, float percent, bool isPremul);
+    static void SetAlpha8888Scalar(uint8_t *pixels, size_t count, float percent, bool isPremul);
+
+    // Premultiply (toPremul) or unpremultiply count pixels from src into dst. src and dst may be the same buffer.
+    static void ConvertAlpha8888(const uint8_t *src, uint8_t *dst, size_t count, bool toPremul);
+    static void ConvertAlpha8888Scalar(const uint8_t *src, uint8_t *dst, size_t count, bool toPremul);
+
+    // Run func over [0, count) in contiguous parts on up to four threads, the calling thread takes the first part.
+    // Small jobs, measured by count * itemBytes, run on the calling thread only.
+    static void ParallelFor(size_t count, size_t itemBytes, const std::function<void(size_t, size_t)> &func);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_ALPHA_KERNELS_H
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_TRANSFORM_KERNELS_H
+#define FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_TRANSFORM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Media {
+// Lossless orientation changes, rotations are clockwise as seen on screen.
+enum class PixelTransformOp : uint8_t {
+    FLIP_HORIZONTAL,
+    FLIP_VERTICAL,
+    ROTATE_90,
+    ROTATE_180,
+    ROTATE_270,
+};
+
+// Kernels behind PixelMap::rotate by multiples of 90 degrees and PixelMap::flip. Pixels are moved, never resampled,
+// so the result is bit exact. Rotations by 90 and 270 walk the image in square tiles to keep both the source
+// columns and the destination rows in cache. Large images are split across threads.
+class PixelTransformKernels {
+public:
+    // Pixel sizes with a dedicated kernel: 1, 2, 3, 4 and 8 bytes.
+    static bool IsSupportedPixelBytes(uint32_t pixelBytes);
+    static bool SwapsSize(PixelTransformOp op);
+    // Flips and 180 degree rotations always work in place, 90 and 270 degree rotations only on square images.
+    static bool CanTransformInPlace(PixelTransformOp op, uint32_t width, uint32_t height);
+
+    // Write the transformed width x height source to dst, which is height x width when SwapsSize(op).
+    // src and dst must not overlap.
+    static bool Transform(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride, uint32_t width,
+        uint32_t height, uint32_t pixelBytes, PixelTransformOp op);
+    static bool TransformInPlace(uint8_t *pixels, size_t stride, uint32_t width, uint32_t height, uint32_t pixelBytes,
+        PixelTransformOp op);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_COMMON_INCLUDE_PIXEL_TRANSFORM_KERNELS_H
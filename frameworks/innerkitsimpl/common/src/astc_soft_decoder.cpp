@@ -0,0 +1,841 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "astc_soft_decoder.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "image_log.h"
+#include "media_errors.h"
+#include "securec.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
+
+#undef LOG_TAG
+#define LOG_TAG "AstcSoftDecoder"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t ASTC_BLOCK_BYTES = 16;
+constexpr uint32_t ASTC_BLOCK_BITS = 128;
+constexpr uint32_t ASTC_MIN_BLOCK_DIM = 4;
+constexpr uint32_t ASTC_MAX_BLOCK_DIM = 12;
+constexpr uint32_t ASTC_MAX_TEXELS = ASTC_MAX_BLOCK_DIM * ASTC_MAX_BLOCK_DIM;
+constexpr uint32_t ASTC_MAX_WEIGHTS = 64;
+constexpr uint32_t ASTC_MAX_PARTITIONS = 4;
+constexpr uint32_t ASTC_MAX_COLOR_VALUES = 18;
+constexpr uint32_t ASTC_MIN_WEIGHT_BITS = 24;
+constexpr uint32_t ASTC_MAX_WEIGHT_BITS = 96;
+constexpr uint32_t ASTC_SMALL_BLOCK_TEXELS = 31;
+constexpr uint32_t BLOCK_MODE_BITS = 11;
+constexpr uint32_t VOID_EXTENT_MASK = 0x1FF;
+constexpr uint32_t VOID_EXTENT_ID = 0x1FC;
+constexpr uint32_t VOID_EXTENT_HDR_BIT = 9;
+constexpr uint32_t VOID_EXTENT_COLOR_POS = 64;
+constexpr uint32_t PARTITION_COUNT_POS = 11;
+constexpr uint32_t PARTITION_COUNT_BITS = 2;
+constexpr uint32_t PARTITION_INDEX_POS = 13;
+constexpr uint32_t PARTITION_INDEX_BITS = 10;
+constexpr uint32_t SINGLE_CEM_POS = 13;
+constexpr uint32_t SINGLE_COLOR_POS = 17;
+constexpr uint32_t MULTI_CEM_POS = 23;
+constexpr uint32_t MULTI_CEM_BITS = 6;
+constexpr uint32_t MULTI_COLOR_POS = 29;
+constexpr uint32_t CCS_BITS = 2;
+constexpr uint32_t QUANT_LEVELS = 21;
+constexpr uint32_t MIN_COLOR_QUANT = 4; // QUANT_6
+constexpr uint32_t MAX_WEIGHT_QUANT = 11; // QUANT_32
+constexpr uint32_t WEIGHT_MAX = 64;
+constexpr uint32_t UNORM16_TO_UNORM8_SHIFT = 8;
+constexpr uint32_t CHANNELS = 4;
+constexpr uint32_t CHANNEL_R = 0;
+constexpr uint32_t CHANNEL_G = 1;
+constexpr uint32_t CHANNEL_B = 2;
+constexpr uint32_t CHANNEL_A = 3;
+constexpr uint8_t COLOR_MAX = 255;
+constexpr uint32_t MAX_DECODE_THREADS = 4;
+constexpr uint32_t MIN_BLOCKS_PER_THREAD = 256;
+constexpr uint8_t ERROR_COLOR[CHANNELS] = {0xFF, 0x00, 0xFF, 0xFF};
+
+struct IseQuant {
+    uint8_t trits;
+    uint8_t quints;
+    uint8_t bits;
+};
+
+// QUANT_2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128, 160, 192, 256
+constexpr IseQuant ISE_QUANTS[QUANT_LEVELS] = {
+    {0, 0, 1}, {1, 0, 0}, {0, 0, 2}, {0, 1, 0}, {1, 0, 1}, {0, 0, 3}, {0, 1, 1},
+    {1, 0, 2}, {0, 0, 4}, {0, 1, 2}, {1, 0, 3}, {0, 0, 5}, {0, 1, 3}, {1, 0, 4},
+    {0, 0, 6}, {0, 1, 4}, {1, 0, 5}, {0, 0, 7}, {0, 1, 5}, {1, 0, 6}, {0, 0, 8},
+};
+
+struct Bits128 {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+};
+
+struct BlockMode {
+    uint32_t gridX = 0;
+    uint32_t gridY = 0;
+    uint32_t weightQuant = 0;
+    bool dualPlane = false;
+};
+
+Bits128 LoadBits(const uint8_t *block)
+{
+    Bits128 bits;
+    for (uint32_t i = 0; i < ASTC_BLOCK_BYTES / 2; i++) {
+        bits.lo |= static_cast<uint64_t>(block[i]) << (i * 8);
+        bits.hi |= static_cast<uint64_t>(block[i + ASTC_BLOCK_BYTES / 2]) << (i * 8);
+    }
+    return bits;
+}
+
+uint64_t ReverseBits64(uint64_t value)
+{
+    value = ((value >> 1) & 0x5555555555555555ULL) | ((value & 0x5555555555555555ULL) << 1);
+    value = ((value >> 2) & 0x3333333333333333ULL) | ((value & 0x3333333333333333ULL) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    value = ((value >> 8) & 0x00FF00FF00FF00FFULL) | ((value & 0x00FF00FF00FF00FFULL) << 8);
+    value = ((value >> 16) & 0x0000FFFF0000FFFFULL) | ((value & 0x0000FFFF0000FFFFULL) << 16);
+    return (value >> 32) | (value << 32);
+}
+
+// count must not exceed 32; bits past the end of the block read as zero.
+uint32_t ReadBits(const Bits128 &bits, uint32_t start, uint32_t count)
+{
+    if (count == 0 || start >= ASTC_BLOCK_BITS) {
+        return 0;
+    }
+    uint64_t value;
+    if (start >= 64) {
+        value = bits.hi >> (start - 64);
+    } else if (start == 0) {
+        value = bits.lo;
+    } else {
+        value = (bits.lo >> start) | (bits.hi << (64 - start));
+    }
+    return static_cast<uint32_t>(value & ((1ULL << count) - 1));
+}
+
+uint32_t IseBitCount(uint32_t count, uint32_t quant)
+{
+    const IseQuant &ise = ISE_QUANTS[quant];
+    uint32_t bits = ise.bits * count;
+    if (ise.trits != 0) {
+        bits += (8 * count + 4) / 5;
+    } else if (ise.quints != 0) {
+        bits += (7 * count + 2) / 3;
+    }
+    return bits;
+}
+
+uint32_t ReplicateBits(uint32_t value, uint32_t fromBits, uint32_t toBits)
+{
+    if (fromBits == 0) {
+        return 0;
+    }
+    uint32_t result = 0;
+    for (uint32_t filled = 0; filled < toBits; filled += fromBits) {
+        int32_t shift = static_cast<int32_t>(toBits) - static_cast<int32_t>(filled) - static_cast<int32_t>(fromBits);
+        result |= (shift >= 0) ? (value << shift) : (value >> (-shift));
+    }
+    return result & ((1u << toBits) - 1);
+}
+
+void DecodeTrits(uint32_t t, uint32_t *out)
+{
+    uint32_t c;
+    if (((t >> 2) & 0x7) == 0x7) {
+        c = (((t >> 5) & 0x7) << 2) | (t & 0x3);
+        out[4] = 2;
+        out[3] = 2;
+    } else {
+        c = t & 0x1F;
+        if (((t >> 5) & 0x3) == 0x3) {
+            out[4] = 2;
+            out[3] = (t >> 7) & 0x1;
+        } else {
+            out[4] = (t >> 7) & 0x1;
+            out[3] = (t >> 5) & 0x3;
+        }
+    }
+    if ((c & 0x3) == 0x3) {
+        out[2] = 2;
+        out[1] = (c >> 4) & 0x1;
+        out[0] = (((c >> 3) & 0x1) << 1) | (((c >> 2) & 0x1) & ~((c >> 3) & 0x1));
+    } else if (((c >> 2) & 0x3) == 0x3) {
+        out[2] = 2;
+        out[1] = 2;
+        out[0] = c & 0x3;
+    } else {
+        out[2] = (c >> 4) & 0x1;
+        out[1] = (c >> 2) & 0x3;
+        out[0] = (((c >> 1) & 0x1) << 1) | ((c & 0x1) & ~((c >> 1) & 0x1));
+    }
+}
+
+void DecodeQuints(uint32_t q, uint32_t *out)
+{
+    if (((q >> 1) & 0x3) == 0x3 && ((q >> 5) & 0x3) == 0) {
+        uint32_t low = q & 0x1;
+        out[2] = (low << 2) | ((((q >> 4) & 0x1) & ~low) << 1) | (((q >> 3) & 0x1) & ~low);
+        out[1] = 4;
+        out[0] = 4;
+        return;
+    }
+    uint32_t c;
+    if (((q >> 1) & 0x3) == 0x3) {
+        out[2] = 4;
+        c = (((q >> 3) & 0x3) << 3) | ((~(q >> 5) & 0x3) << 1) | (q & 0x1);
+    } else {
+        out[2] = (q >> 5) & 0x3;
+        c = q & 0x1F;
+    }
+    if ((c & 0x7) == 0x5) {
+        out[1] = 4;
+        out[0] = (c >> 3) & 0x3;
+    } else {
+        out[1] = (c >> 3) & 0x3;
+        out[0] = c & 0x7;
+    }
+}
+
+// Reads an integer sequence of count values; each output is (trit or quint << bits) | low bits.
+void DecodeIse(const Bits128 &bits, uint32_t start, uint32_t count, uint32_t quant, uint32_t *out)
+{
+    const IseQuant &ise = ISE_QUANTS[quant];
+    uint32_t end = start + IseBitCount(count, quant);
+    uint32_t pos = start;
+    auto read = [&bits, &pos, end](uint32_t n) {
+        uint32_t avail = (pos < end) ? std::min(n, end - pos) : 0;
+        uint32_t value = ReadBits(bits, pos, avail);
+        pos += n;
+        return value;
+    };
+    if (ise.trits != 0) {
+        static constexpr uint32_t tritBits[5] = {2, 2, 1, 2, 1};
+        for (uint32_t i = 0; i < count; i += 5) {
+            uint32_t low[5];
+            uint32_t packed = 0;
+            uint32_t shift = 0;
+            for (uint32_t j = 0; j < 5; j++) {
+                low[j] = read(ise.bits);
+                packed |= read(tritBits[j]) << shift;
+                shift += tritBits[j];
+            }
+            uint32_t trits[5];
+            DecodeTrits(packed, trits);
+            for (uint32_t j = 0; j < 5 && i + j < count; j++) {
+                out[i + j] = (trits[j] << ise.bits) | low[j];
+            }
+        }
+    } else if (ise.quints != 0) {
+        static constexpr uint32_t quintBits[3] = {3, 2, 2};
+        for (uint32_t i = 0; i < count; i += 3) {
+            uint32_t low[3];
+            uint32_t packed = 0;
+            uint32_t shift = 0;
+            for (uint32_t j = 0; j < 3; j++) {
+                low[j] = read(ise.bits);
+                packed |= read(quintBits[j]) << shift;
+                shift += quintBits[j];
+            }
+            uint32_t quints[3];
+            DecodeQuints(packed, quints);
+            for (uint32_t j = 0; j < 3 && i + j < count; j++) {
+                out[i + j] = (quints[j] << ise.bits) | low[j];
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = read(ise.bits);
+        }
+    }
+}
+
+uint32_t UnquantizeColor(uint32_t quant, uint32_t value)
+{
+    const IseQuant &ise = ISE_QUANTS[quant];
+    if (ise.trits == 0 && ise.quints == 0) {
+        return ReplicateBits(value, ise.bits, 8);
+    }
+    uint32_t low = value & ((1u << ise.bits) - 1);
+    uint32_t digit = value >> ise.bits;
+    uint32_t a = (low & 0x1) ? 0x1FF : 0;
+    uint32_t h = low >> 1;
+    uint32_t b = 0;
+    uint32_t c = 0;
+    if (ise.trits != 0) {
+        switch (ise.bits) {
+            case 1: c = 204; break;
+            case 2: b = (h << 8) | (h << 4) | (h << 2) | (h << 1); c = 93; break;
+            case 3: b = (h << 7) | (h << 2) | h; c = 44; break;
+            case 4: b = (h << 6) | h; c = 22; break;
+            case 5: b = (h << 5) | (h >> 2); c = 11; break;
+            default: b = (h << 4) | (h >> 4); c = 5; break;
+        }
+    } else {
+        switch (ise.bits) {
+            case 1: c = 113; break;
+            case 2: b = (h << 8) | (h << 3) | (h << 2); c = 54; break;
+            case 3: b = (h << 7) | (h << 1) | (h >> 1); c = 26; break;
+            case 4: b = (h << 6) | (h >> 1); c = 13; break;
+            default: b = (h << 5) | (h >> 3); c = 6; break;
+        }
+    }
+    uint32_t t = (digit * c + b) ^ a;
+    return (a & 0x80) | (t >> 2);
+}
+
+uint32_t UnquantizeWeight(uint32_t quant, uint32_t value)
+{
+    const IseQuant &ise = ISE_QUANTS[quant];
+    uint32_t result;
+    if (ise.trits == 0 && ise.quints == 0) {
+        result = ReplicateBits(value, ise.bits, 6);
+    } else if (ise.bits == 0) {
+        static constexpr uint32_t tritWeights[3] = {0, 32, 63};
+        static constexpr uint32_t quintWeights[5] = {0, 16, 32, 47, 63};
+        result = (ise.trits != 0) ? tritWeights[value] : quintWeights[value];
+    } else {
+        uint32_t low = value & ((1u << ise.bits) - 1);
+        uint32_t digit = value >> ise.bits;
+        uint32_t a = (low & 0x1) ? 0x7F : 0;
+        uint32_t h = low >> 1;
+        uint32_t b = 0;
+        uint32_t c = 0;
+        if (ise.trits != 0) {
+            switch (ise.bits) {
+                case 1: c = 50; break;
+                case 2: b = (h << 6) | (h << 2) | h; c = 23; break;
+                default: b = (h << 5) | h; c = 11; break;
+            }
+        } else {
+            switch (ise.bits) {
+                case 1: c = 28; break;
+                default: b = (h << 6) | (h << 1); c = 13; break;
+            }
+        }
+        uint32_t t = (digit * c + b) ^ a;
+        result = (a & 0x20) | (t >> 2);
+    }
+    return (result > 32) ? result + 1 : result;
+}
+
+bool DecodeBlockMode(uint32_t mode, BlockMode &blockMode)
+{
+    uint32_t quant = (mode >> 4) & 0x1;
+    uint32_t highPrecision = (mode >> 9) & 0x1;
+    uint32_t dual = (mode >> 10) & 0x1;
+    uint32_t a = (mode >> 5) & 0x3;
+    if ((mode & 0x3) != 0) {
+        quant |= (mode & 0x3) << 1;
+        uint32_t b = (mode >> 7) & 0x3;
+        switch ((mode >> 2) & 0x3) {
+            case 0: blockMode.gridX = b + 4; blockMode.gridY = a + 2; break;
+            case 1: blockMode.gridX = b + 8; blockMode.gridY = a + 2; break;
+            case 2: blockMode.gridX = a + 2; blockMode.gridY = b + 8; break;
+            default:
+                b &= 0x1;
+                if ((mode & 0x100) != 0) {
+                    blockMode.gridX = b + 2;
+                    blockMode.gridY = a + 2;
+                } else {
+                    blockMode.gridX = a + 2;
+                    blockMode.gridY = b + 6;
+                }
+                break;
+        }
+    } else {
+        quant |= ((mode >> 2) & 0x3) << 1;
+        if (((mode >> 2) & 0x3) == 0) {
+            return false;
+        }
+        uint32_t b = (mode >> 9) & 0x3;
+        switch ((mode >> 7) & 0x3) {
+            case 0: blockMode.gridX = 12; blockMode.gridY = a + 2; break;
+            case 1: blockMode.gridX = a + 2; blockMode.gridY = 12; break;
+            case 2:
+                blockMode.gridX = a + 6;
+                blockMode.gridY = b + 6;
+                dual = 0;
+                highPrecision = 0;
+                break;
+            default:
+                if (a == 0) {
+                    blockMode.gridX = 6;
+                    blockMode.gridY = 10;
+                } else if (a == 1) {
+                    blockMode.gridX = 10;
+                    blockMode.gridY = 6;
+                } else {
+                    return false;
+                }
+                break;
+        }
+    }
+    blockMode.weightQuant = quant - 2 + 6 * highPrecision;
+    blockMode.dualPlane = dual != 0;
+    return blockMode.weightQuant <= MAX_WEIGHT_QUANT;
+}
+
+uint32_t Hash52(uint32_t p)
+{
+    p ^= p >> 15;
+    p -= p << 17;
+    p += p << 7;
+    p += p << 4;
+    p ^= p >> 5;
+    p += p << 16;
+    p ^= p >> 7;
+    p ^= p >> 3;
+    p ^= p << 6;
+    p ^= p >> 17;
+    return p;
+}
+
+uint32_t SelectPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitionCount, bool smallBlock)
+{
+    if (smallBlock) {
+        x <<= 1;
+        y <<= 1;
+    }
+    seed += (partitionCount - 1) * 1024;
+    uint32_t rnum = Hash52(seed);
+    uint32_t seeds[8];
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t s = (rnum >> (i * 4)) & 0xF;
+        seeds[i] = s * s;
+    }
+    uint32_t sh1;
+    uint32_t sh2;
+    if ((seed & 1) != 0) {
+        sh1 = (seed & 2) ? 4 : 5;
+        sh2 = (partitionCount == 3) ? 6 : 5;
+    } else {
+        sh1 = (partitionCount == 3) ? 6 : 5;
+        sh2 = (seed & 2) ? 4 : 5;
+    }
+    for (uint32_t i = 0; i < 8; i += 2) {
+        seeds[i] >>= sh1;
+        seeds[i + 1] >>= sh2;
+    }
+    // z is always zero for 2D blocks, so seeds 9 to 12 drop out.
+    uint32_t a = (seeds[0] * x + seeds[1] * y + (rnum >> 14)) & 0x3F;
+    uint32_t b = (seeds[2] * x + seeds[3] * y + (rnum >> 10)) & 0x3F;
+    uint32_t c = (seeds[4] * x + seeds[5] * y + (rnum >> 6)) & 0x3F;
+    uint32_t d = (seeds[6] * x + seeds[7] * y + (rnum >> 2)) & 0x3F;
+    if (partitionCount < 4) {
+        d = 0;
+    }
+    if (partitionCount < 3) {
+        c = 0;
+    }
+    if (a >= b && a >= c && a >= d) {
+        return 0;
+    } else if (b >= c && b >= d) {
+        return 1;
+    } else if (c >= d) {
+        return 2;
+    }
+    return 3;
+}
+
+int32_t ClampColor(int32_t value)
+{
+    return std::min(std::max(value, 0), static_cast<int32_t>(COLOR_MAX));
+}
+
+void BitTransferSigned(int32_t &a, int32_t &b)
+{
+    b >>= 1;
+    b |= a & 0x80;
+    a >>= 1;
+    a &= 0x3F;
+    if ((a & 0x20) != 0) {
+        a -= 0x40;
+    }
+}
+
+void SetEndpoint(int32_t *endpoint, int32_t r, int32_t g, int32_t b, int32_t a)
+{
+    endpoint[CHANNEL_R] = ClampColor(r);
+    endpoint[CHANNEL_G] = ClampColor(g);
+    endpoint[CHANNEL_B] = ClampColor(b);
+    endpoint[CHANNEL_A] = ClampColor(a);
+}
+
+void SetBlueContracted(int32_t *endpoint, int32_t r, int32_t g, int32_t b, int32_t a)
+{
+    SetEndpoint(endpoint, (r + b) >> 1, (g + b) >> 1, b, a);
+}
+
+// Only the LDR endpoint modes are decoded; HDR modes report failure.
+bool DecodeEndpoints(uint32_t cem, const uint32_t *values, int32_t *e0, int32_t *e1)
+{
+    int32_t v[8];
+    for (uint32_t i = 0; i < ((cem >> 2) + 1) * 2; i++) {
+        v[i] = static_cast<int32_t>(values[i]);
+    }
+    switch (cem) {
+        case 0:
+            SetEndpoint(e0, v[0], v[0], v[0], COLOR_MAX);
+            SetEndpoint(e1, v[1], v[1], v[1], COLOR_MAX);
+            return true;
+        case 1: {
+            int32_t l0 = (v[0] >> 2) | (v[1] & 0xC0);
+            int32_t l1 = std::min(l0 + (v[1] & 0x3F), static_cast<int32_t>(COLOR_MAX));
+            SetEndpoint(e0, l0, l0, l0, COLOR_MAX);
+            SetEndpoint(e1, l1, l1, l1, COLOR_MAX);
+            return true;
+        }
+        case 4:
+            SetEndpoint(e0, v[0], v[0], v[0], v[2]);
+            SetEndpoint(e1, v[1], v[1], v[1], v[3]);
+            return true;
+        case 5:
+            BitTransferSigned(v[1], v[0]);
+            BitTransferSigned(v[3], v[2]);
+            SetEndpoint(e0, v[0], v[0], v[0], v[2]);
+            SetEndpoint(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+            return true;
+        case 6:
+            SetEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, COLOR_MAX);
+            SetEndpoint(e1, v[0], v[1], v[2], COLOR_MAX);
+            return true;
+        case 10:
+            SetEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+            SetEndpoint(e1, v[0], v[1], v[2], v[5]);
+            return true;
+        case 8:
+        case 12: {
+            int32_t a0 = (cem == 12) ? v[6] : COLOR_MAX;
+            int32_t a1 = (cem == 12) ? v[7] : COLOR_MAX;
+            if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+                SetEndpoint(e0, v[0], v[2], v[4], a0);
+                SetEndpoint(e1, v[1], v[3], v[5], a1);
+            } else {
+                SetBlueContracted(e0, v[1], v[3], v[5], a1);
+                SetBlueContracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        case 9:
+        case 13: {
+            BitTransferSigned(v[1], v[0]);
+            BitTransferSigned(v[3], v[2]);
+            BitTransferSigned(v[5], v[4]);
+            int32_t a0 = COLOR_MAX;
+            int32_t a1 = COLOR_MAX;
+            if (cem == 13) {
+                BitTransferSigned(v[7], v[6]);
+                a0 = v[6];
+                a1 = v[6] + v[7];
+            }
+            if (v[1] + v[3] + v[5] >= 0) {
+                SetEndpoint(e0, v[0], v[2], v[4], a0);
+                SetEndpoint(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+            } else {
+                SetBlueContracted(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                SetBlueContracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void InfillWeights(const uint32_t *gridWeights, const BlockMode &mode, uint32_t plane, uint32_t blockX,
+    uint32_t blockY, uint8_t *out)
+{
+    uint32_t planes = mode.dualPlane ? 2 : 1;
+    uint32_t gridCount = mode.gridX * mode.gridY;
+    if (mode.gridX == blockX && mode.gridY == blockY) {
+        for (uint32_t i = 0; i < gridCount; i++) {
+            out[i] = static_cast<uint8_t>(gridWeights[i * planes + plane]);
+        }
+        return;
+    }
+    auto weightAt = [gridWeights, gridCount, planes, plane](uint32_t index) {
+        return (index < gridCount) ? gridWeights[index * planes + plane] : 0;
+    };
+    uint32_t ds = (1024 + blockX / 2) / (blockX - 1);
+    uint32_t dt = (1024 + blockY / 2) / (blockY - 1);
+    for (uint32_t t = 0; t < blockY; t++) {
+        uint32_t gt = (dt * t * (mode.gridY - 1) + 32) >> 6;
+        uint32_t jt = gt >> 4;
+        uint32_t ft = gt & 0xF;
+        for (uint32_t s = 0; s < blockX; s++) {
+            uint32_t gs = (ds * s * (mode.gridX - 1) + 32) >> 6;
+            uint32_t js = gs >> 4;
+            uint32_t fs = gs & 0xF;
+            uint32_t v0 = js + jt * mode.gridX;
+            uint32_t w11 = (fs * ft + 8) >> 4;
+            uint32_t w10 = ft - w11;
+            uint32_t w01 = fs - w11;
+            uint32_t w00 = 16 - fs - ft + w11;
+            uint32_t sum = weightAt(v0) * w00 + weightAt(v0 + 1) * w01 +
+                weightAt(v0 + mode.gridX) * w10 + weightAt(v0 + mode.gridX + 1) * w11;
+            out[t * blockX + s] = static_cast<uint8_t>((sum + 8) >> 4);
+        }
+    }
+}
+
+void FillErrorColor(uint32_t texels, uint8_t *rgba)
+{
+    for (uint32_t i = 0; i < texels; i++) {
+        std::copy(ERROR_COLOR, ERROR_COLOR + CHANNELS, rgba + i * CHANNELS);
+    }
+}
+
+bool DecodeVoidExtent(const Bits128 &bits, uint32_t texels, uint8_t *rgba)
+{
+    if (ReadBits(bits, VOID_EXTENT_HDR_BIT, 1) != 0) {
+        FillErrorColor(texels, rgba);
+        return false;
+    }
+    uint8_t color[CHANNELS];
+    for (uint32_t c = 0; c < CHANNELS; c++) {
+        color[c] = static_cast<uint8_t>(ReadBits(bits, VOID_EXTENT_COLOR_POS + c * 16, 16) >> UNORM16_TO_UNORM8_SHIFT);
+    }
+    for (uint32_t i = 0; i < texels; i++) {
+        std::copy(color, color + CHANNELS, rgba + i * CHANNELS);
+    }
+    return true;
+}
+
+struct BlockLayout {
+    uint32_t partitionCount = 1;
+    uint32_t cem[ASTC_MAX_PARTITIONS] = {0};
+    uint32_t colorStart = SINGLE_COLOR_POS;
+    uint32_t colorBits = 0;
+    uint32_t colorValueCount = 0;
+    uint32_t ccs = 0;
+    uint32_t weightBits = 0;
+};
+
+bool DecodeBlockLayout(const Bits128 &bits, const BlockMode &mode, BlockLayout &layout)
+{
+    layout.partitionCount = ReadBits(bits, PARTITION_COUNT_POS, PARTITION_COUNT_BITS) + 1;
+    if (layout.partitionCount == ASTC_MAX_PARTITIONS && mode.dualPlane) {
+        return false;
+    }
+    uint32_t weightCount = mode.gridX * mode.gridY * (mode.dualPlane ? 2 : 1);
+    layout.weightBits = IseBitCount(weightCount, mode.weightQuant);
+    if (weightCount > ASTC_MAX_WEIGHTS || layout.weightBits < ASTC_MIN_WEIGHT_BITS ||
+        layout.weightBits > ASTC_MAX_WEIGHT_BITS) {
+        return false;
+    }
+    uint32_t belowWeights = ASTC_BLOCK_BITS - layout.weightBits;
+    uint32_t extraCemBits = 0;
+    if (layout.partitionCount == 1) {
+        layout.cem[0] = ReadBits(bits, SINGLE_CEM_POS, 4);
+        layout.colorStart = SINGLE_COLOR_POS;
+    } else {
+        layout.colorStart = MULTI_COLOR_POS;
+        uint32_t encoded = ReadBits(bits, MULTI_CEM_POS, MULTI_CEM_BITS);
+        if ((encoded & 0x3) == 0) {
+            for (uint32_t p = 0; p < layout.partitionCount; p++) {
+                layout.cem[p] = (encoded >> 2) & 0xF;
+            }
+        } else {
+            extraCemBits = 3 * layout.partitionCount - 4;
+            encoded |= ReadBits(bits, belowWeights - extraCemBits, extraCemBits) << MULTI_CEM_BITS;
+            uint32_t baseClass = (encoded & 0x3) - 1;
+            uint32_t bitPos = 2;
+            for (uint32_t p = 0; p < layout.partitionCount; p++, bitPos++) {
+                layout.cem[p] = (((encoded >> bitPos) & 0x1) + baseClass) << 2;
+            }
+            for (uint32_t p = 0; p < layout.partitionCount; p++, bitPos += 2) {
+                layout.cem[p] |= (encoded >> bitPos) & 0x3;
+            }
+        }
+    }
+    if (mode.dualPlane) {
+        layout.ccs = ReadBits(bits, belowWeights - extraCemBits - CCS_BITS, CCS_BITS);
+    }
+    layout.colorValueCount = 0;
+    for (uint32_t p = 0; p < layout.partitionCount; p++) {
+        layout.colorValueCount += ((layout.cem[p] >> 2) + 1) * 2;
+    }
+    uint32_t used = layout.colorStart + layout.weightBits + extraCemBits + (mode.dualPlane ? CCS_BITS : 0);
+    if (layout.colorValueCount > ASTC_MAX_COLOR_VALUES || used >= ASTC_BLOCK_BITS) {
+        return false;
+    }
+    layout.colorBits = ASTC_BLOCK_BITS - used;
+    return true;
+}
+
+void DecodeBlockRows(const AstcTextureInfo &texture, const Rect &region, uint32_t firstBlockRow,
+    uint32_t lastBlockRow, uint8_t *dst, uint32_t dstStride)
+{
+    uint32_t blocksPerRow = (static_cast<uint32_t>(texture.width) + texture.blockX - 1) / texture.blockX;
+    uint32_t firstBlockCol = static_cast<uint32_t>(region.left) / texture.blockX;
+    uint32_t lastBlockCol = static_cast<uint32_t>(region.left + region.width - 1) / texture.blockX;
+    uint8_t texels[ASTC_MAX_TEXELS * CHANNELS];
+    for (uint32_t by = firstBlockRow; by <= lastBlockRow; by++) {
+        int32_t blockTop = static_cast<int32_t>(by * texture.blockY);
+        int32_t rowBegin = std::max(region.top, blockTop);
+        int32_t rowEnd = std::min(region.top + region.height, blockTop + static_cast<int32_t>(texture.blockY));
+        for (uint32_t bx = firstBlockCol; bx <= lastBlockCol; bx++) {
+            const uint8_t *block = texture.blocks + (static_cast<size_t>(by) * blocksPerRow + bx) * ASTC_BLOCK_BYTES;
+            AstcSoftDecoder::DecodeBlock(block, texture.blockX, texture.blockY, texels);
+            int32_t blockLeft = static_cast<int32_t>(bx * texture.blockX);
+            int32_t colBegin = std::max(region.left, blockLeft);
+            int32_t colEnd = std::min(region.left + region.width, blockLeft + static_cast<int32_t>(texture.blockX));
+            size_t copyBytes = static_cast<size_t>(colEnd - colBegin) * CHANNELS;
+            for (int32_t y = rowBegin; y < rowEnd; y++) {
+                const uint8_t *src = texels + ((y - blockTop) * texture.blockX + (colBegin - blockLeft)) * CHANNELS;
+                uint8_t *out = dst + static_cast<size_t>(y - region.top) * dstStride +
+                    static_cast<size_t>(colBegin - region.left) * CHANNELS;
+                std::copy(src, src + copyBytes, out);
+            }
+        }
+    }
+}
+} // namespace
+
+bool AstcSoftDecoder::DecodeBlock(const uint8_t *block, uint32_t blockX, uint32_t blockY, uint8_t *rgba)
+{
+    uint32_t texels = blockX * blockY;
+    Bits128 bits = LoadBits(block);
+    uint32_t modeBits = ReadBits(bits, 0, BLOCK_MODE_BITS);
+    if ((modeBits & VOID_EXTENT_MASK) == VOID_EXTENT_ID) {
+        return DecodeVoidExtent(bits, texels, rgba);
+    }
+    BlockMode mode;
+    BlockLayout layout;
+    if (!DecodeBlockMode(modeBits, mode) || mode.gridX > blockX || mode.gridY > blockY ||
+        !DecodeBlockLayout(bits, mode, layout)) {
+        FillErrorColor(texels, rgba);
+        return false;
+    }
+    uint32_t colorQuant = QUANT_LEVELS;
+    for (uint32_t quant = QUANT_LEVELS - 1; quant >= MIN_COLOR_QUANT; quant--) {
+        if (IseBitCount(layout.colorValueCount, quant) <= layout.colorBits) {
+            colorQuant = quant;
+            break;
+        }
+    }
+    if (colorQuant == QUANT_LEVELS) {
+        FillErrorColor(texels, rgba);
+        return false;
+    }
+
+    uint32_t colorValues[ASTC_MAX_COLOR_VALUES];
+    DecodeIse(bits, layout.colorStart, layout.colorValueCount, colorQuant, colorValues);
+    for (uint32_t i = 0; i < layout.colorValueCount; i++) {
+        colorValues[i] = UnquantizeColor(colorQuant, colorValues[i]);
+    }
+    int32_t endpoints[ASTC_MAX_PARTITIONS][2][CHANNELS];
+    for (uint32_t p = 0, offset = 0; p < layout.partitionCount; p++) {
+        if (!DecodeEndpoints(layout.cem[p], colorValues + offset, endpoints[p][0], endpoints[p][1])) {
+            FillErrorColor(texels, rgba);
+            return false;
+        }
+        offset += ((layout.cem[p] >> 2) + 1) * 2;
+    }
+
+    // Weights are stored bit-reversed from the top of the block.
+    Bits128 reversed;
+    reversed.lo = ReverseBits64(bits.hi);
+    reversed.hi = ReverseBits64(bits.lo);
+    uint32_t weightCount = mode.gridX * mode.gridY * (mode.dualPlane ? 2 : 1);
+    uint32_t gridWeights[ASTC_MAX_WEIGHTS];
+    DecodeIse(reversed, 0, weightCount, mode.weightQuant, gridWeights);
+    for (uint32_t i = 0; i < weightCount; i++) {
+        gridWeights[i] = UnquantizeWeight(mode.weightQuant, gridWeights[i]);
+    }
+    uint8_t weights[2][ASTC_MAX_TEXELS];
+    InfillWeights(gridWeights, mode, 0, blockX, blockY, weights[0]);
+    if (mode.dualPlane) {
+        InfillWeights(gridWeights, mode, 1, blockX, blockY, weights[1]);
+    }
+
+    uint32_t seed = ReadBits(bits, PARTITION_INDEX_POS, PARTITION_INDEX_BITS);
+    bool smallBlock = texels < ASTC_SMALL_BLOCK_TEXELS;
+    for (uint32_t y = 0; y < blockY; y++) {
+        for (uint32_t x = 0; x < blockX; x++) {
+            uint32_t texel = y * blockX + x;
+            uint32_t p = (layout.partitionCount > 1) ?
+                SelectPartition(seed, x, y, layout.partitionCount, smallBlock) : 0;
+            const int32_t *e0 = endpoints[p][0];
+            const int32_t *e1 = endpoints[p][1];
+            uint8_t *out = rgba + texel * CHANNELS;
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                int32_t w = (mode.dualPlane && c == layout.ccs) ? weights[1][texel] : weights[0][texel];
+                // Expand endpoints to UNORM16 and keep the top byte of the interpolated value.
+                int32_t c0 = e0[c] * 257;
+                int32_t c1 = e1[c] * 257;
+                int32_t value = (c0 * (static_cast<int32_t>(WEIGHT_MAX) - w) + c1 * w + 32) >> 6;
+                out[c] = static_cast<uint8_t>(value >> UNORM16_TO_UNORM8_SHIFT);
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t AstcSoftDecoder::DecodeRegion(const AstcTextureInfo &texture, const Rect &region, uint8_t *dst,
+    uint32_t dstStride)
+{
+    if (texture.blocks == nullptr || dst == nullptr || texture.width <= 0 || texture.height <= 0 ||
+        texture.blockX < ASTC_MIN_BLOCK_DIM || texture.blockX > ASTC_MAX_BLOCK_DIM ||
+        texture.blockY < ASTC_MIN_BLOCK_DIM || texture.blockY > ASTC_MAX_BLOCK_DIM) {
+        IMAGE_LOGE("DecodeRegion invalid texture");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (region.left < 0 || region.top < 0 || region.width <= 0 || region.height <= 0 ||
+        region.left > texture.width - region.width || region.top > texture.height - region.height ||
+        dstStride < static_cast<uint32_t>(region.width) * RGBA_BYTES) {
+        IMAGE_LOGE("DecodeRegion invalid region [%{public}d, %{public}d, %{public}d, %{public}d]",
+            region.left, region.top, region.width, region.height);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    size_t blocksPerRow = (static_cast<size_t>(texture.width) + texture.blockX - 1) / texture.blockX;
+    size_t blockRows = (static_cast<size_t>(texture.height) + texture.blockY - 1) / texture.blockY;
+    if (blocksPerRow * blockRows * ASTC_BLOCK_BYTES > texture.blocksSize) {
+        IMAGE_LOGE("DecodeRegion texture data is truncated");
+        return ERR_IMAGE_DATA_ABNORMAL;
+    }
+    uint32_t firstRow = static_cast<uint32_t>(region.top) / texture.blockY;
+    uint32_t lastRow = static_cast<uint32_t>(region.top + region.height - 1) / texture.blockY;
+    uint32_t rowCount = lastRow - firstRow + 1;
+    uint32_t colCount = static_cast<uint32_t>(region.left + region.width - 1) / texture.blockX -
+        static_cast<uint32_t>(region.left) / texture.blockX + 1;
+    uint32_t threads = std::min({std::max(std::thread::hardware_concurrency(), 1u), MAX_DECODE_THREADS, rowCount,
+        std::max(rowCount * colCount / MIN_BLOCKS_PER_THREAD, 1u)});
+    uint32_t rowsPerThread = (rowCount + threads - 1) / threads;
+    std::vector<std::future<void>> workers;
+    for (uint32_t begin = firstRow + rowsPerThread; begin <= lastRow; begin += rowsPerThread) {
+        uint32_t end = std::min(begin + rowsPerThread - 1, lastRow);
+        workers.emplace_back(std::async(std::launch::async, DecodeBlockRows, std::cref(texture), std::cref(region),
+            begin, end, dst, dstStride));
+    }
+    DecodeBlockRows(texture, region, firstRow, std::min(firstRow + rowsPerThread - 1, lastRow), dst, dstStride);
+    for (auto &worker : workers) {
+        worker.wait();
+    }
+    return SUCCESS;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_alpha_kernels.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define PIXEL_ALPHA_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_ALPHA_SSE2
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr float HALF_ONE = 0.5F;
+constexpr float FLOAT_U8_MAX = 255.0F;
+constexpr uint32_t ALPHA_INDEX = 3;
+constexpr uint32_t CHANNEL_MASK = 0xFF;
+constexpr uint32_t G_SHIFT = 8;
+constexpr uint32_t B_SHIFT = 16;
+constexpr uint32_t A_SHIFT = 24;
+constexpr size_t VECTOR_PIXELS = 4;
+constexpr size_t MAX_ALPHA_THREADS = 4;
+constexpr size_t MIN_BYTES_PER_THREAD = 1024 * 1024;
+
+inline uint8_t PremulPixelWithPercent(uint8_t mulPixel, uint8_t alpha, float percent)
+{
+    // nP = mP * UINT8_MAX * percent / oAlpha, see SetUintPixelAlpha in pixel_map.cpp
+    if (alpha == 0) {
+        return 0;
+    }
+    float nPixel = mulPixel * percent * UINT8_MAX / alpha;
+    if ((nPixel + HALF_ONE) >= UINT8_MAX) {
+        return UINT8_MAX;
+    }
+    return static_cast<uint8_t>(nPixel + HALF_ONE);
+}
+
+inline uint8_t GetAlphaOfPercent(float percent)
+{
+    return static_cast<uint8_t>(UINT8_MAX * percent + HALF_ONE);
+}
+
+#ifdef PIXEL_ALPHA_NEON
+// c' = alpha == 0 ? 0 : min(trunc(c * percent * 255 / alpha + 0.5), 255)
+inline uint32x4_t PremulChannelWithPercent(uint32x4_t channel, float32x4_t alpha, uint32x4_t alphaZero,
+    float32x4_t percent)
+{
+    const float32x4_t u8Max = vdupq_n_f32(FLOAT_U8_MAX);
+    float32x4_t nPixel = vdivq_f32(vmulq_f32(vmulq_f32(vcvtq_f32_u32(channel), percent), u8Max), alpha);
+    float32x4_t rounded = vaddq_f32(nPixel, vdupq_n_f32(HALF_ONE));
+    uint32x4_t result = vbslq_u32(vcgeq_f32(rounded, u8Max), vdupq_n_u32(CHANNEL_MASK), vcvtq_u32_f32(rounded));
+    return vbicq_u32(result, alphaZero);
+}
+
+inline void SetAlphaPremulVector(uint8_t *pixels, float percent, uint32_t alphaBits)
+{
+    const uint32x4_t mask = vdupq_n_u32(CHANNEL_MASK);
+    uint32x4_t px = vreinterpretq_u32_u8(vld1q_u8(pixels));
+    uint32x4_t a = vshrq_n_u32(px, A_SHIFT);
+    float32x4_t alpha = vcvtq_f32_u32(a);
+    uint32x4_t alphaZero = vceqq_u32(a, vdupq_n_u32(0));
+    float32x4_t vPercent = vdupq_n_f32(percent);
+    uint32x4_t r = PremulChannelWithPercent(vandq_u32(px, mask), alpha, alphaZero, vPercent);
+    uint32x4_t g = PremulChannelWithPercent(vandq_u32(vshrq_n_u32(px, G_SHIFT), mask), alpha, alphaZero, vPercent);
+    uint32x4_t b = PremulChannelWithPercent(vandq_u32(vshrq_n_u32(px, B_SHIFT), mask), alpha, alphaZero, vPercent);
+    uint32x4_t out = vorrq_u32(vorrq_u32(r, vshlq_n_u32(g, G_SHIFT)),
+        vorrq_u32(vshlq_n_u32(b, B_SHIFT), vdupq_n_u32(alphaBits)));
+    vst1q_u8(pixels, vreinterpretq_u8_u32(out));
+}
+
+inline uint32x4_t ConvertChannel(uint32x4_t channel, float32x4_t alphaValue, uint32x4_t alphaPositive, bool toPremul)
+{
+    float32x4_t pixelValue = vcvtq_f32_u32(channel);
+    float32x4_t nPixel;
+    if (toPremul) {
+        nPixel = vmulq_f32(pixelValue, alphaValue);
+    } else {
+        nPixel = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(pixelValue, alphaValue)),
+            alphaPositive));
+    }
+    uint32x4_t result = vcvtq_u32_f32(vaddq_f32(nPixel, vdupq_n_f32(HALF_ONE)));
+    return vandq_u32(result, vdupq_n_u32(CHANNEL_MASK));
+}
+
+inline void ConvertAlphaVector(const uint8_t *src, uint8_t *dst, bool toPremul)
+{
+    const uint32x4_t mask = vdupq_n_u32(CHANNEL_MASK);
+    uint32x4_t px = vreinterpretq_u32_u8(vld1q_u8(src));
+    float32x4_t alphaValue = vdivq_f32(vcvtq_f32_u32(vshrq_n_u32(px, A_SHIFT)), vdupq_n_f32(FLOAT_U8_MAX));
+    uint32x4_t alphaPositive = vcgtq_f32(alphaValue, vdupq_n_f32(0.0F));
+    uint32x4_t r = ConvertChannel(vandq_u32(px, mask), alphaValue, alphaPositive, toPremul);
+    uint32x4_t g = ConvertChannel(vandq_u32(vshrq_n_u32(px, G_SHIFT), mask), alphaValue, alphaPositive, toPremul);
+    uint32x4_t b = ConvertChannel(vandq_u32(vshrq_n_u32(px, B_SHIFT), mask), alphaValue, alphaPositive, toPremul);
+    uint32x4_t out = vorrq_u32(vorrq_u32(r, vshlq_n_u32(g, G_SHIFT)),
+        vorrq_u32(vshlq_n_u32(b, B_SHIFT), vandq_u32(px, vdupq_n_u32(CHANNEL_MASK << A_SHIFT))));
+    vst1q_u8(dst, vreinterpretq_u8_u32(out));
+}
+#endif
+
+#ifdef PIXEL_ALPHA_SSE2
+inline __m128i PremulChannelWithPercent(__m128i channel, __m128 alpha, __m128i alphaZero, __m128 percent)
+{
+    const __m128 u8Max = _mm_set1_ps(FLOAT_U8_MAX);
+    __m128 nPixel = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(channel), percent), u8Max), alpha);
+    __m128 rounded = _mm_add_ps(nPixel, _mm_set1_ps(HALF_ONE));
+    __m128i saturate = _mm_castps_si128(_mm_cmpge_ps(rounded, u8Max));
+    __m128i result = _mm_or_si128(_mm_andnot_si128(saturate, _mm_cvttps_epi32(rounded)),
+        _mm_and_si128(saturate, _mm_set1_epi32(CHANNEL_MASK)));
+    return _mm_andnot_si128(alphaZero, result);
+}
+
+inline void SetAlphaPremulVector(uint8_t *pixels, float percent, uint32_t alphaBits)
+{
+    const __m128i mask = _mm_set1_epi32(CHANNEL_MASK);
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+    __m128i a = _mm_srli_epi32(px, A_SHIFT);
+    __m128 alpha = _mm_cvtepi32_ps(a);
+    __m128i alphaZero = _mm_cmpeq_epi32(a, _mm_setzero_si128());
+    __m128 vPercent = _mm_set1_ps(percent);
+    __m128i r = PremulChannelWithPercent(_mm_and_si128(px, mask), alpha, alphaZero, vPercent);
+    __m128i g = PremulChannelWithPercent(_mm_and_si128(_mm_srli_epi32(px, G_SHIFT), mask), alpha, alphaZero,
+        vPercent);
+    __m128i b = PremulChannelWithPercent(_mm_and_si128(_mm_srli_epi32(px, B_SHIFT), mask), alpha, alphaZero,
+        vPercent);
+    __m128i out = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, G_SHIFT)),
+        _mm_or_si128(_mm_slli_epi32(b, B_SHIFT), _mm_set1_epi32(static_cast<int32_t>(alphaBits))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels), out);
+}
+
+inline __m128i ConvertChannel(__m128i channel, __m128 alphaValue, __m128 alphaPositive, bool toPremul)
+{
+    __m128 pixelValue = _mm_cvtepi32_ps(channel);
+    __m128 nPixel = toPremul ? _mm_mul_ps(pixelValue, alphaValue) :
+        _mm_and_ps(_mm_div_ps(pixelValue, alphaValue), alphaPositive);
+    __m128i result = _mm_cvttps_epi32(_mm_add_ps(nPixel, _mm_set1_ps(HALF_ONE)));
+    return _mm_and_si128(result, _mm_set1_epi32(CHANNEL_MASK));
+}
+
+inline void ConvertAlphaVector(const uint8_t *src, uint8_t *dst, bool toPremul)
+{
+    const __m128i mask = _mm_set1_epi32(CHANNEL_MASK);
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    __m128 alphaValue = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(px, A_SHIFT)), _mm_set1_ps(FLOAT_U8_MAX));
+    __m128 alphaPositive = _mm_cmpgt_ps(alphaValue, _mm_setzero_ps());
+    __m128i r = ConvertChannel(_mm_and_si128(px, mask), alphaValue, alphaPositive, toPremul);
+    __m128i g = ConvertChannel(_mm_and_si128(_mm_srli_epi32(px, G_SHIFT), mask), alphaValue, alphaPositive,
+        toPremul);
+    __m128i b = ConvertChannel(_mm_and_si128(_mm_srli_epi32(px, B_SHIFT), mask), alphaValue, alphaPositive,
+        toPremul);
+    __m128i alphaBits = _mm_andnot_si128(_mm_set1_epi32(static_cast<int32_t>((1U << A_SHIFT) - 1)), px);
+    __m128i out = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, G_SHIFT)),
+        _mm_or_si128(_mm_slli_epi32(b, B_SHIFT), alphaBits));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), out);
+}
+#endif
+} // namespace
+
+void PixelAlphaKernels::SetAlpha8888Scalar(uint8_t *pixels, size_t count, float percent, bool isPremul)
+{
+    uint8_t alpha = GetAlphaOfPercent(percent);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *pixel = pixels + i * PIXEL_BYTES;
+        if (isPremul) {
+            for (uint32_t channel = 0; channel < ALPHA_INDEX; channel++) {
+                pixel[channel] = PremulPixelWithPercent(pixel[channel], pixel[ALPHA_INDEX], percent);
+            }
+        }
+        pixel[ALPHA_INDEX] = alpha;
+    }
+}
+
+void PixelAlphaKernels::SetAlpha8888(uint8_t *pixels, size_t count, float percent, bool isPremul)
+{
+#if defined(PIXEL_ALPHA_NEON) || defined(PIXEL_ALPHA_SSE2)
+    uint8_t alpha = GetAlphaOfPercent(percent);
+    size_t vectorCount = count - count % VECTOR_PIXELS;
+    if (!isPremul) {
+        for (size_t i = 0; i < count; i++) {
+            pixels[i * PIXEL_BYTES + ALPHA_INDEX] = alpha;
+        }
+        return;
+    }
+    uint32_t alphaBits = static_cast<uint32_t>(alpha) << A_SHIFT;
+    for (size_t i = 0; i < vectorCount; i += VECTOR_PIXELS) {
+        SetAlphaPremulVector(pixels + i * PIXEL_BYTES, percent, alphaBits);
+    }
+    SetAlpha8888Scalar(pixels + vectorCount * PIXEL_BYTES, count - vectorCount, percent, isPremul);
+#else
+    SetAlpha8888Scalar(pixels, count, percent, isPremul);
+#endif
+}
+
+void PixelAlphaKernels::ConvertAlpha8888Scalar(const uint8_t *src, uint8_t *dst, size_t count, bool toPremul)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *rpixel = src + i * PIXEL_BYTES;
+        uint8_t *wpixel = dst + i * PIXEL_BYTES;
+        uint8_t alpha = rpixel[ALPHA_INDEX];
+        // same arithmetic as ConvertUintPixelAlpha in pixel_map.cpp
+        float alphaValue = static_cast<float>(alpha) / UINT8_MAX;
+        for (uint32_t channel = 0; channel < ALPHA_INDEX; channel++) {
+            float pixelValue = static_cast<float>(rpixel[channel]);
+            float nPixel;
+            if (toPremul) {
+                nPixel = pixelValue * alphaValue;
+            } else {
+                nPixel = (alphaValue > 0) ? pixelValue / alphaValue : 0;
+            }
+            // channels above alpha are not valid premultiplied input, they keep the low byte as before
+            wpixel[channel] = static_cast<uint8_t>(static_cast<uint32_t>(nPixel + HALF_ONE));
+        }
+        wpixel[ALPHA_INDEX] = alpha;
+    }
+}
+
+void PixelAlphaKernels::ConvertAlpha8888(const uint8_t *src, uint8_t *dst, size_t count, bool toPremul)
+{
+#if defined(PIXEL_ALPHA_NEON) || defined(PIXEL_ALPHA_SSE2)
+    size_t vectorCount = count - count % VECTOR_PIXELS;
+    for (size_t i = 0; i < vectorCount; i += VECTOR_PIXELS) {
+        ConvertAlphaVector(src + i * PIXEL_BYTES, dst + i * PIXEL_BYTES, toPremul);
+    }
+    ConvertAlpha8888Scalar(src + vectorCount * PIXEL_BYTES, dst + vectorCount * PIXEL_BYTES, count - vectorCount,
+        toPremul);
+#else
+    ConvertAlpha8888Scalar(src, dst, count, toPremul);
+#endif
+}
+
+void PixelAlphaKernels::ParallelFor(size_t count, size_t itemBytes, const std::function<void(size_t, size_t)> &func)
+{
+    size_t hardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t threads = std::min({hardwareThreads, MAX_ALPHA_THREADS, std::max<size_t>(count, 1),
+        std::max<size_t>(count * itemBytes / MIN_BYTES_PER_THREAD, 1)});
+    size_t itemsPerThread = (count + threads - 1) / std::max<size_t>(threads, 1);
+    if (threads <= 1 || itemsPerThread == 0) {
+        func(0, count);
+        return;
+    }
+    std::vector<std::future<void>> workers;
+    for (size_t begin = itemsPerThread; begin < count; begin += itemsPerThread) {
+        size_t end = std::min(begin + itemsPerThread, count);
+        workers.emplace_back(std::async(std::launch::async, [&func, begin, end]() { func(begin, end); }));
+    }
+    func(0, itemsPerThread);
+    for (auto &worker : workers) {
+        worker.wait();
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -15,6 +15,7 @@
 
 #include "pixel_astc.h"
 
+#include "astc_soft_decoder.h"
 #include "image_log.h"
 #include "image_utils.h"
 #include "image_trace.h"
@@ -37,38 +38,144 @@ namespace OHOS {
 namespace Media {
 using namespace std;
 
+constexpr uint8_t ASTC_MAGIC_0 = 0x13;
+constexpr uint8_t ASTC_MAGIC_1 = 0xAB;
+constexpr uint8_t ASTC_MAGIC_2 = 0xA1;
+constexpr uint8_t ASTC_MAGIC_3 = 0x5C;
+constexpr uint8_t BYTE_BITS = 8;
+constexpr uint8_t RGBA_R_INDEX = 0;
+constexpr uint8_t RGBA_G_INDEX = 1;
+constexpr uint8_t RGBA_B_INDEX = 2;
+constexpr uint8_t RGBA_A_INDEX = 3;
+constexpr uint8_t ARGB32_A_SHIFT = 24;
+constexpr uint8_t ARGB32_R_SHIFT = 16;
+constexpr uint8_t ARGB32_G_SHIFT = 8;
+constexpr uint32_t ARGB32_CHANNEL_MASK = 0xFF;
+
+static uint32_t ReadAstcHeaderSize(const uint8_t *size)
+{
+    return static_cast<uint32_t>(size[0]) | (static_cast<uint32_t>(size[1]) << BYTE_BITS) |
+        (static_cast<uint32_t>(size[2]) << (BYTE_BITS + BYTE_BITS));
+}
+
 PixelAstc::~PixelAstc()
 {
     IMAGE_LOGI("PixelAstc destory");
     FreePixelMap();
 }
 
+bool PixelAstc::GetAstcTexture(AstcTextureInfo &texture)
+{
+    const uint8_t *data = GetPixels();
+    if (data == nullptr || GetCapacity() <= sizeof(AstcHeader)) {
+        IMAGE_LOGE("GetAstcTexture pixelastc has no data");
+        return false;
+    }
+    const AstcHeader *header = reinterpret_cast<const AstcHeader *>(data);
+    if (header->magic[0] != ASTC_MAGIC_0 || header->magic[1] != ASTC_MAGIC_1 ||
+        header->magic[2] != ASTC_MAGIC_2 || header->magic[3] != ASTC_MAGIC_3) {
+        IMAGE_LOGE("GetAstcTexture astc header magic mismatch");
+        return false;
+    }
+    texture.blocks = data + sizeof(AstcHeader);
+    texture.blocksSize = GetCapacity() - sizeof(AstcHeader);
+    texture.blockX = header->blockdimX;
+    texture.blockY = header->blockdimY;
+    texture.width = static_cast<int32_t>(ReadAstcHeaderSize(header->xsize));
+    texture.height = static_cast<int32_t>(ReadAstcHeaderSize(header->ysize));
+    return true;
+}
+
+uint32_t PixelAstc::DecodeRegion(const Rect &region, uint8_t *dst, uint32_t dstStride)
+{
+    if (region.left < 0 || region.top < 0 || region.width <= 0 || region.height <= 0 ||
+        region.left > GetWidth() - region.width || region.top > GetHeight() - region.height) {
+        IMAGE_LOGE("DecodeRegion region out of pixelastc range");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    // Scale, rotate and flip are only applied when the texture is sampled on the GPU.
+    TransformData transformData;
+    GetTransformData(transformData);
+    if (!ImageUtils::FloatCompareZero(transformData.scaleX - 1.0f) ||
+        !ImageUtils::FloatCompareZero(transformData.scaleY - 1.0f) ||
+        !ImageUtils::FloatCompareZero(transformData.rotateD) || transformData.flipX || transformData.flipY) {
+        IMAGE_LOGE("DecodeRegion is not support on transformed pixelastc");
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    AstcTextureInfo texture;
+    if (!GetAstcTexture(texture)) {
+        return ERR_IMAGE_READ_PIXELMAP_FAILED;
+    }
+    Rect textureRegion = region;
+    textureRegion.left += static_cast<int32_t>(transformData.cropLeft);
+    textureRegion.top += static_cast<int32_t>(transformData.cropTop);
+    return AstcSoftDecoder::DecodeRegion(texture, textureRegion, dst, dstStride);
+}
+
+const uint8_t *PixelAstc::GetDecodedPixel(int32_t x, int32_t y)
+{
+    int32_t width = GetWidth();
+    int32_t height = GetHeight();
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        IMAGE_LOGE("GetDecodedPixel position [%{public}d, %{public}d] out of range", x, y);
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(*decodedMutex_);
+    uint32_t rowBytes = static_cast<uint32_t>(width) * AstcSoftDecoder::RGBA_BYTES;
+    if (decodedPixels_ == nullptr) {
+        std::unique_ptr<uint8_t[]> pixels(new (std::nothrow) uint8_t[static_cast<size_t>(rowBytes) * height]);
+        if (pixels == nullptr) {
+            IMAGE_LOGE("GetDecodedPixel alloc decode buffer failed");
+            return nullptr;
+        }
+        Rect region = {0, 0, width, height};
+        if (DecodeRegion(region, pixels.get(), rowBytes) != SUCCESS) {
+            return nullptr;
+        }
+        decodedPixels_ = std::move(pixels);
+    }
+    return decodedPixels_.get() + static_cast<size_t>(y) * rowBytes +
+        static_cast<size_t>(x) * AstcSoftDecoder::RGBA_BYTES;
+}
+
+void PixelAstc::ReleaseDecodedPixels()
+{
+    std::lock_guard<std::mutex> lock(*decodedMutex_);
+    decodedPixels_.reset();
+}
+
 const uint8_t *PixelAstc::GetPixel8(int32_t x, int32_t y)
 {
-    IMAGE_LOGE("GetPixel8 is not support on pixelastc");
-    return nullptr;
+    return GetDecodedPixel(x, y);
 }
 
 const uint16_t *PixelAstc::GetPixel16(int32_t x, int32_t y)
 {
-    IMAGE_LOGE("GetPixel16 is not support on pixelastc");
-    return nullptr;
+    return reinterpret_cast<const uint16_t *>(GetDecodedPixel(x, y));
 }
 
 const uint32_t *PixelAstc::GetPixel32(int32_t x, int32_t y)
 {
-    IMAGE_LOGE("GetPixel32 is not support on pixelastc");
-    return nullptr;
+    return reinterpret_cast<const uint32_t *>(GetDecodedPixel(x, y));
 }
 
 bool PixelAstc::GetARGB32Color(int32_t x, int32_t y, uint32_t &color)
 {
-    IMAGE_LOGE("GetARGB32Color is not support on pixelastc");
-    return false;
+    uint8_t rgba[AstcSoftDecoder::RGBA_BYTES] = {0};
+    Rect region = {x, y, 1, 1};
+    if (DecodeRegion(region, rgba, AstcSoftDecoder::RGBA_BYTES) != SUCCESS) {
+        IMAGE_LOGE("GetARGB32Color decode pixelastc failed");
+        return false;
+    }
+    color = (static_cast<uint32_t>(rgba[RGBA_A_INDEX]) << ARGB32_A_SHIFT) |
+        (static_cast<uint32_t>(rgba[RGBA_R_INDEX]) << ARGB32_R_SHIFT) |
+        (static_cast<uint32_t>(rgba[RGBA_G_INDEX]) << ARGB32_G_SHIFT) | static_cast<uint32_t>(rgba[RGBA_B_INDEX]);
+    return true;
 }
 
 void PixelAstc::scale(float xAxis, float yAxis)
 {
+    ReleaseDecodedPixels();
     if (xAxis == 0 || yAxis == 0) {
         IMAGE_LOGE("scale param incorrect on pixelastc");
         return;
@@ -103,6 +210,7 @@ void PixelAstc::translate(float xAxis, float yAxis)
 
 void PixelAstc::rotate(float degrees)
 {
+    ReleaseDecodedPixels();
     TransformData transformData;
     GetTransformData(transformData);
     transformData.rotateD = degrees;
@@ -111,6 +219,7 @@ void PixelAstc::rotate(float degrees)
 
 void PixelAstc::flip(bool xAxis, bool yAxis)
 {
+    ReleaseDecodedPixels();
     TransformData transformData;
     GetTransformData(transformData);
     transformData.flipX = xAxis;
@@ -120,6 +229,7 @@ void PixelAstc::flip(bool xAxis, bool yAxis)
 
 uint32_t PixelAstc::crop(const Rect &rect)
 {
+    ReleaseDecodedPixels();
     ImageInfo imageInfo;
     GetImageInfo(imageInfo);
     if (rect.left >= 0 && rect.top >= 0 && rect.width > 0 && rect.height > 0 &&
@@ -150,26 +260,22 @@ uint32_t PixelAstc::SetAlpha(const float percent)
 
 uint8_t PixelAstc::GetARGB32ColorA(uint32_t color)
 {
-    IMAGE_LOGE("GetARGB32ColorA is not support on pixelastc");
-    return 0;
+    return (color >> ARGB32_A_SHIFT) & ARGB32_CHANNEL_MASK;
 }
 
 uint8_t PixelAstc::GetARGB32ColorR(uint32_t color)
 {
-    IMAGE_LOGE("GetARGB32ColorR is not support on pixelastc");
-    return 0;
+    return (color >> ARGB32_R_SHIFT) & ARGB32_CHANNEL_MASK;
 }
 
 uint8_t PixelAstc::GetARGB32ColorG(uint32_t color)
 {
-    IMAGE_LOGE("GetARGB32ColorG is not support on pixelastc");
-    return 0;
+    return (color >> ARGB32_G_SHIFT) & ARGB32_CHANNEL_MASK;
 }
 
 uint8_t PixelAstc::GetARGB32ColorB(uint32_t color)
 {
-    IMAGE_LOGE("GetARGB32ColorB is not support on pixelastc");
-    return 0;
+    return color & ARGB32_CHANNEL_MASK;
 }
 
 bool PixelAstc::IsSameImage(const PixelMap &other)
@@ -181,20 +287,31 @@ bool PixelAstc::IsSameImage(const PixelMap &other)
 uint32_t PixelAstc::ReadPixels(const uint64_t &bufferSize, const uint32_t &offset, const uint32_t &stride,
                                const Rect &region, uint8_t *dst)
 {
-    IMAGE_LOGE("ReadPixels is not support on pixelastc");
-    return ERR_IMAGE_INVALID_PARAMETER;
+    if (dst == nullptr || region.width <= 0 || region.height <= 0 ||
+        stride < static_cast<uint64_t>(region.width) * AstcSoftDecoder::RGBA_BYTES ||
+        bufferSize < static_cast<uint64_t>(offset) + static_cast<uint64_t>(stride) * (region.height - 1) +
+        static_cast<uint64_t>(region.width) * AstcSoftDecoder::RGBA_BYTES) {
+        IMAGE_LOGE("ReadPixels invalid param on pixelastc");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    return DecodeRegion(region, dst + offset, stride);
 }
 
 uint32_t PixelAstc::ReadPixels(const uint64_t &bufferSize, uint8_t *dst)
 {
-    IMAGE_LOGE("ReadPixels is not support on pixelastc");
-    return ERR_IMAGE_INVALID_PARAMETER;
+    uint64_t rowBytes = static_cast<uint64_t>(GetWidth()) * AstcSoftDecoder::RGBA_BYTES;
+    if (dst == nullptr || rowBytes == 0 || bufferSize < rowBytes * static_cast<uint64_t>(GetHeight())) {
+        IMAGE_LOGE("ReadPixels invalid param on pixelastc");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    Rect region = {0, 0, GetWidth(), GetHeight()};
+    return DecodeRegion(region, dst, static_cast<uint32_t>(rowBytes));
 }
 
 uint32_t PixelAstc::ReadPixel(const Position &pos, uint32_t &dst)
 {
-    IMAGE_LOGE("ReadPixel is not support on pixelastc");
-    return ERR_IMAGE_INVALID_PARAMETER;
+    // A BGRA_8888 texel read as uint32_t has the same layout as an ARGB32 color value.
+    return GetARGB32Color(pos.x, pos.y, dst) ? SUCCESS : ERR_IMAGE_INVALID_PARAMETER;
 }
 
 uint32_t PixelAstc::ResetConfig(const Size &size, const PixelFormat &format)
@@ -17,9 +17,13 @@
 #ifdef EXT_PIXEL
 #include "pixel_yuv_ext.h"
 #endif
+#include <algorithm>
 #include <charconv>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <unistd.h>
+#include <zlib.h>
 
 #include "image_log.h"
 #include "image_system_properties.h"
@@ -32,8 +36,10 @@
 #include "include/core/SkImage.h"
 #include "hitrace_meter.h"
 #include "media_errors.h"
+#include "pixel_alpha_kernels.h"
 #include "pixel_convert_adapter.h"
 #include "pixel_map_utils.h"
+#include "pixel_transform_kernels.h"
 #include "post_proc.h"
 #include "parcel.h"
 #include "pubdef.h"
@@ -104,9 +110,56 @@ static const uint8_t NUM_7 = 7;
 static const uint8_t NUM_8 = 8;
 
 constexpr int32_t ANTIALIASING_SIZE = 350;
+constexpr uint8_t TLV_ROW_FILTER_NONE = 0;
+constexpr uint8_t TLV_ROW_FILTER_SUB = 1;
+constexpr uint8_t TLV_ROW_FILTER_UP = 2;
 
 std::atomic<uint32_t> PixelMap::currentId = 0;
 
+struct PixelMapSharedStorage {
+    uint8_t *data = nullptr;
+    void *context = nullptr;
+    uint32_t size = 0;
+    AllocatorType allocatorType = AllocatorType::HEAP_ALLOC;
+    CustomFreePixelMap freePixelMapProc = nullptr;
+
+    ~PixelMapSharedStorage()
+    {
+        if (data == nullptr) {
+            return;
+        }
+        if (freePixelMapProc != nullptr) {
+            freePixelMapProc(data, context, size);
+        }
+        switch (allocatorType) {
+            case AllocatorType::HEAP_ALLOC:
+                free(data);
+                break;
+            case AllocatorType::SHARE_MEM_ALLOC: {
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
+                int *fd = static_cast<int *>(context);
+                ::munmap(data, size);
+                if (fd != nullptr) {
+                    ::close(*fd);
+                    delete fd;
+                }
+#endif
+                break;
+            }
+            case AllocatorType::DMA_ALLOC:
+#if !defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
+                ImageUtils::SurfaceBuffer_Unreference(static_cast<SurfaceBuffer*>(context));
+#endif
+                break;
+            default:
+                IMAGE_LOGE("shared storage unknown allocator type:[%{public}d].", allocatorType);
+                break;
+        }
+        data = nullptr;
+        context = nullptr;
+    }
+};
+
 PixelMap::~PixelMap()
 {
     IMAGE_LOGD("PixelMap::~PixelMap_id:%{public}d width:%{public}d height:%{public}d",
@@ -129,6 +182,15 @@ void PixelMap::FreePixelMap() __attribute__((no_sanitize("cfi")))
         return;
     }
 
+    ReleaseMarshallingCache();
+    if (sharedStorage_ != nullptr) {
+        // the last PixelMap holding the shared pixels releases them
+        sharedStorage_ = nullptr;
+        data_ = nullptr;
+        context_ = nullptr;
+        return;
+    }
+
     if (freePixelMapProc_ != nullptr) {
         freePixelMapProc_(data_, context_, pixelsSize_);
     }
@@ -831,6 +893,13 @@ bool PixelMap::CopyPixelMap(PixelMap &source, PixelMap &dstPixelMap, int32_t &er
         error = IMAGE_RESULT_DATA_ABNORMAL;
         return false;
     }
+    if (source.ShareStorage(dstPixelMap)) {
+#ifdef IMAGE_COLORSPACE_FLAG
+        OHOS::ColorManager::ColorSpace colorspace = source.InnerGetGrColorSpace();
+        dstPixelMap.InnerSetColorSpace(colorspace);
+#endif
+        return true;
+    }
     int fd = -1;
     void *dstPixels = nullptr;
     unique_ptr<AbsMemory> memory;
@@ -866,6 +935,107 @@ bool PixelMap::CopyPixelMap(PixelMap &source, PixelMap &dstPixelMap, int32_t &er
     return true;
 }
 
+bool PixelMap::IsStorageShareable() const
+{
+    if (data_ == nullptr || isAstc_ || purgeableMemPtr_ != nullptr) {
+        return false;
+    }
+    if (allocatorType_ == AllocatorType::SHARE_MEM_ALLOC) {
+        return context_ != nullptr;
+    }
+    return allocatorType_ == AllocatorType::HEAP_ALLOC || allocatorType_ == AllocatorType::DMA_ALLOC;
+}
+
+bool PixelMap::ShareStorage(PixelMap &dstPixelMap)
+{
+    if (!IsStorageShareable() || dstPixelMap.data_ != nullptr ||
+        imageInfo_.pixelFormat != dstPixelMap.imageInfo_.pixelFormat ||
+        !IsSameSize(imageInfo_.size, dstPixelMap.imageInfo_.size) ||
+        (allocatorType_ != AllocatorType::DMA_ALLOC && rowStride_ != dstPixelMap.rowStride_)) {
+        return false;
+    }
+    if (sharedStorage_ == nullptr) {
+        auto storage = std::make_shared<PixelMapSharedStorage>();
+        storage->data = data_;
+        storage->context = context_;
+        storage->size = pixelsSize_;
+        storage->allocatorType = allocatorType_;
+        storage->freePixelMapProc = freePixelMapProc_;
+        freePixelMapProc_ = nullptr;
+        sharedStorage_ = storage;
+    }
+    dstPixelMap.SetPixelsAddr(data_, context_, pixelsSize_, allocatorType_, nullptr);
+    dstPixelMap.sharedStorage_ = sharedStorage_;
+    IMAGE_LOGD("ShareStorage id:%{public}u share pixels with id:%{public}u", GetUniqueId(),
+        dstPixelMap.GetUniqueId());
+    return true;
+}
+
+uint32_t PixelMap::DetachSharedStorage()
+{
+    if (sharedStorage_ == nullptr) {
+        return SUCCESS;
+    }
+    if (sharedStorage_.use_count() == 1) {
+        // no other PixelMap holds the pixels anymore, take the ownership back
+        freePixelMapProc_ = sharedStorage_->freePixelMapProc;
+        sharedStorage_->data = nullptr;
+        sharedStorage_ = nullptr;
+        return SUCCESS;
+    }
+    ImageTrace imageTrace("PixelMap DetachSharedStorage");
+    MemoryData memoryData = {nullptr, pixelsSize_, "Detach ImageData", imageInfo_.size, imageInfo_.pixelFormat};
+    auto memory = MemoryManager::CreateMemory(allocatorType_, memoryData);
+    if (memory == nullptr || memory->data.data == nullptr) {
+        IMAGE_LOGE("DetachSharedStorage allocate memory fail allocatetype: %{public}d", allocatorType_);
+        return ERR_IMAGE_MALLOC_ABNORMAL;
+    }
+    uint8_t *dstPixels = static_cast<uint8_t *>(memory->data.data);
+    if (allocatorType_ == AllocatorType::DMA_ALLOC) {
+#if !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+        int32_t dstStride = reinterpret_cast<SurfaceBuffer*>(memory->extend.data)->GetStride();
+        for (int32_t i = 0; i < imageInfo_.size.height; ++i) {
+            if (memcpy_s(dstPixels + i * dstStride, dstStride, data_ + i * rowStride_, rowDataSize_) != EOK) {
+                IMAGE_LOGE("DetachSharedStorage copy row %{public}d fail", i);
+                memory->Release();
+                return ERR_IMAGE_MALLOC_ABNORMAL;
+            }
+        }
+#endif
+    } else if (memcpy_s(dstPixels, memory->data.size, data_, pixelsSize_) != EOK) {
+        IMAGE_LOGE("DetachSharedStorage copy size %{public}u fail", pixelsSize_);
+        memory->Release();
+        return ERR_IMAGE_MALLOC_ABNORMAL;
+    }
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    if (allocatorType_ == AllocatorType::DMA_ALLOC && IsHdr()) {
+        sptr<SurfaceBuffer> sourceSurfaceBuffer(reinterpret_cast<SurfaceBuffer*>(GetFd()));
+        sptr<SurfaceBuffer> dstSurfaceBuffer(reinterpret_cast<SurfaceBuffer*>(memory->extend.data));
+        VpeUtils::CopySurfaceBufferInfo(sourceSurfaceBuffer, dstSurfaceBuffer);
+    }
+#endif
+    // drop the reference without touching the memory still used by the other PixelMaps
+    sharedStorage_ = nullptr;
+    data_ = nullptr;
+    context_ = nullptr;
+    SetPixelsAddr(memory->data.data, memory->extend.data, memory->data.size, memory->GetType(), nullptr);
+    return SUCCESS;
+}
+
+uint32_t PixelMap::PrepareWritablePixels()
+{
+    ReleaseMarshallingCache();
+    return DetachSharedStorage();
+}
+
+void *PixelMap::GetWritablePixels() const
+{
+    if (const_cast<PixelMap *>(this)->PrepareWritablePixels() != SUCCESS) {
+        return nullptr;
+    }
+    return static_cast<void *>(data_);
+}
+
 bool PixelMap::IsSameSize(const Size &src, const Size &dst)
 {
     return (src.width == dst.width) && (src.height == dst.height);
@@ -1571,7 +1741,7 @@ uint32_t PixelMap::WritePixel(const Position &pos, const uint32_t &color)
         IMAGE_LOGE("write pixel by pos current pixelmap image info is invalid.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("write pixel by pos but current pixelmap data is nullptr.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
@@ -1602,7 +1772,7 @@ uint32_t PixelMap::WritePixels(const uint8_t *source, const uint64_t &bufferSize
         IMAGE_LOGE("write pixel by rect current pixelmap image info is invalid.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("write pixel by rect current pixel map data is null.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
@@ -1638,7 +1808,7 @@ uint32_t PixelMap::WritePixels(const uint8_t *source, const uint64_t &bufferSize
         IMAGE_LOGE("write pixels by buffer current pixelmap image info is invalid.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("write pixels by buffer current pixelmap data is nullptr.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
@@ -1680,7 +1850,7 @@ bool PixelMap::WritePixels(const uint32_t &color)
         IMAGE_LOGE("erase pixels by color current pixelmap image info is invalid.");
         return false;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("erase pixels by color current pixel map data is null.");
         return false;
     }
@@ -1798,6 +1968,73 @@ bool PixelMap::WriteAshmemDataToParcel(Parcel &parcel, size_t size) const
     IMAGE_LOGE("WriteAshmemData not support crossplatform");
     return false;
 }
+
+bool PixelMap::WriteCachedAshmemDataToParcel(Parcel &parcel, size_t size) const
+{
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
+    std::lock_guard<std::mutex> lock(*marshallingMutex_);
+    if (marshallingFd_ >= 0 && marshallingSize_ == size) {
+        IMAGE_LOGD("WriteCachedAshmemData reuse fd:[%{public}d].", marshallingFd_);
+        return WriteFileDescriptor(parcel, marshallingFd_);
+    }
+    if (marshallingFd_ >= 0) {
+        ::close(marshallingFd_);
+        marshallingFd_ = -1;
+        marshallingSize_ = 0;
+    }
+    std::string name = "Parcel ImageData, uniqueId: " + std::to_string(getpid()) + '_' +
+        std::to_string(GetUniqueId());
+    int fd = AshmemCreate(name.c_str(), size);
+    if (fd < 0) {
+        IMAGE_LOGE("WriteCachedAshmemData AshmemCreate failed:[%{public}d].", fd);
+        return false;
+    }
+    if (AshmemSetProt(fd, PROT_READ | PROT_WRITE) < 0) {
+        ::close(fd);
+        return false;
+    }
+    void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        ::close(fd);
+        IMAGE_LOGE("WriteCachedAshmemData map failed, errno:%{public}d", errno);
+        return false;
+    }
+    if (memcpy_s(ptr, size, data_, size) != EOK) {
+        ::munmap(ptr, size);
+        ::close(fd);
+        IMAGE_LOGE("WriteCachedAshmemData memcpy_s error");
+        return false;
+    }
+    ::munmap(ptr, size);
+    // receivers only map the region for reading, seal it so the cached copy cannot be modified
+    if (AshmemSetProt(fd, PROT_READ) < 0) {
+        IMAGE_LOGW("WriteCachedAshmemData set read only prot failed");
+    }
+    if (!WriteFileDescriptor(parcel, fd)) {
+        ::close(fd);
+        IMAGE_LOGE("WriteCachedAshmemData WriteFileDescriptor error");
+        return false;
+    }
+    marshallingFd_ = fd;
+    marshallingSize_ = size;
+    return true;
+#else
+    return WriteAshmemDataToParcel(parcel, size);
+#endif
+}
+
+void PixelMap::ReleaseMarshallingCache() const
+{
+    std::lock_guard<std::mutex> lock(*marshallingMutex_);
+    if (marshallingFd_ < 0) {
+        return;
+    }
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
+    ::close(marshallingFd_);
+#endif
+    marshallingFd_ = -1;
+    marshallingSize_ = 0;
+}
 // LCOV_EXCL_STOP
 
 bool PixelMap::WriteImageData(Parcel &parcel, size_t size) const
@@ -1815,6 +2052,9 @@ bool PixelMap::WriteImageData(Parcel &parcel, size_t size) const
     if (size <= MIN_IMAGEDATA_SIZE) {
         return parcel.WriteUnpadBuffer(data, size);
     }
+    if (allocatorType_ == AllocatorType::HEAP_ALLOC) {
+        return WriteCachedAshmemDataToParcel(parcel, size);
+    }
     return WriteAshmemDataToParcel(parcel, size);
 }
 
@@ -2407,15 +2647,11 @@ void PixelMap::WriteData(std::vector<uint8_t> &buff, const uint8_t *data,
 {
     if (allocatorType_ == AllocatorType::DMA_ALLOC) {
         for (int row = 0; row < height; row++) {
-            for (int col = 0; col < rowDataSize; col++) {
-                buff.push_back(*(data + row * rowStride + col));
-            }
+            const uint8_t *rowData = data + row * rowStride;
+            buff.insert(buff.end(), rowData, rowData + rowDataSize);
         }
     } else {
-        int32_t size = pixelsSize_;
-        for (int32_t offset = 0; offset < size; offset++) {
-            buff.push_back(*(data + offset));
-        }
+        buff.insert(buff.end(), data, data + pixelsSize_);
     }
 }
 
@@ -2434,14 +2670,198 @@ uint8_t *PixelMap::ReadData(std::vector<uint8_t> &buff, int32_t size, int32_t &c
         IMAGE_LOGE("pixel map tlv read data fail: malloc memory size[%{public}d]", size);
         return nullptr;
     }
-    for (int32_t offset = 0; offset < size; offset++) {
-        *(data + offset) = buff[cursor++];
+    if (memcpy_s(data, size, buff.data() + cursor, size) != EOK) {
+        free(data);
+        IMAGE_LOGE("pixel map tlv read data fail: memcpy error");
+        return nullptr;
+    }
+    cursor += size;
+    return data;
+}
+
+// Pick the PNG-style predictor (none, left neighbour or row above) with the smallest residual magnitude.
+static uint8_t ChooseTlvRowFilter(const uint8_t *row, const uint8_t *prevRow, int32_t rowSize, int32_t pixelBytes)
+{
+    uint64_t noneCost = 0;
+    uint64_t subCost = 0;
+    uint64_t upCost = 0;
+    for (int32_t i = 0; i < rowSize; i++) {
+        uint8_t left = (i >= pixelBytes) ? row[i - pixelBytes] : 0;
+        uint8_t up = (prevRow != nullptr) ? prevRow[i] : 0;
+        noneCost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(row[i])));
+        subCost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(static_cast<uint8_t>(row[i] - left))));
+        upCost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(static_cast<uint8_t>(row[i] - up))));
+    }
+    if (subCost <= upCost && subCost < noneCost) {
+        return TLV_ROW_FILTER_SUB;
+    }
+    return (upCost < noneCost) ? TLV_ROW_FILTER_UP : TLV_ROW_FILTER_NONE;
+}
+
+// Writes the filter type followed by the filtered row, so out must hold rowSize + 1 bytes.
+static void FilterTlvRow(const uint8_t *row, const uint8_t *prevRow, int32_t rowSize, int32_t pixelBytes,
+    uint8_t *out)
+{
+    uint8_t filter = ChooseTlvRowFilter(row, prevRow, rowSize, pixelBytes);
+    out[0] = filter;
+    uint8_t *dst = out + 1;
+    for (int32_t i = 0; i < rowSize; i++) {
+        uint8_t predict = 0;
+        if (filter == TLV_ROW_FILTER_SUB && i >= pixelBytes) {
+            predict = row[i - pixelBytes];
+        } else if (filter == TLV_ROW_FILTER_UP && prevRow != nullptr) {
+            predict = prevRow[i];
+        }
+        dst[i] = static_cast<uint8_t>(row[i] - predict);
+    }
+}
+
+static bool UnfilterTlvRow(uint8_t filter, uint8_t *row, const uint8_t *prevRow, int32_t rowSize,
+    int32_t pixelBytes)
+{
+    switch (filter) {
+        case TLV_ROW_FILTER_NONE:
+            return true;
+        case TLV_ROW_FILTER_SUB:
+            for (int32_t i = pixelBytes; i < rowSize; i++) {
+                row[i] = static_cast<uint8_t>(row[i] + row[i - pixelBytes]);
+            }
+            return true;
+        case TLV_ROW_FILTER_UP:
+            if (prevRow == nullptr) {
+                return true;
+            }
+            for (int32_t i = 0; i < rowSize; i++) {
+                row[i] = static_cast<uint8_t>(row[i] + prevRow[i]);
+            }
+            return true;
+        default:
+            IMAGE_LOGE("pixel map tlv decode fail: unknown row filter[%{public}d]", filter);
+            return false;
+    }
+}
+
+static bool InflateTlvBytes(z_stream &stream, uint8_t *dst, uInt size)
+{
+    stream.next_out = dst;
+    stream.avail_out = size;
+    while (stream.avail_out > 0) {
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            return stream.avail_out == 0;
+        }
+        if (ret != Z_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PixelMap::WriteCompressedData(std::vector<uint8_t> &buff, const uint8_t *data, const int32_t &height,
+    const int32_t &rowDataSize, const int32_t &rowStride) const
+{
+    int32_t pixelBytes = std::max(ImageUtils::GetPixelBytes(imageInfo_.pixelFormat), 1);
+    int32_t srcStride = (allocatorType_ == AllocatorType::DMA_ALLOC) ? rowStride : rowDataSize;
+    z_stream stream = {};
+    if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+        IMAGE_LOGE("pixel map tlv compress fail: deflateInit error");
+        return false;
+    }
+    uLong filteredSize = static_cast<uLong>(rowDataSize + 1) * static_cast<uLong>(height);
+    std::vector<uint8_t> compressed(deflateBound(&stream, filteredSize));
+    std::vector<uint8_t> filtered(rowDataSize + 1);
+    stream.next_out = compressed.data();
+    stream.avail_out = static_cast<uInt>(compressed.size());
+    int ret = Z_OK;
+    for (int32_t row = 0; row < height; row++) {
+        const uint8_t *rowData = data + row * srcStride;
+        FilterTlvRow(rowData, (row > 0) ? rowData - srcStride : nullptr, rowDataSize, pixelBytes, filtered.data());
+        stream.next_in = filtered.data();
+        stream.avail_in = static_cast<uInt>(filtered.size());
+        ret = deflate(&stream, (row == height - 1) ? Z_FINISH : Z_NO_FLUSH);
+        if (ret == Z_STREAM_ERROR || stream.avail_in != 0) {
+            break;
+        }
+    }
+    size_t compressedSize = stream.total_out;
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        IMAGE_LOGE("pixel map tlv compress fail: deflate error[%{public}d]", ret);
+        return false;
+    }
+    int32_t rawSize = rowDataSize * height;
+    if (compressedSize >= static_cast<size_t>(rawSize)) {
+        IMAGE_LOGD("pixel map tlv compress skipped: incompressible data");
+        return false;
+    }
+    WriteUint8(buff, TLV_IMAGE_COMPRESSED_DATA);
+    WriteVarint(buff, GetVarintLen(rawSize) + static_cast<int32_t>(compressedSize));
+    WriteVarint(buff, rawSize);
+    buff.insert(buff.end(), compressed.begin(), compressed.begin() + compressedSize);
+    return true;
+}
+
+uint8_t *PixelMap::ReadCompressedData(std::vector<uint8_t> &buff, const ImageInfo &info, int32_t len,
+    int32_t &cursor, int32_t &size)
+{
+    int32_t end = cursor + len;
+    int32_t rawSize = ReadVarint(buff, cursor);
+    int32_t height = info.size.height;
+    if (rawSize <= 0 || static_cast<size_t>(rawSize) > MAX_IMAGEDATA_SIZE || height <= 0 ||
+        rawSize % height != 0 || cursor >= end) {
+        IMAGE_LOGE("pixel map tlv decode fail: invalid compressed data, raw size[%{public}d]", rawSize);
+        cursor = end;
+        return nullptr;
+    }
+    int32_t rowDataSize = rawSize / height;
+    int32_t pixelBytes = std::max(ImageUtils::GetPixelBytes(info.pixelFormat), 1);
+    uint8_t *data = static_cast<uint8_t *>(malloc(rawSize));
+    if (data == nullptr) {
+        IMAGE_LOGE("pixel map tlv read data fail: malloc memory size[%{public}d]", rawSize);
+        cursor = end;
+        return nullptr;
+    }
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) {
+        free(data);
+        IMAGE_LOGE("pixel map tlv decode fail: inflateInit error");
+        cursor = end;
+        return nullptr;
+    }
+    stream.next_in = buff.data() + cursor;
+    stream.avail_in = static_cast<uInt>(end - cursor);
+    bool success = true;
+    for (int32_t row = 0; row < height && success; row++) {
+        uint8_t *rowData = data + row * rowDataSize;
+        uint8_t filter = TLV_ROW_FILTER_NONE;
+        success = InflateTlvBytes(stream, &filter, 1) &&
+            InflateTlvBytes(stream, rowData, static_cast<uInt>(rowDataSize)) &&
+            UnfilterTlvRow(filter, rowData, (row > 0) ? rowData - rowDataSize : nullptr, rowDataSize, pixelBytes);
+    }
+    inflateEnd(&stream);
+    cursor = end;
+    if (!success) {
+        free(data);
+        IMAGE_LOGE("pixel map tlv decode fail: inflate error");
+        return nullptr;
     }
+    size = rawSize;
     return data;
 }
 
 bool PixelMap::EncodeTlv(std::vector<uint8_t> &buff) const
 {
+    return EncodeTlv(buff, false);
+}
+
+bool PixelMap::EncodeTlv(std::vector<uint8_t> &buff, bool compress) const
+{
+    if (!compress && rowDataSize_ > 0 && imageInfo_.size.height > 0) {
+        // header attributes stay well below the reserved slack
+        constexpr size_t tlvHeaderReserve = 64;
+        buff.reserve(buff.size() + tlvHeaderReserve +
+            static_cast<size_t>(rowDataSize_) * static_cast<size_t>(imageInfo_.size.height));
+    }
     WriteUint8(buff, TLV_IMAGE_WIDTH);
     WriteVarint(buff, GetVarintLen(imageInfo_.size.width));
     WriteVarint(buff, imageInfo_.size.width);
@@ -2464,15 +2884,20 @@ bool PixelMap::EncodeTlv(std::vector<uint8_t> &buff) const
     AllocatorType tmpAllocatorType = AllocatorType::HEAP_ALLOC;
     WriteVarint(buff, GetVarintLen(static_cast<int32_t>(tmpAllocatorType)));
     WriteVarint(buff, static_cast<int32_t>(tmpAllocatorType));
-    WriteUint8(buff, TLV_IMAGE_DATA);
     const uint8_t *data = data_;
     int32_t dataSize = rowDataSize_ * imageInfo_.size.height;
     if (data == nullptr || size_t(dataSize) > MAX_IMAGEDATA_SIZE || dataSize <= 0) {
+        WriteUint8(buff, TLV_IMAGE_DATA);
         WriteVarint(buff, 0); // L is zero and no value
         WriteUint8(buff, TLV_END); // end tag
         IMAGE_LOGE("pixel map tlv encode fail: no data");
         return false;
     }
+    if (compress && WriteCompressedData(buff, data, imageInfo_.size.height, rowDataSize_, rowStride_)) {
+        WriteUint8(buff, TLV_END); // end tag
+        return true;
+    }
+    WriteUint8(buff, TLV_IMAGE_DATA);
     WriteVarint(buff, dataSize);
     WriteData(buff, data, imageInfo_.size.height, rowDataSize_, rowStride_);
     WriteUint8(buff, TLV_END); // end tag
@@ -2515,6 +2940,9 @@ void PixelMap::ReadTlvAttr(std::vector<uint8_t> &buff, ImageInfo &info, int32_t
                 size = len;
                 *data = ReadData(buff, size, cursor);
                 break;
+            case TLV_IMAGE_COMPRESSED_DATA:
+                *data = ReadCompressedData(buff, info, len, cursor, size);
+                break;
             default:
                 cursor += len; // skip unknown tag
                 IMAGE_LOGW("pixel map tlv decode warn: unknown tag[%{public}d]", tag);
@@ -2881,14 +3309,24 @@ uint32_t PixelMap::ConvertAlphaFormat(PixelMap &wPixelMap, const bool isPremul)
 
     PixelFormat srcPixelFormat = GetPixelFormat();
     int8_t srcAlphaIndex = GetAlphaIndex(srcPixelFormat);
-    int32_t index = 0;
-    for (int32_t i = 0; i < imageInfo_.size.height; ++i) {
-        for (int32_t j = 0; j < stride; j+=pixelBytes_) {
-            index = i * stride + j;
-            ConvertUintPixelAlpha(data_ + index, pixelBytes_, srcAlphaIndex, isPremul,
-                static_cast<uint8_t*>(dstData) + index);
+    uint8_t* dstPixels = static_cast<uint8_t*>(dstData);
+    bool useKernel = pixelBytes_ == static_cast<int32_t>(PixelAlphaKernels::PIXEL_BYTES) &&
+        srcAlphaIndex == BGRA_ALPHA_INDEX && stride % pixelBytes_ == 0;
+    PixelAlphaKernels::ParallelFor(static_cast<size_t>(imageInfo_.size.height), static_cast<size_t>(stride),
+        [this, dstPixels, stride, srcAlphaIndex, isPremul, useKernel](size_t beginRow, size_t endRow) {
+        if (useKernel) {
+            size_t offset = beginRow * static_cast<size_t>(stride);
+            PixelAlphaKernels::ConvertAlpha8888(data_ + offset, dstPixels + offset,
+                (endRow - beginRow) * static_cast<size_t>(stride) / PixelAlphaKernels::PIXEL_BYTES, isPremul);
+            return;
         }
-    }
+        for (size_t i = beginRow; i < endRow; ++i) {
+            for (int32_t j = 0; j < stride; j += pixelBytes_) {
+                size_t index = i * static_cast<size_t>(stride) + static_cast<size_t>(j);
+                ConvertUintPixelAlpha(data_ + index, pixelBytes_, srcAlphaIndex, isPremul, dstPixels + index);
+            }
+        }
+    });
     if (isPremul == true) {
         wPixelMap.SetAlphaType(AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
     } else {
@@ -2931,17 +3369,30 @@ uint32_t PixelMap::SetAlpha(const float percent)
             GetNamedPixelFormat(pixelFormat).c_str(), pixelBytes_);
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    for (uint32_t i = 0; i < pixelsSize;) {
-        uint8_t* pixel = data_ + i;
-        if (pixelFormat == PixelFormat::RGBA_F16) {
-            SetF16PixelAlpha(pixel, percent, isPixelPremul);
-        } else if (pixelFormat == PixelFormat::RGBA_1010102) {
-            SetRGBA1010102PixelAlpha(pixel, percent, alphaIndex, isPixelPremul);
-        } else {
-            SetUintPixelAlpha(pixel, percent, pixelBytes_, alphaIndex, isPixelPremul);
+    if (PrepareWritablePixels() != SUCCESS) {
+        IMAGE_LOGE("SetAlpha detach shared pixels failed");
+        return ERR_IMAGE_MALLOC_ABNORMAL;
+    }
+    size_t pixelBytes = static_cast<size_t>(pixelBytes_);
+    bool useKernel = (pixelFormat == PixelFormat::RGBA_8888 || pixelFormat == PixelFormat::BGRA_8888) &&
+        pixelBytes == PixelAlphaKernels::PIXEL_BYTES;
+    PixelAlphaKernels::ParallelFor(pixelsSize / pixelBytes, pixelBytes,
+        [this, pixelFormat, pixelBytes, percent, alphaIndex, isPixelPremul, useKernel](size_t begin, size_t end) {
+        if (useKernel) {
+            PixelAlphaKernels::SetAlpha8888(data_ + begin * pixelBytes, end - begin, percent, isPixelPremul);
+            return;
         }
-        i += static_cast<uint32_t>(pixelBytes_);
-    }
+        for (size_t i = begin; i < end; i++) {
+            uint8_t* pixel = data_ + i * pixelBytes;
+            if (pixelFormat == PixelFormat::RGBA_F16) {
+                SetF16PixelAlpha(pixel, percent, isPixelPremul);
+            } else if (pixelFormat == PixelFormat::RGBA_1010102) {
+                SetRGBA1010102PixelAlpha(pixel, percent, alphaIndex, isPixelPremul);
+            } else {
+                SetUintPixelAlpha(pixel, percent, pixelBytes_, alphaIndex, isPixelPremul);
+            }
+        }
+    });
     return SUCCESS;
 }
 
@@ -3014,7 +3465,7 @@ static void GenSrcTransInfo(SkTransInfo &srcInfo, ImageInfo &imageInfo, PixelMap
         SurfaceBuffer* sbBuffer = reinterpret_cast<SurfaceBuffer*>(pixelmap->GetFd());
         rowStride = static_cast<uint64_t>(sbBuffer->GetStride());
     }
-    srcInfo.bitmap.installPixels(srcInfo.info, static_cast<uint8_t *>(pixelmap->GetWritablePixels()), rowStride);
+    srcInfo.bitmap.installPixels(srcInfo.info, const_cast<uint8_t *>(pixelmap->GetPixels()), rowStride);
 }
 #else
 static void GenSrcTransInfo(SkTransInfo &srcInfo, ImageInfo &imageInfo, uint8_t* pixels,
@@ -3158,6 +3609,90 @@ bool PixelMap::DoTranslation(TransInfos &infos, const AntiAliasingOption &option
     return true;
 }
 
+// Moves pixels for flips and right angle rotations instead of drawing through a canvas. Square images and
+// orientations that keep the size are changed in place, the others get a new buffer from the same allocator.
+bool PixelMap::DoExactTransform(PixelTransformOp op)
+{
+    uint32_t pixelBytes = static_cast<uint32_t>(pixelBytes_);
+    if (data_ == nullptr || isAstc_ || IsYuvFormat() || !PixelTransformKernels::IsSupportedPixelBytes(pixelBytes) ||
+        imageInfo_.size.width <= 0 || imageInfo_.size.height <= 0 || rowStride_ <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(*translationMutex_);
+    uint32_t width = static_cast<uint32_t>(imageInfo_.size.width);
+    uint32_t height = static_cast<uint32_t>(imageInfo_.size.height);
+    if (PixelTransformKernels::CanTransformInPlace(op, width, height)) {
+        if (PrepareWritablePixels() != SUCCESS) {
+            return false;
+        }
+        PixelTransformKernels::TransformInPlace(data_, static_cast<size_t>(rowStride_), width, height, pixelBytes, op);
+        ImageUtils::FlushSurfaceBuffer(this);
+        return true;
+    }
+    ImageInfo imageInfo;
+    GetImageInfo(imageInfo);
+    std::swap(imageInfo.size.width, imageInfo.size.height);
+    AllocatorType allocType = (allocatorType_ == AllocatorType::CUSTOM_ALLOC) ? AllocatorType::DEFAULT : allocatorType_;
+    uint64_t dstRowStride = static_cast<uint64_t>(height) * pixelBytes;
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    MemoryData memoryData = {nullptr, dstRowStride * width, "Trans ImageData", imageInfo.size, imageInfo.pixelFormat};
+#else
+    MemoryData memoryData = {nullptr, dstRowStride * width, "Trans ImageData"};
+    memoryData.format = imageInfo.pixelFormat;
+#endif
+    std::unique_ptr<AbsMemory> m = MemoryManager::CreateMemory(allocType, memoryData);
+    if (m == nullptr) {
+        IMAGE_LOGE("DoExactTransform CreateMemory failed");
+        this->errorCode = IMAGE_RESULT_DECODE_FAILED;
+        return false;
+    }
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    if (allocType == AllocatorType::DMA_ALLOC) {
+        if (m->extend.data == nullptr) {
+            IMAGE_LOGE("DoExactTransform get surfacebuffer failed");
+            m->Release();
+            return false;
+        }
+        dstRowStride = static_cast<uint64_t>(reinterpret_cast<SurfaceBuffer*>(m->extend.data)->GetStride());
+    }
+#endif
+    PixelTransformKernels::Transform(data_, static_cast<size_t>(rowStride_), static_cast<uint8_t*>(m->data.data),
+        dstRowStride, width, height, pixelBytes, op);
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    if (allocatorType_ == AllocatorType::DMA_ALLOC && IsHdr()) {
+        sptr<SurfaceBuffer> sourceSurfaceBuffer(reinterpret_cast<SurfaceBuffer*> (GetFd()));
+        sptr<SurfaceBuffer> dstSurfaceBuffer(reinterpret_cast<SurfaceBuffer*>(m->extend.data));
+        VpeUtils::CopySurfaceBufferInfo(sourceSurfaceBuffer, dstSurfaceBuffer);
+    }
+#endif
+    SetPixelsAddr(m->data.data, m->extend.data, m->data.size, m->GetType(), nullptr);
+    SetImageInfo(imageInfo, true);
+    ImageUtils::FlushSurfaceBuffer(this);
+    return true;
+}
+
+static bool GetRightAngleRotation(float degrees, PixelTransformOp &op)
+{
+    constexpr float fullTurn = 360.0f;
+    constexpr float quarterTurn = 90.0f;
+    constexpr float halfTurn = 180.0f;
+    constexpr float threeQuarterTurn = 270.0f;
+    float normalized = std::fmod(degrees, fullTurn);
+    if (normalized < 0) {
+        normalized += fullTurn;
+    }
+    if (normalized == quarterTurn) {
+        op = PixelTransformOp::ROTATE_90;
+    } else if (normalized == halfTurn) {
+        op = PixelTransformOp::ROTATE_180;
+    } else if (normalized == threeQuarterTurn) {
+        op = PixelTransformOp::ROTATE_270;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 void PixelMap::scale(float xAxis, float yAxis)
 {
     ImageTrace imageTrace("PixelMap scale xAxis = %f, yAxis = %f", xAxis, yAxis);
@@ -3215,6 +3750,10 @@ void PixelMap::translate(float xAxis, float yAxis)
 void PixelMap::rotate(float degrees)
 {
     ImageTrace imageTrace("PixelMap rotate");
+    PixelTransformOp op;
+    if (GetRightAngleRotation(degrees, op) && DoExactTransform(op)) {
+        return;
+    }
     TransInfos infos;
     infos.matrix.setRotate(degrees);
     if (!DoTranslation(infos)) {
@@ -3228,6 +3767,11 @@ void PixelMap::flip(bool xAxis, bool yAxis)
     if (xAxis == false && yAxis == false) {
         return;
     }
+    PixelTransformOp op = xAxis ? (yAxis ? PixelTransformOp::ROTATE_180 : PixelTransformOp::FLIP_HORIZONTAL) :
+        PixelTransformOp::FLIP_VERTICAL;
+    if (DoExactTransform(op)) {
+        return;
+    }
     scale(xAxis ? -1 : 1, yAxis ? -1 : 1);
 }
 
@@ -3282,6 +3826,226 @@ uint32_t PixelMap::crop(const Rect &rect)
     return SUCCESS;
 }
 
+PixelMapTransform &PixelMapTransform::Scale(float xAxis, float yAxis)
+{
+    PixelMapTransformStep step;
+    step.type = PixelMapTransformStepType::SCALE;
+    step.xAxis = xAxis;
+    step.yAxis = yAxis;
+    steps_.push_back(step);
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::Translate(float xAxis, float yAxis)
+{
+    PixelMapTransformStep step;
+    step.type = PixelMapTransformStepType::TRANSLATE;
+    step.xAxis = xAxis;
+    step.yAxis = yAxis;
+    steps_.push_back(step);
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::Rotate(float degrees)
+{
+    PixelMapTransformStep step;
+    step.type = PixelMapTransformStepType::ROTATE;
+    step.xAxis = degrees;
+    steps_.push_back(step);
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::Flip(bool xAxis, bool yAxis)
+{
+    if (!xAxis && !yAxis) {
+        return *this;
+    }
+    PixelMapTransformStep step;
+    step.type = PixelMapTransformStepType::FLIP;
+    step.xAxis = xAxis ? -1.0f : 1.0f;
+    step.yAxis = yAxis ? -1.0f : 1.0f;
+    steps_.push_back(step);
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::Crop(const Rect &rect)
+{
+    PixelMapTransformStep step;
+    step.type = PixelMapTransformStepType::CROP;
+    step.rect = rect;
+    steps_.push_back(step);
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::SetPixelFormat(PixelFormat format)
+{
+    pixelFormat_ = format;
+    return *this;
+}
+
+PixelMapTransform &PixelMapTransform::SetAntiAliasing(AntiAliasingOption option)
+{
+    antiAliasing_ = option;
+    return *this;
+}
+
+struct FusedTransform {
+    SkMatrix matrix;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// Concatenates the steps into one source to destination matrix. The size after every step is rounded exactly as
+// DoTranslation and crop round it, so the fused output has the size the step by step chain would produce.
+static uint32_t ComposeTransform(const std::vector<PixelMapTransformStep> &steps, FusedTransform &fused)
+{
+    for (const PixelMapTransformStep &step : steps) {
+        if (step.type == PixelMapTransformStepType::CROP) {
+            SkIRect bounds = SkIRect::MakeWH(fused.width, fused.height);
+            SkIRect cropRect = SkIRect::MakeXYWH(step.rect.left, step.rect.top, step.rect.width, step.rect.height);
+            if (cropRect.isEmpty() || !bounds.contains(cropRect)) {
+                IMAGE_LOGE("ComposeTransform invalid crop rect");
+                return ERR_IMAGE_CROP;
+            }
+            fused.matrix.postTranslate(-cropRect.fLeft, -cropRect.fTop);
+            fused.width = cropRect.width();
+            fused.height = cropRect.height();
+            continue;
+        }
+        SkMatrix op;
+        if (step.type == PixelMapTransformStepType::TRANSLATE) {
+            op.setTranslate(step.xAxis, step.yAxis);
+        } else if (step.type == PixelMapTransformStepType::ROTATE) {
+            op.setRotate(step.xAxis);
+        } else {
+            op.setScale(step.xAxis, step.yAxis);
+        }
+        SkRect r = op.mapRect(SkRect::MakeIWH(fused.width, fused.height));
+        int width = FloatToInt(r.width());
+        int height = FloatToInt(r.height());
+        if (op.isTranslate()) {
+            width += r.fLeft;
+            height += r.fTop;
+        } else {
+            op.postTranslate(-r.fLeft, -r.fTop);
+        }
+        if (width <= 0 || height <= 0) {
+            IMAGE_LOGE("ComposeTransform empty result %{public}d x %{public}d", width, height);
+            return ERR_IMAGE_INVALID_PARAMETER;
+        }
+        fused.matrix.postConcat(op);
+        fused.width = width;
+        fused.height = height;
+    }
+    return SUCCESS;
+}
+
+uint32_t PixelMap::ApplyTransformSteps(const PixelMapTransform &transform)
+{
+    if (transform.GetPixelFormat() != PixelFormat::UNKNOWN && transform.GetPixelFormat() != imageInfo_.pixelFormat) {
+        IMAGE_LOGE("ApplyTransform can not convert this pixel map to %{public}d", transform.GetPixelFormat());
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    for (const PixelMapTransformStep &step : transform.GetSteps()) {
+        switch (step.type) {
+            case PixelMapTransformStepType::SCALE:
+                scale(step.xAxis, step.yAxis, transform.GetAntiAliasing());
+                break;
+            case PixelMapTransformStepType::TRANSLATE:
+                translate(step.xAxis, step.yAxis);
+                break;
+            case PixelMapTransformStepType::ROTATE:
+                rotate(step.xAxis);
+                break;
+            case PixelMapTransformStepType::FLIP:
+                flip(step.xAxis < 0, step.yAxis < 0);
+                break;
+            default: {
+                uint32_t ret = crop(step.rect);
+                if (ret != SUCCESS) {
+                    return ret;
+                }
+                break;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+uint32_t PixelMap::ApplyTransform(const PixelMapTransform &transform)
+{
+    ImageTrace imageTrace("PixelMap ApplyTransform");
+    const std::vector<PixelMapTransformStep> &steps = transform.GetSteps();
+    PixelFormat dstFormat = transform.GetPixelFormat() == PixelFormat::UNKNOWN ?
+        imageInfo_.pixelFormat : transform.GetPixelFormat();
+    bool convert = dstFormat != imageInfo_.pixelFormat;
+    if (data_ == nullptr) {
+        return ERR_IMAGE_DATA_ABNORMAL;
+    }
+    if (isAstc_ || IsYuvFormat() || (steps.size() <= 1 && !convert)) {
+        return ApplyTransformSteps(transform);
+    }
+    std::lock_guard<std::mutex> lock(*translationMutex_);
+    ImageInfo imageInfo;
+    GetImageInfo(imageInfo);
+    FusedTransform fused;
+    fused.width = imageInfo.size.width;
+    fused.height = imageInfo.size.height;
+    uint32_t ret = ComposeTransform(steps, fused);
+    if (ret != SUCCESS) {
+        return ret;
+    }
+    SkTransInfo src;
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    GenSrcTransInfo(src, imageInfo, this, ToSkColorSpace(this));
+#else
+    GenSrcTransInfo(src, imageInfo, data_, ToSkColorSpace(this));
+#endif
+    SkTransInfo dst;
+    dst.info = src.info.makeWH(fused.width, fused.height).makeColorType(ImageTypeConverter::ToSkColorType(dstFormat));
+    if (dst.info.colorType() == kUnknown_SkColorType) {
+        IMAGE_LOGE("ApplyTransform unsupported pixel format %{public}d", dstFormat);
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    if (dst.info.colorType() == kRGB_565_SkColorType) {
+        dst.info = dst.info.makeAlphaType(kOpaque_SkAlphaType);
+    }
+    // Reuse the destination set up of DoTranslation with an identity size mapping.
+    SkTransInfo sized;
+    sized.r = SkRect::MakeIWH(fused.width, fused.height);
+    sized.info = dst.info;
+    SkMatrix identity;
+    TransMemoryInfo dstMemory;
+    dstMemory.allocType = (allocatorType_ == AllocatorType::CUSTOM_ALLOC) ? AllocatorType::DEFAULT : allocatorType_;
+    if (!GendstTransInfo(sized, dst, identity, dstMemory)) {
+        IMAGE_LOGE("ApplyTransform alloc %{public}d x %{public}d failed", fused.width, fused.height);
+        return ERR_IMAGE_MALLOC_ABNORMAL;
+    }
+    SkCanvas canvas(dst.bitmap);
+    canvas.concat(fused.matrix);
+    src.bitmap.setImmutable();
+    auto skimage = SkImage::MakeFromBitmap(src.bitmap);
+    if (skimage == nullptr) {
+        IMAGE_LOGE("ApplyTransform MakeFromBitmap failed");
+        dstMemory.memory->Release();
+        return IMAGE_RESULT_TRANSFORM;
+    }
+    DrawImage(fused.matrix.rectStaysRect(), transform.GetAntiAliasing(), canvas, skimage);
+    ToImageInfo(imageInfo, dst.info, false);
+    auto m = dstMemory.memory.get();
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    if (allocatorType_ == AllocatorType::DMA_ALLOC && IsHdr() && !convert) {
+        sptr<SurfaceBuffer> sourceSurfaceBuffer(reinterpret_cast<SurfaceBuffer*>(GetFd()));
+        sptr<SurfaceBuffer> dstSurfaceBuffer(reinterpret_cast<SurfaceBuffer*>(m->extend.data));
+        VpeUtils::CopySurfaceBufferInfo(sourceSurfaceBuffer, dstSurfaceBuffer);
+    }
+#endif
+    SetPixelsAddr(m->data.data, m->extend.data, m->data.size, m->GetType(), nullptr);
+    SetImageInfo(imageInfo, true);
+    ImageUtils::FlushSurfaceBuffer(this);
+    return SUCCESS;
+}
+
 #if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
 static bool DecomposeImage(sptr<SurfaceBuffer>& hdr, sptr<SurfaceBuffer>& sdr, bool isSRGB = false)
 {
@@ -3411,7 +4175,6 @@ uint32_t PixelMap::ApplyColorSpace(const OHOS::ColorManager::ColorSpace &grColor
         SurfaceBuffer* sbBuffer = reinterpret_cast<SurfaceBuffer*>(GetFd());
         rowStride = static_cast<uint64_t>(sbBuffer->GetStride());
     }
-    srcData = static_cast<uint8_t *>(GetWritablePixels());
 #endif
     src.bitmap.installPixels(src.info, srcData, rowStride);
     // Build sk target infomation
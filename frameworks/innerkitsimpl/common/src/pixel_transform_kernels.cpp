@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_transform_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include "pixel_alpha_kernels.h"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t TILE_PIXELS = 32;
+constexpr uint32_t PIXEL_BYTES_1 = 1;
+constexpr uint32_t PIXEL_BYTES_2 = 2;
+constexpr uint32_t PIXEL_BYTES_3 = 3;
+constexpr uint32_t PIXEL_BYTES_4 = 4;
+constexpr uint32_t PIXEL_BYTES_8 = 8;
+constexpr uint32_t HALF = 2;
+
+// N is a compile time constant, so every copy below is a single load and store of the pixel size.
+template <size_t N>
+inline void CopyPixel(uint8_t *dst, const uint8_t *src)
+{
+    std::memcpy(dst, src, N);
+}
+
+template <size_t N>
+inline void SwapPixel(uint8_t *a, uint8_t *b)
+{
+    uint8_t tmp[N];
+    std::memcpy(tmp, a, N);
+    std::memcpy(a, b, N);
+    std::memcpy(b, tmp, N);
+}
+
+template <size_t N>
+void ReverseRow(const uint8_t *src, uint8_t *dst, uint32_t width)
+{
+    const uint8_t *last = src + static_cast<size_t>(width - 1) * N;
+    for (uint32_t x = 0; x < width; x++) {
+        CopyPixel<N>(dst + static_cast<size_t>(x) * N, last - static_cast<size_t>(x) * N);
+    }
+}
+
+// Swap a with b mirrored, which reverses a single row when a == b.
+template <size_t N>
+void SwapReversedRows(uint8_t *a, uint8_t *b, uint32_t width)
+{
+    uint8_t *lastB = b + static_cast<size_t>(width - 1) * N;
+    uint32_t count = (a == b) ? width / HALF : width;
+    for (uint32_t x = 0; x < count; x++) {
+        SwapPixel<N>(a + static_cast<size_t>(x) * N, lastB - static_cast<size_t>(x) * N);
+    }
+}
+
+template <size_t N>
+void SwapRows(uint8_t *a, uint8_t *b, uint32_t width)
+{
+    for (uint32_t x = 0; x < width; x++) {
+        SwapPixel<N>(a + static_cast<size_t>(x) * N, b + static_cast<size_t>(x) * N);
+    }
+}
+
+// dst row r takes source column r (ROTATE_90, read bottom up) or column width - 1 - r (ROTATE_270, read top down).
+template <size_t N>
+void RotateRows(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride, uint32_t width,
+    uint32_t height, bool clockwise, size_t beginRow, size_t endRow)
+{
+    for (size_t rowTile = beginRow; rowTile < endRow; rowTile += TILE_PIXELS) {
+        size_t rowEnd = std::min(rowTile + TILE_PIXELS, endRow);
+        for (uint32_t colTile = 0; colTile < height; colTile += TILE_PIXELS) {
+            uint32_t colEnd = std::min(colTile + TILE_PIXELS, height);
+            for (size_t r = rowTile; r < rowEnd; r++) {
+                size_t srcX = clockwise ? r : width - 1 - r;
+                const uint8_t *srcColumn = src + srcX * N;
+                uint8_t *dstRow = dst + r * dstStride;
+                for (uint32_t c = colTile; c < colEnd; c++) {
+                    size_t srcY = clockwise ? height - 1 - c : c;
+                    CopyPixel<N>(dstRow + static_cast<size_t>(c) * N, srcColumn + srcY * srcStride);
+                }
+            }
+        }
+    }
+}
+
+template <size_t N>
+void TransformPixels(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride, uint32_t width,
+    uint32_t height, PixelTransformOp op)
+{
+    size_t rowBytes = static_cast<size_t>(width) * N;
+    if (op == PixelTransformOp::ROTATE_90 || op == PixelTransformOp::ROTATE_270) {
+        bool clockwise = op == PixelTransformOp::ROTATE_90;
+        PixelAlphaKernels::ParallelFor(width, static_cast<size_t>(height) * N,
+            [=](size_t begin, size_t end) {
+            RotateRows<N>(src, srcStride, dst, dstStride, width, height, clockwise, begin, end);
+        });
+        return;
+    }
+    PixelAlphaKernels::ParallelFor(height, rowBytes, [=](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            uint8_t *dstRow = dst + y * dstStride;
+            if (op == PixelTransformOp::FLIP_HORIZONTAL) {
+                ReverseRow<N>(src + y * srcStride, dstRow, width);
+            } else if (op == PixelTransformOp::FLIP_VERTICAL) {
+                std::memcpy(dstRow, src + (height - 1 - y) * srcStride, rowBytes);
+            } else {
+                ReverseRow<N>(src + (height - 1 - y) * srcStride, dstRow, width);
+            }
+        }
+    });
+}
+
+// Transposes a square image in place. Each part owns whole tile rows and swaps the tiles right of the diagonal
+// with their mirror below it, so no two parts touch the same tile.
+template <size_t N>
+void TransposeSquare(uint8_t *pixels, size_t stride, uint32_t size)
+{
+    size_t tiles = (size + TILE_PIXELS - 1) / TILE_PIXELS;
+    PixelAlphaKernels::ParallelFor(tiles, static_cast<size_t>(size) * TILE_PIXELS * N,
+        [=](size_t begin, size_t end) {
+        for (size_t tileRow = begin; tileRow < end; tileRow++) {
+            uint32_t rowBegin = static_cast<uint32_t>(tileRow * TILE_PIXELS);
+            uint32_t rowEnd = std::min(rowBegin + TILE_PIXELS, size);
+            for (uint32_t colBegin = rowBegin; colBegin < size; colBegin += TILE_PIXELS) {
+                uint32_t colEnd = std::min(colBegin + TILE_PIXELS, size);
+                for (uint32_t y = rowBegin; y < rowEnd; y++) {
+                    for (uint32_t x = std::max(colBegin, y + 1); x < colEnd; x++) {
+                        SwapPixel<N>(pixels + y * stride + static_cast<size_t>(x) * N,
+                            pixels + x * stride + static_cast<size_t>(y) * N);
+                    }
+                }
+            }
+        }
+    });
+}
+
+template <size_t N>
+void TransformPixelsInPlace(uint8_t *pixels, size_t stride, uint32_t width, uint32_t height, PixelTransformOp op)
+{
+    if (op == PixelTransformOp::ROTATE_90 || op == PixelTransformOp::ROTATE_270) {
+        // A clockwise quarter turn is a transpose followed by a horizontal flip, counter clockwise a vertical one.
+        TransposeSquare<N>(pixels, stride, width);
+        TransformPixelsInPlace<N>(pixels, stride, width, height, op == PixelTransformOp::ROTATE_90 ?
+            PixelTransformOp::FLIP_HORIZONTAL : PixelTransformOp::FLIP_VERTICAL);
+        return;
+    }
+    size_t rowBytes = static_cast<size_t>(width) * N;
+    if (op == PixelTransformOp::FLIP_HORIZONTAL) {
+        PixelAlphaKernels::ParallelFor(height, rowBytes, [=](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                SwapReversedRows<N>(pixels + y * stride, pixels + y * stride, width);
+            }
+        });
+        return;
+    }
+    bool reverse = op == PixelTransformOp::ROTATE_180;
+    // The middle row of an odd height stays in place, a 180 degree turn still mirrors it.
+    size_t pairs = (height + (reverse ? 1 : 0)) / HALF;
+    PixelAlphaKernels::ParallelFor(pairs, rowBytes * HALF, [=](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; y++) {
+            uint8_t *top = pixels + y * stride;
+            uint8_t *bottom = pixels + (height - 1 - y) * stride;
+            if (reverse) {
+                SwapReversedRows<N>(top, bottom, width);
+            } else {
+                SwapRows<N>(top, bottom, width);
+            }
+        }
+    });
+}
+} // namespace
+
+bool PixelTransformKernels::IsSupportedPixelBytes(uint32_t pixelBytes)
+{
+    return pixelBytes == PIXEL_BYTES_1 || pixelBytes == PIXEL_BYTES_2 || pixelBytes == PIXEL_BYTES_3 ||
+        pixelBytes == PIXEL_BYTES_4 || pixelBytes == PIXEL_BYTES_8;
+}
+
+bool PixelTransformKernels::SwapsSize(PixelTransformOp op)
+{
+    return op == PixelTransformOp::ROTATE_90 || op == PixelTransformOp::ROTATE_270;
+}
+
+bool PixelTransformKernels::CanTransformInPlace(PixelTransformOp op, uint32_t width, uint32_t height)
+{
+    return !SwapsSize(op) || width == height;
+}
+
+bool PixelTransformKernels::Transform(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+    uint32_t width, uint32_t height, uint32_t pixelBytes, PixelTransformOp op)
+{
+    uint32_t dstWidth = SwapsSize(op) ? height : width;
+    if (src == nullptr || dst == nullptr || width == 0 || height == 0 || !IsSupportedPixelBytes(pixelBytes) ||
+        srcStride < static_cast<size_t>(width) * pixelBytes || dstStride < static_cast<size_t>(dstWidth) * pixelBytes) {
+        return false;
+    }
+    switch (pixelBytes) {
+        case PIXEL_BYTES_1:
+            TransformPixels<PIXEL_BYTES_1>(src, srcStride, dst, dstStride, width, height, op);
+            break;
+        case PIXEL_BYTES_2:
+            TransformPixels<PIXEL_BYTES_2>(src, srcStride, dst, dstStride, width, height, op);
+            break;
+        case PIXEL_BYTES_3:
+            TransformPixels<PIXEL_BYTES_3>(src, srcStride, dst, dstStride, width, height, op);
+            break;
+        case PIXEL_BYTES_4:
+            TransformPixels<PIXEL_BYTES_4>(src, srcStride, dst, dstStride, width, height, op);
+            break;
+        default:
+            TransformPixels<PIXEL_BYTES_8>(src, srcStride, dst, dstStride, width, height, op);
+            break;
+    }
+    return true;
+}
+
+bool PixelTransformKernels::TransformInPlace(uint8_t *pixels, size_t stride, uint32_t width, uint32_t height,
+    uint32_t pixelBytes, PixelTransformOp op)
+{
+    if (pixels == nullptr || width == 0 || height == 0 || !IsSupportedPixelBytes(pixelBytes) ||
+        stride < static_cast<size_t>(width) * pixelBytes || !CanTransformInPlace(op, width, height)) {
+        return false;
+    }
+    switch (pixelBytes) {
+        case PIXEL_BYTES_1:
+            TransformPixelsInPlace<PIXEL_BYTES_1>(pixels, stride, width, height, op);
+            break;
+        case PIXEL_BYTES_2:
+            TransformPixelsInPlace<PIXEL_BYTES_2>(pixels, stride, width, height, op);
+            break;
+        case PIXEL_BYTES_3:
+            TransformPixelsInPlace<PIXEL_BYTES_3>(pixels, stride, width, height, op);
+            break;
+        case PIXEL_BYTES_4:
+            TransformPixelsInPlace<PIXEL_BYTES_4>(pixels, stride, width, height, op);
+            break;
+        default:
+            TransformPixelsInPlace<PIXEL_BYTES_8>(pixels, stride, width, height, op);
+            break;
+    }
+    return true;
+}
+} // namespace Media
+} // namespace OHOS
@@ -440,7 +440,7 @@ uint32_t PixelYuv::WritePixels(const uint8_t *source, const uint64_t &bufferSize
         IMAGE_LOGE("write pixel by rect current PixelYuv image info is invalid.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("write pixel by rect current pixel map data is null.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
@@ -540,7 +540,7 @@ uint32_t PixelYuv::ReadPixel(const Position &pos, uint32_t &dst)
 
 bool PixelYuv::WritePixels(const uint32_t &color)
 {
-    if (!IsYuvFormat() || data_ == nullptr) {
+    if (!IsYuvFormat() || data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("erase pixels by color current pixel map data is null.");
         return false;
     }
@@ -554,7 +554,7 @@ uint32_t PixelYuv::WritePixel(const Position &pos, const uint32_t &color)
         IMAGE_LOGE("write pixel by pos but input position is invalid. [x(%{public}d), y(%{public}d)]", pos.x, pos.y);
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    if (data_ == nullptr) {
+    if (data_ == nullptr || PrepareWritablePixels() != SUCCESS) {
         IMAGE_LOGE("write pixel by pos but current pixelmap data is nullptr.");
         return ERR_IMAGE_WRITE_PIXELMAP_FAILED;
     }
@@ -777,7 +777,6 @@ uint32_t PixelYuv::ApplyColorSpace(const OHOS::ColorManager::ColorSpace &grColor
         SurfaceBuffer *sbBuffer = reinterpret_cast<SurfaceBuffer *>(GetFd());
         rowStride = static_cast<uint64_t>(sbBuffer->GetStride());
     }
-    srcData = static_cast<uint8_t *>(GetWritablePixels());
 #endif
 
     YUVDataInfo yuvDataInfo;
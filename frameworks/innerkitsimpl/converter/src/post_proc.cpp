@@ -763,7 +763,7 @@ bool PostProc::ScalePixelMapEx(const Size &desiredSize, PixelMap &pixelMap, cons
     pixelMap.GetImageInfo(imgInfo);
     int32_t srcWidth = pixelMap.GetWidth();
     int32_t srcHeight = pixelMap.GetHeight();
-    if (srcWidth <= 0 || srcHeight <= 0 || !pixelMap.GetWritablePixels()) {
+    if (srcWidth <= 0 || srcHeight <= 0 || pixelMap.GetPixels() == nullptr) {
         IMAGE_LOGE("pixelMap param is invalid, src width:%{public}d, height:%{public}d", srcWidth, srcHeight);
         return false;
     }
@@ -811,7 +811,7 @@ bool PostProc::ScalePixelMapEx(const Size &desiredSize, PixelMap &pixelMap, cons
         }
         inBuf = malloc(byteCount);
         srcPixels[0] = reinterpret_cast<uint8_t*>(inBuf);
-        errno_t errRet = memcpy_s(inBuf, byteCount, pixelMap.GetWritablePixels(), byteCount);
+        errno_t errRet = memcpy_s(inBuf, byteCount, pixelMap.GetPixels(), byteCount);
         if (errRet != EOK) {
             if (inBuf != nullptr) {
                 free(inBuf);
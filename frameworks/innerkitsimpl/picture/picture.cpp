@@ -328,7 +328,12 @@ std::unique_ptr<PixelMap> Picture::GetHdrComposedPixelMap()
         IMAGE_LOGE("Unsupport HDR compose.");
         return nullptr;
     }
-    std::shared_ptr<PixelMap> gainmap = Picture::GetAuxiliaryPicture(AuxiliaryPictureType::GAINMAP)->GetContentPixel();
+    std::shared_ptr<AuxiliaryPicture> gainmapPicture = Picture::GetAuxiliaryPicture(AuxiliaryPictureType::GAINMAP);
+    std::shared_ptr<PixelMap> gainmap = gainmapPicture == nullptr ? nullptr : gainmapPicture->GetContentPixel();
+    if (gainmap == nullptr) {
+        IMAGE_LOGE("Gain map decode failed, unsupport HDR compose.");
+        return nullptr;
+    }
     ImageHdrType hdrType = gainmap->GetHdrType();
     std::shared_ptr<HdrMetadata> metadata = gainmap->GetHdrMetadata();
 
@@ -353,13 +358,19 @@ std::shared_ptr<PixelMap> Picture::GetGainmapPixelMap()
     if (!HasAuxiliaryPicture(AuxiliaryPictureType::GAINMAP)) {
         IMAGE_LOGE("Unsupport gain map.");
         return nullptr;
-    } else {
-        return GetAuxiliaryPicture(AuxiliaryPictureType::GAINMAP)->GetContentPixel();
     }
+    std::shared_ptr<AuxiliaryPicture> gainmapPicture = GetAuxiliaryPicture(AuxiliaryPictureType::GAINMAP);
+    if (gainmapPicture == nullptr) {
+        IMAGE_LOGE("Gain map decode failed.");
+        return nullptr;
+    }
+    return gainmapPicture->GetContentPixel();
 }
 
 std::shared_ptr<AuxiliaryPicture> Picture::GetAuxiliaryPicture(AuxiliaryPictureType type)
 {
+    std::lock_guard<std::recursive_mutex> lock(auxiliaryMutex_);
+    LoadAuxiliaryPicture(type);
     auto iter = auxiliaryPictures_.find(type);
     if (iter == auxiliaryPictures_.end()) {
         return nullptr;
@@ -369,17 +380,66 @@ std::shared_ptr<AuxiliaryPicture> Picture::GetAuxiliaryPicture(AuxiliaryPictureT
 
 void Picture::SetAuxiliaryPicture(std::shared_ptr<AuxiliaryPicture> &picture)
 {
+    std::lock_guard<std::recursive_mutex> lock(auxiliaryMutex_);
+    if (picture != nullptr) {
+        auxiliaryLoaders_.erase(picture->GetType());
+    }
+    AddAuxiliaryPicture(picture);
+}
+
+bool Picture::HasAuxiliaryPicture(AuxiliaryPictureType type)
+{
+    std::lock_guard<std::recursive_mutex> lock(auxiliaryMutex_);
+    return auxiliaryPictures_.find(type) != auxiliaryPictures_.end() ||
+        auxiliaryLoaders_.find(type) != auxiliaryLoaders_.end();
+}
+
+void Picture::SetAuxiliaryPictureLoader(AuxiliaryPictureType type, AuxiliaryPictureLoader loader)
+{
+    if (loader == nullptr) {
+        IMAGE_LOGE("%{public}s loader is nullptr, type: %{public}d", __func__, type);
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(auxiliaryMutex_);
+    auxiliaryPictures_.erase(type);
+    auxiliaryLoaders_[type] = std::move(loader);
+}
+
+void Picture::AddAuxiliaryPicture(const std::shared_ptr<AuxiliaryPicture> &picture) const
+{
+    if (picture == nullptr) {
+        IMAGE_LOGE("%{public}s auxiliary picture is nullptr", __func__);
+        return;
+    }
     auxiliaryPictures_[picture->GetType()] = picture;
-    if (picture != nullptr && picture->GetType() == AuxiliaryPictureType::GAINMAP) {
-        std::shared_ptr<PixelMap> gainmapPixel = GetGainmapPixelMap();
+    if (picture->GetType() == AuxiliaryPictureType::GAINMAP) {
+        std::shared_ptr<PixelMap> gainmapPixel = picture->GetContentPixel();
         mainPixelMap_->SetHdrMetadata(gainmapPixel->GetHdrMetadata());
         mainPixelMap_->SetHdrType(gainmapPixel->GetHdrType());
     }
 }
 
-bool Picture::HasAuxiliaryPicture(AuxiliaryPictureType type)
+void Picture::LoadAuxiliaryPicture(AuxiliaryPictureType type) const
+{
+    auto iter = auxiliaryLoaders_.find(type);
+    if (iter == auxiliaryLoaders_.end()) {
+        return;
+    }
+    AuxiliaryPictureLoader loader = std::move(iter->second);
+    auxiliaryLoaders_.erase(iter);
+    std::shared_ptr<AuxiliaryPicture> auxPicture = loader();
+    if (auxPicture == nullptr) {
+        IMAGE_LOGE("Deferred decode of auxiliary picture failed! Type: %{public}d", type);
+        return;
+    }
+    AddAuxiliaryPicture(auxPicture);
+}
+
+void Picture::LoadAllAuxiliaryPictures() const
 {
-    return auxiliaryPictures_.find(type) != auxiliaryPictures_.end();
+    while (!auxiliaryLoaders_.empty()) {
+        LoadAuxiliaryPicture(auxiliaryLoaders_.begin()->first);
+    }
 }
 
 bool Picture::Marshalling(Parcel &data) const
@@ -393,6 +453,8 @@ bool Picture::Marshalling(Parcel &data) const
         return false;
     }
 
+    std::lock_guard<std::recursive_mutex> lock(auxiliaryMutex_);
+    LoadAllAuxiliaryPictures();
     size_t numAuxiliaryPictures = auxiliaryPictures_.size();
     if (!data.WriteUint64(numAuxiliaryPictures)) {
         IMAGE_LOGE("Failed to write number of auxiliary pictures.");
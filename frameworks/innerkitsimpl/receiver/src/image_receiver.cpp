@@ -88,13 +88,62 @@ std::unique_ptr<PixelMap> ImageReceiver::getSurfacePixelMap(InitializationOption
     return PixelMap::Create(addr, (uint32_t)size, initializationOpts);
 }
 
-static int32_t SaveSTP(uint32_t *buffer,
-                       uint32_t bufferSize,
-                       int &fd,
-                       InitializationOptions initializationOpts)
+static PixelFormat GetBorrowablePixelFormat(GraphicPixelFormat format)
+{
+    switch (format) {
+        case GraphicPixelFormat::GRAPHIC_PIXEL_FMT_RGBA_8888:
+            return PixelFormat::RGBA_8888;
+        case GraphicPixelFormat::GRAPHIC_PIXEL_FMT_BGRA_8888:
+            return PixelFormat::BGRA_8888;
+        default:
+            return PixelFormat::UNKNOWN;
+    }
+}
+
+// Wrap the surface buffer in a PixelMap that references its memory instead of copying it. This is only done when
+// PixelMap::Create would produce exactly the pixels the buffer already holds, otherwise nullptr is returned.
+static std::unique_ptr<PixelMap> CreateBorrowedPixelMap(OHOS::sptr<OHOS::SurfaceBuffer> &buffer,
+    const InitializationOptions &opts)
+{
+    PixelFormat srcFormat = opts.srcPixelFormat == PixelFormat::UNKNOWN ? PixelFormat::BGRA_8888 : opts.srcPixelFormat;
+    PixelFormat dstFormat = opts.pixelFormat == PixelFormat::UNKNOWN ? PixelFormat::RGBA_8888 : opts.pixelFormat;
+    // PixelMap::Create premultiplies for PREMUL and for the default UNKNOWN alpha type, only straight alpha
+    // can be used as it is
+    bool straightAlpha = opts.alphaType == AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL ||
+        opts.alphaType == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    if (srcFormat != dstFormat || GetBorrowablePixelFormat(static_cast<GraphicPixelFormat>(buffer->GetFormat())) !=
+        srcFormat || !straightAlpha || buffer->GetVirAddr() == nullptr ||
+        opts.size.width != buffer->GetWidth() || opts.size.height != buffer->GetHeight()) {
+        return nullptr;
+    }
+    int64_t rowBytes = static_cast<int64_t>(opts.size.width) * ImageUtils::GetPixelBytes(dstFormat);
+    int64_t stride = buffer->GetStride();
+    if (stride < rowBytes || (opts.srcRowStride != 0 && opts.srcRowStride != stride) ||
+        stride * opts.size.height > static_cast<int64_t>(buffer->GetSize())) {
+        return nullptr;
+    }
+
+    std::unique_ptr<PixelMap> pixelMap = std::make_unique<PixelMap>();
+    ImageInfo info;
+    info.size = opts.size;
+    info.pixelFormat = dstFormat;
+    info.alphaType = opts.alphaType;
+    if (pixelMap->SetImageInfo(info) != SUCCESS) {
+        IMAGE_LOGE("CreateBorrowedPixelMap set image info failed");
+        return nullptr;
+    }
+    void *nativeBuffer = buffer.GetRefPtr();
+    if (ImageUtils::SurfaceBuffer_Reference(nativeBuffer) != OHOS::GSERROR_OK) {
+        IMAGE_LOGE("CreateBorrowedPixelMap reference surface buffer failed");
+        return nullptr;
+    }
+    pixelMap->SetPixelsAddr(buffer->GetVirAddr(), nativeBuffer, buffer->GetSize(), AllocatorType::DMA_ALLOC, nullptr);
+    return pixelMap;
+}
+
+static int32_t SaveSTP(std::unique_ptr<PixelMap> pixelMap, int &fd)
 {
     int64_t errorCode = -1;
-    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(buffer, bufferSize, initializationOpts);
     if (pixelMap.get() != nullptr) {
         ImageInfo imageInfo;
         pixelMap->GetImageInfo(imageInfo);
@@ -103,7 +152,6 @@ static int32_t SaveSTP(uint32_t *buffer,
         IMAGE_LOGE("pixelMap.get() == nullptr");
         return ERR_MEDIA_INVALID_VALUE;
     }
-    ImagePacker imagePacker;
     errorCode = PackImage(fd, std::move(pixelMap));
     if (errorCode > 0) {
         errorCode = SUCCESS;
@@ -113,24 +161,37 @@ static int32_t SaveSTP(uint32_t *buffer,
     return errorCode;
 }
 
+static void ReleaseConsumerBuffer(std::shared_ptr<ImageReceiverContext> &iraContext,
+    OHOS::sptr<OHOS::SurfaceBuffer> &buffer)
+{
+    if ((iraContext->GetReceiverBufferConsumer()) != nullptr) {
+        (iraContext->GetReceiverBufferConsumer())->ReleaseBuffer(buffer, -1);
+    } else {
+        IMAGE_LOGD("iraContext_->GetReceiverBufferConsumer() == nullptr");
+    }
+}
+
 int32_t ImageReceiver::SaveBufferAsImage(int &fd,
                                          OHOS::sptr<OHOS::SurfaceBuffer> buffer,
                                          InitializationOptions initializationOpts)
 {
-    int32_t errorcode = 0;
-    if (buffer != nullptr) {
-        uint32_t *addr = reinterpret_cast<uint32_t *>(buffer->GetVirAddr());
-        int32_t size = buffer->GetSize();
-        errorcode = SaveSTP(addr, static_cast<uint32_t>(size), fd, initializationOpts);
-        if ((iraContext_->GetReceiverBufferConsumer()) != nullptr) {
-            (iraContext_->GetReceiverBufferConsumer())->ReleaseBuffer(buffer, -1);
-        } else {
-            IMAGE_LOGD("iraContext_->GetReceiverBufferConsumer() == nullptr");
-        }
-    } else {
+    if (buffer == nullptr) {
         IMAGE_LOGD("SaveBufferAsImage buffer == nullptr");
+        return 0;
+    }
+    // PackImage drops the borrowed PixelMap, and its buffer reference, as soon as encoding has finished
+    std::unique_ptr<PixelMap> pixelMap = CreateBorrowedPixelMap(buffer, initializationOpts);
+    if (pixelMap != nullptr) {
+        int32_t errorcode = SaveSTP(std::move(pixelMap), fd);
+        ReleaseConsumerBuffer(iraContext_, buffer);
+        return errorcode;
     }
-    return errorcode;
+    uint32_t *addr = reinterpret_cast<uint32_t *>(buffer->GetVirAddr());
+    int32_t size = buffer->GetSize();
+    pixelMap = PixelMap::Create(addr, static_cast<uint32_t>(size), initializationOpts);
+    // the pixels have been copied, the buffer can go back to the queue before encoding starts
+    ReleaseConsumerBuffer(iraContext_, buffer);
+    return SaveSTP(std::move(pixelMap), fd);
 }
 
 int32_t ImageReceiver::SaveBufferAsImage(int &fd,
@@ -45,6 +45,11 @@ public:
     uint32_t GetStreamType() override;
     ImagePlugin::OutputDataStream* ToOutputDataStream() override;
     int GetMMapFd();
+    // Copy length bytes from stream position offset to the current position of dstFd inside the kernel
+    // (copy_file_range, then sendfile). copied reports how much was written when it stops early.
+    bool CopyRangeTo(int dstFd, uint32_t offset, uint32_t length, uint32_t &copied);
+    // Device, inode, size and modification time of the backing file plus the stream window, for cache keys.
+    bool GetFileIdentity(std::string &identity);
 
 private:
     DISALLOW_COPY_AND_MOVE(FileSourceStream);
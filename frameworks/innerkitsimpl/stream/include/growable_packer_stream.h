@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_STREAM_INCLUDE_GROWABLE_PACKER_STREAM_H
+#define FRAMEWORKS_INNERKITSIMPL_STREAM_INCLUDE_GROWABLE_PACKER_STREAM_H
+
+#include <cstdlib>
+#include <memory>
+#include "nocopyable.h"
+#include "packer_stream.h"
+
+namespace OHOS {
+namespace Media {
+// Packer output held in a buffer of its own that grows on demand up to maxSize. Memory is never zeroed and only
+// as much as the encoder writes is allocated, so small outputs stay small even when maxSize is large.
+class GrowablePackerStream : public PackerStream {
+public:
+    struct BufferDeleter {
+        void operator()(uint8_t *data) const
+        {
+            free(data);
+        }
+    };
+    using Buffer = std::unique_ptr<uint8_t, BufferDeleter>;
+
+    explicit GrowablePackerStream(uint32_t maxSize);
+    ~GrowablePackerStream() = default;
+    bool Write(const uint8_t *buffer, uint32_t size) override;
+    int64_t BytesWritten() override;
+    bool GetCapicity(size_t &size) override;
+    // Valid until the next Write, which may move the buffer.
+    uint8_t* GetAddr() const override
+    {
+        return data_.get();
+    }
+    void SetOffset(uint32_t offset) override;
+    ImagePlugin::OutputStreamType GetType() override;
+    // Hand over the written bytes, trimmed to size and allocated with malloc. The stream is empty afterwards.
+    Buffer ReleaseBuffer(int64_t &size);
+
+private:
+    DISALLOW_COPY(GrowablePackerStream);
+    bool Reserve(uint64_t size);
+    Buffer data_;
+    uint32_t maxSize_ = 0;
+    uint32_t capacity_ = 0;
+    uint32_t offset_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_STREAM_INCLUDE_GROWABLE_PACKER_STREAM_H
@@ -26,6 +26,8 @@
 
 #if !defined(_WIN32) && !defined(_APPLE) &&!defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
 #include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
 #define SUPPORT_MMAP
 #endif
 
@@ -368,5 +370,65 @@ int FileSourceStream::GetMMapFd()
     mmapFdPassedOn_ = true;
     return mmapFd_;
 }
+
+bool FileSourceStream::CopyRangeTo(int dstFd, uint32_t offset, uint32_t length, uint32_t &copied)
+{
+    copied = 0;
+#ifdef SUPPORT_MMAP
+    if (dstFd < 0 || static_cast<size_t>(offset) + length > GetStreamSize()) {
+        return false;
+    }
+    int srcFd = fileno(filePtr_);
+    if (srcFd < 0) {
+        return false;
+    }
+    // Explicit source offsets leave the FILE position of this stream untouched.
+    off_t srcOffset = static_cast<off_t>(fileOriginalOffset_ + offset);
+    bool useCopyFileRange = true;
+    while (copied < length) {
+        size_t remaining = length - copied;
+        ssize_t ret = -1;
+        if (useCopyFileRange) {
+            loff_t inOffset = static_cast<loff_t>(srcOffset + copied);
+            ret = copy_file_range(srcFd, &inOffset, dstFd, nullptr, remaining, 0);
+            if (ret < 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP)) {
+                useCopyFileRange = false;
+                continue;
+            }
+        } else {
+            off_t inOffset = srcOffset + copied;
+            ret = sendfile(dstFd, srcFd, &inOffset, remaining);
+        }
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            IMAGE_LOGD("[FileSourceStream] CopyRangeTo stopped at %{public}u, errno:%{public}d", copied, errno);
+            return false;
+        }
+        copied += static_cast<uint32_t>(ret);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileSourceStream::GetFileIdentity(std::string &identity)
+{
+#ifdef SUPPORT_MMAP
+    struct stat st;
+    int fd = fileno(filePtr_);
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    identity = std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" + std::to_string(st.st_size) +
+        ":" + std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec) + ":" +
+        std::to_string(fileOriginalOffset_) + ":" + std::to_string(fileSize_);
+    return true;
+#else
+    return false;
+#endif
+}
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "growable_packer_stream.h"
+
+#include <algorithm>
+#include "image_log.h"
+#include "securec.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
+
+#undef LOG_TAG
+#define LOG_TAG "GrowablePackerStream"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t INITIAL_CAPACITY = 64 * 1024;
+constexpr uint32_t GROWTH_FACTOR = 2;
+}
+
+GrowablePackerStream::GrowablePackerStream(uint32_t maxSize) : maxSize_(maxSize)
+{}
+
+bool GrowablePackerStream::Reserve(uint64_t size)
+{
+    if (size <= capacity_) {
+        return true;
+    }
+    if (size > maxSize_) {
+        IMAGE_LOGE("write data:[%{public}llu] out of max size:[%{public}u].",
+            static_cast<unsigned long long>(size), maxSize_);
+        return false;
+    }
+    uint64_t grown = std::max<uint64_t>(static_cast<uint64_t>(capacity_) * GROWTH_FACTOR, INITIAL_CAPACITY);
+    uint32_t capacity = static_cast<uint32_t>(std::min<uint64_t>(std::max(grown, size), maxSize_));
+    uint8_t *data = static_cast<uint8_t *>(realloc(data_.get(), capacity));
+    if (data == nullptr) {
+        IMAGE_LOGE("grow output buffer to %{public}u failed.", capacity);
+        return false;
+    }
+    data_.release();
+    data_.reset(data);
+    capacity_ = capacity;
+    return true;
+}
+
+bool GrowablePackerStream::Write(const uint8_t *buffer, uint32_t size)
+{
+    if ((buffer == nullptr) || (size == 0)) {
+        IMAGE_LOGE("input parameter invalid.");
+        return false;
+    }
+    if (!Reserve(static_cast<uint64_t>(offset_) + size)) {
+        return false;
+    }
+    if (memcpy_s(data_.get() + offset_, capacity_ - offset_, buffer, size) != EOK) {
+        IMAGE_LOGE("memory copy failed.");
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+int64_t GrowablePackerStream::BytesWritten()
+{
+    return offset_;
+}
+
+bool GrowablePackerStream::GetCapicity(size_t &size)
+{
+    size = maxSize_;
+    return true;
+}
+
+void GrowablePackerStream::SetOffset(uint32_t offset)
+{
+    if (offset > capacity_) {
+        IMAGE_LOGE("offset %{public}u beyond written capacity %{public}u.", offset, capacity_);
+        return;
+    }
+    offset_ = offset;
+}
+
+ImagePlugin::OutputStreamType GrowablePackerStream::GetType()
+{
+    return ImagePlugin::OutputStreamType::BUFFER_PACKER;
+}
+
+GrowablePackerStream::Buffer GrowablePackerStream::ReleaseBuffer(int64_t &size)
+{
+    size = offset_;
+    if (offset_ > 0 && offset_ < capacity_) {
+        // shrinking normally happens in place, keep the larger block if it does not
+        uint8_t *data = static_cast<uint8_t *>(realloc(data_.get(), offset_));
+        if (data != nullptr) {
+            data_.release();
+            data_.reset(data);
+        }
+    }
+    capacity_ = 0;
+    offset_ = 0;
+    return std::move(data_);
+}
+} // namespace Media
+} // namespace OHOS
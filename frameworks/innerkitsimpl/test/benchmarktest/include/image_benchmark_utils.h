@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARKTEST_INCLUDE_IMAGE_BENCHMARK_UTILS_H
+#define FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARKTEST_INCLUDE_IMAGE_BENCHMARK_UTILS_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+class PixelMap;
+
+namespace BenchmarkUtils {
+// Checked-in images from test/resource/image/images, pushed here by ohos_test.xml.
+constexpr const char *IMAGE_CORPUS_DIR = "/data/local/tmp/image/";
+constexpr uint32_t DEFAULT_SEED = 0x5eed;
+
+// Registers the square edge lengths every size-dependent benchmark runs at: 256, 1024 and 2048.
+void ApplyImageSizes(benchmark::internal::Benchmark *bench);
+
+// ARGB_8888 colors for a width x height image. Gradients and hard edged blocks give the codecs and filters
+// realistic content, low amplitude noise keeps it from being trivially compressible. The same seed always
+// produces the same pixels.
+std::vector<uint32_t> MakeSyntheticColors(int32_t width, int32_t height, uint32_t seed = DEFAULT_SEED);
+
+// Pixel map in format holding colors. NV21, NV12 and the P010 formats are converted from RGBA_8888.
+std::shared_ptr<PixelMap> CreatePixelMapFromColors(const std::vector<uint32_t> &colors, int32_t width,
+    int32_t height, PixelFormat format = PixelFormat::RGBA_8888);
+std::shared_ptr<PixelMap> CreateSyntheticPixelMap(int32_t width, int32_t height,
+    PixelFormat format = PixelFormat::RGBA_8888, uint32_t seed = DEFAULT_SEED);
+
+bool ReadCorpusFile(const std::string &name, std::vector<uint8_t> &data);
+
+// Reports pixelsPerIteration as an "MP/s" rate counter.
+void SetPixelThroughput(benchmark::State &state, int64_t pixelsPerIteration);
+
+// Peak memory of a benchmark run. Construction resets the kernel high-water mark of the resident set,
+// Report publishes how far it rose above the resident size at that point as "peak_MiB". Reports 0 where
+// /proc/self/clear_refs is not writable.
+class PeakMemoryScope {
+public:
+    PeakMemoryScope();
+    void Report(benchmark::State &state) const;
+
+private:
+    int64_t baselineKb_ = -1;
+};
+} // namespace BenchmarkUtils
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARKTEST_INCLUDE_IMAGE_BENCHMARK_UTILS_H
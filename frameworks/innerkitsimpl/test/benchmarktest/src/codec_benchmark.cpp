@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "image_benchmark_utils.h"
+#include "image_packer.h"
+#include "image_source.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+// Encode and decode per codec. Synthetic inputs run at every size from ApplyImageSizes, corpus inputs at their
+// own size. HEIF needs the hardware codec and is left out so the suite runs the same everywhere.
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint8_t ENCODE_QUALITY = 90;
+constexpr size_t RGBA_BYTES = 4;
+// Headroom over the raw pixels for container overhead of incompressible input.
+constexpr size_t ENCODE_BUFFER_SLACK = 64 * 1024;
+
+size_t EncodeBufferSize(int32_t width, int32_t height)
+{
+    return static_cast<size_t>(width) * static_cast<size_t>(height) * RGBA_BYTES * 2 + ENCODE_BUFFER_SLACK;
+}
+
+uint32_t EncodeToBuffer(PixelMap &pixelMap, const std::string &format, std::vector<uint8_t> &buffer,
+    int64_t &packedSize)
+{
+    ImagePacker packer;
+    PackOption option;
+    option.format = format;
+    option.quality = ENCODE_QUALITY;
+    uint32_t ret = packer.StartPacking(buffer.data(), static_cast<uint32_t>(buffer.size()), option);
+    if (ret != SUCCESS) {
+        return ret;
+    }
+    ret = packer.AddImage(pixelMap);
+    if (ret != SUCCESS) {
+        return ret;
+    }
+    return packer.FinalizePacking(packedSize);
+}
+
+std::unique_ptr<PixelMap> DecodeBuffer(const std::vector<uint8_t> &data)
+{
+    SourceOptions sourceOpts;
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> source =
+        ImageSource::CreateImageSource(data.data(), static_cast<uint32_t>(data.size()), sourceOpts, errorCode);
+    if (source == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    return source->CreatePixelMap(decodeOpts, errorCode);
+}
+
+void BM_Encode(benchmark::State &state, const std::string &format)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    std::vector<uint8_t> buffer(EncodeBufferSize(size, size));
+    int64_t packedSize = 0;
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        if (EncodeToBuffer(*pixelMap, format, buffer, packedSize) != SUCCESS) {
+            state.SkipWithError("encode failed");
+            break;
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, static_cast<int64_t>(size) * size);
+    state.counters["encoded_bytes"] = benchmark::Counter(static_cast<double>(packedSize));
+    peak.Report(state);
+}
+
+void RunDecode(benchmark::State &state, const std::vector<uint8_t> &data)
+{
+    // The decoded image cache is opt-in, keep it off so every iteration really decodes.
+    ImageSource::SetDecodedImageCacheEnabled(false);
+    int64_t pixels = 0;
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        std::unique_ptr<PixelMap> pixelMap = DecodeBuffer(data);
+        if (pixelMap == nullptr) {
+            state.SkipWithError("decode failed");
+            break;
+        }
+        pixels = static_cast<int64_t>(pixelMap->GetWidth()) * pixelMap->GetHeight();
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, pixels);
+    state.counters["encoded_bytes"] = benchmark::Counter(static_cast<double>(data.size()));
+    peak.Report(state);
+}
+
+void BM_DecodeSynthetic(benchmark::State &state, const std::string &format)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    std::vector<uint8_t> data(EncodeBufferSize(size, size));
+    int64_t packedSize = 0;
+    if (EncodeToBuffer(*pixelMap, format, data, packedSize) != SUCCESS || packedSize <= 0) {
+        state.SkipWithError("encode input failed");
+        return;
+    }
+    data.resize(static_cast<size_t>(packedSize));
+    pixelMap.reset();
+    RunDecode(state, data);
+}
+
+void BM_DecodeCorpus(benchmark::State &state, const std::string &name)
+{
+    std::vector<uint8_t> data;
+    if (!BenchmarkUtils::ReadCorpusFile(name, data)) {
+        state.SkipWithError("corpus file missing");
+        return;
+    }
+    RunDecode(state, data);
+}
+
+// Repeated decodes of one source with the decoded image cache on, which is the cost of a cache hit.
+void BM_DecodeCachedHit(benchmark::State &state)
+{
+    std::vector<uint8_t> data;
+    if (!BenchmarkUtils::ReadCorpusFile("test.jpg", data)) {
+        state.SkipWithError("corpus file missing");
+        return;
+    }
+    SourceOptions sourceOpts;
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> source =
+        ImageSource::CreateImageSource(data.data(), static_cast<uint32_t>(data.size()), sourceOpts, errorCode);
+    if (source == nullptr) {
+        state.SkipWithError("create image source failed");
+        return;
+    }
+    ImageSource::SetDecodedImageCacheEnabled(true);
+    DecodeOptions decodeOpts;
+    int64_t pixels = 0;
+    for (auto _ : state) {
+        std::unique_ptr<PixelMap> pixelMap = source->CreatePixelMap(decodeOpts, errorCode);
+        if (pixelMap == nullptr) {
+            state.SkipWithError("decode failed");
+            break;
+        }
+        pixels = static_cast<int64_t>(pixelMap->GetWidth()) * pixelMap->GetHeight();
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    DecodedImageCacheStats stats = ImageSource::GetDecodedImageCacheStats();
+    ImageSource::SetDecodedImageCacheEnabled(false);
+    BenchmarkUtils::SetPixelThroughput(state, pixels);
+    state.counters["cache_hits"] = benchmark::Counter(static_cast<double>(stats.hits));
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Encode, jpeg, std::string("image/jpeg"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Encode, png, std::string("image/png"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Encode, webp, std::string("image/webp"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_DecodeSynthetic, jpeg, std::string("image/jpeg"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeSynthetic, png, std::string("image/png"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeSynthetic, webp, std::string("image/webp"))
+    ->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_DecodeCorpus, jpeg, std::string("test.jpg"))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeCorpus, png, std::string("test.png"))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeCorpus, webp, std::string("test_large.webp"))
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeCorpus, gif, std::string("test.gif"))->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeCorpus, bmp, std::string("test.bmp"))->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(BM_DecodeCachedHit)->Unit(benchmark::kMicrosecond)->UseRealTime();
+} // namespace Media
+} // namespace OHOS
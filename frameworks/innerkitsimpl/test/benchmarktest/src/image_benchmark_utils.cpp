@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark_utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include "image_format_convert.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Media {
+namespace BenchmarkUtils {
+namespace {
+constexpr int64_t IMAGE_SIZE_SMALL = 256;
+constexpr int64_t IMAGE_SIZE_MEDIUM = 1024;
+constexpr int64_t IMAGE_SIZE_LARGE = 2048;
+constexpr int32_t BLOCK_SHIFT = 5;
+constexpr uint32_t BLOCK_LIGHT = 200;
+constexpr uint32_t BLOCK_DARK = 40;
+constexpr uint32_t CHANNEL_MAX = 255;
+constexpr uint32_t NOISE_SHIFT = 28;
+constexpr int32_t NOISE_BIAS = 8;
+constexpr uint32_t LCG_MULTIPLIER = 1664525u;
+constexpr uint32_t LCG_INCREMENT = 1013904223u;
+constexpr uint32_t SHIFT_8 = 8;
+constexpr uint32_t SHIFT_16 = 16;
+constexpr uint32_t SHIFT_24 = 24;
+constexpr double PIXELS_PER_MEGAPIXEL = 1e6;
+constexpr double KB_PER_MIB = 1024.0;
+constexpr const char *PROC_CLEAR_REFS = "/proc/self/clear_refs";
+constexpr const char *PROC_STATUS = "/proc/self/status";
+// Writing 5 to clear_refs resets VmHWM to the current VmRSS.
+constexpr const char *RESET_PEAK_RSS = "5";
+
+uint32_t AddNoise(uint32_t channel, int32_t noise)
+{
+    int32_t value = static_cast<int32_t>(channel) + noise;
+    return static_cast<uint32_t>(std::clamp(value, 0, static_cast<int32_t>(CHANNEL_MAX)));
+}
+
+bool IsYuvFormat(PixelFormat format)
+{
+    return format == PixelFormat::NV21 || format == PixelFormat::NV12 ||
+        format == PixelFormat::YCBCR_P010 || format == PixelFormat::YCRCB_P010;
+}
+
+int64_t ReadStatusKb(const std::string &field)
+{
+    std::ifstream status(PROC_STATUS);
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0) {
+            return std::stoll(line.substr(field.size()));
+        }
+    }
+    return -1;
+}
+} // namespace
+
+void ApplyImageSizes(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgName("size")->Arg(IMAGE_SIZE_SMALL)->Arg(IMAGE_SIZE_MEDIUM)->Arg(IMAGE_SIZE_LARGE);
+}
+
+std::vector<uint32_t> MakeSyntheticColors(int32_t width, int32_t height, uint32_t seed)
+{
+    if (width <= 0 || height <= 0) {
+        return {};
+    }
+    std::vector<uint32_t> colors(static_cast<size_t>(width) * static_cast<size_t>(height));
+    uint32_t state = seed;
+    uint32_t xSpan = static_cast<uint32_t>(std::max(width - 1, 1));
+    uint32_t ySpan = static_cast<uint32_t>(std::max(height - 1, 1));
+    for (int32_t y = 0; y < height; y++) {
+        for (int32_t x = 0; x < width; x++) {
+            state = state * LCG_MULTIPLIER + LCG_INCREMENT;
+            int32_t noise = static_cast<int32_t>(state >> NOISE_SHIFT) - NOISE_BIAS;
+            uint32_t red = AddNoise(static_cast<uint32_t>(x) * CHANNEL_MAX / xSpan, noise);
+            uint32_t green = AddNoise(static_cast<uint32_t>(y) * CHANNEL_MAX / ySpan, noise);
+            bool light = (((x >> BLOCK_SHIFT) ^ (y >> BLOCK_SHIFT)) & 1) != 0;
+            uint32_t blue = AddNoise(light ? BLOCK_LIGHT : BLOCK_DARK, noise);
+            colors[static_cast<size_t>(y) * width + x] =
+                (CHANNEL_MAX << SHIFT_24) | (red << SHIFT_16) | (green << SHIFT_8) | blue;
+        }
+    }
+    return colors;
+}
+
+std::shared_ptr<PixelMap> CreatePixelMapFromColors(const std::vector<uint32_t> &colors, int32_t width,
+    int32_t height, PixelFormat format)
+{
+    if (width <= 0 || height <= 0 || colors.size() != static_cast<size_t>(width) * static_cast<size_t>(height)) {
+        return nullptr;
+    }
+    InitializationOptions opts;
+    opts.size = {width, height};
+    opts.srcPixelFormat = PixelFormat::BGRA_8888;
+    opts.pixelFormat = IsYuvFormat(format) ? PixelFormat::RGBA_8888 : format;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    opts.editable = true;
+    std::shared_ptr<PixelMap> pixelMap = PixelMap::Create(colors.data(), static_cast<uint32_t>(colors.size()), opts);
+    if (pixelMap == nullptr || !IsYuvFormat(format)) {
+        return pixelMap;
+    }
+    if (ImageFormatConvert::ConvertImageFormat(pixelMap, format) != SUCCESS) {
+        return nullptr;
+    }
+    return pixelMap;
+}
+
+std::shared_ptr<PixelMap> CreateSyntheticPixelMap(int32_t width, int32_t height, PixelFormat format, uint32_t seed)
+{
+    return CreatePixelMapFromColors(MakeSyntheticColors(width, height, seed), width, height, format);
+}
+
+bool ReadCorpusFile(const std::string &name, std::vector<uint8_t> &data)
+{
+    std::ifstream file(std::string(IMAGE_CORPUS_DIR) + name, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !data.empty();
+}
+
+void SetPixelThroughput(benchmark::State &state, int64_t pixelsPerIteration)
+{
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(pixelsPerIteration) / PIXELS_PER_MEGAPIXEL,
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+PeakMemoryScope::PeakMemoryScope()
+{
+    std::ofstream clearRefs(PROC_CLEAR_REFS);
+    if (!clearRefs || !(clearRefs << RESET_PEAK_RSS)) {
+        return;
+    }
+    clearRefs.close();
+    baselineKb_ = ReadStatusKb("VmRSS:");
+}
+
+void PeakMemoryScope::Report(benchmark::State &state) const
+{
+    int64_t peakKb = ReadStatusKb("VmHWM:");
+    double peakMiB = 0.0;
+    if (baselineKb_ >= 0 && peakKb > baselineKb_) {
+        peakMiB = static_cast<double>(peakKb - baselineKb_) / KB_PER_MIB;
+    }
+    state.counters["peak_MiB"] = benchmark::Counter(peakMiB);
+}
+} // namespace BenchmarkUtils
+} // namespace Media
+} // namespace OHOS
+
+// Results for comparison across commits: --benchmark_out=<file> --benchmark_out_format=json
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "exif_metadata.h"
+#include "image_benchmark_utils.h"
+#include "image_source.h"
+#include "media_errors.h"
+#include "parcel.h"
+
+// Exif read, write and marshalling on the checked-in test_exif.jpg.
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr const char *EXIF_CORPUS = "test_exif.jpg";
+constexpr const char *EXIF_SCRATCH_NAME = "benchmark_exif_copy.jpg";
+const std::vector<std::string> EXIF_READ_KEYS = {
+    "Orientation", "DateTimeOriginal", "ExposureTime", "FNumber", "ISOSpeedRatings", "GPSLatitude", "GPSLongitude",
+};
+const std::string EXIF_WRITE_KEY = "Orientation";
+const std::vector<std::string> EXIF_WRITE_VALUES = {"1", "3"};
+
+std::unique_ptr<ImageSource> CreateSource(const std::vector<uint8_t> &data)
+{
+    SourceOptions opts;
+    uint32_t errorCode = 0;
+    return ImageSource::CreateImageSource(data.data(), static_cast<uint32_t>(data.size()), opts, errorCode);
+}
+
+void BM_ExifRead(benchmark::State &state)
+{
+    std::vector<uint8_t> data;
+    if (!BenchmarkUtils::ReadCorpusFile(EXIF_CORPUS, data)) {
+        state.SkipWithError("corpus file missing");
+        return;
+    }
+    for (auto _ : state) {
+        std::unique_ptr<ImageSource> source = CreateSource(data);
+        if (source == nullptr) {
+            state.SkipWithError("create image source failed");
+            break;
+        }
+        for (const std::string &key : EXIF_READ_KEYS) {
+            std::string value;
+            source->GetImagePropertyString(0, key, value);
+            benchmark::DoNotOptimize(value.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(EXIF_READ_KEYS.size()));
+}
+
+// Parse, modify and write back to a file, which is what editing apps pay per property change.
+void BM_ExifWriteFile(benchmark::State &state)
+{
+    std::vector<uint8_t> data;
+    if (!BenchmarkUtils::ReadCorpusFile(EXIF_CORPUS, data)) {
+        state.SkipWithError("corpus file missing");
+        return;
+    }
+    std::string path = std::string(BenchmarkUtils::IMAGE_CORPUS_DIR) + EXIF_SCRATCH_NAME;
+    {
+        std::ofstream scratch(path, std::ios::binary | std::ios::trunc);
+        if (!scratch.write(reinterpret_cast<const char *>(data.data()), data.size())) {
+            state.SkipWithError("write scratch copy failed");
+            return;
+        }
+    }
+    size_t round = 0;
+    for (auto _ : state) {
+        SourceOptions opts;
+        uint32_t errorCode = 0;
+        std::unique_ptr<ImageSource> source = ImageSource::CreateImageSource(path, opts, errorCode);
+        const std::string &value = EXIF_WRITE_VALUES[round++ % EXIF_WRITE_VALUES.size()];
+        if (source == nullptr || source->ModifyImageProperty(0, EXIF_WRITE_KEY, value, path) != SUCCESS) {
+            state.SkipWithError("ModifyImageProperty failed");
+            break;
+        }
+    }
+    std::remove(path.c_str());
+}
+
+void BM_ExifMarshalling(benchmark::State &state)
+{
+    std::vector<uint8_t> data;
+    if (!BenchmarkUtils::ReadCorpusFile(EXIF_CORPUS, data)) {
+        state.SkipWithError("corpus file missing");
+        return;
+    }
+    std::unique_ptr<ImageSource> source = CreateSource(data);
+    std::shared_ptr<ExifMetadata> exifMetadata = source == nullptr ? nullptr : source->GetExifMetadata();
+    if (exifMetadata == nullptr) {
+        state.SkipWithError("read exif failed");
+        return;
+    }
+    size_t parcelBytes = 0;
+    for (auto _ : state) {
+        Parcel parcel;
+        if (!exifMetadata->Marshalling(parcel)) {
+            state.SkipWithError("Marshalling failed");
+            break;
+        }
+        parcelBytes = parcel.GetDataSize();
+        std::unique_ptr<ExifMetadata> result(ExifMetadata::Unmarshalling(parcel));
+        if (result == nullptr) {
+            state.SkipWithError("Unmarshalling failed");
+            break;
+        }
+        benchmark::DoNotOptimize(result.get());
+    }
+    state.counters["parcel_bytes"] = benchmark::Counter(static_cast<double>(parcelBytes));
+}
+} // namespace
+
+BENCHMARK(BM_ExifRead)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_ExifWriteFile)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_ExifMarshalling)->Unit(benchmark::kMicrosecond)->UseRealTime();
+} // namespace Media
+} // namespace OHOS
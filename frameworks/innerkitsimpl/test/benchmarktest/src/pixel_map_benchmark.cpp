@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "image_benchmark_utils.h"
+#include "image_format_convert.h"
+#include "media_errors.h"
+#include "parcel.h"
+#include "pixel_convert.h"
+#include "pixel_map.h"
+#include "pixel_yuv_utils.h"
+
+// Format conversions, transforms and serialization of pixel maps. Operations that change their input in a way
+// that alters the next iteration's work (scale, crop, format conversion) get a fresh copy with the timer paused.
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr size_t RGBA_BYTES = 4;
+constexpr uint32_t YUV420_NUMERATOR = 3;
+constexpr uint32_t YUV420_DENOMINATOR = 2;
+constexpr float HALF_SCALE = 0.5f;
+constexpr float DOUBLE_SCALE = 2.0f;
+constexpr int32_t CROP_DIVISOR = 4;
+constexpr float ROTATE_90 = 90.0f;
+constexpr float ROTATE_180 = 180.0f;
+constexpr float ROTATE_ODD_ANGLE = 30.0f;
+constexpr size_t PARCEL_MAX_CAPACITY = 256 * 1024 * 1024;
+
+int64_t PixelCount(int32_t size)
+{
+    return static_cast<int64_t>(size) * size;
+}
+
+// Source pixels kept as colors so every reset only pays for the copy into a new pixel map.
+class ResettableInput {
+public:
+    ResettableInput(int32_t size, PixelFormat format)
+        : size_(size), format_(format), colors_(BenchmarkUtils::MakeSyntheticColors(size, size))
+    {
+    }
+
+    std::shared_ptr<PixelMap> Create() const
+    {
+        return BenchmarkUtils::CreatePixelMapFromColors(colors_, size_, size_, format_);
+    }
+
+    std::shared_ptr<PixelMap> Reset(benchmark::State &state) const
+    {
+        state.PauseTiming();
+        std::shared_ptr<PixelMap> pixelMap = Create();
+        state.ResumeTiming();
+        return pixelMap;
+    }
+
+private:
+    int32_t size_;
+    PixelFormat format_;
+    std::vector<uint32_t> colors_;
+};
+
+void BM_PixelConvert(benchmark::State &state, PixelFormat dstFormat)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::vector<uint32_t> colors = BenchmarkUtils::MakeSyntheticColors(size, size);
+    ImageInfo srcInfo;
+    srcInfo.size = {size, size};
+    srcInfo.pixelFormat = PixelFormat::BGRA_8888;
+    srcInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    ImageInfo dstInfo = srcInfo;
+    dstInfo.pixelFormat = dstFormat;
+    std::unique_ptr<PixelConvert> converter = PixelConvert::Create(srcInfo, dstInfo);
+    if (converter == nullptr) {
+        state.SkipWithError("unsupported conversion");
+        return;
+    }
+    std::vector<uint8_t> dst(colors.size() * RGBA_BYTES);
+    for (auto _ : state) {
+        converter->Convert(dst.data(), reinterpret_cast<const uint8_t *>(colors.data()),
+            static_cast<uint32_t>(colors.size()));
+        benchmark::DoNotOptimize(dst.data());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+}
+
+void BM_ImageFormatConvert(benchmark::State &state, PixelFormat srcFormat, PixelFormat dstFormat)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    ResettableInput input(size, srcFormat);
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        std::shared_ptr<PixelMap> pixelMap = input.Reset(state);
+        if (pixelMap == nullptr || ImageFormatConvert::ConvertImageFormat(pixelMap, dstFormat) != SUCCESS) {
+            state.SkipWithError("format conversion failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+    peak.Report(state);
+}
+
+// The ffmpeg backed BGRA <-> NV21 conversion PixelYuv uses for color space changes.
+void BM_YuvUtilsConvert(benchmark::State &state, bool toYuv)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    uint32_t pixels = static_cast<uint32_t>(PixelCount(size));
+    std::vector<uint32_t> colors = BenchmarkUtils::MakeSyntheticColors(size, size);
+    std::vector<uint8_t> yuv(pixels * YUV420_NUMERATOR / YUV420_DENOMINATOR);
+    std::vector<uint8_t> bgra(static_cast<size_t>(pixels) * RGBA_BYTES);
+    YUVDataInfo yuvDataInfo;
+    yuvDataInfo.imageSize = {size, size};
+    yuvDataInfo.yWidth = static_cast<uint32_t>(size);
+    yuvDataInfo.yHeight = static_cast<uint32_t>(size);
+    yuvDataInfo.yStride = static_cast<uint32_t>(size);
+    yuvDataInfo.uvStride = static_cast<uint32_t>(size);
+    yuvDataInfo.uvOffset = pixels;
+    YuvImageInfo bgraInfo = {PixelYuvUtils::ConvertFormat(PixelFormat::BGRA_8888), size, size,
+        PixelFormat::BGRA_8888, yuvDataInfo};
+    YuvImageInfo yuvInfo = {PixelYuvUtils::ConvertFormat(PixelFormat::NV21), size, size,
+        PixelFormat::NV21, yuvDataInfo};
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(colors.data());
+    if (!PixelYuvUtils::BGRAToYuv420(src, bgraInfo, yuv.data(), yuvInfo)) {
+        state.SkipWithError("BGRAToYuv420 failed");
+        return;
+    }
+    for (auto _ : state) {
+        bool ret = toYuv ? PixelYuvUtils::BGRAToYuv420(src, bgraInfo, yuv.data(), yuvInfo) :
+            PixelYuvUtils::Yuv420ToBGRA(yuv.data(), yuvInfo, bgra.data(), bgraInfo);
+        if (!ret) {
+            state.SkipWithError("yuv conversion failed");
+            break;
+        }
+        benchmark::DoNotOptimize(toYuv ? yuv.data() : bgra.data());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+}
+
+// Quarter turns and flips leave the work of the next iteration unchanged, so they run on one pixel map.
+void BM_Rotate(benchmark::State &state, PixelFormat format, float degrees)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size, format);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        pixelMap->rotate(degrees);
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+    peak.Report(state);
+}
+
+void BM_Flip(benchmark::State &state, PixelFormat format)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size, format);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    for (auto _ : state) {
+        pixelMap->flip(true, false);
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+}
+
+void BM_Scale(benchmark::State &state, PixelFormat format, float factor, AntiAliasingOption option)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    ResettableInput input(size, format);
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        std::shared_ptr<PixelMap> pixelMap = input.Reset(state);
+        if (pixelMap == nullptr) {
+            state.SkipWithError("create synthetic pixel map failed");
+            break;
+        }
+        pixelMap->scale(factor, factor, option);
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    // Throughput counts the larger of source and destination, which is what the resampler walks.
+    int64_t dstPixels = static_cast<int64_t>(PixelCount(size) * factor * factor);
+    BenchmarkUtils::SetPixelThroughput(state, std::max(PixelCount(size), dstPixels));
+    peak.Report(state);
+}
+
+void BM_Crop(benchmark::State &state, PixelFormat format)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    ResettableInput input(size, format);
+    int32_t margin = size / CROP_DIVISOR;
+    Rect rect = {margin, margin, size - margin * 2, size - margin * 2};
+    for (auto _ : state) {
+        std::shared_ptr<PixelMap> pixelMap = input.Reset(state);
+        if (pixelMap == nullptr || pixelMap->crop(rect) != SUCCESS) {
+            state.SkipWithError("crop failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, static_cast<int64_t>(rect.width) * rect.height);
+}
+
+// Crop, scale and an off-axis rotation as one resample, against the same edits made one by one.
+void BM_TransformChain(benchmark::State &state, bool fused)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    ResettableInput input(size, PixelFormat::RGBA_8888);
+    int32_t margin = size / CROP_DIVISOR;
+    Rect rect = {margin, margin, size - margin * 2, size - margin * 2};
+    PixelMapTransform transform;
+    transform.Crop(rect).Scale(DOUBLE_SCALE, DOUBLE_SCALE).Rotate(ROTATE_ODD_ANGLE)
+        .SetAntiAliasing(AntiAliasingOption::LOW);
+    BenchmarkUtils::PeakMemoryScope peak;
+    for (auto _ : state) {
+        std::shared_ptr<PixelMap> pixelMap = input.Reset(state);
+        if (pixelMap == nullptr) {
+            state.SkipWithError("create synthetic pixel map failed");
+            break;
+        }
+        if (fused) {
+            if (pixelMap->ApplyTransform(transform) != SUCCESS) {
+                state.SkipWithError("ApplyTransform failed");
+                break;
+            }
+        } else {
+            pixelMap->crop(rect);
+            pixelMap->scale(DOUBLE_SCALE, DOUBLE_SCALE, AntiAliasingOption::LOW);
+            pixelMap->rotate(ROTATE_ODD_ANGLE);
+        }
+        benchmark::DoNotOptimize(pixelMap->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+    peak.Report(state);
+}
+
+// Cached reuses the read-only ashmem copy made by the first Marshalling; cold drops it before every round trip.
+void BM_Marshalling(benchmark::State &state, bool cold)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    for (auto _ : state) {
+        if (cold) {
+            state.PauseTiming();
+            benchmark::DoNotOptimize(pixelMap->GetWritablePixels());
+            state.ResumeTiming();
+        }
+        Parcel parcel;
+        parcel.SetMaxCapacity(PARCEL_MAX_CAPACITY);
+        if (!pixelMap->Marshalling(parcel)) {
+            state.SkipWithError("Marshalling failed");
+            break;
+        }
+        std::unique_ptr<PixelMap> result(PixelMap::Unmarshalling(parcel));
+        if (result == nullptr) {
+            state.SkipWithError("Unmarshalling failed");
+            break;
+        }
+        benchmark::DoNotOptimize(result->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+}
+
+// Raw against row-filtered, deflated TLV pixels: encode cost and size, then decode cost of each layout.
+void BM_EncodeTlv(benchmark::State &state, bool compress)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create synthetic pixel map failed");
+        return;
+    }
+    size_t encodedBytes = 0;
+    for (auto _ : state) {
+        std::vector<uint8_t> buff;
+        if (!pixelMap->EncodeTlv(buff, compress)) {
+            state.SkipWithError("EncodeTlv failed");
+            break;
+        }
+        encodedBytes = buff.size();
+        benchmark::DoNotOptimize(buff.data());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+    state.counters["encoded_bytes"] = benchmark::Counter(static_cast<double>(encodedBytes));
+}
+
+void BM_DecodeTlv(benchmark::State &state, bool compress)
+{
+    int32_t size = static_cast<int32_t>(state.range(0));
+    std::shared_ptr<PixelMap> pixelMap = BenchmarkUtils::CreateSyntheticPixelMap(size, size);
+    std::vector<uint8_t> encoded;
+    if (pixelMap == nullptr || !pixelMap->EncodeTlv(encoded, compress)) {
+        state.SkipWithError("EncodeTlv failed");
+        return;
+    }
+    pixelMap.reset();
+    for (auto _ : state) {
+        std::unique_ptr<PixelMap> result(PixelMap::DecodeTlv(encoded));
+        if (result == nullptr) {
+            state.SkipWithError("DecodeTlv failed");
+            break;
+        }
+        benchmark::DoNotOptimize(result->GetPixels());
+    }
+    BenchmarkUtils::SetPixelThroughput(state, PixelCount(size));
+}
+} // namespace
+
+#define IMAGE_SIZES_BENCHMARK(...) \
+    BENCHMARK_CAPTURE(__VA_ARGS__)->Apply(BenchmarkUtils::ApplyImageSizes)->Unit(benchmark::kMillisecond)->UseRealTime()
+
+IMAGE_SIZES_BENCHMARK(BM_PixelConvert, rgba_8888, PixelFormat::RGBA_8888);
+IMAGE_SIZES_BENCHMARK(BM_PixelConvert, rgb_565, PixelFormat::RGB_565);
+IMAGE_SIZES_BENCHMARK(BM_PixelConvert, rgb_888, PixelFormat::RGB_888);
+
+IMAGE_SIZES_BENCHMARK(BM_ImageFormatConvert, rgba_to_nv21, PixelFormat::RGBA_8888, PixelFormat::NV21);
+IMAGE_SIZES_BENCHMARK(BM_ImageFormatConvert, nv21_to_rgba, PixelFormat::NV21, PixelFormat::RGBA_8888);
+IMAGE_SIZES_BENCHMARK(BM_ImageFormatConvert, nv12_to_rgb_565, PixelFormat::NV12, PixelFormat::RGB_565);
+IMAGE_SIZES_BENCHMARK(BM_ImageFormatConvert, rgba_to_p010, PixelFormat::RGBA_8888, PixelFormat::YCBCR_P010);
+
+IMAGE_SIZES_BENCHMARK(BM_YuvUtilsConvert, bgra_to_nv21, true);
+IMAGE_SIZES_BENCHMARK(BM_YuvUtilsConvert, nv21_to_bgra, false);
+
+IMAGE_SIZES_BENCHMARK(BM_Rotate, rgba_90, PixelFormat::RGBA_8888, ROTATE_90);
+IMAGE_SIZES_BENCHMARK(BM_Rotate, rgba_180, PixelFormat::RGBA_8888, ROTATE_180);
+IMAGE_SIZES_BENCHMARK(BM_Rotate, nv21_90, PixelFormat::NV21, ROTATE_90);
+IMAGE_SIZES_BENCHMARK(BM_Flip, rgba, PixelFormat::RGBA_8888);
+IMAGE_SIZES_BENCHMARK(BM_Flip, nv21, PixelFormat::NV21);
+
+IMAGE_SIZES_BENCHMARK(BM_Scale, rgba_half_none, PixelFormat::RGBA_8888, HALF_SCALE, AntiAliasingOption::NONE);
+IMAGE_SIZES_BENCHMARK(BM_Scale, rgba_half_high, PixelFormat::RGBA_8888, HALF_SCALE, AntiAliasingOption::HIGH);
+IMAGE_SIZES_BENCHMARK(BM_Scale, rgba_double_low, PixelFormat::RGBA_8888, DOUBLE_SCALE, AntiAliasingOption::LOW);
+IMAGE_SIZES_BENCHMARK(BM_Scale, nv21_half_low, PixelFormat::NV21, HALF_SCALE, AntiAliasingOption::LOW);
+IMAGE_SIZES_BENCHMARK(BM_Crop, rgba, PixelFormat::RGBA_8888);
+IMAGE_SIZES_BENCHMARK(BM_Crop, nv21, PixelFormat::NV21);
+IMAGE_SIZES_BENCHMARK(BM_TransformChain, separate, false);
+IMAGE_SIZES_BENCHMARK(BM_TransformChain, fused, true);
+
+IMAGE_SIZES_BENCHMARK(BM_Marshalling, cached, false);
+IMAGE_SIZES_BENCHMARK(BM_Marshalling, cold, true);
+IMAGE_SIZES_BENCHMARK(BM_EncodeTlv, raw, false);
+IMAGE_SIZES_BENCHMARK(BM_EncodeTlv, compressed, true);
+IMAGE_SIZES_BENCHMARK(BM_DecodeTlv, raw, false);
+IMAGE_SIZES_BENCHMARK(BM_DecodeTlv, compressed, true);
+} // namespace Media
+} // namespace OHOS
@@ -14,8 +14,10 @@
  */
 
 #include <fcntl.h>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
+#include <unistd.h>
 
 #include "file_metadata_stream.h"
 #include "image_source.h"
@@ -34,6 +36,7 @@ static const std::string IMAGE_GET_FILTER_AREA_PNG_PATH = "/data/local/tmp/image
 static const std::string IMAGE_GET_FILTER_AREA_WEBP_PATH = "/data/local/tmp/image/get_filter_area.webp";
 static const std::string IMAGE_GET_FILTER_AREA_DNG_PATH = "/data/local/tmp/image/get_filter_area.dng";
 static const std::string IMAGE_GET_FILTER_AREA_DNG_FILTERED_PATH = "/data/local/tmp/image/get_filter_area_filtered.dng";
+static const std::string IMAGE_GET_FILTER_AREA_JPEG_FILTERED_PATH = "/data/local/tmp/image/get_filter_area_filtered.jpg";
 static const std::string IMAGE_NO_GPS_HEIF_PATH = "/data/local/tmp/image/test.heic";
 static const std::string IMAGE_NO_GPS_JPEG_PATH = "/data/local/tmp/image/test_jpeg_readexifblob003.jpg";
 static const std::string IMAGE_NO_GPS_PNG_PATH = "/data/local/tmp/image/test_exif.png";
@@ -451,5 +454,38 @@ HWTEST_F(ExifGetFilterAreaTest, GetFilterArea011, TestSize.Level3)
         ASSERT_NE(values[i], filteredValues[i]);
     }
 }
+
+/**
+ * @tc.name: WriteFilteredCopy001
+ * @tc.desc: test WriteFilteredCopy zeroes exactly the filter area and copies everything else
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExifGetFilterAreaTest, WriteFilteredCopy001, TestSize.Level3)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_GET_FILTER_AREA_JPEG_PATH,
+        opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    ASSERT_EQ(imageSource->GetFilterArea(gpsExifKeys, ranges), SUCCESS);
+    ASSERT_FALSE(ranges.empty());
+
+    int fd = open(IMAGE_GET_FILTER_AREA_JPEG_FILTERED_PATH.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(imageSource->WriteFilteredCopy(gpsExifKeys, fd), SUCCESS);
+    close(fd);
+    EXPECT_EQ(imageSource->WriteFilteredCopy(gpsExifKeys, -1), ERR_IMAGE_INVALID_PARAMETER);
+
+    std::ifstream src(IMAGE_GET_FILTER_AREA_JPEG_PATH, std::ios::binary);
+    std::ifstream dst(IMAGE_GET_FILTER_AREA_JPEG_FILTERED_PATH, std::ios::binary);
+    std::vector<char> expected((std::istreambuf_iterator<char>(src)), std::istreambuf_iterator<char>());
+    std::vector<char> actual((std::istreambuf_iterator<char>(dst)), std::istreambuf_iterator<char>());
+    for (const auto& range : ranges) {
+        std::fill_n(expected.begin() + range.first, range.second, 0);
+    }
+    ASSERT_EQ(expected.size(), actual.size());
+    EXPECT_EQ(expected, actual);
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
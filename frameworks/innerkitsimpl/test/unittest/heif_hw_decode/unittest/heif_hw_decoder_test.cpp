@@ -203,4 +203,61 @@ HWTEST_F(HeifHwDecoderTest, DoDecodeOkWithGrid, TestSize.Level1)
     }
     ASSERT_TRUE(ret);
 }
+
+HWTEST_F(HeifHwDecoderTest, GetGridRegionSelectsIntersectingTiles, TestSize.Level1)
+{
+    // 3 x 2 tiles of 512 x 512 with partial tiles on the right and bottom edges
+    GridInfo gridInfo = {
+        .displayWidth = 1200,
+        .displayHeight = 1000,
+        .enableGrid = true,
+        .cols = 3,
+        .rows = 2,
+        .tileWidth = 512,
+        .tileHeight = 512
+    };
+    GridRegion region;
+    ASSERT_TRUE(gridInfo.GetRegion(600, 100, 100, 100, region));
+    ASSERT_EQ(region.firstCol, 1);
+    ASSERT_EQ(region.firstRow, 0);
+    ASSERT_EQ(region.grid.cols, 1);
+    ASSERT_EQ(region.grid.rows, 1);
+    ASSERT_EQ(region.grid.displayWidth, 512);
+    ASSERT_EQ(region.grid.displayHeight, 512);
+    ASSERT_TRUE(region.grid.IsValid());
+
+    ASSERT_TRUE(gridInfo.GetRegion(1000, 500, 1000, 1000, region));
+    ASSERT_EQ(region.firstCol, 1);
+    ASSERT_EQ(region.firstRow, 0);
+    ASSERT_EQ(region.grid.cols, 2);
+    ASSERT_EQ(region.grid.rows, 2);
+    ASSERT_EQ(region.grid.displayWidth, 1200 - 512);
+    ASSERT_EQ(region.grid.displayHeight, 1000);
+    ASSERT_TRUE(region.grid.IsValid());
+
+    ASSERT_TRUE(gridInfo.GetRegion(1199, 999, 1, 1, region));
+    ASSERT_EQ(region.firstCol, 2);
+    ASSERT_EQ(region.firstRow, 1);
+    ASSERT_EQ(region.grid.displayWidth, 1200 - 1024);
+    ASSERT_EQ(region.grid.displayHeight, 1000 - 512);
+    ASSERT_TRUE(region.grid.IsValid());
+}
+
+HWTEST_F(HeifHwDecoderTest, GetGridRegionWithInvalidRegion, TestSize.Level1)
+{
+    GridInfo gridInfo = {
+        .displayWidth = 1024,
+        .displayHeight = 1024,
+        .enableGrid = true,
+        .cols = 2,
+        .rows = 2,
+        .tileWidth = 512,
+        .tileHeight = 512
+    };
+    GridRegion region;
+    ASSERT_FALSE(gridInfo.GetRegion(0, 0, 0, 100, region));
+    ASSERT_FALSE(gridInfo.GetRegion(1024, 0, 100, 100, region));
+    gridInfo.enableGrid = false;
+    ASSERT_FALSE(gridInfo.GetRegion(0, 0, 100, 100, region));
+}
 } // namespace OHOS::Media
\ No newline at end of file
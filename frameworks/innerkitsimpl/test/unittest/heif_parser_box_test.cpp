@@ -15,6 +15,7 @@
 
 #define private public
 #define protected public
+#include <algorithm>
 #include <gtest/gtest.h>
 #include "item_data_box.h"
 #include "item_property_transform_box.h"
@@ -435,5 +436,45 @@ HWTEST_F(HeifParserBoxTest, ReadDataTest001, TestSize.Level3)
     ASSERT_EQ(heifIdatBox.ReadData(stream, 0, 16, outData), heif_error_eof);
     GTEST_LOG_(INFO) << "HeifParserBoxTest: ReadDataTest001 end";
 }
+
+/**
+ * @tc.name: GetDataViewTest001
+ * @tc.desc: HeifIlocBox finds items through its index and borrows single-extent data from the stream
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifParserBoxTest, GetDataViewTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "HeifParserBoxTest: GetDataViewTest001 start";
+    std::vector<uint8_t> buffer(64);
+    for (size_t i = 0; i < buffer.size(); i++) {
+        buffer[i] = static_cast<uint8_t>(i);
+    }
+    auto stream = std::make_shared<HeifBufferInputStream>(buffer.data(), buffer.size(), false);
+    HeifIlocBox heifIlocBox;
+    heifIlocBox.AppendData(1, {}, 0);
+    heifIlocBox.AppendData(2, {}, 0);
+    heifIlocBox.items_[0].extents[0].offset = 8;
+    heifIlocBox.items_[0].extents[0].length = 16;
+    heifIlocBox.items_[1].extents[0].offset = 60;
+    heifIlocBox.items_[1].extents[0].length = 16;
+
+    const HeifIlocBox::Item *item = heifIlocBox.GetItem(1);
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(item->itemId, 1);
+    ASSERT_EQ(heifIlocBox.GetItem(3), nullptr);
+
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    ASSERT_EQ(heifIlocBox.GetDataView(*item, stream, data, size), heif_error_ok);
+    ASSERT_EQ(data, buffer.data() + 8);
+    ASSERT_EQ(size, 16);
+    std::vector<uint8_t> copied;
+    ASSERT_EQ(heifIlocBox.ReadData(*item, stream, nullptr, &copied), heif_error_ok);
+    ASSERT_TRUE(std::equal(copied.begin(), copied.end(), data));
+
+    // extent past the end of the buffer has no view
+    ASSERT_EQ(heifIlocBox.GetDataView(*heifIlocBox.GetItem(2), stream, data, size), heif_error_item_data_not_found);
+    GTEST_LOG_(INFO) << "HeifParserBoxTest: GetDataViewTest001 end";
+}
 }
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include "image_type.h"
 #include "image_utils.h"
 #include "image_receiver_manager.h"
+#include "securec.h"
 
 using namespace testing::ext;
 using namespace OHOS::Media;
@@ -32,6 +33,12 @@ static constexpr int32_t RECEIVER_TEST_WIDTH = 8192;
 static constexpr int32_t RECEIVER_TEST_HEIGHT = 8;
 static constexpr int32_t RECEIVER_TEST_CAPACITY = 8;
 static constexpr int32_t RECEIVER_TEST_FORMAT = 4;
+static constexpr int32_t RECEIVER_BORROW_WIDTH = 64;
+static constexpr int32_t RECEIVER_BORROW_HEIGHT = 48;
+static constexpr int32_t RECEIVER_BORROW_STRIDE_ALIGNMENT = 0x8;
+static constexpr uint8_t RECEIVER_BORROW_FILL = 0x80;
+static const std::string RECEIVER_BORROW_PATH = "/data/receiver/Receiver_borrowed.jpg";
+static const std::string RECEIVER_COPY_PATH = "/data/receiver/Receiver_copied.jpg";
 
 class ImageReceiverTest : public testing::Test {
 public:
@@ -473,5 +480,99 @@ HWTEST_F(ImageReceiverTest, ReleaseReceiverTest001, TestSize.Level3)
     imageReceiver->ReleaseReceiver();
     GTEST_LOG_(INFO) << "ImageReceiverTest: ReleaseReceiverTest001 end";
 }
+
+static std::unique_ptr<PixelMap> DecodeReceiverFile(const std::string &path)
+{
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(path, sourceOpts, errorCode);
+    if (imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    return imageSource->CreatePixelMap(decodeOpts, errorCode);
+}
+
+// Encodes the buffer once through SaveBufferAsImage and once through a PixelMap::Create copy packed with the
+// receiver's options, then checks both files decode to the same pixels.
+static void CheckSaveBufferMatchesCopy(AlphaType alphaType)
+{
+    std::shared_ptr<ImageReceiver> imageReceiver = ImageReceiver::CreateImageReceiver(RECEIVER_TEST_WIDTH,
+        RECEIVER_TEST_HEIGHT, RECEIVER_TEST_FORMAT, RECEIVER_TEST_CAPACITY);
+    ASSERT_NE(imageReceiver, nullptr);
+    sptr<SurfaceBuffer> surfaceBuffer = SurfaceBuffer::Create();
+    ASSERT_NE(surfaceBuffer, nullptr);
+    BufferRequestConfig requestConfig = {
+        .width = RECEIVER_BORROW_WIDTH,
+        .height = RECEIVER_BORROW_HEIGHT,
+        .strideAlignment = RECEIVER_BORROW_STRIDE_ALIGNMENT,
+        .format = GraphicPixelFormat::GRAPHIC_PIXEL_FMT_BGRA_8888,
+        .usage = BUFFER_USAGE_CPU_READ | BUFFER_USAGE_CPU_WRITE | BUFFER_USAGE_MEM_DMA | BUFFER_USAGE_MEM_MMZ_CACHE,
+        .timeout = 0,
+    };
+    ASSERT_EQ(surfaceBuffer->Alloc(requestConfig), GSERROR_OK);
+    ASSERT_EQ(memset_s(surfaceBuffer->GetVirAddr(), surfaceBuffer->GetSize(), RECEIVER_BORROW_FILL,
+        surfaceBuffer->GetSize()), EOK);
+
+    InitializationOptions opts;
+    opts.size.width = RECEIVER_BORROW_WIDTH;
+    opts.size.height = RECEIVER_BORROW_HEIGHT;
+    opts.srcPixelFormat = PixelFormat::BGRA_8888;
+    opts.pixelFormat = PixelFormat::BGRA_8888;
+    opts.alphaType = alphaType;
+    std::unique_ptr<PixelMap> copied = PixelMap::Create(reinterpret_cast<uint32_t *>(surfaceBuffer->GetVirAddr()),
+        surfaceBuffer->GetSize(), opts);
+    ASSERT_NE(copied, nullptr);
+
+    int fd = open(RECEIVER_BORROW_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    int32_t res = imageReceiver->SaveBufferAsImage(fd, surfaceBuffer, opts);
+    close(fd);
+    ASSERT_EQ(res, SUCCESS);
+
+    ImagePacker imagePacker;
+    PackOption option;
+    option.format = ImageReceiver::OPTION_FORMAT;
+    option.quality = ImageReceiver::OPTION_QUALITY;
+    option.numberHint = ImageReceiver::OPTION_NUMBERHINT;
+    ASSERT_EQ(imagePacker.StartPacking(RECEIVER_COPY_PATH, option), SUCCESS);
+    ASSERT_EQ(imagePacker.AddImage(*copied), SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(imagePacker.FinalizePacking(packedSize), SUCCESS);
+
+    std::unique_ptr<PixelMap> saved = DecodeReceiverFile(RECEIVER_BORROW_PATH);
+    std::unique_ptr<PixelMap> expected = DecodeReceiverFile(RECEIVER_COPY_PATH);
+    ASSERT_NE(saved, nullptr);
+    ASSERT_NE(expected, nullptr);
+    ASSERT_EQ(saved->GetWidth(), RECEIVER_BORROW_WIDTH);
+    ASSERT_EQ(saved->GetHeight(), RECEIVER_BORROW_HEIGHT);
+    ASSERT_EQ(saved->GetByteCount(), expected->GetByteCount());
+    ASSERT_EQ(memcmp(saved->GetPixels(), expected->GetPixels(), expected->GetByteCount()), 0);
+}
+
+/**
+ * @tc.name: SaveBufferAsImageBorrowTest001
+ * @tc.desc: a translucent BGRA surface buffer with straight alpha options encodes like the copy path
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageReceiverTest, SaveBufferAsImageBorrowTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageReceiverTest: SaveBufferAsImageBorrowTest001 start";
+    CheckSaveBufferMatchesCopy(AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
+    GTEST_LOG_(INFO) << "ImageReceiverTest: SaveBufferAsImageBorrowTest001 end";
+}
+
+/**
+ * @tc.name: SaveBufferAsImageBorrowTest002
+ * @tc.desc: with the default alpha type a translucent buffer is premultiplied exactly as the copy path does
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageReceiverTest, SaveBufferAsImageBorrowTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageReceiverTest: SaveBufferAsImageBorrowTest002 start";
+    CheckSaveBufferMatchesCopy(AlphaType::IMAGE_ALPHA_TYPE_UNKNOWN);
+    GTEST_LOG_(INFO) << "ImageReceiverTest: SaveBufferAsImageBorrowTest002 end";
+}
 }
 }
\ No newline at end of file
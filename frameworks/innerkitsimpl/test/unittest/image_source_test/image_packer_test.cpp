@@ -40,9 +40,16 @@ using namespace OHOS::MultimediaPlugin;
 namespace OHOS {
 namespace Multimedia {
 constexpr uint32_t NUM_1 = 1;
+constexpr uint32_t NUM_2 = 2;
+constexpr uint32_t NUM_3 = 3;
 constexpr uint32_t NUM_100 = 100;
 constexpr int64_t BUFFER_SIZE = 2 * 1024 * 1024;
 constexpr uint32_t MAX_IMAGE_SIZE = 10 * 1024;
+constexpr int32_t HDR_IMAGE_WIDTH = 256;
+constexpr int32_t HDR_IMAGE_HEIGHT = 128;
+constexpr uint32_t F16_CHANNELS = 4;
+constexpr uint16_t F16_ONE = 0x3c00;
+constexpr uint16_t F16_FOUR = 0x4400;
 static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test_packing.jpg";
 static const std::string IMAGE_JPG_SRC = "/data/local/tmp/image/test_packing_exif.jpg";
 static const std::string IMAGE_JPG_DEST = "/data/local/tmp/image/test_jpg2jpg_out.jpg";
@@ -802,5 +809,54 @@ HWTEST_F(ImagePackerTest, PackYuv2Jpeg004, TestSize.Level3)
     close(fd);
     GTEST_LOG_(INFO) << "ImagePackerTest: PackYuv2Jpeg004 end";
 }
+
+/**
+ * @tc.name: PackHdrDualJpegByCpu001
+ * @tc.desc: test packing a heap RGBA_F16 pixelmap with values above SDR white as a dual layer HDR jpeg
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, PackHdrDualJpegByCpu001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackHdrDualJpegByCpu001 start";
+    InitializationOptions initOpts;
+    initOpts.size = {HDR_IMAGE_WIDTH, HDR_IMAGE_HEIGHT};
+    initOpts.pixelFormat = PixelFormat::RGBA_F16;
+    initOpts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(initOpts);
+    ASSERT_NE(pixelMap, nullptr);
+    uint16_t* pixels = static_cast<uint16_t*>(pixelMap->GetWritablePixels());
+    ASSERT_NE(pixels, nullptr);
+    uint32_t rowHalfs = static_cast<uint32_t>(pixelMap->GetRowStride()) / sizeof(uint16_t);
+    for (int32_t y = 0; y < HDR_IMAGE_HEIGHT; y++) {
+        for (int32_t x = 0; x < HDR_IMAGE_WIDTH; x++) {
+            uint16_t* pixel = pixels + y * rowHalfs + x * F16_CHANNELS;
+            uint16_t value = x < HDR_IMAGE_WIDTH / NUM_2 ? F16_ONE : F16_FOUR;
+            pixel[0] = value;
+            pixel[NUM_1] = value;
+            pixel[NUM_2] = value;
+            pixel[NUM_3] = F16_ONE;
+        }
+    }
+
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    ImagePacker pack;
+    PackOption option;
+    option.format = "image/jpeg";
+    option.desiredDynamicRange = EncodeDynamicRange::HDR_VIVID_DUAL;
+    ASSERT_EQ(pack.StartPacking(buffer.data(), BUFFER_SIZE, option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(pack.AddImage(*pixelMap), OHOS::Media::SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(pack.FinalizePacking(packedSize), OHOS::Media::SUCCESS);
+    ASSERT_GT(packedSize, 0);
+
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(buffer.data(), static_cast<uint32_t>(packedSize), sourceOpts, errorCode);
+    ASSERT_EQ(errorCode, OHOS::Media::SUCCESS);
+    ASSERT_NE(imageSource, nullptr);
+    ASSERT_TRUE(imageSource->IsHdrImage());
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackHdrDualJpegByCpu001 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
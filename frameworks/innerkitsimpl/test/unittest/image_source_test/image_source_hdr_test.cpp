@@ -368,5 +368,48 @@ HWTEST_F(ImageSourceHdrTest, ToSdr002, TestSize.Level3)
     uint32_t errCode = pixelMap->ToSdr();
     ASSERT_NE(errCode, SUCCESS);
 }
+
+/**
+ * @tc.name: CreatePictureDeferredAuxiliary001
+ * @tc.desc: Picture created with deferred auxiliary decode reads the same gainmap and main HDR type as the eager one
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceHdrTest, CreatePictureDeferredAuxiliary001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceHdrTest: CreatePictureDeferredAuxiliary001 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> eagerSource =
+        ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_HDR_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(eagerSource.get(), nullptr);
+    DecodingOptionsForPicture pictureOpts;
+    pictureOpts.desireAuxiliaryPictures = { AuxiliaryPictureType::GAINMAP };
+    std::unique_ptr<Picture> eagerPicture = eagerSource->CreatePicture(pictureOpts, errorCode);
+    ASSERT_NE(eagerPicture, nullptr);
+
+    std::unique_ptr<ImageSource> deferredSource =
+        ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_HDR_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(deferredSource.get(), nullptr);
+    pictureOpts.deferAuxiliaryDecode = true;
+    std::unique_ptr<Picture> deferredPicture = deferredSource->CreatePicture(pictureOpts, errorCode);
+    ASSERT_NE(deferredPicture, nullptr);
+    // The main pixel map is HDR tagged before any auxiliary picture is read.
+    ASSERT_EQ(deferredPicture->GetMainPixel()->GetHdrType(), eagerPicture->GetMainPixel()->GetHdrType());
+
+    std::shared_ptr<PixelMap> eagerGainmap = eagerPicture->GetGainmapPixelMap();
+    std::shared_ptr<PixelMap> deferredGainmap = deferredPicture->GetGainmapPixelMap();
+#ifdef IMAGE_VPE_FLAG
+    ASSERT_NE(eagerGainmap, nullptr);
+    ASSERT_NE(deferredGainmap, nullptr);
+    ASSERT_EQ(deferredGainmap->GetWidth(), eagerGainmap->GetWidth());
+    ASSERT_EQ(deferredGainmap->GetHeight(), eagerGainmap->GetHeight());
+    ASSERT_EQ(memcmp(deferredGainmap->GetPixels(), eagerGainmap->GetPixels(), eagerGainmap->GetByteCount()), 0);
+#else
+    ASSERT_EQ(deferredGainmap == nullptr, eagerGainmap == nullptr);
+#endif
+    GTEST_LOG_(INFO) << "ImageSourceHdrTest: CreatePictureDeferredAuxiliary001 end";
+}
 }
 }
\ No newline at end of file
@@ -71,6 +71,10 @@ const std::string GPS_LONGITUDE_REF = "GPSLongitudeRef";
 
 static constexpr size_t FILE_SIZE = 10;
 static constexpr size_t SIZE_T = 0;
+static constexpr int32_t EXIF_THUMBNAIL_GRID_WIDTH = 192;
+static constexpr int32_t EXIF_THUMBNAIL_GRID_HEIGHT = 256;
+static constexpr int32_t EXIF_THUMBNAIL_LARGE_WIDTH = 768;
+static constexpr int32_t EXIF_THUMBNAIL_LARGE_HEIGHT = 1024;
 
 class ImageSourceJpegTest : public testing::Test {
 public:
@@ -3502,5 +3506,43 @@ HWTEST_F(ImageSourceJpegTest, GetEncodedFormat003, TestSize.Level3)
     EXPECT_EQ(imageinfo2.encodedFormat.empty(), false);
     ASSERT_EQ(imageinfo2.encodedFormat, IMAGE_ENCODEDFORMAT);
 }
+
+/**
+ * @tc.name: PreferExifThumbnailTest001
+ * @tc.desc: a small desired size is served from the embedded thumbnail, a larger one from the main image
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, PreferExifThumbnailTest001, TestSize.Level3)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_EXIF_JPEG_PATH,
+        opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+
+    DecodeOptions decodeOpts;
+    decodeOpts.preferExifThumbnail = true;
+    decodeOpts.desiredSize = {EXIF_THUMBNAIL_GRID_WIDTH, EXIF_THUMBNAIL_GRID_HEIGHT};
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), EXIF_THUMBNAIL_GRID_WIDTH);
+    ASSERT_EQ(pixelMap->GetHeight(), EXIF_THUMBNAIL_GRID_HEIGHT);
+    std::shared_ptr<ExifMetadata> exifMetadata = pixelMap->GetExifMetadata();
+    ASSERT_NE(exifMetadata, nullptr);
+    std::string pixelMapOrientation;
+    std::string sourceOrientation;
+    exifMetadata->GetValue(ORIENTATION, pixelMapOrientation);
+    imageSource->GetImagePropertyString(0, ORIENTATION, sourceOrientation);
+    ASSERT_EQ(pixelMapOrientation, sourceOrientation);
+
+    decodeOpts.desiredSize = {EXIF_THUMBNAIL_LARGE_WIDTH, EXIF_THUMBNAIL_LARGE_HEIGHT};
+    pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), EXIF_THUMBNAIL_LARGE_WIDTH);
+    ASSERT_EQ(pixelMap->GetHeight(), EXIF_THUMBNAIL_LARGE_HEIGHT);
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
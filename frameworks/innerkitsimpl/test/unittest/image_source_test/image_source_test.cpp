@@ -2113,5 +2113,84 @@ HWTEST_F(ImageSourceTest, ApplyGainMap001, TestSize.Level3)
     ret = imageSource->ComposeHdrImage(hdrType, baseCtx, gainMapCtx, hdrCtx, metadata);
     ASSERT_EQ(ret, false);
 }
+
+/**
+ * @tc.name: DecodedImageCache001
+ * @tc.desc: test a second decode of the same file with the same options is served from the decoded image cache
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceTest, DecodedImageCache001, TestSize.Level3)
+{
+    ImageSource::SetDecodedImageCacheEnabled(true);
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    DecodeOptions decodeOpts;
+    std::unique_ptr<ImageSource> first = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(first, nullptr);
+    std::unique_ptr<PixelMap> decoded = first->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(decoded, nullptr);
+    DecodedImageCacheStats before = ImageSource::GetDecodedImageCacheStats();
+    EXPECT_GT(before.entryCount, 0u);
+
+    std::unique_ptr<ImageSource> second = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(second, nullptr);
+    std::unique_ptr<PixelMap> cached = second->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(errorCode, SUCCESS);
+    EXPECT_EQ(ImageSource::GetDecodedImageCacheStats().hits, before.hits + 1);
+    EXPECT_TRUE(cached->IsPixelsShared());
+    EXPECT_TRUE(decoded->IsSameImage(*cached));
+
+    decodeOpts.desiredSize = {decoded->GetWidth() / 2, decoded->GetHeight() / 2};
+    std::unique_ptr<PixelMap> scaled = second->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(scaled, nullptr);
+    EXPECT_EQ(ImageSource::GetDecodedImageCacheStats().hits, before.hits + 1);
+    ImageSource::SetDecodedImageCacheEnabled(false);
+    EXPECT_EQ(ImageSource::GetDecodedImageCacheStats().entryCount, 0u);
+}
+
+/**
+ * @tc.name: DecodedImageCache002
+ * @tc.desc: test buffer sources are keyed by content, hits are copy-on-write, and trim evicts
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceTest, DecodedImageCache002, TestSize.Level3)
+{
+    size_t bufferSize = 0;
+    ASSERT_TRUE(ImageUtils::GetFileSize(IMAGE_INPUT_JPEG_PATH, bufferSize));
+    std::vector<uint8_t> buffer(bufferSize);
+    ASSERT_TRUE(OHOS::ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_JPEG_PATH, buffer.data(), bufferSize));
+    std::vector<uint8_t> copy = buffer;
+    ImageSource::SetDecodedImageCacheEnabled(true);
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    DecodeOptions decodeOpts;
+    decodeOpts.editable = true;
+    std::unique_ptr<ImageSource> first = ImageSource::CreateImageSource(buffer.data(), buffer.size(), opts,
+        errorCode);
+    ASSERT_NE(first, nullptr);
+    std::unique_ptr<PixelMap> decoded = first->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(decoded, nullptr);
+
+    std::unique_ptr<ImageSource> second = ImageSource::CreateImageSource(copy.data(), copy.size(), opts, errorCode);
+    ASSERT_NE(second, nullptr);
+    uint64_t hits = ImageSource::GetDecodedImageCacheStats().hits;
+    std::unique_ptr<PixelMap> cached = second->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(ImageSource::GetDecodedImageCacheStats().hits, hits + 1);
+    EXPECT_TRUE(cached->IsEditable());
+    ASSERT_EQ(cached->WritePixel({0, 0}, 0x12345678), SUCCESS);
+    EXPECT_FALSE(decoded->IsSameImage(*cached));
+    std::unique_ptr<PixelMap> again = second->CreatePixelMapEx(0, decodeOpts, errorCode);
+    ASSERT_NE(again, nullptr);
+    EXPECT_TRUE(decoded->IsSameImage(*again));
+
+    ImageSource::TrimDecodedImageCache(0);
+    DecodedImageCacheStats stats = ImageSource::GetDecodedImageCacheStats();
+    EXPECT_EQ(stats.entryCount, 0u);
+    EXPECT_EQ(stats.usedBytes, 0u);
+    EXPECT_GT(stats.evictions, 0u);
+    ImageSource::SetDecodedImageCacheEnabled(false);
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -14,7 +14,9 @@
  */
 #define private public
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
+#include <vector>
 #include "directory_ex.h"
 #include "image_log.h"
 #include "image_packer.h"
@@ -689,5 +691,56 @@ HWTEST_F(ImageSourceWebpTest, WebpGetEncodedFormat001, TestSize.Level3)
     EXPECT_EQ(imageinfo2.encodedFormat.empty(), false);
     GTEST_LOG_(INFO) << "ImageSourceWebpTest: WebpGetEncodedFormat001 imageinfo2: " << imageinfo2.encodedFormat;
 }
+
+/**
+ * @tc.name: WebpImageDecode011
+ * @tc.desc: Decode a large webp fed in small chunks, the result matches a one-shot decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceWebpTest, WebpImageDecode011, TestSize.Level3)
+{
+    size_t bufferSize = 0;
+    ASSERT_TRUE(ImageUtils::GetFileSize(IMAGE_INPUT_WEBP_PATH, bufferSize));
+    std::vector<uint8_t> buffer(bufferSize);
+    ASSERT_TRUE(ReadFileToBuffer(IMAGE_INPUT_WEBP_PATH, buffer.data(), bufferSize));
+    uint32_t errorCode = 0;
+    IncrementalSourceOptions incOpts;
+    incOpts.incrementalMode = IncrementalMode::INCREMENTAL_DATA;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateIncrementalImageSource(incOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<IncrementalPixelMap> incPixelMap = imageSource->CreateIncrementalPixelMap(0, decodeOpts, errorCode);
+    ASSERT_NE(incPixelMap.get(), nullptr);
+
+    const uint32_t chunkSize = 512;
+    uint8_t lastProgress = 0;
+    for (size_t updateSize = 0; updateSize < bufferSize; updateSize += chunkSize) {
+        uint32_t updateOnceSize = static_cast<uint32_t>(std::min<size_t>(chunkSize, bufferSize - updateSize));
+        bool isCompleted = updateSize + updateOnceSize == bufferSize;
+        ASSERT_EQ(imageSource->UpdateData(buffer.data() + updateSize, updateOnceSize, isCompleted), SUCCESS);
+        uint8_t decodeProgress = 0;
+        incPixelMap->PromoteDecoding(decodeProgress);
+        ASSERT_GE(decodeProgress, lastProgress);
+        lastProgress = decodeProgress;
+    }
+    incPixelMap->DetachFromDecoding();
+    ASSERT_EQ(incPixelMap->GetDecodingStatus().decodingProgress, 100);
+
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> oneShotSource = ImageSource::CreateImageSource(IMAGE_INPUT_WEBP_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(oneShotSource.get(), nullptr);
+    std::unique_ptr<PixelMap> pixelMap = oneShotSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), incPixelMap->GetWidth());
+    ASSERT_EQ(pixelMap->GetHeight(), incPixelMap->GetHeight());
+    for (int32_t y = 0; y < pixelMap->GetHeight(); y++) {
+        ASSERT_EQ(memcmp(pixelMap->GetPixels() + y * pixelMap->GetRowStride(),
+            incPixelMap->GetPixels() + y * incPixelMap->GetRowStride(), pixelMap->GetRowBytes()), 0);
+    }
+}
 } // namespace Multimedia
 } // namespace OHOS
@@ -38,11 +38,29 @@ static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg
 static const std::string OPTION_FORMAT_TEST = "image/jpeg";
 static const std::int32_t OPTION_QUALITY_TEST = 100;
 static const std::int32_t OPTION_NUMBERHINT_TEST = 1;
+static const std::string OPTION_FORMAT_PNG_TEST = "image/png";
+static constexpr int32_t PACK_REUSE_SIZE = 16;
+static constexpr uint32_t PACK_REUSE_BUFFER_SIZE = 64 * 1024;
 
 class InterfaceTest : public testing::Test {
 public:
     InterfaceTest() {}
     ~InterfaceTest() {}
+
+    void SetUp() override
+    {
+        encoderPoolEnabled_ = ImagePacker::IsEncoderPoolEnabled();
+    }
+
+    void TearDown() override
+    {
+        // disabling drops any encoder set a test left in the process-wide pool
+        ImagePacker::SetEncoderPoolEnabled(false);
+        ImagePacker::SetEncoderPoolEnabled(encoderPoolEnabled_);
+    }
+
+private:
+    bool encoderPoolEnabled_ = false;
 };
 
 /**
@@ -257,5 +275,89 @@ HWTEST_F(InterfaceTest, InterfaceTest0012, TestSize.Level3)
     ASSERT_EQ(tmp, SUCCESS);
     GTEST_LOG_(INFO) << "InterfaceTest: InterfaceTest0012 end";
 }
+
+static std::string PackAndGetFormat(ImagePacker &imagePacker, PixelMap &pixelMap, const std::string &format)
+{
+    PackOption option;
+    option.format = format;
+    option.quality = OPTION_QUALITY_TEST;
+    std::vector<uint8_t> buffer(PACK_REUSE_BUFFER_SIZE);
+    int64_t packedSize = 0;
+    if (imagePacker.StartPacking(buffer.data(), buffer.size(), option) != SUCCESS ||
+        imagePacker.AddImage(pixelMap) != SUCCESS || imagePacker.FinalizePacking(packedSize) != SUCCESS ||
+        packedSize <= 0) {
+        return "";
+    }
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(buffer.data(), static_cast<uint32_t>(packedSize), opts, errorCode);
+    if (imageSource == nullptr) {
+        return "";
+    }
+    return imageSource->GetSourceInfo(errorCode).encodedFormat;
+}
+
+/**
+ * @tc.name: InterfaceTest0013
+ * @tc.desc: ImagePacker reuses its encoders for the same format and replaces them when the format changes
+ * @tc.type: FUNC
+ */
+HWTEST_F(InterfaceTest, InterfaceTest0013, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "InterfaceTest: InterfaceTest0013 start";
+    InitializationOptions opts;
+    opts.size.width = PACK_REUSE_SIZE;
+    opts.size.height = PACK_REUSE_SIZE;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(opts);
+    ASSERT_NE(pixelMap, nullptr);
+
+    ImagePacker imagePacker;
+    ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_TEST), OPTION_FORMAT_TEST);
+    ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_TEST), OPTION_FORMAT_TEST);
+    ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_PNG_TEST), OPTION_FORMAT_PNG_TEST);
+    ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_TEST), OPTION_FORMAT_TEST);
+    GTEST_LOG_(INFO) << "InterfaceTest: InterfaceTest0013 end";
+}
+
+/**
+ * @tc.name: InterfaceTest0014
+ * @tc.desc: Encoders released to the process-wide pool are handed to the next packer of the same format
+ * @tc.type: FUNC
+ */
+HWTEST_F(InterfaceTest, InterfaceTest0014, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "InterfaceTest: InterfaceTest0014 start";
+    InitializationOptions opts;
+    opts.size.width = PACK_REUSE_SIZE;
+    opts.size.height = PACK_REUSE_SIZE;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(opts);
+    ASSERT_NE(pixelMap, nullptr);
+
+    ImagePacker::SetEncoderPoolEnabled(false);
+    ImagePacker::SetEncoderPoolEnabled(true);
+    ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_PNG_TEST), 0u);
+    {
+        ImagePacker imagePacker;
+        ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_PNG_TEST), OPTION_FORMAT_PNG_TEST);
+    }
+    ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_PNG_TEST), 1u);
+    {
+        ImagePacker imagePacker;
+        ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_PNG_TEST), OPTION_FORMAT_PNG_TEST);
+        // the set released by the first packer was taken instead of a new one from the plugin server
+        ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_PNG_TEST), 0u);
+        ASSERT_EQ(PackAndGetFormat(imagePacker, *pixelMap, OPTION_FORMAT_TEST), OPTION_FORMAT_TEST);
+        ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_PNG_TEST), 1u);
+    }
+    ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_TEST), 1u);
+
+    ImagePacker::SetEncoderPoolEnabled(false);
+    ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_PNG_TEST), 0u);
+    ASSERT_EQ(ImagePacker::GetPooledEncoderSetCount(OPTION_FORMAT_TEST), 0u);
+    GTEST_LOG_(INFO) << "InterfaceTest: InterfaceTest0014 end";
+}
 }
 }
\ No newline at end of file
@@ -13,7 +13,9 @@
  * limitations under the License.
  */
 
+#define private public
 #include <gtest/gtest.h>
+#include "image_pixel_map_napi_kits.h"
 #include "pixel_map_napi.h"
 #include "image_packer_napi.h"
 #include "image_source_napi.h"
@@ -263,6 +265,45 @@ HWTEST_F(NapiTest, NapiTest0015, TestSize.Level3)
 
     GTEST_LOG_(INFO) << "NapiTest: NapiTest0015 end";
 }
+
+/**
+ * @tc.name: NapiTest0016
+ * @tc.desc: pixels written through AccessPixels do not show up in a clone sharing the storage
+ * @tc.type: FUNC
+ */
+HWTEST_F(NapiTest, NapiTest0016, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "NapiTest: NapiTest0016 start";
+    InitializationOptions opts;
+    opts.size.width = 4;
+    opts.size.height = 4;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    opts.editable = true;
+    std::shared_ptr<PixelMap> pixelMap = PixelMap::Create(opts);
+    ASSERT_NE(pixelMap, nullptr);
+    InitializationOptions cloneOpts;
+    cloneOpts.editable = true;
+    std::unique_ptr<PixelMap> clone = PixelMap::Create(*pixelMap, cloneOpts);
+    ASSERT_NE(clone, nullptr);
+    ASSERT_EQ(pixelMap->GetPixels(), clone->GetPixels());
+    uint8_t cloneFirstByte = clone->GetPixels()[0];
+
+    PixelMapNapi napi;
+    napi.nativePixelMap_ = pixelMap;
+    void *addr = nullptr;
+    PixelMapNapiArgs args;
+    args.outAddr = &addr;
+    ASSERT_EQ(PixelMapNapiNativeCtxCall(CTX_FUNC_ACCESS_PIXELS, &napi, &args), IMAGE_RESULT_SUCCESS);
+    ASSERT_NE(addr, nullptr);
+    static_cast<uint8_t *>(addr)[0] = static_cast<uint8_t>(~cloneFirstByte);
+    napi.UnlockPixelMap();
+
+    ASSERT_NE(pixelMap->GetPixels(), clone->GetPixels());
+    ASSERT_EQ(pixelMap->GetPixels()[0], static_cast<uint8_t>(~cloneFirstByte));
+    ASSERT_EQ(clone->GetPixels()[0], cloneFirstByte);
+    GTEST_LOG_(INFO) << "NapiTest: NapiTest0016 end";
+}
 }
 }
 
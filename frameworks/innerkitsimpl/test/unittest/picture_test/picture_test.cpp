@@ -772,5 +772,62 @@ HWTEST_F(PictureTest, SetExifMetadataByExifMetadataTest002, TestSize.Level2)
     int32_t result = picture->SetExifMetadata(exifMetadata);
     EXPECT_EQ(result, ERR_IMAGE_INVALID_PARAMETER);
 }
+
+/**
+ * @tc.name: SetAuxiliaryPictureLoaderTest001
+ * @tc.desc: Deferred auxiliary picture is decoded once, on first access.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PictureTest, SetAuxiliaryPictureLoaderTest001, TestSize.Level1)
+{
+    const AuxiliaryPictureType type = AuxiliaryPictureType::DEPTH_MAP;
+    std::unique_ptr<Picture> picture = CreatePicture();
+    ASSERT_NE(picture, nullptr);
+    int32_t loadCount = 0;
+    picture->SetAuxiliaryPictureLoader(type, [&loadCount, type]() {
+        loadCount++;
+        return CreateAuxiliaryPicture(type);
+    });
+    EXPECT_TRUE(picture->HasAuxiliaryPicture(type));
+    EXPECT_EQ(loadCount, 0);
+    std::shared_ptr<AuxiliaryPicture> auxiliaryPicture = picture->GetAuxiliaryPicture(type);
+    ASSERT_NE(auxiliaryPicture, nullptr);
+    EXPECT_EQ(auxiliaryPicture->GetType(), type);
+    EXPECT_EQ(picture->GetAuxiliaryPicture(type), auxiliaryPicture);
+    EXPECT_EQ(loadCount, 1);
+}
+
+/**
+ * @tc.name: SetAuxiliaryPictureLoaderTest002
+ * @tc.desc: Marshalling a picture resolves its deferred auxiliary pictures.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PictureTest, SetAuxiliaryPictureLoaderTest002, TestSize.Level1)
+{
+    const AuxiliaryPictureType type = AuxiliaryPictureType::LINEAR_MAP;
+    std::unique_ptr<Picture> srcPicture = CreatePicture();
+    ASSERT_NE(srcPicture, nullptr);
+    srcPicture->SetAuxiliaryPictureLoader(type, [type]() { return CreateAuxiliaryPicture(type); });
+    Parcel data;
+    ASSERT_TRUE(srcPicture->Marshalling(data));
+    std::unique_ptr<Picture> dstPicture(Picture::Unmarshalling(data));
+    ASSERT_NE(dstPicture, nullptr);
+    EXPECT_TRUE(dstPicture->HasAuxiliaryPicture(type));
+}
+
+/**
+ * @tc.name: SetAuxiliaryPictureLoaderTest003
+ * @tc.desc: A failed deferred decode leaves the picture without that auxiliary picture.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PictureTest, SetAuxiliaryPictureLoaderTest003, TestSize.Level2)
+{
+    const AuxiliaryPictureType type = AuxiliaryPictureType::FRAGMENT_MAP;
+    std::unique_ptr<Picture> picture = CreatePicture();
+    ASSERT_NE(picture, nullptr);
+    picture->SetAuxiliaryPictureLoader(type, []() { return std::shared_ptr<AuxiliaryPicture>(nullptr); });
+    EXPECT_EQ(picture->GetAuxiliaryPicture(type), nullptr);
+    EXPECT_FALSE(picture->HasAuxiliaryPicture(type));
+}
 } // namespace Media
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
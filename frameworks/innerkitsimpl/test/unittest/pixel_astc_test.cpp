@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 #include <securec.h>
+#include <functional>
+#include <vector>
 #include "image_source.h"
 #include "image_type.h"
 #include "image_utils.h"
@@ -37,10 +39,33 @@ constexpr uint8_t ASTC_1TH_BYTES = 8;
 constexpr uint8_t ASTC_2TH_BYTES = 16;
 constexpr uint8_t MASKBITS_FOR_8BIT = 255;
 constexpr uint8_t ASTC_PER_BLOCK_BYTES = 16;
+constexpr uint8_t ASTC_RGBA_BYTES = 4;
+constexpr int32_t ASTC_BLOCK_SIDE = 4;
+constexpr int32_t ASTC_BLOCK_HALF = 2;
 
 constexpr uint8_t ASTC_BLOCK4X4_FIT_SUT_ASTC_EXAMPLE0[ASTC_PER_BLOCK_BYTES] = {
     0x43, 0x80, 0xE9, 0xE8, 0xFA, 0xFC, 0x14, 0x17, 0xFF, 0xFF, 0x81, 0x42, 0x12, 0x5A, 0xD4, 0xE9
 };
+// Golden blocks with known decoded colours, checked against the ASTC specification.
+// Void-extent LDR block with no extent, UNORM16 colour 0xFFFF, 0x0000, 0x8080, 0xFFFF.
+constexpr uint8_t ASTC_BLOCK4X4_VOID_EXTENT[ASTC_PER_BLOCK_BYTES] = {
+    0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x80, 0x80, 0xFF, 0xFF
+};
+constexpr uint8_t ASTC_VOID_EXTENT_RGBA[ASTC_RGBA_BYTES] = {0xFF, 0x00, 0x80, 0xFF};
+// Block mode 0x042 (4x4 grid of 2 bit weights), one partition, CEM 8 (RGB direct) with endpoints
+// (200, 40, 90) and (250, 250, 250). All weights are 0, so every texel is the first endpoint.
+constexpr uint8_t ASTC_BLOCK4X4_RGB_ENDPOINT0[ASTC_PER_BLOCK_BYTES] = {
+    0x42, 0x00, 0x91, 0xF5, 0x51, 0xF4, 0xB5, 0xF4, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+// Same endpoints, the weights of the top two texel rows are 3 and select the second endpoint.
+constexpr uint8_t ASTC_BLOCK4X4_RGB_SPLIT[ASTC_PER_BLOCK_BYTES] = {
+    0x42, 0x00, 0x91, 0xF5, 0x51, 0xF4, 0xB5, 0xF4, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF
+};
+constexpr uint8_t ASTC_RGB_ENDPOINT0_RGBA[ASTC_RGBA_BYTES] = {200, 40, 90, 0xFF};
+constexpr uint8_t ASTC_RGB_ENDPOINT1_RGBA[ASTC_RGBA_BYTES] = {250, 250, 250, 0xFF};
+// Block mode 0 is reserved and decodes to the ASTC error colour.
+constexpr uint8_t ASTC_BLOCK4X4_RESERVED[ASTC_PER_BLOCK_BYTES] = {0};
+constexpr uint8_t ASTC_ERROR_RGBA[ASTC_RGBA_BYTES] = {0xFF, 0x00, 0xFF, 0xFF};
 
 class PixelAstcTest : public testing::Test {
 public:
@@ -91,7 +116,8 @@ static bool ConstructAstcBody(uint8_t* astcBody, size_t& blockNums, const uint8_
     return true;
 }
 
-static void ConstructPixelAstc(std::unique_ptr<PixelMap>& pixelMap, uint8_t** dataIn)
+static void ConstructPixelAstc(std::unique_ptr<PixelMap>& pixelMap, uint8_t** dataIn,
+    const uint8_t* astcBlock = ASTC_BLOCK4X4_FIT_SUT_ASTC_EXAMPLE0)
 {
     uint32_t errorCode = 0;
     SourceOptions opts;
@@ -108,7 +134,7 @@ static void ConstructPixelAstc(std::unique_ptr<PixelMap>& pixelMap, uint8_t** da
         GTEST_LOG_(INFO) << "GenAstcHeader failed";
     }
     //  16 means header bytes
-    if (!ConstructAstcBody(data + 16, blockNum, ASTC_BLOCK4X4_FIT_SUT_ASTC_EXAMPLE0)) {
+    if (!ConstructAstcBody(data + 16, blockNum, astcBlock)) {
         GTEST_LOG_(INFO) << "ConstructAstcBody failed";
     }
 
@@ -122,6 +148,22 @@ static void ConstructPixelAstc(std::unique_ptr<PixelMap>& pixelMap, uint8_t** da
     *dataIn = data;
 }
 
+// Decode the whole PixelAstc on the CPU and check every texel against expected(x, y).
+static void CheckAstcPixels(PixelMap& pixelAstc, const std::function<const uint8_t*(int32_t, int32_t)>& expected)
+{
+    int32_t width = pixelAstc.GetWidth();
+    int32_t height = pixelAstc.GetHeight();
+    uint32_t rowBytes = static_cast<uint32_t>(width) * ASTC_RGBA_BYTES;
+    std::vector<uint8_t> pixels(static_cast<size_t>(rowBytes) * height);
+    ASSERT_EQ(SUCCESS, pixelAstc.ReadPixels(pixels.size(), pixels.data()));
+    for (int32_t y = 0; y < height; y++) {
+        for (int32_t x = 0; x < width; x++) {
+            const uint8_t* pixel = pixels.data() + y * rowBytes + x * ASTC_RGBA_BYTES;
+            ASSERT_EQ(0, memcmp(pixel, expected(x, y), ASTC_RGBA_BYTES)) << "texel " << x << ", " << y;
+        }
+    }
+}
+
 /**
  * @tc.name: PixelAstcTest001
  * @tc.desc: PixelAstc scale
@@ -377,7 +419,7 @@ HWTEST_F(PixelAstcTest, PixelAstcTest011, TestSize.Level3)
     // 1 means ARGB color value
     uint32_t color = 1;
     uint8_t ret = pixelAstc->GetARGB32ColorB(color);
-    EXPECT_EQ(0, ret);
+    EXPECT_EQ(1, ret);
     if (data != nullptr) {
         free(data);
     }
@@ -483,6 +525,9 @@ HWTEST_F(PixelAstcTest, PixelAstcTest016, TestSize.Level3)
     Position pos;
     uint32_t dst;
     uint32_t ret = pixelAstc->ReadPixel(pos, dst);
+    EXPECT_EQ(SUCCESS, ret);
+    pos.x = pixelAstc->GetWidth();
+    ret = pixelAstc->ReadPixel(pos, dst);
     EXPECT_EQ(ERR_IMAGE_INVALID_PARAMETER, ret);
     if (data != nullptr) {
         free(data);
@@ -693,5 +738,129 @@ HWTEST_F(PixelAstcTest, PixelAstcTest026, TestSize.Level3)
     }
     GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest026 end";
 }
+
+/**
+ * @tc.name: PixelAstcTest027
+ * @tc.desc: PixelAstc ReadPixels decodes a region identical to the full decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelAstcTest, PixelAstcTest027, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest027 start";
+    std::unique_ptr<PixelMap> pixelAstc = std::unique_ptr<PixelMap>();
+    uint8_t* data = nullptr;
+    ConstructPixelAstc(pixelAstc, &data);
+    ASSERT_NE(pixelAstc.get(), nullptr);
+    int32_t width = pixelAstc->GetWidth();
+    int32_t height = pixelAstc->GetHeight();
+    // 4 means RGBA_8888 bytes per pixel
+    uint32_t rowBytes = static_cast<uint32_t>(width) * 4;
+    std::vector<uint8_t> full(static_cast<size_t>(rowBytes) * height);
+    ASSERT_EQ(SUCCESS, pixelAstc->ReadPixels(full.size(), full.data()));
+    // ASTC error colour is opaque magenta, a valid block never decodes to it
+    EXPECT_FALSE(full[0] == 0xFF && full[1] == 0x00 && full[2] == 0xFF);
+
+    // region not aligned to the 4x4 block grid
+    Rect region = {3, 6, 7, 5};
+    uint32_t stride = static_cast<uint32_t>(region.width) * 4;
+    std::vector<uint8_t> part(static_cast<size_t>(stride) * region.height);
+    ASSERT_EQ(SUCCESS, pixelAstc->ReadPixels(part.size(), 0, stride, region, part.data()));
+    for (int32_t y = 0; y < region.height; y++) {
+        const uint8_t *expect = full.data() + (region.top + y) * rowBytes + region.left * 4;
+        EXPECT_EQ(0, memcmp(part.data() + y * stride, expect, stride));
+    }
+    if (data != nullptr) {
+        free(data);
+    }
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest027 end";
+}
+
+/**
+ * @tc.name: PixelAstcTest028
+ * @tc.desc: PixelAstc GetPixel32 and GetARGB32Color agree, and crop shifts the decoded origin
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelAstcTest, PixelAstcTest028, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest028 start";
+    std::unique_ptr<PixelMap> pixelAstc = std::unique_ptr<PixelMap>();
+    uint8_t* data = nullptr;
+    ConstructPixelAstc(pixelAstc, &data);
+    ASSERT_NE(pixelAstc.get(), nullptr);
+    // 5 and 9 means a texel position inside the second block column
+    const uint8_t *rgba = reinterpret_cast<const uint8_t *>(pixelAstc->GetPixel32(5, 9));
+    ASSERT_NE(rgba, nullptr);
+    uint32_t color = 0;
+    ASSERT_TRUE(pixelAstc->GetARGB32Color(5, 9, color));
+    EXPECT_EQ(pixelAstc->GetARGB32ColorR(color), rgba[0]);
+    EXPECT_EQ(pixelAstc->GetARGB32ColorG(color), rgba[1]);
+    EXPECT_EQ(pixelAstc->GetARGB32ColorB(color), rgba[2]);
+    EXPECT_EQ(pixelAstc->GetARGB32ColorA(color), rgba[3]);
+
+    Rect cropRect = {4, 8, 16, 16};
+    ASSERT_EQ(SUCCESS, pixelAstc->crop(cropRect));
+    uint32_t croppedColor = 0;
+    ASSERT_TRUE(pixelAstc->GetARGB32Color(1, 1, croppedColor));
+    EXPECT_EQ(color, croppedColor);
+    if (data != nullptr) {
+        free(data);
+    }
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest028 end";
+}
+
+/**
+ * @tc.name: PixelAstcTest029
+ * @tc.desc: PixelAstc decodes golden solid colour blocks to their known RGBA
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelAstcTest, PixelAstcTest029, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest029 start";
+    const std::pair<const uint8_t*, const uint8_t*> goldens[] = {
+        {ASTC_BLOCK4X4_VOID_EXTENT, ASTC_VOID_EXTENT_RGBA},
+        {ASTC_BLOCK4X4_RGB_ENDPOINT0, ASTC_RGB_ENDPOINT0_RGBA},
+        {ASTC_BLOCK4X4_RESERVED, ASTC_ERROR_RGBA},
+    };
+    for (const auto& golden : goldens) {
+        std::unique_ptr<PixelMap> pixelAstc = std::unique_ptr<PixelMap>();
+        uint8_t* data = nullptr;
+        ConstructPixelAstc(pixelAstc, &data, golden.first);
+        ASSERT_NE(pixelAstc.get(), nullptr);
+        const uint8_t* rgba = golden.second;
+        CheckAstcPixels(*pixelAstc, [rgba](int32_t, int32_t) { return rgba; });
+        uint32_t color = 0;
+        // 5 and 9 means a texel position inside the second block column
+        ASSERT_TRUE(pixelAstc->GetARGB32Color(5, 9, color));
+        EXPECT_EQ(pixelAstc->GetARGB32ColorR(color), rgba[0]);
+        EXPECT_EQ(pixelAstc->GetARGB32ColorG(color), rgba[1]);
+        EXPECT_EQ(pixelAstc->GetARGB32ColorB(color), rgba[2]);
+        EXPECT_EQ(pixelAstc->GetARGB32ColorA(color), rgba[3]);
+        if (data != nullptr) {
+            free(data);
+        }
+    }
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest029 end";
+}
+
+/**
+ * @tc.name: PixelAstcTest030
+ * @tc.desc: PixelAstc decodes a golden block whose weights pick a different endpoint per texel row
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelAstcTest, PixelAstcTest030, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest030 start";
+    std::unique_ptr<PixelMap> pixelAstc = std::unique_ptr<PixelMap>();
+    uint8_t* data = nullptr;
+    ConstructPixelAstc(pixelAstc, &data, ASTC_BLOCK4X4_RGB_SPLIT);
+    ASSERT_NE(pixelAstc.get(), nullptr);
+    CheckAstcPixels(*pixelAstc, [](int32_t, int32_t y) {
+        return y % ASTC_BLOCK_SIDE < ASTC_BLOCK_HALF ? ASTC_RGB_ENDPOINT1_RGBA : ASTC_RGB_ENDPOINT0_RGBA;
+    });
+    if (data != nullptr) {
+        free(data);
+    }
+    GTEST_LOG_(INFO) << "PixelAstcTest: PixelAstcTest030 end";
+}
 }
 }
\ No newline at end of file
@@ -1890,6 +1890,35 @@ HWTEST_F(ImagePixelMapTest, TlvEncode001, TestSize.Level3)
     GTEST_LOG_(INFO) << "ImagePixelMapTest: TlvEncode001 end";
 }
 
+/**
+* @tc.name: TlvEncode002
+* @tc.desc: test TlvEncode with compression round trips losslessly and shrinks the buffer
+* @tc.type: FUNC
+*/
+HWTEST_F(ImagePixelMapTest, TlvEncode002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePixelMapTest: TlvEncode002 start";
+    // 64 means pixelmap width and height
+    std::unique_ptr<PixelMap> pixelMap = CreatePixelMapCommon(64, 64);
+    ASSERT_NE(pixelMap.get(), nullptr);
+
+    std::vector<uint8_t> rawBuff;
+    ASSERT_TRUE(pixelMap->EncodeTlv(rawBuff, false));
+    std::vector<uint8_t> compressedBuff;
+    ASSERT_TRUE(pixelMap->EncodeTlv(compressedBuff, true));
+    EXPECT_LT(compressedBuff.size(), rawBuff.size());
+
+    std::unique_ptr<PixelMap> pixelMap2(PixelMap::DecodeTlv(compressedBuff));
+    ASSERT_NE(pixelMap2, nullptr);
+    EXPECT_EQ(pixelMap2->GetWidth(), pixelMap->GetWidth());
+    EXPECT_EQ(pixelMap2->GetHeight(), pixelMap->GetHeight());
+    EXPECT_EQ(pixelMap2->GetPixelFormat(), pixelMap->GetPixelFormat());
+    ASSERT_EQ(pixelMap2->GetByteCount(), pixelMap->GetByteCount());
+    EXPECT_EQ(memcmp(pixelMap2->GetPixels(), pixelMap->GetPixels(), pixelMap->GetByteCount()), 0);
+
+    GTEST_LOG_(INFO) << "ImagePixelMapTest: TlvEncode002 end";
+}
+
 /**
  * @tc.name: TransformData001
  * @tc.desc: ASTC transform test
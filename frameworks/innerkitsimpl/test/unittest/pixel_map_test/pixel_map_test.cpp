@@ -14,6 +14,8 @@
  */
 
 #define protected public
+#include <algorithm>
+#include <vector>
 #include <gtest/gtest.h>
 #include "image_type.h"
 #include "image_utils.h"
@@ -2282,5 +2284,392 @@ HWTEST_F(PixelMapTest, ConvertAlphaFormatTest008, TestSize.Level3)
     ASSERT_NE(ret, SUCCESS);
     GTEST_LOG_(INFO) << "ImagePixelMapTest: ConvertAlphaFormatTest008 end";
 }
+static std::unique_ptr<PixelMap> ConstructEditablePixmap()
+{
+    InitializationOptions opts;
+    opts.size.width = 200;
+    opts.size.height = 300;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    opts.editable = true;
+    return PixelMap::Create(opts);
+}
+
+/**
+ * @tc.name: SharedStorageTest001
+ * @tc.desc: Clone shares pixels with source until one of them is written.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, SharedStorageTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest001 start";
+    std::unique_ptr<PixelMap> source = ConstructPixmap(PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
+    ASSERT_NE(source, nullptr);
+    InitializationOptions opts;
+    opts.editable = true;
+    std::unique_ptr<PixelMap> clone = PixelMap::Create(*source, opts);
+    ASSERT_NE(clone, nullptr);
+    EXPECT_TRUE(source->IsPixelsShared());
+    EXPECT_TRUE(clone->IsPixelsShared());
+    EXPECT_EQ(source->GetPixels(), clone->GetPixels());
+
+    const uint8_t *sourcePixels = source->GetPixels();
+    uint8_t firstByte = sourcePixels[0];
+    EXPECT_TRUE(clone->WritePixels(static_cast<uint32_t>(~firstByte)));
+    EXPECT_FALSE(clone->IsPixelsShared());
+    EXPECT_NE(source->GetPixels(), clone->GetPixels());
+    EXPECT_EQ(source->GetPixels(), sourcePixels);
+    EXPECT_EQ(source->GetPixels()[0], firstByte);
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest001 end";
+}
+
+/**
+ * @tc.name: SharedStorageTest002
+ * @tc.desc: Source keeps valid pixels after the clone sharing them is released.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, SharedStorageTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest002 start";
+    std::unique_ptr<PixelMap> source = ConstructPixmap(PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
+    ASSERT_NE(source, nullptr);
+    const uint8_t *sourcePixels = source->GetPixels();
+    InitializationOptions opts;
+    std::unique_ptr<PixelMap> clone = PixelMap::Create(*source, opts);
+    ASSERT_NE(clone, nullptr);
+    clone.reset();
+    EXPECT_TRUE(source->IsPixelsShared());
+    EXPECT_NE(source->GetWritablePixels(), nullptr);
+    EXPECT_FALSE(source->IsPixelsShared());
+    EXPECT_EQ(source->GetPixels(), sourcePixels);
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest002 end";
+}
+
+/**
+ * @tc.name: SharedStorageTest003
+ * @tc.desc: SetAlpha on a source detaches it from its clone.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, SharedStorageTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest003 start";
+    std::unique_ptr<PixelMap> source = ConstructEditablePixmap();
+    ASSERT_NE(source, nullptr);
+    ASSERT_TRUE(source->WritePixels(0xFFFFFFFF));
+    InitializationOptions opts;
+    std::unique_ptr<PixelMap> clone = PixelMap::Create(*source, opts);
+    ASSERT_NE(clone, nullptr);
+    uint32_t cloneColor = 0;
+    ASSERT_EQ(clone->ReadPixel({0, 0}, cloneColor), SUCCESS);
+    EXPECT_EQ(source->SetAlpha(0.5f), SUCCESS);
+    uint32_t color = 0;
+    ASSERT_EQ(clone->ReadPixel({0, 0}, color), SUCCESS);
+    EXPECT_EQ(color, cloneColor);
+    EXPECT_NE(source->GetPixels(), clone->GetPixels());
+    GTEST_LOG_(INFO) << "PixelMapTest: SharedStorageTest003 end";
+}
+/**
+ * @tc.name: MarshallingCacheTest001
+ * @tc.desc: Heap pixels are copied to ashmem once and the region is reused until the pixels change.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, MarshallingCacheTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: MarshallingCacheTest001 start";
+    const int32_t width = 100;
+    const int32_t height = 200;
+    std::unique_ptr<PixelMap> pixelMap = ConstructPixmap(width, height, PixelFormat::RGB_888,
+        AlphaType::IMAGE_ALPHA_TYPE_OPAQUE, AllocatorType::HEAP_ALLOC);
+    ASSERT_NE(pixelMap, nullptr);
+    pixelMap->SetEditable(true);
+
+    Parcel parcel1;
+    ASSERT_TRUE(pixelMap->Marshalling(parcel1));
+    int32_t cachedFd = pixelMap->marshallingFd_;
+    EXPECT_GE(cachedFd, 0);
+    Parcel parcel2;
+    ASSERT_TRUE(pixelMap->Marshalling(parcel2));
+    EXPECT_EQ(pixelMap->marshallingFd_, cachedFd);
+
+    std::vector<uint8_t> source(pixelMap->GetCapacity(), 0x5A);
+    EXPECT_EQ(pixelMap->WritePixels(source.data(), source.size()), SUCCESS);
+    EXPECT_LT(pixelMap->marshallingFd_, 0);
+    Parcel parcel3;
+    ASSERT_TRUE(pixelMap->Marshalling(parcel3));
+    std::unique_ptr<PixelMap> dstPixelMap(PixelMap::Unmarshalling(parcel3));
+    ASSERT_NE(dstPixelMap, nullptr);
+    EXPECT_TRUE(pixelMap->IsSameImage(*dstPixelMap));
+    GTEST_LOG_(INFO) << "PixelMapTest: MarshallingCacheTest001 end";
+}
+
+static constexpr size_t RGBA_BYTES = 4;
+static constexpr size_t RGBA_ALPHA_OFFSET = 3;
+static constexpr size_t BITS_PER_BYTE = 8;
+static constexpr size_t ALPHA_KERNEL_PATHS = 2;
+// Odd widths and heights leave a tail of one to three pixels behind the four pixel vector step, 1023 and 1024
+// square maps are large enough to be split across threads at odd and even offsets.
+static const std::vector<Size> ALPHA_KERNEL_SIZES = {
+    {1, 1}, {3, 1}, {5, 3}, {7, 7}, {13, 5}, {1023, 3}, {1023, 1023}, {1024, 1024},
+};
+
+// Same pattern in RGBA_8888, which runs the vector kernels, and in ARGB_8888, which keeps the per-pixel path.
+static std::unique_ptr<PixelMap> ConstructAlphaPatternPixmap(PixelFormat format, const Size &size,
+    AlphaType alphaType, bool alphaAboveColor)
+{
+    InitializationOptions opts;
+    opts.size = size;
+    opts.pixelFormat = format;
+    opts.alphaType = alphaType;
+    opts.editable = true;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(opts);
+    if (pixelMap == nullptr || static_cast<size_t>(pixelMap->GetRowStride()) != size.width * RGBA_BYTES) {
+        return nullptr;
+    }
+    size_t alphaOffset = format == PixelFormat::ARGB_8888 ? 0 : RGBA_ALPHA_OFFSET;
+    size_t colorOffset = format == PixelFormat::ARGB_8888 ? 1 : 0;
+    std::vector<uint8_t> pixels(pixelMap->GetByteCount());
+    for (size_t i = 0; i < pixels.size() / RGBA_BYTES; i++) {
+        uint8_t color = static_cast<uint8_t>(i);
+        uint8_t pixelAlpha = static_cast<uint8_t>(i >> BITS_PER_BYTE);
+        if (alphaAboveColor) {
+            pixelAlpha = std::max(pixelAlpha, color);
+        }
+        uint8_t *pixel = pixels.data() + i * RGBA_BYTES;
+        pixel[colorOffset] = color;
+        pixel[colorOffset + 1] = static_cast<uint8_t>(UINT8_MAX - color);
+        pixel[colorOffset + 2] = static_cast<uint8_t>(color / 2);
+        pixel[alphaOffset] = pixelAlpha;
+    }
+    if (pixelMap->WritePixels(pixels.data(), pixels.size()) != SUCCESS) {
+        return nullptr;
+    }
+    return pixelMap;
+}
+
+// Pixels of an RGBA_8888 or ARGB_8888 map in RGBA order.
+static std::vector<uint8_t> GetRgbaPixels(PixelMap &pixelMap)
+{
+    std::vector<uint8_t> pixels(pixelMap.GetPixels(), pixelMap.GetPixels() + pixelMap.GetByteCount());
+    if (pixelMap.GetPixelFormat() == PixelFormat::ARGB_8888) {
+        for (size_t i = 0; i < pixels.size(); i += RGBA_BYTES) {
+            std::rotate(pixels.begin() + i, pixels.begin() + i + 1, pixels.begin() + i + RGBA_BYTES);
+        }
+    }
+    return pixels;
+}
+
+/**
+ * @tc.name: AlphaKernelTest001
+ * @tc.desc: SetAlpha on RGBA_8888 matches the per-pixel ARGB_8888 path byte for byte, including odd tails.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, AlphaKernelTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: AlphaKernelTest001 start";
+    const float percent = 0.33f;
+    for (AlphaType alphaType : {AlphaType::IMAGE_ALPHA_TYPE_PREMUL, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL}) {
+        for (const Size &size : ALPHA_KERNEL_SIZES) {
+            std::unique_ptr<PixelMap> kernel = ConstructAlphaPatternPixmap(PixelFormat::RGBA_8888, size, alphaType,
+                false);
+            ASSERT_NE(kernel, nullptr);
+            std::unique_ptr<PixelMap> scalar = ConstructAlphaPatternPixmap(PixelFormat::ARGB_8888, size, alphaType,
+                false);
+            ASSERT_NE(scalar, nullptr);
+            ASSERT_EQ(kernel->SetAlpha(percent), SUCCESS);
+            ASSERT_EQ(scalar->SetAlpha(percent), SUCCESS);
+            EXPECT_EQ(GetRgbaPixels(*kernel), GetRgbaPixels(*scalar)) << size.width << "x" << size.height;
+        }
+    }
+    GTEST_LOG_(INFO) << "PixelMapTest: AlphaKernelTest001 end";
+}
+
+/**
+ * @tc.name: AlphaKernelTest002
+ * @tc.desc: ConvertAlphaFormat on RGBA_8888 matches the per-pixel ARGB_8888 path in both directions.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, AlphaKernelTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: AlphaKernelTest002 start";
+    for (bool toPremul : {true, false}) {
+        AlphaType srcAlphaType = toPremul ? AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL : AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+        for (const Size &size : ALPHA_KERNEL_SIZES) {
+            std::vector<uint8_t> results[ALPHA_KERNEL_PATHS];
+            const PixelFormat formats[ALPHA_KERNEL_PATHS] = {PixelFormat::RGBA_8888, PixelFormat::ARGB_8888};
+            for (size_t i = 0; i < ALPHA_KERNEL_PATHS; i++) {
+                std::unique_ptr<PixelMap> src = ConstructAlphaPatternPixmap(formats[i], size, srcAlphaType, !toPremul);
+                ASSERT_NE(src, nullptr);
+                std::unique_ptr<PixelMap> dst = ConstructAlphaPatternPixmap(formats[i], size, srcAlphaType, !toPremul);
+                ASSERT_NE(dst, nullptr);
+                ASSERT_EQ(src->ConvertAlphaFormat(*dst, toPremul), SUCCESS);
+                results[i] = GetRgbaPixels(*dst);
+            }
+            EXPECT_EQ(results[0], results[1]) << size.width << "x" << size.height;
+        }
+    }
+    GTEST_LOG_(INFO) << "PixelMapTest: AlphaKernelTest002 end";
+}
+
+static std::unique_ptr<PixelMap> ConstructIndexedPixmap(int32_t width, int32_t height, PixelFormat format)
+{
+    InitializationOptions opts;
+    opts.size.width = width;
+    opts.size.height = height;
+    opts.pixelFormat = format;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    opts.editable = true;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(opts);
+    if (pixelMap == nullptr) {
+        return nullptr;
+    }
+    // Every pixel holds its own index, so any misplaced pixel changes the bytes.
+    std::vector<uint8_t> pixels(pixelMap->GetByteCount());
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint8_t>((i / pixelMap->GetPixelBytes()) * 7 + i % pixelMap->GetPixelBytes());
+    }
+    if (pixelMap->WritePixels(pixels.data(), pixels.size()) != SUCCESS) {
+        return nullptr;
+    }
+    return pixelMap;
+}
+
+// dst(dstX, dstY) of a clockwise quarter turn is src(dstY, height - 1 - dstX).
+static bool IsRotated90(PixelMap &src, PixelMap &dst)
+{
+    int32_t width = src.GetWidth();
+    int32_t height = src.GetHeight();
+    if (dst.GetWidth() != height || dst.GetHeight() != width) {
+        return false;
+    }
+    size_t pixelBytes = static_cast<size_t>(src.GetPixelBytes());
+    for (int32_t y = 0; y < dst.GetHeight(); y++) {
+        for (int32_t x = 0; x < dst.GetWidth(); x++) {
+            const uint8_t *dstPixel = dst.GetPixels() + y * dst.GetRowStride() + x * pixelBytes;
+            const uint8_t *srcPixel = src.GetPixels() + (height - 1 - x) * src.GetRowStride() + y * pixelBytes;
+            if (memcmp(dstPixel, srcPixel, pixelBytes) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @tc.name: TransformKernelTest001
+ * @tc.desc: rotate by right angles on a non square RGBA_8888 map moves every pixel exactly, four turns restore it.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, TransformKernelTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: TransformKernelTest001 start";
+    const int32_t width = 301;
+    const int32_t height = 97;
+    std::unique_ptr<PixelMap> origin = ConstructIndexedPixmap(width, height, PixelFormat::RGBA_8888);
+    ASSERT_NE(origin, nullptr);
+    std::unique_ptr<PixelMap> pixelMap = ConstructIndexedPixmap(width, height, PixelFormat::RGBA_8888);
+    ASSERT_NE(pixelMap, nullptr);
+    pixelMap->rotate(90);
+    EXPECT_TRUE(IsRotated90(*origin, *pixelMap));
+    pixelMap->rotate(-90);
+    EXPECT_TRUE(origin->IsSameImage(*pixelMap));
+    pixelMap->rotate(270);
+    pixelMap->rotate(180);
+    EXPECT_TRUE(IsRotated90(*origin, *pixelMap));
+    pixelMap->rotate(450);
+    pixelMap->flip(true, true);
+    EXPECT_TRUE(origin->IsSameImage(*pixelMap));
+    GTEST_LOG_(INFO) << "PixelMapTest: TransformKernelTest001 end";
+}
+
+/**
+ * @tc.name: TransformKernelTest002
+ * @tc.desc: flips and in place quarter turns of a square RGBA_F16 map are exact.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, TransformKernelTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: TransformKernelTest002 start";
+    const int32_t side = 67;
+    std::unique_ptr<PixelMap> origin = ConstructIndexedPixmap(side, side, PixelFormat::RGBA_F16);
+    ASSERT_NE(origin, nullptr);
+    std::unique_ptr<PixelMap> pixelMap = ConstructIndexedPixmap(side, side, PixelFormat::RGBA_F16);
+    ASSERT_NE(pixelMap, nullptr);
+    const uint8_t *pixels = pixelMap->GetPixels();
+    pixelMap->rotate(90);
+    EXPECT_EQ(pixelMap->GetPixels(), pixels);
+    EXPECT_TRUE(IsRotated90(*origin, *pixelMap));
+    pixelMap->rotate(270);
+    EXPECT_TRUE(origin->IsSameImage(*pixelMap));
+
+    size_t pixelBytes = static_cast<size_t>(origin->GetPixelBytes());
+    pixelMap->flip(true, false);
+    const uint8_t *first = origin->GetPixels();
+    const uint8_t *mirrored = pixelMap->GetPixels() + (side - 1) * pixelBytes;
+    EXPECT_EQ(memcmp(first, mirrored, pixelBytes), 0);
+    pixelMap->flip(true, false);
+    pixelMap->flip(false, true);
+    mirrored = pixelMap->GetPixels() + (side - 1) * pixelMap->GetRowStride();
+    EXPECT_EQ(memcmp(first, mirrored, pixelBytes), 0);
+    pixelMap->flip(false, true);
+    EXPECT_TRUE(origin->IsSameImage(*pixelMap));
+    GTEST_LOG_(INFO) << "PixelMapTest: TransformKernelTest002 end";
+}
+
+/**
+ * @tc.name: ApplyTransformTest001
+ * @tc.desc: a fused crop, rotate, flip and scale chain matches the same edits applied one by one.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, ApplyTransformTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest001 start";
+    const int32_t width = 120;
+    const int32_t height = 80;
+    std::unique_ptr<PixelMap> sequential = ConstructIndexedPixmap(width, height, PixelFormat::RGBA_8888);
+    ASSERT_NE(sequential, nullptr);
+    std::unique_ptr<PixelMap> fused = ConstructIndexedPixmap(width, height, PixelFormat::RGBA_8888);
+    ASSERT_NE(fused, nullptr);
+    Rect rect = {10, 5, 60, 40};
+    ASSERT_EQ(sequential->crop(rect), SUCCESS);
+    sequential->rotate(90);
+    sequential->flip(true, false);
+    sequential->scale(2.0f, 2.0f);
+
+    PixelMapTransform transform;
+    transform.Crop(rect).Rotate(90).Flip(true, false).Scale(2.0f, 2.0f);
+    ASSERT_EQ(fused->ApplyTransform(transform), SUCCESS);
+    EXPECT_EQ(fused->GetWidth(), 80);
+    EXPECT_EQ(fused->GetHeight(), 120);
+    EXPECT_TRUE(sequential->IsSameImage(*fused));
+
+    std::unique_ptr<PixelMap> invalid = ConstructIndexedPixmap(width, height, PixelFormat::RGBA_8888);
+    ASSERT_NE(invalid, nullptr);
+    PixelMapTransform outside;
+    outside.Rotate(90).Crop(rect).Crop({0, 0, 61, 10});
+    EXPECT_EQ(invalid->ApplyTransform(outside), ERR_IMAGE_CROP);
+    EXPECT_EQ(invalid->GetWidth(), width);
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest001 end";
+}
+
+/**
+ * @tc.name: ApplyTransformTest002
+ * @tc.desc: ApplyTransform converts the pixel format in the same pass.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, ApplyTransformTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest002 start";
+    std::unique_ptr<PixelMap> pixelMap = ConstructIndexedPixmap(64, 48, PixelFormat::RGBA_8888);
+    ASSERT_NE(pixelMap, nullptr);
+    PixelMapTransform transform;
+    transform.Scale(0.5f, 0.5f).SetPixelFormat(PixelFormat::RGB_565);
+    ASSERT_EQ(pixelMap->ApplyTransform(transform), SUCCESS);
+    EXPECT_EQ(pixelMap->GetWidth(), 32);
+    EXPECT_EQ(pixelMap->GetHeight(), 24);
+    EXPECT_EQ(pixelMap->GetPixelFormat(), PixelFormat::RGB_565);
+    EXPECT_EQ(pixelMap->GetPixelBytes(), 2);
+    EXPECT_EQ(pixelMap->GetAlphaType(), AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest002 end";
+}
 }
 }
@@ -15,6 +15,7 @@
 
 #define private public
 #define protected public
+#include <cstdlib>
 #include <gtest/gtest.h>
 #include "ext_pixel_convert.h"
 #include "ext_wstream.h"
@@ -25,6 +26,8 @@
 #include "mock_data_stream.h"
 #include "mock_skw_stream.h"
 #include "file_source_stream.h"
+#include "hdr_gainmap_decomposer.h"
+#include "image_source.h"
 
 using namespace testing::ext;
 using namespace OHOS::Media;
@@ -42,6 +45,36 @@ const static string ENCODED_FORMAT_KEY = "EncodedFormat";
 const static string SUPPORT_SCALE_KEY = "SupportScale";
 const static string SUPPORT_CROP_KEY = "SupportCrop";
 const static string EXT_SHAREMEM_NAME = "EXT RawData";
+constexpr static int32_t NUM_2 = 2;
+constexpr static int32_t NUM_3 = 3;
+constexpr static int32_t HDR_REGION_WIDTH = 8;
+constexpr static int32_t HDR_TEST_HEIGHT = 4;
+constexpr static int32_t JPEG_REGION_WIDTH = 32;
+constexpr static uint32_t RGB_CHANNELS = 3;
+constexpr static uint32_t RGBA_CHANNELS = 4;
+constexpr static uint32_t HDR_1010102_BYTES = 4;
+constexpr static uint32_t HDR_1010102_OPAQUE = 0xc0000000;
+constexpr static uint32_t SHIFT_10 = 10;
+constexpr static uint32_t SHIFT_20 = 20;
+constexpr static uint32_t P010_SAMPLE_BYTES = 2;
+constexpr static uint32_t P010_SHIFT = 6;
+constexpr static uint32_t MAX_10BIT_CODE = 1023;
+constexpr static uint32_t UV_NEUTRAL = 512;
+constexpr static uint32_t LIMIT_Y_BLACK = 64;
+constexpr static uint32_t LIMIT_Y_MID = 502;
+constexpr static uint32_t LIMIT_Y_WHITE = 940;
+constexpr static uint32_t LIMIT_UV_MAX = 960;
+// PQ code of SDR white (203 nits) and the HLG code at the transfer knee.
+constexpr static uint32_t PQ_CODE_SDR_WHITE = 594;
+constexpr static uint32_t HLG_CODE_KNEE = 512;
+// sRGB base values of those codes: the PQ one through the highlight knee, the HLG one at a quarter of SDR white.
+constexpr static int32_t PQ_SDR_WHITE_BASE = 247;
+constexpr static int32_t HLG_KNEE_BASE = 137;
+constexpr static int32_t BASE_TOLERANCE = 1;
+constexpr static uint8_t JPEG_TOLERANCE = 4;
+constexpr static float PQ_PEAK_NITS = 10000.0f;
+constexpr static float HLG_PEAK_NITS = 1000.0f;
+constexpr static float PEAK_TOLERANCE = 0.01f;
 class ExtDecoderTest : public testing::Test {
 public:
     ExtDecoderTest() {}
@@ -1119,5 +1152,256 @@ HWTEST_F(ExtDecoderTest, EncodeSdrImageTest001, TestSize.Level3)
     ASSERT_EQ(ret, IMAGE_RESULT_CREATE_SURFAC_FAILED);
     GTEST_LOG_(INFO) << "ExtDecoderTest: EncodeSdrImageTest001 end";
 }
+
+// Heap backed HDR pixel map with zeroed pixels, as handed to the CPU dual layer encoder.
+static std::unique_ptr<Media::PixelMap> CreateHeapHdrPixelMap(Media::PixelFormat format, int32_t width, int32_t height)
+{
+    Media::ImageInfo info;
+    info.size = {width, height};
+    info.pixelFormat = format;
+    info.alphaType = Media::AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::unique_ptr<Media::PixelMap> pixelMap = std::make_unique<Media::PixelMap>();
+    if (pixelMap->SetImageInfo(info) != SUCCESS) {
+        return nullptr;
+    }
+    uint32_t pixelCount = static_cast<uint32_t>(width * height);
+    uint32_t size = format == Media::PixelFormat::RGBA_1010102 ? pixelCount * HDR_1010102_BYTES :
+        pixelCount * P010_SAMPLE_BYTES + pixelCount * P010_SAMPLE_BYTES / NUM_2;
+    void* buffer = calloc(size, 1);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    pixelMap->SetPixelsAddr(buffer, nullptr, size, AllocatorType::HEAP_ALLOC, nullptr);
+    return pixelMap;
+}
+
+// Splits the width into equal column regions, region i gets the grey 10 bit code codes[i].
+static void FillRgba1010102Regions(Media::PixelMap& pixelMap, const std::vector<uint32_t>& codes)
+{
+    uint32_t* pixels = static_cast<uint32_t*>(pixelMap.GetWritablePixels());
+    uint32_t width = static_cast<uint32_t>(pixelMap.GetWidth());
+    uint32_t regionWidth = width / codes.size();
+    for (int32_t y = 0; y < pixelMap.GetHeight(); y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t code = codes[x / regionWidth];
+            pixels[y * width + x] = code | (code << SHIFT_10) | (code << SHIFT_20) | HDR_1010102_OPAQUE;
+        }
+    }
+}
+
+struct P010Block {
+    uint32_t y;
+    uint32_t cb;
+    uint32_t cr;
+};
+
+// Splits the width into equal column regions of whole chroma blocks, region i gets the 10 bit samples blocks[i].
+static void FillP010Regions(Media::PixelMap& pixelMap, const std::vector<P010Block>& blocks)
+{
+    uint16_t* samples = static_cast<uint16_t*>(pixelMap.GetWritablePixels());
+    uint32_t width = static_cast<uint32_t>(pixelMap.GetWidth());
+    uint32_t height = static_cast<uint32_t>(pixelMap.GetHeight());
+    uint32_t regionWidth = width / blocks.size();
+    uint32_t cbIndex = pixelMap.GetPixelFormat() == Media::PixelFormat::YCBCR_P010 ? 0 : 1;
+    uint16_t* uvPlane = samples + width * height;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const P010Block& block = blocks[x / regionWidth];
+            samples[y * width + x] = static_cast<uint16_t>(block.y << P010_SHIFT);
+            uint16_t* uv = uvPlane + (y / NUM_2) * width + (x / NUM_2) * NUM_2;
+            uv[cbIndex] = static_cast<uint16_t>(block.cb << P010_SHIFT);
+            uv[1 - cbIndex] = static_cast<uint16_t>(block.cr << P010_SHIFT);
+        }
+    }
+}
+
+static const uint8_t* GetBasePixel(const HdrDecomposeResult& result, int32_t x, int32_t y)
+{
+    return result.base.data() + (y * result.width + x) * RGBA_CHANNELS;
+}
+
+static uint8_t GetGain(const HdrDecomposeResult& result, int32_t x, int32_t y)
+{
+    return result.gainmap[(y * result.gainmapWidth + x) * RGBA_CHANNELS];
+}
+
+/**
+@tc.name: HdrGainmapDecomposeTest001
+@tc.desc: Decompose heap RGBA_1010102 PQ greys into known base and gainmap values
+@tc.type: FUNC
+*/
+HWTEST_F(ExtDecoderTest, HdrGainmapDecomposeTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest001 start";
+    std::unique_ptr<Media::PixelMap> pixelMap =
+        CreateHeapHdrPixelMap(Media::PixelFormat::RGBA_1010102, HDR_REGION_WIDTH * NUM_3, HDR_TEST_HEIGHT);
+    ASSERT_NE(pixelMap, nullptr);
+    FillRgba1010102Regions(*pixelMap, {0, PQ_CODE_SDR_WHITE, MAX_10BIT_CODE});
+    HdrDecomposeOptions options;
+    options.transfer = HdrTransfer::PQ;
+    HdrDecomposeResult result;
+    ASSERT_EQ(HdrGainmapDecomposer::Decompose(pixelMap.get(), options, result), SUCCESS);
+    ASSERT_EQ(result.gainmapWidth, result.width / NUM_2);
+    ASSERT_EQ(result.gainmapHeight, result.height / NUM_2);
+    for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+        ASSERT_EQ(GetBasePixel(result, 0, 0)[c], 0);
+        ASSERT_NEAR(GetBasePixel(result, HDR_REGION_WIDTH, 0)[c], PQ_SDR_WHITE_BASE, BASE_TOLERANCE);
+        ASSERT_EQ(GetBasePixel(result, HDR_REGION_WIDTH * NUM_2, 0)[c], UINT8_MAX);
+    }
+    ASSERT_EQ(GetBasePixel(result, 0, 0)[RGB_CHANNELS], UINT8_MAX);
+    // Black has no gain and the PQ peak the most, whatever the quantisation range in between.
+    ASSERT_EQ(GetGain(result, 0, 0), 0);
+    ASSERT_EQ(GetGain(result, HDR_REGION_WIDTH, 0), UINT8_MAX);
+    ASSERT_GT(GetGain(result, HDR_REGION_WIDTH / NUM_2, 0), 0);
+    ASSERT_LT(GetGain(result, HDR_REGION_WIDTH / NUM_2, 0), UINT8_MAX);
+    ASSERT_NEAR(result.peakNits, PQ_PEAK_NITS, PQ_PEAK_NITS * PEAK_TOLERANCE);
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest001 end";
+}
+
+/**
+@tc.name: HdrGainmapDecomposeTest002
+@tc.desc: Decompose heap RGBA_1010102 HLG greys through the HLG transfer, not the PQ one
+@tc.type: FUNC
+*/
+HWTEST_F(ExtDecoderTest, HdrGainmapDecomposeTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest002 start";
+    std::unique_ptr<Media::PixelMap> pixelMap =
+        CreateHeapHdrPixelMap(Media::PixelFormat::RGBA_1010102, HDR_REGION_WIDTH * NUM_3, HDR_TEST_HEIGHT);
+    ASSERT_NE(pixelMap, nullptr);
+    FillRgba1010102Regions(*pixelMap, {0, HLG_CODE_KNEE, MAX_10BIT_CODE});
+    HdrDecomposeOptions options;
+    options.transfer = HdrTransfer::HLG;
+    HdrDecomposeResult result;
+    ASSERT_EQ(HdrGainmapDecomposer::Decompose(pixelMap.get(), options, result), SUCCESS);
+    for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+        ASSERT_EQ(GetBasePixel(result, 0, 0)[c], 0);
+        ASSERT_NEAR(GetBasePixel(result, HDR_REGION_WIDTH, 0)[c], HLG_KNEE_BASE, BASE_TOLERANCE);
+        ASSERT_EQ(GetBasePixel(result, HDR_REGION_WIDTH * NUM_2, 0)[c], UINT8_MAX);
+    }
+    ASSERT_EQ(GetGain(result, HDR_REGION_WIDTH, 0), UINT8_MAX);
+    ASSERT_NEAR(result.peakNits, HLG_PEAK_NITS, HLG_PEAK_NITS * PEAK_TOLERANCE);
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest002 end";
+}
+
+/**
+@tc.name: HdrGainmapDecomposeTest003
+@tc.desc: Decompose heap limit range P010 in both chroma orders through the BT.2020 YUV matrix
+@tc.type: FUNC
+*/
+HWTEST_F(ExtDecoderTest, HdrGainmapDecomposeTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest003 start";
+    // Limit range black, white, a Cr only and a Cb only colour, one chroma block each.
+    const std::vector<P010Block> blocks = {
+        {LIMIT_Y_BLACK, UV_NEUTRAL, UV_NEUTRAL},
+        {LIMIT_Y_WHITE, UV_NEUTRAL, UV_NEUTRAL},
+        {LIMIT_Y_MID, UV_NEUTRAL, LIMIT_UV_MAX},
+        {LIMIT_Y_MID, LIMIT_UV_MAX, UV_NEUTRAL},
+    };
+    const int32_t width = static_cast<int32_t>(NUM_2 * blocks.size());
+    HdrDecomposeOptions options;
+    options.transfer = HdrTransfer::PQ;
+    options.limitRange = true;
+    HdrDecomposeResult results[NUM_2];
+    const Media::PixelFormat formats[NUM_2] = {Media::PixelFormat::YCBCR_P010, Media::PixelFormat::YCRCB_P010};
+    for (int32_t i = 0; i < NUM_2; i++) {
+        std::unique_ptr<Media::PixelMap> pixelMap = CreateHeapHdrPixelMap(formats[i], width, NUM_2);
+        ASSERT_NE(pixelMap, nullptr);
+        FillP010Regions(*pixelMap, blocks);
+        ASSERT_EQ(HdrGainmapDecomposer::Decompose(pixelMap.get(), options, results[i]), SUCCESS);
+    }
+    const HdrDecomposeResult& result = results[0];
+    ASSERT_EQ(result.base, results[1].base);
+    ASSERT_EQ(result.gainmap, results[1].gainmap);
+    for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+        ASSERT_EQ(GetBasePixel(result, 0, 0)[c], 0);
+        ASSERT_EQ(GetBasePixel(result, NUM_2, 0)[c], UINT8_MAX);
+    }
+    const uint8_t* red = GetBasePixel(result, NUM_2 * NUM_2, 0);
+    ASSERT_EQ(red[0], UINT8_MAX);
+    ASSERT_EQ(red[1], 0);
+    ASSERT_LT(red[NUM_2], red[0]);
+    const uint8_t* blue = GetBasePixel(result, NUM_2 * NUM_3, 0);
+    ASSERT_EQ(blue[0], 0);
+    ASSERT_LT(blue[1], blue[NUM_2]);
+    ASSERT_EQ(blue[NUM_2], UINT8_MAX);
+    ASSERT_EQ(GetGain(result, 0, 0), 0);
+    ASSERT_EQ(GetGain(result, 1, 0), UINT8_MAX);
+    ASSERT_NEAR(result.peakNits, PQ_PEAK_NITS, PQ_PEAK_NITS * PEAK_TOLERANCE);
+
+    // Read as full range the limit range black lifts above zero.
+    std::unique_ptr<Media::PixelMap> pixelMap = CreateHeapHdrPixelMap(formats[0], width, NUM_2);
+    ASSERT_NE(pixelMap, nullptr);
+    FillP010Regions(*pixelMap, blocks);
+    options.limitRange = false;
+    HdrDecomposeResult fullRange;
+    ASSERT_EQ(HdrGainmapDecomposer::Decompose(pixelMap.get(), options, fullRange), SUCCESS);
+    ASSERT_GT(GetBasePixel(fullRange, 0, 0)[0], 0);
+    GTEST_LOG_(INFO) << "ExtDecoderTest: HdrGainmapDecomposeTest003 end";
+}
+
+class VectorOutputStream : public OutputDataStream {
+public:
+    bool Write(const uint8_t* buffer, uint32_t size) override
+    {
+        data.insert(data.end(), buffer, buffer + size);
+        return true;
+    }
+    std::vector<uint8_t> data;
+};
+
+/**
+@tc.name: EncodeDualVividByCpuTest001
+@tc.desc: Encode heap RGBA_1010102 and P010 pixel maps on the CPU and decode the dual layer jpeg base image
+@tc.type: FUNC
+*/
+HWTEST_F(ExtDecoderTest, EncodeDualVividByCpuTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExtDecoderTest: EncodeDualVividByCpuTest001 start";
+    const Media::PixelFormat formats[NUM_2] = {Media::PixelFormat::RGBA_1010102, Media::PixelFormat::YCBCR_P010};
+    for (Media::PixelFormat format : formats) {
+        std::unique_ptr<Media::PixelMap> pixelMap =
+            CreateHeapHdrPixelMap(format, JPEG_REGION_WIDTH * NUM_2, JPEG_REGION_WIDTH);
+        ASSERT_NE(pixelMap, nullptr);
+        if (format == Media::PixelFormat::RGBA_1010102) {
+            FillRgba1010102Regions(*pixelMap, {0, MAX_10BIT_CODE});
+        } else {
+            FillP010Regions(*pixelMap, {{0, UV_NEUTRAL, UV_NEUTRAL}, {MAX_10BIT_CODE, UV_NEUTRAL, UV_NEUTRAL}});
+        }
+        ExtEncoder extEncoder;
+        extEncoder.pixelmap_ = pixelMap.get();
+        extEncoder.encodeFormat_ = SkEncodedImageFormat::kJPEG;
+        VectorOutputStream output;
+        ExtWStream outputStream(&output);
+        ASSERT_EQ(extEncoder.EncodeDualVividByCpu(outputStream), SUCCESS);
+        ASSERT_FALSE(output.data.empty());
+
+        uint32_t errorCode = 0;
+        SourceOptions sourceOpts;
+        std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(output.data.data(),
+            static_cast<uint32_t>(output.data.size()), sourceOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(imageSource, nullptr);
+        ASSERT_TRUE(imageSource->IsHdrImage());
+        DecodeOptions decodeOpts;
+        decodeOpts.desiredPixelFormat = Media::PixelFormat::RGBA_8888;
+        std::unique_ptr<Media::PixelMap> base = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(base, nullptr);
+        ASSERT_EQ(base->GetWidth(), pixelMap->GetWidth());
+        ASSERT_EQ(base->GetHeight(), pixelMap->GetHeight());
+        // Sample the middle of each region, away from the jpeg ringing at the edge.
+        const uint8_t* pixels = base->GetPixels();
+        int32_t row = (JPEG_REGION_WIDTH / NUM_2) * base->GetRowStride();
+        const uint8_t* black = pixels + row + (JPEG_REGION_WIDTH / NUM_2) * RGBA_CHANNELS;
+        const uint8_t* white = pixels + row + (JPEG_REGION_WIDTH + JPEG_REGION_WIDTH / NUM_2) * RGBA_CHANNELS;
+        for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+            ASSERT_LE(black[c], JPEG_TOLERANCE);
+            ASSERT_GE(white[c], UINT8_MAX - JPEG_TOLERANCE);
+        }
+    }
+    GTEST_LOG_(INFO) << "ExtDecoderTest: EncodeDualVividByCpuTest001 end";
+}
 }
 }
\ No newline at end of file
@@ -13,6 +13,10 @@
  * limitations under the License.
  */
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
 #include "gif_encoder.h"
 #include "image_source.h"
 #include "buffer_packer_stream.h"
@@ -22,6 +26,75 @@ using namespace testing::ext;
 using namespace OHOS::Media;
 namespace OHOS {
 namespace ImagePlugin {
+static constexpr int32_t ANIMATION_WIDTH = 64;
+static constexpr int32_t ANIMATION_HEIGHT = 48;
+static constexpr uint32_t ANIMATION_FRAMES = 4;
+static constexpr uint32_t ANIMATION_BUFFER_SIZE = 256 * 1024;
+static constexpr int32_t SPRITE_SIZE = 8;
+static constexpr uint32_t RGBA_BYTES = 4;
+// palette quantization of the gradient moves a channel by a few levels, a misplaced sprite by more than 100
+static constexpr int32_t GIF_CHANNEL_TOLERANCE = 32;
+
+// gradient background with a small square moving to the right, so only a strip changes between frames
+static std::unique_ptr<PixelMap> CreateAnimationFrame(uint32_t frame)
+{
+    std::vector<uint32_t> colors(ANIMATION_WIDTH * ANIMATION_HEIGHT);
+    for (int32_t y = 0; y < ANIMATION_HEIGHT; y++) {
+        for (int32_t x = 0; x < ANIMATION_WIDTH; x++) {
+            bool inSprite = x >= static_cast<int32_t>(frame) * SPRITE_SIZE &&
+                x < static_cast<int32_t>(frame + 1) * SPRITE_SIZE && y < SPRITE_SIZE;
+            colors[y * ANIMATION_WIDTH + x] = inSprite ? 0xFFFFFF00 :
+                (0xFF000000 | (static_cast<uint32_t>(x * 4) << 16) | (static_cast<uint32_t>(y * 4) << 8));
+        }
+    }
+    InitializationOptions opts;
+    opts.size.width = ANIMATION_WIDTH;
+    opts.size.height = ANIMATION_HEIGHT;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    return PixelMap::Create(colors.data(), colors.size(), opts);
+}
+
+static int64_t EncodeAnimation(bool optimizeFrames, std::vector<uint8_t> &output)
+{
+    std::vector<std::unique_ptr<PixelMap>> frames;
+    for (uint32_t i = 0; i < ANIMATION_FRAMES; i++) {
+        frames.emplace_back(CreateAnimationFrame(i));
+        if (frames.back() == nullptr) {
+            return -1;
+        }
+    }
+    output.resize(ANIMATION_BUFFER_SIZE);
+    BufferPackerStream stream(output.data(), output.size());
+    PlEncodeOptions plOpts;
+    plOpts.optimizeFrames = optimizeFrames;
+    GifEncoder gifEncoder;
+    gifEncoder.StartEncode(stream, plOpts);
+    for (auto &frame : frames) {
+        gifEncoder.AddImage(*frame);
+    }
+    if (gifEncoder.FinalizeEncode() != SUCCESS) {
+        return -1;
+    }
+    return stream.BytesWritten();
+}
+
+// largest per channel difference between two RGBA_8888 pixel maps, -1 when the sizes differ
+static int32_t MaxChannelDiff(PixelMap &decoded, PixelMap &expected)
+{
+    if (decoded.GetWidth() != expected.GetWidth() || decoded.GetHeight() != expected.GetHeight()) {
+        return -1;
+    }
+    int32_t maxDiff = 0;
+    for (int32_t y = 0; y < expected.GetHeight(); y++) {
+        const uint8_t *decodedRow = decoded.GetPixels() + y * decoded.GetRowStride();
+        const uint8_t *expectedRow = expected.GetPixels() + y * expected.GetRowStride();
+        for (int32_t i = 0; i < expected.GetWidth() * static_cast<int32_t>(RGBA_BYTES); i++) {
+            maxDiff = std::max(maxDiff, std::abs(static_cast<int32_t>(decodedRow[i]) - expectedRow[i]));
+        }
+    }
+    return maxDiff;
+}
+
 class GifEncoderTest : public testing::Test {
 public:
     GifEncoderTest() {}
@@ -161,5 +234,50 @@ HWTEST_F(GifEncoderTest, Write001, TestSize.Level3)
     GTEST_LOG_(INFO) << "GifEncoderTest: Write001 end";
 }
 
+/**
+ * @tc.name: FinalizeEncode003
+ * @tc.desc: frames encoded with optimizeFrames are smaller and decode to composites matching the input frames
+ * @tc.type: FUNC
+ */
+HWTEST_F(GifEncoderTest, FinalizeEncode003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncode003 start";
+    std::vector<uint8_t> fullFrames;
+    std::vector<uint8_t> deltaFrames;
+    int64_t fullSize = EncodeAnimation(false, fullFrames);
+    int64_t deltaSize = EncodeAnimation(true, deltaFrames);
+    ASSERT_GT(fullSize, 0);
+    ASSERT_GT(deltaSize, 0);
+    ASSERT_LT(deltaSize, fullSize);
+    fullFrames.resize(fullSize);
+    deltaFrames.resize(deltaSize);
+
+    const std::pair<const char *, const std::vector<uint8_t> *> encodings[] = {{"full", &fullFrames},
+        {"delta", &deltaFrames}};
+    for (const auto &encoding : encodings) {
+        uint32_t errorCode = 0;
+        SourceOptions opts;
+        auto imageSource = ImageSource::CreateImageSource(encoding.second->data(),
+            static_cast<uint32_t>(encoding.second->size()), opts, errorCode);
+        ASSERT_NE(imageSource, nullptr);
+        ASSERT_EQ(imageSource->GetFrameCount(errorCode), ANIMATION_FRAMES);
+        ASSERT_EQ(errorCode, SUCCESS);
+        // every decoded frame is the composite of the frames so far, so it has to match the input frame
+        for (uint32_t i = 0; i < ANIMATION_FRAMES; i++) {
+            std::unique_ptr<PixelMap> expected = CreateAnimationFrame(i);
+            ASSERT_NE(expected, nullptr);
+            DecodeOptions decodeOpts;
+            decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+            std::unique_ptr<PixelMap> decoded = imageSource->CreatePixelMap(i, decodeOpts, errorCode);
+            ASSERT_EQ(errorCode, SUCCESS);
+            ASSERT_NE(decoded, nullptr);
+            int32_t diff = MaxChannelDiff(*decoded, *expected);
+            ASSERT_GE(diff, 0);
+            EXPECT_LE(diff, GIF_CHANNEL_TOLERANCE) << encoding.first << " frame " << i;
+        }
+    }
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncode003 end";
+}
+
 }
 }
\ No newline at end of file
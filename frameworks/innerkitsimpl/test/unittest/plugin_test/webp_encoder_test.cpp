@@ -14,6 +14,8 @@
  */
 #define private public
 #define protected public
+#include <algorithm>
+#include <cstring>
 #include <gtest/gtest.h>
 #include "webp_encoder.h"
 #include "image_source.h"
@@ -1004,5 +1006,283 @@ HWTEST_F(WebpEncoderTest, DoTransformGrayTest001, TestSize.Level3)
     delete pixelMap.data_;
     GTEST_LOG_(INFO) << "WebpEncoderTest: DoTransformGrayTest001 end";
 }
+
+static std::unique_ptr<PixelMap> ConstructPatternPixelMap(PixelFormat format, AlphaType alphaType,
+    uint8_t seed = 0, int32_t side = 96)
+{
+    constexpr uint32_t bytesPerPixel = 4;
+    constexpr uint8_t opaqueAlpha = 255;
+    Media::InitializationOptions opts;
+    opts.pixelFormat = format;
+    opts.alphaType = alphaType;
+    opts.size.width = side;
+    opts.size.height = side;
+    opts.editable = true;
+    auto pixelMap = Media::PixelMap::Create(opts);
+    if (pixelMap == nullptr) {
+        return nullptr;
+    }
+    auto pixels = static_cast<uint8_t *>(pixelMap->GetWritablePixels());
+    for (int32_t y = 0; y < side; y++) {
+        uint8_t *row = pixels + y * pixelMap->GetRowStride();
+        for (int32_t x = 0; x < side; x++) {
+            row[x * bytesPerPixel] = static_cast<uint8_t>(x * 3 + y + seed);
+            row[x * bytesPerPixel + 1] = static_cast<uint8_t>(y * 5);
+            row[x * bytesPerPixel + 2] = static_cast<uint8_t>(x ^ y);
+            row[x * bytesPerPixel + 3] = opaqueAlpha;
+        }
+    }
+    return pixelMap;
+}
+
+static std::unique_ptr<PixelMap> ConstructSolidPixelMap(int32_t side, const uint8_t (&rgba)[4])
+{
+    constexpr uint32_t bytesPerPixel = 4;
+    Media::InitializationOptions opts;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    opts.size.width = side;
+    opts.size.height = side;
+    opts.editable = true;
+    auto pixelMap = Media::PixelMap::Create(opts);
+    if (pixelMap == nullptr) {
+        return nullptr;
+    }
+    auto pixels = static_cast<uint8_t *>(pixelMap->GetWritablePixels());
+    for (int32_t y = 0; y < side; y++) {
+        uint8_t *row = pixels + y * pixelMap->GetRowStride();
+        for (int32_t x = 0; x < side; x++) {
+            memcpy(row + x * bytesPerPixel, rgba, bytesPerPixel);
+        }
+    }
+    return pixelMap;
+}
+
+static std::unique_ptr<PixelMap> EncodeAndDecode(WebpEncoder &webpEncoder, PixelMap &pixelMap,
+    PlEncodeOptions &plOpts)
+{
+    constexpr uint32_t minOutputSize = 256 * 1024;
+    uint32_t outputSize = std::max(minOutputSize, static_cast<uint32_t>(pixelMap.GetByteCount()) * 2);
+    auto outputData = std::make_unique<uint8_t[]>(outputSize);
+    BufferPackerStream stream(outputData.get(), outputSize);
+    if (webpEncoder.StartEncode(stream, plOpts) != SUCCESS || webpEncoder.AddImage(pixelMap) != SUCCESS ||
+        webpEncoder.FinalizeEncode() != SUCCESS) {
+        return nullptr;
+    }
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(),
+        static_cast<uint32_t>(stream.BytesWritten()), sourceOpts, errorCode);
+    if (imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    return imageSource->CreatePixelMap(decodeOpts, errorCode);
+}
+
+/**
+ * @tc.name: ImportDirectTest001
+ * @tc.desc: RGBA rows imported directly with a worker thread decode back to the same pixels
+ * @tc.type: FUNC
+ */
+HWTEST_F(WebpEncoderTest, ImportDirectTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "WebpEncoderTest: ImportDirectTest001 start";
+    // Larger than the 512x512 the encoder needs before it starts a worker thread.
+    constexpr int32_t side = 640;
+    auto pixelMap = ConstructPatternPixelMap(PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL, 0, side);
+    ASSERT_NE(pixelMap, nullptr);
+    WebpEncoder webpEncoder;
+    PlEncodeOptions plOpts;
+    plOpts.effort = 4;
+    plOpts.multiThread = true;
+    auto decoded = EncodeAndDecode(webpEncoder, *pixelMap, plOpts);
+    ASSERT_NE(decoded, nullptr);
+    ASSERT_EQ(decoded->GetWidth(), pixelMap->GetWidth());
+    ASSERT_EQ(decoded->GetHeight(), pixelMap->GetHeight());
+    for (int32_t y = 0; y < pixelMap->GetHeight(); y++) {
+        ASSERT_EQ(memcmp(decoded->GetPixels() + y * decoded->GetRowStride(),
+            pixelMap->GetPixels() + y * pixelMap->GetRowStride(), pixelMap->GetRowBytes()), 0);
+    }
+    GTEST_LOG_(INFO) << "WebpEncoderTest: ImportDirectTest001 end";
+}
+
+/**
+ * @tc.name: ImportConvertedTest001
+ * @tc.desc: premultiplied BGRA converted into the picture decodes back with red and blue swapped
+ * @tc.type: FUNC
+ */
+HWTEST_F(WebpEncoderTest, ImportConvertedTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "WebpEncoderTest: ImportConvertedTest001 start";
+    constexpr uint32_t bytesPerPixel = 4;
+    constexpr uint32_t blueOffset = 2;
+    auto pixelMap = ConstructPatternPixelMap(PixelFormat::BGRA_8888, AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
+    ASSERT_NE(pixelMap, nullptr);
+    WebpEncoder webpEncoder;
+    PlEncodeOptions plOpts;
+    auto decoded = EncodeAndDecode(webpEncoder, *pixelMap, plOpts);
+    ASSERT_NE(decoded, nullptr);
+    for (int32_t y = 0; y < pixelMap->GetHeight(); y++) {
+        const uint8_t *src = pixelMap->GetPixels() + y * pixelMap->GetRowStride();
+        const uint8_t *dst = decoded->GetPixels() + y * decoded->GetRowStride();
+        for (int32_t x = 0; x < pixelMap->GetWidth(); x++) {
+            const uint8_t *srcPixel = src + x * bytesPerPixel;
+            const uint8_t *dstPixel = dst + x * bytesPerPixel;
+            ASSERT_EQ(dstPixel[0], srcPixel[blueOffset]);
+            ASSERT_EQ(dstPixel[1], srcPixel[1]);
+            ASSERT_EQ(dstPixel[blueOffset], srcPixel[0]);
+            ASSERT_EQ(dstPixel[bytesPerPixel - 1], srcPixel[bytesPerPixel - 1]);
+        }
+    }
+    GTEST_LOG_(INFO) << "WebpEncoderTest: ImportConvertedTest001 end";
+}
+
+/**
+ * @tc.name: EncodeAnimationTest001
+ * @tc.desc: several pixel maps pack into an animated webp that decodes back frame by frame with its delays
+ * @tc.type: FUNC
+ */
+HWTEST_F(WebpEncoderTest, EncodeAnimationTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "WebpEncoderTest: EncodeAnimationTest001 start";
+    constexpr uint32_t frameCount = 3;
+    constexpr uint8_t seedStep = 40;
+    constexpr int32_t delayUnitMs = 10;
+    std::vector<std::unique_ptr<PixelMap>> frames;
+    for (uint32_t i = 0; i < frameCount; i++) {
+        frames.emplace_back(ConstructPatternPixelMap(PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_OPAQUE,
+            static_cast<uint8_t>(i * seedStep)));
+        ASSERT_NE(frames.back(), nullptr);
+    }
+    WebpEncoder webpEncoder;
+    PlEncodeOptions plOpts;
+    plOpts.numberHint = frameCount;
+    plOpts.delayTimes = { 5, 10, 20 };
+    constexpr uint32_t outputSize = 256 * 1024;
+    auto outputData = std::make_unique<uint8_t[]>(outputSize);
+    BufferPackerStream stream(outputData.get(), outputSize);
+    ASSERT_EQ(webpEncoder.StartEncode(stream, plOpts), SUCCESS);
+    for (auto &frame : frames) {
+        ASSERT_EQ(webpEncoder.AddImage(*frame), SUCCESS);
+    }
+    ASSERT_EQ(webpEncoder.FinalizeEncode(), SUCCESS);
+
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(),
+        static_cast<uint32_t>(stream.BytesWritten()), sourceOpts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    ASSERT_EQ(imageSource->GetFrameCount(errorCode), frameCount);
+    auto delayTimes = imageSource->GetDelayTime(errorCode);
+    ASSERT_NE(delayTimes, nullptr);
+    ASSERT_EQ(delayTimes->size(), frameCount);
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    auto decoded = imageSource->CreatePixelMapList(decodeOpts, errorCode);
+    ASSERT_NE(decoded, nullptr);
+    ASSERT_EQ(decoded->size(), frameCount);
+    for (uint32_t i = 0; i < frameCount; i++) {
+        ASSERT_EQ((*delayTimes)[i], plOpts.delayTimes[i] * delayUnitMs);
+        auto &frame = frames[i];
+        auto &result = (*decoded)[i];
+        ASSERT_EQ(result->GetWidth(), frame->GetWidth());
+        ASSERT_EQ(result->GetHeight(), frame->GetHeight());
+        for (int32_t y = 0; y < frame->GetHeight(); y++) {
+            ASSERT_EQ(memcmp(result->GetPixels() + y * result->GetRowStride(),
+                frame->GetPixels() + y * frame->GetRowStride(), frame->GetRowBytes()), 0);
+        }
+    }
+    GTEST_LOG_(INFO) << "WebpEncoderTest: EncodeAnimationTest001 end";
+}
+
+/**
+ * @tc.name: EncodeAnimationTest002
+ * @tc.desc: translucent frames blend over the canvas left by earlier frames, dispose-to-background clears it
+ * @tc.type: FUNC
+ */
+HWTEST_F(WebpEncoderTest, EncodeAnimationTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "WebpEncoderTest: EncodeAnimationTest002 start";
+    constexpr int32_t side = 16;
+    constexpr uint32_t frameCount = 3;
+    constexpr uint32_t alphaOffset = 3;
+    constexpr uint8_t disposalNone = 1;
+    constexpr uint8_t disposalBackground = 2;
+    constexpr uint8_t opaqueAlpha = 255;
+    constexpr uint8_t halfAlpha = 128;
+    constexpr uint8_t blendedAlpha = 192;
+    constexpr uint32_t opaqueRed = 0xFFFF0000;
+    constexpr uint32_t translucentBlue = 0x800000FF;
+    constexpr uint32_t translucentGreen = 0x8000FF00;
+    // green at alpha 128 over blue at alpha 128: alpha 192, green 170, blue 85
+    constexpr uint32_t blendedGreenOverBlue = 0xC000AA55;
+    WebpEncoder webpEncoder;
+    PlEncodeOptions plOpts;
+    plOpts.numberHint = frameCount;
+    plOpts.disposalTypes = { disposalBackground, disposalNone, disposalNone };
+
+    WebPPicture picture;
+    ASSERT_TRUE(WebPPictureInit(&picture));
+    picture.use_argb = 1;
+    picture.width = side;
+    picture.height = side;
+    ASSERT_TRUE(WebPPictureAlloc(&picture));
+    std::vector<uint32_t> canvas(static_cast<size_t>(side) * side, 0);
+    auto compose = [&webpEncoder, &picture, &canvas](uint32_t argb, uint8_t disposalType) {
+        for (int32_t y = 0; y < picture.height; y++) {
+            std::fill_n(picture.argb + y * picture.argb_stride, picture.width, argb);
+        }
+        webpEncoder.ComposeFrame(picture, canvas, disposalType);
+        return picture.argb[(picture.height - 1) * picture.argb_stride + picture.width - 1];
+    };
+    ASSERT_EQ(compose(opaqueRed, disposalBackground), opaqueRed);
+    ASSERT_EQ(std::count(canvas.begin(), canvas.end(), 0u), static_cast<std::ptrdiff_t>(canvas.size()));
+    ASSERT_EQ(compose(translucentBlue, disposalNone), translucentBlue);
+    ASSERT_EQ(compose(translucentGreen, disposalNone), blendedGreenOverBlue);
+    ASSERT_EQ(canvas.front(), blendedGreenOverBlue);
+    WebPPictureFree(&picture);
+
+    const uint8_t colors[frameCount][4] = {
+        { 255, 0, 0, opaqueAlpha }, { 0, 0, 255, halfAlpha }, { 0, 255, 0, halfAlpha },
+    };
+    std::vector<std::unique_ptr<PixelMap>> frames;
+    for (uint32_t i = 0; i < frameCount; i++) {
+        frames.emplace_back(ConstructSolidPixelMap(side, colors[i]));
+        ASSERT_NE(frames.back(), nullptr);
+    }
+    constexpr uint32_t outputSize = 256 * 1024;
+    auto outputData = std::make_unique<uint8_t[]>(outputSize);
+    BufferPackerStream stream(outputData.get(), outputSize);
+    WebpEncoder animEncoder;
+    ASSERT_EQ(animEncoder.StartEncode(stream, plOpts), SUCCESS);
+    for (auto &frame : frames) {
+        ASSERT_EQ(animEncoder.AddImage(*frame), SUCCESS);
+    }
+    ASSERT_EQ(animEncoder.FinalizeEncode(), SUCCESS);
+
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(),
+        static_cast<uint32_t>(stream.BytesWritten()), sourceOpts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    auto decoded = imageSource->CreatePixelMapList(decodeOpts, errorCode);
+    ASSERT_NE(decoded, nullptr);
+    ASSERT_EQ(decoded->size(), frameCount);
+    // Alpha and the absent red channel do not depend on whether the decoder premultiplies.
+    const uint8_t expectedAlpha[frameCount] = { opaqueAlpha, halfAlpha, blendedAlpha };
+    for (uint32_t i = 0; i < frameCount; i++) {
+        const uint8_t *pixel = (*decoded)[i]->GetPixels();
+        ASSERT_NE(pixel, nullptr);
+        ASSERT_EQ(pixel[alphaOffset], expectedAlpha[i]);
+        if (i > 0) {
+            ASSERT_EQ(pixel[0], 0);
+        }
+    }
+    GTEST_LOG_(INFO) << "WebpEncoderTest: EncodeAnimationTest002 end";
+}
 }
 }
\ No newline at end of file
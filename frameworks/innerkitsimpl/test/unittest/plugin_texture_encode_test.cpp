@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <securec.h>
 #include <sys/time.h>
+#include <vector>
 
 #include "astc_codec.h"
 #include "buffer_packer_stream.h"
@@ -839,6 +840,26 @@ HWTEST_F(PluginTextureEncodeTest, AstcEncoderTime_009, TestSize.Level3)
     ASSERT_EQ(AstcCodec::AstcSoftwareEncodeCore(param, &pixmapIn, nullptr), false);
 }
 
+/**
+ * @tc.name: AstcEncoderContextReuse001
+ * @tc.desc: repeated multithreaded encodes reuse pooled contexts and produce identical output
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginTextureEncodeTest, AstcEncoderContextReuse001, TestSize.Level3)
+{
+    TextureEncodeOptions param;
+    // 1024x1024 block 4x4 spans enough blocks to spread over several encode threads
+    ASSERT_TRUE(FillEncodeOptions(param, 1024, 1024, 4, HIGH_SPEED_PROFILE));
+    size_t bytesPerFile = static_cast<size_t>(param.width_) * param.height_ * BYTES_PER_PIXEL;
+    std::vector<uint8_t> pixMap(bytesPerFile);
+    SelfCreatePixMap(pixMap.data(), bytesPerFile, 0);
+    std::vector<uint8_t> firstOut(param.astcBytes);
+    std::vector<uint8_t> secondOut(param.astcBytes);
+    ASSERT_TRUE(AstcCodec::AstcSoftwareEncodeCore(param, pixMap.data(), firstOut.data()));
+    ASSERT_TRUE(AstcCodec::AstcSoftwareEncodeCore(param, pixMap.data(), secondOut.data()));
+    ASSERT_EQ(firstOut, secondOut);
+}
+
 #ifdef ASTC_CUSTOMIZED_ENABLE
 /**
  * @tc.name: AstcEncoderTime_010
@@ -782,5 +782,99 @@ HWTEST_F(RawDecoderTest, GetDataTest001, TestSize.Level3)
     ASSERT_EQ(result, piex::kFail);
     GTEST_LOG_(INFO) << "RawStreamTest: GetDataTest001 end";
 }
+/**
+ * @tc.name: RawSubStreamTest001
+ * @tc.desc: RawSubStream reads a sub-range of the source without copying it
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawDecoderTest, RawSubStreamTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "RawDecoderTest: RawSubStreamTest001 start";
+    const uint32_t size = 100;
+    const uint32_t offset = 10;
+    const uint32_t length = 20;
+    std::unique_ptr<uint8_t[]> data = std::make_unique<uint8_t[]>(size);
+    for (uint32_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i);
+    }
+    auto sourceStream = BufferSourceStream::CreateSourceStream(data.get(), size);
+    ASSERT_NE(sourceStream, nullptr);
+    RawSubStream subStream(*sourceStream, offset, length);
+    ASSERT_EQ(subStream.GetStreamSize(), length);
+    ASSERT_EQ(subStream.GetDataPtr(), sourceStream->GetDataPtr() + offset);
+
+    DataStreamBuffer buffer;
+    ASSERT_TRUE(subStream.Read(length + 1, buffer));
+    ASSERT_EQ(buffer.inputStreamBuffer, sourceStream->GetDataPtr() + offset);
+    ASSERT_EQ(buffer.dataSize, length);
+    ASSERT_EQ(subStream.Tell(), length);
+    ASSERT_FALSE(subStream.Read(1, buffer));
+
+    ASSERT_TRUE(subStream.Seek(length - 2));
+    uint8_t out[4] = {0};
+    uint32_t readSize = 0;
+    ASSERT_TRUE(subStream.Read(sizeof(out), out, sizeof(out), readSize));
+    ASSERT_EQ(readSize, 2);
+    ASSERT_EQ(out[0], offset + length - 2);
+    ASSERT_FALSE(subStream.Seek(length + 1));
+    GTEST_LOG_(INFO) << "RawDecoderTest: RawSubStreamTest001 end";
+}
+
+/**
+ * @tc.name: SelectPreviewTest001
+ * @tc.desc: Test of SelectPreview, the smallest preview covering desiredSize with the same aspect ratio wins
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawDecoderTest, SelectPreviewTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "RawDecoderTest: SelectPreviewTest001 start";
+    auto rawDecoder = std::make_shared<RawDecoder>();
+    Size desiredSize;
+    ASSERT_EQ(rawDecoder->SelectPreview(desiredSize), 0);
+
+    RawDecoder::RawPreview preview;
+    preview.size = {6000, 4000};
+    rawDecoder->previews_.push_back(preview);
+    preview.size = {1620, 1080};
+    rawDecoder->previews_.push_back(preview);
+    preview.size = {160, 120};
+    rawDecoder->previews_.push_back(preview);
+
+    ASSERT_EQ(rawDecoder->SelectPreview(desiredSize), 0);
+    desiredSize = {1200, 800};
+    ASSERT_EQ(rawDecoder->SelectPreview(desiredSize), 1);
+    desiredSize = {3000, 2000};
+    ASSERT_EQ(rawDecoder->SelectPreview(desiredSize), 0);
+    // the 4:3 thumbnail is letterboxed, it is never used for a 3:2 image
+    desiredSize = {150, 100};
+    ASSERT_EQ(rawDecoder->SelectPreview(desiredSize), 1);
+    GTEST_LOG_(INFO) << "RawDecoderTest: SelectPreviewTest001 end";
+}
+
+/**
+ * @tc.name: SelectPreviewTest002
+ * @tc.desc: Test of SelectPreview, a crop keeps the full size preview whatever desiredSize asks for
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawDecoderTest, SelectPreviewTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "RawDecoderTest: SelectPreviewTest002 start";
+    auto rawDecoder = std::make_shared<RawDecoder>();
+    RawDecoder::RawPreview preview;
+    preview.size = {6000, 4000};
+    rawDecoder->previews_.push_back(preview);
+    preview.size = {1620, 1080};
+    rawDecoder->previews_.push_back(preview);
+
+    PixelDecodeOptions opts;
+    opts.desiredSize = {1200, 800};
+    ASSERT_EQ(rawDecoder->SelectPreview(opts), 1);
+    // the crop rect is in full size preview coordinates and reaches past the smaller preview
+    opts.CropRect = {3000, 2000, 2400, 1600};
+    ASSERT_EQ(rawDecoder->SelectPreview(opts), 0);
+    opts.CropRect = {0, 0, 0, 0};
+    ASSERT_EQ(rawDecoder->SelectPreview(opts), 1);
+    GTEST_LOG_(INFO) << "RawDecoderTest: SelectPreviewTest002 end";
+}
 }
 }
\ No newline at end of file
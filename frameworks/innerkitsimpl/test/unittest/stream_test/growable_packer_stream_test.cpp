@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "growable_packer_stream.h"
+#include "image_packer.h"
+#include "image_source.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+namespace OHOS {
+namespace Multimedia {
+static const std::string IMAGE_INPUT_JPG_PATH = "/data/local/tmp/image/test.jpg";
+static constexpr uint32_t MAXSIZE = 200000;
+static constexpr uint32_t CHUNK_SIZE = 10000;
+static constexpr uint32_t PACK_MAXSIZE = 10 * 1024 * 1024;
+static constexpr uint8_t PACK_QUALITY = 90;
+class GrowablePackerStreamTest : public testing::Test {
+public:
+    GrowablePackerStreamTest() {}
+    ~GrowablePackerStreamTest() {}
+};
+
+/**
+ * @tc.name: GrowablePackerStreamTest001
+ * @tc.desc: Write grows the buffer up to maxSize and ReleaseBuffer hands over exactly the written bytes
+ * @tc.type: FUNC
+ */
+HWTEST_F(GrowablePackerStreamTest, GrowablePackerStreamTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GrowablePackerStreamTest: GrowablePackerStreamTest001 start";
+    std::vector<uint8_t> source(MAXSIZE);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i] = static_cast<uint8_t>(i);
+    }
+    GrowablePackerStream stream(MAXSIZE);
+    size_t capacity = 0;
+    ASSERT_TRUE(stream.GetCapicity(capacity));
+    ASSERT_EQ(capacity, MAXSIZE);
+    ASSERT_FALSE(stream.Write(nullptr, CHUNK_SIZE));
+    for (uint32_t offset = 0; offset < MAXSIZE; offset += CHUNK_SIZE) {
+        ASSERT_TRUE(stream.Write(source.data() + offset, CHUNK_SIZE));
+    }
+    ASSERT_FALSE(stream.Write(source.data(), 1));
+    ASSERT_EQ(stream.BytesWritten(), MAXSIZE);
+
+    int64_t size = 0;
+    GrowablePackerStream::Buffer buffer = stream.ReleaseBuffer(size);
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(size, MAXSIZE);
+    ASSERT_EQ(memcmp(buffer.get(), source.data(), size), 0);
+    ASSERT_EQ(stream.BytesWritten(), 0);
+    GTEST_LOG_(INFO) << "GrowablePackerStreamTest: GrowablePackerStreamTest001 end";
+}
+
+/**
+ * @tc.name: GrowablePackerStreamTest002
+ * @tc.desc: Packing into a growable stream produces the same bytes as packing into a fixed buffer
+ * @tc.type: FUNC
+ */
+HWTEST_F(GrowablePackerStreamTest, GrowablePackerStreamTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GrowablePackerStreamTest: GrowablePackerStreamTest002 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+
+    PackOption option;
+    option.format = "image/jpeg";
+    option.quality = PACK_QUALITY;
+    ImagePacker packer;
+    std::vector<uint8_t> fixed(PACK_MAXSIZE);
+    int64_t fixedSize = 0;
+    ASSERT_EQ(packer.StartPacking(fixed.data(), PACK_MAXSIZE, option), SUCCESS);
+    ASSERT_EQ(packer.AddImage(*pixelMap), SUCCESS);
+    ASSERT_EQ(packer.FinalizePacking(fixedSize), SUCCESS);
+
+    auto stream = std::make_unique<GrowablePackerStream>(PACK_MAXSIZE);
+    GrowablePackerStream *output = stream.get();
+    int64_t packedSize = 0;
+    ASSERT_EQ(packer.StartPacking(std::move(stream), option), SUCCESS);
+    ASSERT_EQ(packer.AddImage(*pixelMap), SUCCESS);
+    ASSERT_EQ(packer.FinalizePacking(packedSize), SUCCESS);
+    int64_t size = 0;
+    GrowablePackerStream::Buffer buffer = output->ReleaseBuffer(size);
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(size, packedSize);
+    ASSERT_EQ(size, fixedSize);
+    ASSERT_EQ(memcmp(buffer.get(), fixed.data(), size), 0);
+    GTEST_LOG_(INFO) << "GrowablePackerStreamTest: GrowablePackerStreamTest002 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
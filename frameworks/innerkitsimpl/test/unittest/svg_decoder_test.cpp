@@ -15,6 +15,9 @@
 
 #define private public
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <string>
 #include "svg_decoder.h"
 #include "buffer_source_stream.h"
 #include "mock_data_stream.h"
@@ -23,6 +26,14 @@ using namespace testing::ext;
 using namespace OHOS::Media;
 namespace OHOS {
 namespace ImagePlugin {
+static const std::string SVG_ICON = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\">"
+    "<rect x=\"2\" y=\"2\" width=\"20\" height=\"20\" fill=\"#ff0000\"/></svg>";
+static constexpr int32_t SVG_ICON_LARGE_SIZE = 96;
+static constexpr uint32_t SVG_FILL_COLOR = 0x00ff00;
+// RGBA bytes of the rect, as rendered and with the fill override
+static const std::array<uint8_t, 4> SVG_ICON_RGBA = { 0xff, 0x00, 0x00, 0xff };
+static const std::array<uint8_t, 4> SVG_FILL_RGBA = { 0x00, 0xff, 0x00, 0xff };
+
 class SvgDecoderTest : public testing::Test {
 public:
     SvgDecoderTest() {}
@@ -485,5 +496,75 @@ HWTEST_F(SvgDecoderTest, DoDecode001, TestSize.Level3)
     ASSERT_EQ(ret, Media::ERROR);
     GTEST_LOG_(INFO) << "SvgDecoderTest: DoDecode001 end";
 }
+
+static std::array<uint8_t, 4> GetCenterPixel(const DecodeContext &context, const PlImageInfo &info)
+{
+    std::array<uint8_t, 4> pixel = {};
+    size_t rowBytes = static_cast<size_t>(info.size.width) * pixel.size();
+    size_t offset = static_cast<size_t>(info.size.height / 2) * rowBytes +
+        static_cast<size_t>(info.size.width / 2) * pixel.size();
+    if (context.pixelsBuffer.buffer == nullptr || offset + pixel.size() > context.pixelsBuffer.bufferSize) {
+        return pixel;
+    }
+    const uint8_t *data = static_cast<const uint8_t *>(context.pixelsBuffer.buffer) + offset;
+    std::copy(data, data + pixel.size(), pixel.begin());
+    return pixel;
+}
+
+/**
+ * @tc.name: SvgDomCache001
+ * @tc.desc: decoders of the same svg share one parsed DOM and still render at their own sizes
+ * @tc.type: FUNC
+ */
+HWTEST_F(SvgDecoderTest, SvgDomCache001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "SvgDecoderTest: SvgDomCache001 start";
+    auto data = reinterpret_cast<const uint8_t *>(SVG_ICON.data());
+    auto smallStream = BufferSourceStream::CreateSourceStream(data, SVG_ICON.size());
+    auto largeStream = BufferSourceStream::CreateSourceStream(data, SVG_ICON.size());
+    ASSERT_NE(smallStream, nullptr);
+    ASSERT_NE(largeStream, nullptr);
+    auto smallDecoder = std::make_shared<SvgDecoder>();
+    auto largeDecoder = std::make_shared<SvgDecoder>();
+    smallDecoder->SetSource(*smallStream);
+    largeDecoder->SetSource(*largeStream);
+
+    PixelDecodeOptions smallOpts;
+    PixelDecodeOptions largeOpts;
+    largeOpts.desiredSize.width = SVG_ICON_LARGE_SIZE;
+    largeOpts.desiredSize.height = SVG_ICON_LARGE_SIZE;
+    PlImageInfo smallInfo;
+    PlImageInfo largeInfo;
+    ASSERT_EQ(smallDecoder->SetDecodeOptions(0, smallOpts, smallInfo), SUCCESS);
+    ASSERT_EQ(largeDecoder->SetDecodeOptions(0, largeOpts, largeInfo), SUCCESS);
+    ASSERT_EQ(smallDecoder->svgDom_.get(), largeDecoder->svgDom_.get());
+    ASSERT_EQ(largeInfo.size.width, SVG_ICON_LARGE_SIZE);
+
+    DecodeContext smallContext;
+    DecodeContext largeContext;
+    smallContext.allocatorType = AllocatorType::HEAP_ALLOC;
+    largeContext.allocatorType = AllocatorType::HEAP_ALLOC;
+    ASSERT_EQ(largeDecoder->Decode(0, largeContext), SUCCESS);
+    ASSERT_EQ(smallDecoder->Decode(0, smallContext), SUCCESS);
+    ASSERT_EQ(smallContext.pixelsBuffer.bufferSize,
+        static_cast<uint32_t>(smallInfo.size.width * smallInfo.size.height * sizeof(uint32_t)));
+    ASSERT_EQ(GetCenterPixel(smallContext, smallInfo), SVG_ICON_RGBA);
+    ASSERT_EQ(GetCenterPixel(largeContext, largeInfo), SVG_ICON_RGBA);
+    free(smallContext.pixelsBuffer.buffer);
+    free(largeContext.pixelsBuffer.buffer);
+
+    PixelDecodeOptions fillOpts;
+    fillOpts.plFillColor.isValidColor = true;
+    fillOpts.plFillColor.color = SVG_FILL_COLOR;
+    PlImageInfo fillInfo;
+    ASSERT_EQ(largeDecoder->SetDecodeOptions(0, fillOpts, fillInfo), SUCCESS);
+    ASSERT_NE(smallDecoder->svgDom_.get(), largeDecoder->svgDom_.get());
+    DecodeContext fillContext;
+    fillContext.allocatorType = AllocatorType::HEAP_ALLOC;
+    ASSERT_EQ(largeDecoder->Decode(0, fillContext), SUCCESS);
+    ASSERT_EQ(GetCenterPixel(fillContext, fillInfo), SVG_FILL_RGBA);
+    free(fillContext.pixelsBuffer.buffer);
+    GTEST_LOG_(INFO) << "SvgDecoderTest: SvgDomCache001 end";
+}
 }
 }
\ No newline at end of file
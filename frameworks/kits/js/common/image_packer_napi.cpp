@@ -15,6 +15,9 @@
 
 #include "image_packer_napi.h"
 
+#include <algorithm>
+
+#include "growable_packer_stream.h"
 #include "image_log.h"
 #include "image_napi_utils.h"
 #include "image_packer.h"
@@ -97,7 +100,7 @@ struct ImagePackerAsyncContext {
     std::shared_ptr<PixelMap> rPixelMap;
     std::shared_ptr<Picture> rPicture;
     std::shared_ptr<std::vector<std::shared_ptr<PixelMap>>> rPixelMaps;
-    std::unique_ptr<uint8_t[]> resultBuffer;
+    GrowablePackerStream::Buffer resultBuffer;
     int32_t packType = TYPE_IMAGE_SOURCE;
     int64_t resultBufferSize = 0;
     int64_t packedSize = 0;
@@ -261,19 +264,45 @@ static int64_t getDefaultBufferSize(ImagePackerAsyncContext *context)
     return getDefaultBufferSize(imageInfo.size.width, imageInfo.size.height);
 }
 
+static GrowablePackerStream* StartPackingToBuffer(ImagePackerAsyncContext *context)
+{
+    // the output grows with the encoded data, resultBufferSize only caps it
+    uint32_t maxSize = static_cast<uint32_t>(std::clamp<int64_t>(context->resultBufferSize, 0, UINT32_MAX));
+    auto stream = std::make_unique<GrowablePackerStream>(maxSize);
+    GrowablePackerStream *output = stream.get();
+    if (context->rImagePacker->StartPacking(std::move(stream), context->packOption) != SUCCESS) {
+        return nullptr;
+    }
+    return output;
+}
+
+static bool CreatePackedArrayBuffer(napi_env env, ImagePackerAsyncContext *context, napi_value *result)
+{
+    if (context->resultBuffer == nullptr || context->packedSize <= 0) {
+        return false;
+    }
+    napi_status status = napi_create_external_arraybuffer(env, context->resultBuffer.get(),
+        static_cast<size_t>(context->packedSize), [](napi_env env, void *data, void *hint) {
+            GrowablePackerStream::BufferDeleter()(static_cast<uint8_t *>(data));
+        }, nullptr, result);
+    if (status == napi_ok) {
+        context->resultBuffer.release();
+        return true;
+    }
+    IMAGE_LOGD("napi_create_external_arraybuffer failed, copy the packed data instead");
+    return ImageNapiUtils::CreateArrayBuffer(env, context->resultBuffer.get(), context->packedSize, result);
+}
+
 STATIC_EXEC_FUNC(Packing)
 {
     int64_t packedSize = 0;
     auto context = static_cast<ImagePackerAsyncContext*>(data);
     IMAGE_LOGD("ImagePacker BufferSize %{public}" PRId64, context->resultBufferSize);
-    context->resultBuffer = std::make_unique<uint8_t[]>(
-        (context->resultBufferSize <= 0) ? getDefaultBufferSize(context) : context->resultBufferSize);
-    if (context->resultBuffer == nullptr) {
-        BuildMsgOnError(context, context->resultBuffer == nullptr, "ImagePacker buffer alloc error");
+    GrowablePackerStream *output = StartPackingToBuffer(context);
+    if (output == nullptr) {
+        BuildMsgOnError(context, output != nullptr, "ImagePacker start packing error");
         return;
     }
-    context->rImagePacker->StartPacking(context->resultBuffer.get(),
-        context->resultBufferSize, context->packOption);
     if (context->packType == TYPE_IMAGE_SOURCE) {
         IMAGE_LOGI("ImagePacker set image source");
         if (context->rImageSource == nullptr) {
@@ -299,6 +328,7 @@ STATIC_EXEC_FUNC(Packing)
     context->rImagePacker->FinalizePacking(packedSize);
     IMAGE_LOGD("packedSize=%{public}" PRId64, packedSize);
     if (packedSize > 0 && (packedSize < context->resultBufferSize)) {
+        context->resultBuffer = output->ReleaseBuffer(packedSize);
         context->packedSize = packedSize;
         context->status = SUCCESS;
     } else {
@@ -322,8 +352,7 @@ STATIC_COMPLETE_FUNC(Packing)
     napi_get_undefined(env, &result);
     auto context = static_cast<ImagePackerAsyncContext*>(data);
 
-    if (!ImageNapiUtils::CreateArrayBuffer(env, context->resultBuffer.get(),
-                                           context->packedSize, &result)) {
+    if (!CreatePackedArrayBuffer(env, context, &result)) {
         context->status = ERROR;
         IMAGE_LOGE("napi_create_arraybuffer failed!");
         napi_get_undefined(env, &result);
@@ -997,6 +1026,9 @@ static void ParserPackingMultiFramesArguments(napi_env env,
             parsePackOptionOfdisposalTypes(env, argv[PARAM1], &(context->packOption)),
             "PackOptions mismatch", ERR_IMAGE_INVALID_PARAMETER);
     }
+    if (context->rPixelMaps != nullptr) {
+        context->packOption.numberHint = static_cast<uint32_t>(context->rPixelMaps->size());
+    }
 }
 
 STATIC_EXEC_FUNC(PackingMultiFrames)
@@ -1004,14 +1036,11 @@ STATIC_EXEC_FUNC(PackingMultiFrames)
     int64_t packedSize = 0;
     auto context = static_cast<ImagePackerAsyncContext*>(data);
     IMAGE_LOGD("ImagePacker BufferSize %{public}" PRId64, context->resultBufferSize);
-    context->resultBuffer = std::make_unique<uint8_t[]>(
-        (context->resultBufferSize <= 0)?DEFAULT_BUFFER_SIZE:context->resultBufferSize);
-    if (context->resultBuffer == nullptr) {
-        BuildMsgOnError(context, context->resultBuffer == nullptr, "ImagePacker buffer alloc error");
+    GrowablePackerStream *output = StartPackingToBuffer(context);
+    if (output == nullptr) {
+        BuildMsgOnError(context, output != nullptr, "ImagePacker start packing error");
         return;
     }
-    context->rImagePacker->StartPacking(context->resultBuffer.get(),
-        context->resultBufferSize, context->packOption);
     IMAGE_LOGD("ImagePacker set pixelmap");
     if (context->rPixelMaps == nullptr) {
         BuildMsgOnError(context, context->rPixelMaps == nullptr,
@@ -1024,6 +1053,7 @@ STATIC_EXEC_FUNC(PackingMultiFrames)
     context->rImagePacker->FinalizePacking(packedSize);
     IMAGE_LOGD("packedSize=%{public}" PRId64, packedSize);
     if (packedSize > 0 && (packedSize < context->resultBufferSize)) {
+        context->resultBuffer = output->ReleaseBuffer(packedSize);
         context->packedSize = packedSize;
         context->status = SUCCESS;
     } else {
@@ -1038,8 +1068,7 @@ STATIC_COMPLETE_FUNC(PackingMultiFrames)
     napi_get_undefined(env, &result);
     auto context = static_cast<ImagePackerAsyncContext*>(data);
 
-    if (!ImageNapiUtils::CreateArrayBuffer(env, context->resultBuffer.get(),
-                                           context->packedSize, &result)) {
+    if (!CreatePackedArrayBuffer(env, context, &result)) {
         context->status = ERROR;
         IMAGE_LOGE("napi_create_arraybuffer failed!");
         napi_get_undefined(env, &result);
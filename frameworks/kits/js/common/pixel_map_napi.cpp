@@ -627,13 +627,8 @@ extern "C" __attribute__((visibility("default"))) int32_t OHOS_MEDIA_AccessPixel
         return OHOS_IMAGE_RESULT_BAD_PARAMETER;
     }
 
-    const uint8_t *constPixels = pixelMap->GetPixels();
-    if (constPixels == nullptr) {
-        IMAGE_LOGE("const pixels is nullptr");
-        return OHOS_IMAGE_RESULT_BAD_PARAMETER;
-    }
-
-    uint8_t *pixels = const_cast<uint8_t*>(constPixels);
+    // The caller may write through the address, so detach from pixels shared with clones first.
+    uint8_t *pixels = static_cast<uint8_t*>(pixelMap->GetWritablePixels());
     if (pixels == nullptr) {
         IMAGE_LOGE("pixels is nullptr");
         return OHOS_IMAGE_RESULT_BAD_PARAMETER;
@@ -78,10 +78,30 @@ struct PackOption {
      */
     std::vector<uint8_t> disposalTypes;
 
+    /**
+     * Store each frame as the rectangle that changed since the previous frame,
+     * with unchanged pixels made transparent.
+     * Only for gif.
+     */
+    bool optimizeFrames = false;
+
     /**
      * Hint to pack image with properties.
     */
     bool needsPackProperties = false;
+
+    /**
+     * Trade-off between encoding speed and output size, 0 (fastest) to 6 (smallest).
+     * Negative values keep the encoder default.
+     * Only for webp.
+     */
+    int8_t effort = -1;
+
+    /**
+     * Allow the encoder to use a worker thread for large images, off by default.
+     * Only for webp.
+     */
+    bool multiThread = false;
 };
 
 class PackerStream;
@@ -91,10 +111,25 @@ public:
     ImagePacker();
     ~ImagePacker();
     static uint32_t GetSupportedFormats(std::set<std::string> &formats);
+    /**
+     * When enabled, encoders released by a packer are kept in a process-wide pool keyed by format
+     * and handed to the next packer that packs the same format. Disabled by default.
+     */
+    static void SetEncoderPoolEnabled(bool enabled);
+    static bool IsEncoderPoolEnabled();
+    /**
+     * Number of idle encoder sets the pool holds for format.
+     */
+    static size_t GetPooledEncoderSetCount(const std::string &format);
     uint32_t StartPacking(uint8_t *data, uint32_t maxSize, const PackOption &option);
     uint32_t StartPacking(const std::string &filePath, const PackOption &option);
     uint32_t StartPacking(const int &fd, const PackOption &option);
     uint32_t StartPacking(std::ostream &outputStream, const PackOption &option);
+    /**
+     * Pack into outputStream. The packer owns the stream until the next StartPacking or its own destruction,
+     * so callers may keep a raw pointer to read the result back after FinalizePacking.
+     */
+    uint32_t StartPacking(std::unique_ptr<PackerStream> outputStream, const PackOption &option);
     uint32_t AddImage(PixelMap &pixelMap);
     uint32_t AddImage(ImageSource &source);
     uint32_t AddImage(ImageSource &source, uint32_t index);
@@ -111,11 +146,13 @@ private:
     uint32_t StartPackingImpl(const PackOption &option);
     uint32_t DoEncodingFunc(std::function<uint32_t(ImagePlugin::AbsImageEncoder*)> func, bool forAll = true);
     bool GetEncoderPlugin(const PackOption &option);
+    void ReleaseEncoders();
     void FreeOldPackerStream();
     bool IsPackOptionValid(const PackOption &option);
     static MultimediaPlugin::PluginServer &pluginServer_;
     std::unique_ptr<PackerStream> packerStream_;
     std::vector<std::unique_ptr<ImagePlugin::AbsImageEncoder>> encoders_;
+    std::string encoderFormat_;  // format, or animated format, the cached encoders_ were created for
     std::unique_ptr<ImagePlugin::AbsImageEncoder> encoder_;
     std::unique_ptr<ImagePlugin::AbsImageEncoder> exEncoder_;
     std::unique_ptr<PixelMap> pixelMap_;  // inner imagesource create, our manage the lifecycle
@@ -23,6 +23,7 @@
 #include <mutex>
 #include <optional>
 #include <set>
+#include <vector>
 
 #include "decode_listener.h"
 #include "image_type.h"
@@ -145,8 +146,19 @@ struct ASTCInfo {
     Size blockFootprint;
 };
 
+struct DecodedImageCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint32_t entryCount = 0;
+    size_t usedBytes = 0;
+    size_t maxBytes = 0;
+};
+
 class SourceStream;
 enum class ImageHdrType;
+struct JpegAuxiliaryRange;
+struct JpegAuxiliaryTasks;
 struct HdrMetadata;
 class MetadataAccessor;
 class ExifMetadata;
@@ -177,6 +189,19 @@ public:
     
     NATIVEEXPORT static void SetVividMetaColor(HdrMetadata& metadata, CM_ColorSpaceType base,
                                                 CM_ColorSpaceType gainmap, CM_ColorSpaceType hdr);
+    /**
+     * When enabled, CreatePixelMapEx keeps decoded SDR pixel maps in a process-wide LRU cache limited to maxBytes,
+     * keyed by the file identity (device, inode, size and modification time) or the content of a buffer
+     * source, plus the decode options. Buffer source entries keep a copy of the encoded bytes, which counts
+     * towards maxBytes, and only hit when those bytes are identical. A hit returns a copy-on-write clone, so no
+     * pixels are copied until the caller writes to them. Disabled by default; disabling drops all entries.
+     */
+    NATIVEEXPORT static void SetDecodedImageCacheEnabled(bool enabled, size_t maxBytes = 64 * 1024 * 1024);
+    NATIVEEXPORT static DecodedImageCacheStats GetDecodedImageCacheStats();
+    /**
+     * Evict least recently used entries until at most targetBytes are cached, 0 empties the cache.
+     */
+    NATIVEEXPORT static void TrimDecodedImageCache(size_t targetBytes);
     
     NATIVEEXPORT std::unique_ptr<PixelMap> CreatePixelMap(const DecodeOptions &opts, uint32_t &errorCode)
     {
@@ -227,6 +252,11 @@ public:
     NATIVEEXPORT uint32_t GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges);
     NATIVEEXPORT uint32_t GetFilterArea(const std::vector<std::string> &exifKeys,
                                         std::vector<std::pair<uint32_t, uint32_t>> &ranges);
+    /**
+     * Write the source to dstFd, at its current position, with the values of exifKeys zeroed. Unchanged spans
+     * of a file source are copied inside the kernel, so the image data never passes through user space.
+     */
+    NATIVEEXPORT uint32_t WriteFilteredCopy(const std::vector<std::string> &exifKeys, const int dstFd);
     NATIVEEXPORT std::unique_ptr<std::vector<std::unique_ptr<PixelMap>>> CreatePixelMapList(const DecodeOptions &opts,
         uint32_t &errorCode);
     NATIVEEXPORT std::unique_ptr<std::vector<int32_t>> GetDelayTime(uint32_t &errorCode);
@@ -293,6 +323,7 @@ private:
     bool ConvertYUV420ToRGBA(uint8_t *data, uint32_t size, bool isSupportOdd, bool isAddUV, uint32_t &errorCode);
     std::unique_ptr<PixelMap> CreatePixelMapForYUV(uint32_t &errorCode);
     std::unique_ptr<PixelMap> CreatePixelMapForASTC(uint32_t &errorCode, bool fastAstc = false);
+    std::unique_ptr<PixelMap> CreatePixelMapFromExifThumbnail(uint32_t index, const DecodeOptions &opts);
     uint32_t GetFormatExtended(std::string &format);
     static std::unique_ptr<ImageSource> DoImageSourceCreate(
         std::function<std::unique_ptr<SourceStream>(void)> stream,
@@ -320,6 +351,9 @@ private:
     uint32_t ModifyImageProperty(const std::string &key, const std::string &value);
     uint32_t CreatExifMetadataByImageSource(bool addFlag = false);
     uint32_t CreateExifMetadata(uint8_t *buffer, const uint32_t size, bool addFlag);
+    bool CopySourceSpan(int dstFd, uint32_t offset, uint32_t length);
+    bool GetDecodedImageCacheKey(uint32_t index, const DecodeOptions &opts, std::string &key);
+    std::unique_ptr<PixelMap> CreatePixelMapUncached(uint32_t index, const DecodeOptions &opts, uint32_t &errorCode);
     void SetDecodeInfoOptions(uint32_t index, const DecodeOptions &opts, const ImageInfo &info, ImageEvent &imageEvent);
     void SetDecodeInfoOptions(uint32_t index, const DecodeOptions &opts, const ImagePlugin::PlImageInfo &plInfo,
         ImageEvent &imageEvent);
@@ -354,6 +388,12 @@ private:
                                      uint32_t &errorCode);
     void DecodeJpegAuxiliaryPicture(const std::set<AuxiliaryPictureType> &auxTypes, std::unique_ptr<Picture> &picture,
                                     uint32_t &errorCode);
+    bool ParseJpegAuxiliaryRanges(const std::set<AuxiliaryPictureType> &auxTypes,
+                                  std::vector<JpegAuxiliaryRange> &ranges, uint32_t &errorCode);
+    bool CreateJpegAuxiliaryTasks(const std::set<AuxiliaryPictureType> &auxTypes, bool deferred,
+                                  JpegAuxiliaryTasks &tasks, uint32_t &errorCode);
+    void CollectJpegAuxiliaryTasks(JpegAuxiliaryTasks &tasks, std::unique_ptr<Picture> &picture,
+                                   uint32_t &errorCode);
 
     const std::string NINE_PATCH = "ninepatch";
     const std::string SKIA_DECODER = "SKIA_DECODER";
@@ -310,6 +310,7 @@ struct DecodeOptions {
     DecodeDynamicRange desiredDynamicRange = DecodeDynamicRange::SDR;
     ResolutionQuality resolutionQuality = ResolutionQuality::UNKNOWN;
     bool isAisr = false;
+    bool preferExifThumbnail = false;
 };
 
 enum class ScaleMode : int32_t {
@@ -357,6 +358,10 @@ enum class MetadataType {
 
 struct DecodingOptionsForPicture {
     std::set<AuxiliaryPictureType> desireAuxiliaryPictures;
+    // Postpone auxiliary picture decoding until Picture::GetAuxiliaryPicture is first called. JPEG only, HEIF
+    // auxiliary pictures are always decoded by CreatePicture. The gainmap is never deferred because the main
+    // pixel map takes its HDR type and metadata from it.
+    bool deferAuxiliaryDecode = false;
 };
 
 typedef struct PictureError {
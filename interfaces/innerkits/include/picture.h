@@ -19,7 +19,9 @@
 #include "pixel_map.h"
 #include "auxiliary_picture.h"
 #include "image_type.h"
+#include <functional>
 #include <map>
+#include <mutex>
 
 namespace OHOS {
     class SurfaceBuffer;
@@ -30,6 +32,8 @@ namespace Media {
 
 class ExifMetadata;
 
+using AuxiliaryPictureLoader = std::function<std::shared_ptr<AuxiliaryPicture>()>;
+
 class Picture : public Parcelable {
 public:
     virtual ~Picture();
@@ -44,6 +48,7 @@ public:
     NATIVEEXPORT std::shared_ptr<AuxiliaryPicture> GetAuxiliaryPicture(AuxiliaryPictureType type);
     NATIVEEXPORT void SetAuxiliaryPicture(std::shared_ptr<AuxiliaryPicture> &picture);
     NATIVEEXPORT bool HasAuxiliaryPicture(AuxiliaryPictureType type);
+    NATIVEEXPORT void SetAuxiliaryPictureLoader(AuxiliaryPictureType type, AuxiliaryPictureLoader loader);
     NATIVEEXPORT virtual bool Marshalling(Parcel &data) const override;
     NATIVEEXPORT static Picture *Unmarshalling(Parcel &data);
     NATIVEEXPORT static Picture *Unmarshalling(Parcel &data, PICTURE_ERR &error);
@@ -54,8 +59,14 @@ public:
     NATIVEEXPORT sptr<SurfaceBuffer> GetMaintenanceData() const;
 
 private:
+    void LoadAuxiliaryPicture(AuxiliaryPictureType type) const;
+    void LoadAllAuxiliaryPictures() const;
+    void AddAuxiliaryPicture(const std::shared_ptr<AuxiliaryPicture> &picture) const;
+
     std::shared_ptr<PixelMap> mainPixelMap_;
-    std::map<AuxiliaryPictureType, std::shared_ptr<AuxiliaryPicture>> auxiliaryPictures_;
+    mutable std::recursive_mutex auxiliaryMutex_;
+    mutable std::map<AuxiliaryPictureType, std::shared_ptr<AuxiliaryPicture>> auxiliaryPictures_;
+    mutable std::map<AuxiliaryPictureType, AuxiliaryPictureLoader> auxiliaryLoaders_;
     sptr<SurfaceBuffer> maintenanceData_;
     std::shared_ptr<ExifMetadata> exifMetadata_ = nullptr;
 };
@@ -16,10 +16,15 @@
 #ifndef INTERFACES_INNERKITS_INCLUDE_PIXEL_ASTC_H
 #define INTERFACES_INNERKITS_INCLUDE_PIXEL_ASTC_H
 
+#include <memory>
+#include <mutex>
+
 #include "pixel_map.h"
 
 namespace OHOS {
 namespace Media {
+struct AstcTextureInfo;
+
 typedef struct {
     uint8_t magic[4];
     uint8_t blockdimX;
@@ -71,6 +76,7 @@ public:
     // judgement whether create pixelmap use source as result
     NATIVEEXPORT bool IsSourceAsResponse() override;
 
+    // Pixel reads decode the texture on the CPU and return RGBA_8888 (BGRA_8888 for ReadPixel, as PixelMap does).
     NATIVEEXPORT uint32_t ReadPixels(const uint64_t &bufferSize, const uint32_t &offset, const uint32_t &stride,
                                      const Rect &region, uint8_t *dst) override;
     NATIVEEXPORT uint32_t ReadPixels(const uint64_t &bufferSize, uint8_t *dst) override;
@@ -83,7 +89,15 @@ public:
     NATIVEEXPORT bool WritePixels(const uint32_t &color) override;
 
 private:
+    bool GetAstcTexture(AstcTextureInfo &texture);
+    uint32_t DecodeRegion(const Rect &region, uint8_t *dst, uint32_t dstStride);
+    const uint8_t *GetDecodedPixel(int32_t x, int32_t y);
+    void ReleaseDecodedPixels();
+
     uint32_t astcId_ = 0;
+    // Lazily decoded RGBA_8888 copy of the visible area, backing GetPixel8/16/32.
+    std::unique_ptr<uint8_t[]> decodedPixels_;
+    std::shared_ptr<std::mutex> decodedMutex_ = std::make_shared<std::mutex>();
 };
 } // namespace Media
 } // namespace OHOS
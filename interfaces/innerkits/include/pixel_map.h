@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <vector>
 #ifdef IMAGE_COLORSPACE_FLAG
 #include "color_space.h"
 #endif
@@ -63,6 +64,7 @@ struct InitializationOptions {
     bool useDMA = false;
 };
 struct TransInfos;
+enum class PixelTransformOp : uint8_t;
 
 // Build ARGB_8888 pixel value
 constexpr uint8_t ARGB_MASK = 0xFF;
@@ -92,7 +94,58 @@ struct PixelMemInfo {
     bool isAstc = false;
 };
 
+enum class PixelMapTransformStepType : uint8_t {
+    SCALE,
+    TRANSLATE,
+    ROTATE,
+    FLIP,
+    CROP,
+};
+
+struct PixelMapTransformStep {
+    PixelMapTransformStepType type = PixelMapTransformStepType::SCALE;
+    float xAxis = 0.0f;  // scale factor, translation, degrees for ROTATE, -1 or 1 for FLIP
+    float yAxis = 0.0f;
+    Rect rect;           // CROP only
+};
+
+/**
+ * Records edits for PixelMap::ApplyTransform. Each step means the same as the PixelMap method of the same name
+ * applied in order, but the whole chain is resampled once into a single new buffer.
+ */
+class PixelMapTransform {
+public:
+    NATIVEEXPORT PixelMapTransform &Scale(float xAxis, float yAxis);
+    NATIVEEXPORT PixelMapTransform &Translate(float xAxis, float yAxis);
+    NATIVEEXPORT PixelMapTransform &Rotate(float degrees);
+    NATIVEEXPORT PixelMapTransform &Flip(bool xAxis, bool yAxis);
+    NATIVEEXPORT PixelMapTransform &Crop(const Rect &rect);
+    /**
+     * Convert to this format in the same pass. UNKNOWN keeps the source format.
+     */
+    NATIVEEXPORT PixelMapTransform &SetPixelFormat(PixelFormat format);
+    NATIVEEXPORT PixelMapTransform &SetAntiAliasing(AntiAliasingOption option);
+    NATIVEEXPORT const std::vector<PixelMapTransformStep> &GetSteps() const
+    {
+        return steps_;
+    }
+    NATIVEEXPORT PixelFormat GetPixelFormat() const
+    {
+        return pixelFormat_;
+    }
+    NATIVEEXPORT AntiAliasingOption GetAntiAliasing() const
+    {
+        return antiAliasing_;
+    }
+
+private:
+    std::vector<PixelMapTransformStep> steps_;
+    PixelFormat pixelFormat_ = PixelFormat::UNKNOWN;
+    AntiAliasingOption antiAliasing_ = AntiAliasingOption::NONE;
+};
+
 class ExifMetadata;
+struct PixelMapSharedStorage;
 
 class PixelMap : public Parcelable, public PIXEL_MAP_ERR {
 public:
@@ -149,6 +202,11 @@ public:
     NATIVEEXPORT virtual void rotate(float degrees);
     NATIVEEXPORT virtual void flip(bool xAxis, bool yAxis);
     NATIVEEXPORT virtual uint32_t crop(const Rect &rect);
+    /**
+     * Apply all steps of transform with one resampling pass and one allocation. YUV and ASTC pixel maps, and
+     * single step chains, run the steps one by one through the methods above.
+     */
+    NATIVEEXPORT uint32_t ApplyTransform(const PixelMapTransform &transform);
     NATIVEEXPORT virtual void GetImageInfo(ImageInfo &imageInfo);
     NATIVEEXPORT virtual PixelFormat GetPixelFormat();
     NATIVEEXPORT virtual ColorSpace GetColorSpace();
@@ -217,9 +275,12 @@ public:
         return useSourceAsResponse_;
     }
 
-    NATIVEEXPORT virtual void *GetWritablePixels() const
+    // Writable access detaches the pixels from any clone still sharing them.
+    NATIVEEXPORT virtual void *GetWritablePixels() const;
+
+    NATIVEEXPORT bool IsPixelsShared() const
     {
-        return static_cast<void *>(data_);
+        return sharedStorage_ != nullptr;
     }
 
     NATIVEEXPORT virtual uint32_t GetUniqueId() const
@@ -231,6 +292,8 @@ public:
     NATIVEEXPORT static PixelMap *Unmarshalling(Parcel &data);
     NATIVEEXPORT static PixelMap *Unmarshalling(Parcel &parcel, PIXEL_MAP_ERR &error);
     NATIVEEXPORT virtual bool EncodeTlv(std::vector<uint8_t> &buff) const;
+    // compress: store the pixels row-filtered and deflated; DecodeTlv accepts both layouts.
+    NATIVEEXPORT bool EncodeTlv(std::vector<uint8_t> &buff, bool compress) const;
     NATIVEEXPORT static PixelMap *DecodeTlv(std::vector<uint8_t> &buff);
     NATIVEEXPORT virtual void SetImageYUVInfo(YUVDataInfo &yuvinfo)
     {
@@ -352,6 +415,7 @@ protected:
     static constexpr uint8_t TLV_IMAGE_BASEDENSITY = 0x06;
     static constexpr uint8_t TLV_IMAGE_ALLOCATORTYPE = 0x07;
     static constexpr uint8_t TLV_IMAGE_DATA = 0x08;
+    static constexpr uint8_t TLV_IMAGE_COMPRESSED_DATA = 0x09;
     static constexpr size_t MAX_IMAGEDATA_SIZE = 128 * 1024 * 1024; // 128M
     static constexpr size_t MIN_IMAGEDATA_SIZE = 32 * 1024;         // 32k
     friend class ImageSource;
@@ -370,6 +434,11 @@ protected:
     static bool CopyPixMapToDst(PixelMap &source, void* &dstPixels, int &fd, uint32_t bufferSize);
     static bool CopyPixelMap(PixelMap &source, PixelMap &dstPixelMap, int32_t &error);
     static bool CopyPixelMap(PixelMap &source, PixelMap &dstPixelMap);
+    bool IsStorageShareable() const;
+    bool ShareStorage(PixelMap &dstPixelMap);
+    uint32_t DetachSharedStorage();
+    uint32_t PrepareWritablePixels();
+    void ReleaseMarshallingCache() const;
     static bool SourceCropAndConvert(PixelMap &source, const ImageInfo &srcImageInfo, const ImageInfo &dstImageInfo,
         const Rect &srcRect, PixelMap &dstPixelMap);
     static bool IsSameSize(const Size &src, const Size &dst);
@@ -417,6 +486,7 @@ protected:
     static bool UpdatePixelMapMemInfo(PixelMap *pixelMap, ImageInfo &imgInfo, PixelMemInfo &pixelMemInfo);
     bool WriteImageData(Parcel &parcel, size_t size) const;
     bool WriteAshmemDataToParcel(Parcel &parcel, size_t size) const;
+    bool WriteCachedAshmemDataToParcel(Parcel &parcel, size_t size) const;
     static uint8_t *ReadImageData(Parcel &parcel, int32_t size);
     static uint8_t *ReadHeapDataFromParcel(Parcel &parcel, int32_t bufferSize);
     static uint8_t *ReadAshmemDataFromParcel(Parcel &parcel, int32_t bufferSize);
@@ -432,8 +502,14 @@ protected:
     void WriteData(std::vector<uint8_t> &buff, const uint8_t *data,
         const int32_t &height, const int32_t &rowDataSize, const int32_t &rowStride) const;
     static uint8_t *ReadData(std::vector<uint8_t> &buff, int32_t size, int32_t &cursor);
+    bool WriteCompressedData(std::vector<uint8_t> &buff, const uint8_t *data, const int32_t &height,
+        const int32_t &rowDataSize, const int32_t &rowStride) const;
+    static uint8_t *ReadCompressedData(std::vector<uint8_t> &buff, const ImageInfo &info, int32_t len,
+        int32_t &cursor, int32_t &size);
     static void ReadTlvAttr(std::vector<uint8_t> &buff, ImageInfo &info, int32_t &type, int32_t &size, uint8_t **data);
     bool DoTranslation(TransInfos &infos, const AntiAliasingOption &option = AntiAliasingOption::NONE);
+    bool DoExactTransform(PixelTransformOp op);
+    uint32_t ApplyTransformSteps(const PixelMapTransform &transform);
     void UpdateImageInfo();
     bool IsYuvFormat();
     static int32_t ConvertPixelAlpha(const void *srcPixels, const int32_t srcLength, const ImageInfo &srcInfo,
@@ -454,6 +530,12 @@ protected:
     bool useSourceAsResponse_ = false;
     bool isTransformered_ = false;
     std::shared_ptr<std::mutex> transformMutex_ = std::make_shared<std::mutex>();
+    // pixels shared copy-on-write with clones, owns the memory while set
+    std::shared_ptr<PixelMapSharedStorage> sharedStorage_ = nullptr;
+    // read-only ashmem copy of heap pixels reused by Marshalling until the pixels change
+    mutable int32_t marshallingFd_ = -1;
+    mutable size_t marshallingSize_ = 0;
+    std::shared_ptr<std::mutex> marshallingMutex_ = std::make_shared<std::mutex>();
 
     // only used by rosen backend
     uint32_t uniqueId_ = 0;
@@ -96,6 +96,7 @@ private:
     bool IsYuv420Format(OHOS::Media::PixelFormat format) const;
     bool IsHeifToYuvDecode(const DecodeContext &context) const;
     uint32_t DoHeifToYuvDecode(DecodeContext &context);
+    void SetHeifDecodeRegion(const SkIRect &region);
     bool ConvertInfoToAlphaType(SkAlphaType &alphaType, OHOS::Media::AlphaType &outputType);
     bool ConvertInfoToColorType(SkColorType &format, OHOS::Media::PixelFormat &outputFormat);
     bool GetPropertyCheck(uint32_t index, const std::string &key, uint32_t &res);
@@ -59,6 +59,7 @@ public:
     uint32_t AddImage(Media::PixelMap &pixelMap) override;
     uint32_t AddPicture(Media::Picture &picture) override;
     uint32_t FinalizeEncode() override;
+    void Reset() override;
 
 private:
     DISALLOW_COPY_AND_MOVE(ExtEncoder);
@@ -71,11 +72,13 @@ private:
     sptr<SurfaceBuffer> ConvertToSurfaceBuffer(Media::PixelMap* pixelmap);
     uint32_t EncodeSdrImage(ExtWStream& outputStream);
     uint32_t EncodeDualVivid(ExtWStream& outputStream);
+    uint32_t EncodeDualVividByCpu(ExtWStream& outputStream);
     uint32_t EncodeSingleVivid(ExtWStream& outputStream);
     uint32_t EncodePicture();
     uint32_t EncodeCameraSencePicture(SkWStream& skStream);
     uint32_t EncodeEditSencePicture(ExtWStream& outputStream);
     sk_sp<SkData> GetImageEncodeData(sptr<SurfaceBuffer>& surfaceBuffer, SkImageInfo info, bool needExif);
+    sk_sp<SkData> GetImageEncodeData(SkBitmap& bitmap, bool needExif);
     uint32_t EncodeImageBySurfaceBuffer(sptr<SurfaceBuffer>& surfaceBuffer, SkImageInfo info,
         bool needExif, SkWStream& outputStream);
     uint32_t EncodeHeifDualHdrImage(sptr<SurfaceBuffer>& sdr, sptr<SurfaceBuffer>& gainmap,
@@ -20,6 +20,8 @@
 
 namespace OHOS {
 namespace ImagePlugin {
+struct GridRegion;
+
 struct GridInfo {
     uint32_t displayWidth = 0;
     uint32_t displayHeight = 0;
@@ -30,6 +32,17 @@ struct GridInfo {
     uint32_t tileHeight = 0;
 
     bool IsValid() const;
+
+    // Select the tiles intersecting [left, left + width) x [top, top + height) of the display area.
+    bool GetRegion(uint32_t left, uint32_t top, uint32_t width, uint32_t height, GridRegion &region) const;
+};
+
+// Tiles [firstCol, firstCol + grid.cols) x [firstRow, firstRow + grid.rows) of a grid image, described as a grid
+// of their own so they can be decoded and placed at (firstCol * tileWidth, firstRow * tileHeight).
+struct GridRegion {
+    uint32_t firstCol = 0;
+    uint32_t firstRow = 0;
+    GridInfo grid;
 };
 }
 }
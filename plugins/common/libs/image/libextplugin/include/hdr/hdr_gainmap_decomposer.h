@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_HDR_HDR_GAINMAP_DECOMPOSER_H
+#define PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_HDR_HDR_GAINMAP_DECOMPOSER_H
+
+#include <cstdint>
+#include <vector>
+#include "hdr_type.h"
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+class PixelMap;
+}
+namespace ImagePlugin {
+enum class HdrTransfer : uint8_t {
+    LINEAR,
+    PQ,
+    HLG,
+};
+
+struct HdrDecomposeOptions {
+    HdrTransfer transfer = HdrTransfer::PQ;
+    bool limitRange = false;
+    bool sdrIsSRGB = false;
+};
+
+struct HdrDecomposeResult {
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t gainmapWidth = 0;
+    int32_t gainmapHeight = 0;
+    std::vector<uint8_t> base;     // RGBA_8888, sRGB transfer, P3 or sRGB gamut, width * height
+    std::vector<uint8_t> gainmap;  // RGBA_8888 with R == G == B, gainmapWidth * gainmapHeight
+    float peakNits = 0.0f;
+    Media::HdrMetadata metadata;
+};
+
+// Splits an HDR pixel map into an 8-bit SDR base image and a half size gain map on the CPU, for pixel maps the
+// VPE decomposer can not take (not DMA backed, or no VPE on the device).
+// Supported inputs: RGBA_1010102 and YCBCR_P010/YCRCB_P010 in BT.2020 PQ or HLG, and linear RGBA_F16 in sRGB gamut.
+class HdrGainmapDecomposer {
+public:
+    static bool IsSupported(Media::PixelFormat format);
+    static uint32_t Decompose(Media::PixelMap* pixelMap, const HdrDecomposeOptions& options,
+        HdrDecomposeResult& result);
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_HDR_HDR_GAINMAP_DECOMPOSER_H
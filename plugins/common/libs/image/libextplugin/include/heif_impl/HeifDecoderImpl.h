@@ -69,6 +69,9 @@ public:
     bool getAuxiliaryMapInfo(HeifFrameInfo* frameInfo);
     bool decodeAuxiliaryMap();
     void setAuxiliaryDstBuffer(uint8_t* dstBuffer, size_t rowStride);
+    // Only the grid tiles intersecting region are decoded into the primary image destination, the
+    // rest of the destination is left untouched. An empty region decodes the whole image.
+    void setDecodeRegion(const Media::Rect &region);
 private:
     bool Reinit(HeifFrameInfo *frameInfo);
 
@@ -91,7 +94,7 @@ private:
                        sptr<SurfaceBuffer> *outBuffer, bool isPrimary);
 
     bool HwDecodeGrids(HeifHardwareDecoder *hwDecoder, std::shared_ptr<HeifImage> &image,
-                       GridInfo &gridInfo, sptr<SurfaceBuffer> &hwBuffer);
+                       GridInfo &gridInfo, sptr<SurfaceBuffer> &hwBuffer, bool isPrimary);
 
     bool HwDecodeIdenImage(HeifHardwareDecoder *hwDecoder,
                            std::shared_ptr<HeifImage> &image, GridInfo &gridInfo,
@@ -104,7 +107,17 @@ private:
                        GridInfo &gridInfo, bool isPrimary);
 
     bool SwDecodeGrids(Media::ImageFwkExtManager &extManager,
-                       std::shared_ptr<HeifImage> &image, HevcSoftDecodeParam &param);
+                       std::shared_ptr<HeifImage> &image, HevcSoftDecodeParam &param, bool isPrimary);
+
+    bool SwDecodeGridRegion(Media::ImageFwkExtManager &extManager,
+                            std::vector<std::shared_ptr<HeifImage>> &tileImages, HevcSoftDecodeParam &param);
+
+    bool PrepareGridRegion(std::vector<std::shared_ptr<HeifImage>> &tileImages, const HevcSoftDecodeParam &param,
+                           HevcSoftDecodeParam &regionParam, std::vector<std::vector<uint8_t>> &inputs);
+
+    bool PrepareDecodeRegion();
+
+    uint8_t *GetRegionDstMemory();
 
     bool SwDecodeIdenImage(std::shared_ptr<HeifImage> &image, HevcSoftDecodeParam &param,
                            GridInfo &gridInfo, bool isPrimary);
@@ -150,6 +163,10 @@ private:
     HeifFrameInfo tmapInfo_{};
     std::string errMsg_;
 
+    Media::Rect decodeRegion_ {};
+    GridRegion gridRegion_ {};
+    bool isRegionDecode_ = false;
+
     GridInfo gainmapGridInfo_ = {0, 0, false, 0, 0, 0, 0};
 };
 } // namespace ImagePlugin
@@ -18,6 +18,8 @@
 
 #include "box/heif_box.h"
 
+#include <unordered_map>
+
 namespace OHOS {
 namespace ImagePlugin {
 class HeifIlocBox : public HeifFullBox {
@@ -50,11 +52,17 @@ public:
 
     const std::vector<Item> &GetItems() const { return items_; }
 
+    const Item *GetItem(heif_item_id itemId) const;
+
     heif_error ReadData(const Item &item,
                     const std::shared_ptr<HeifInputStream> &stream,
                     const std::shared_ptr<class HeifIdatBox> &idat,
                     std::vector<uint8_t> *dest) const;
 
+    // View of a single-extent, file-offset item inside an in-memory stream; other items have to be read.
+    heif_error GetDataView(const Item &item, const std::shared_ptr<HeifInputStream> &stream,
+                           const uint8_t *&data, size_t &size) const;
+
     heif_error AppendData(heif_item_id itemId,
                      const std::vector<uint8_t> &data,
                      uint8_t constructionMethod = 0);
@@ -75,6 +83,7 @@ protected:
 
 private:
     std::vector<Item> items_;
+    std::unordered_map<heif_item_id, size_t> itemIndex_;
 
     mutable size_t startPos_ = 0;
     uint8_t offsetSize_ = 0;
@@ -83,6 +92,7 @@ private:
     uint8_t indexSize_ = 0;
     void ParseExtents(Item& item, HeifStreamReader &reader, int indexSize, int offsetSize, int lengthSize);
     void PackIlocHeader(HeifStreamWriter &writer) const;
+    size_t FindItemIndex(heif_item_id itemId) const;
 
     uint64_t idatOffset_ = 0;
 };
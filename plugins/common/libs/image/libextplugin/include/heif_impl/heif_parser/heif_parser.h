@@ -155,6 +155,8 @@ private:
 
     void ExtractMetadata(const std::vector<heif_item_id> &allItemIds);
 
+    heif_error ReadIlocItemData(const HeifIlocBox::Item &item, std::vector<uint8_t> *out) const;
+
     // writing fuctions for boxes
     heif_item_id GetNextItemId() const;
 
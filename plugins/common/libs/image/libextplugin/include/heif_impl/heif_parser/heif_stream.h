@@ -34,6 +34,12 @@ public:
     virtual bool Read(void *data, size_t size) = 0;
 
     virtual bool Seek(int64_t position) = 0;
+
+    // Pointer to size bytes at position when the whole stream is in memory, nullptr otherwise.
+    [[nodiscard]] virtual const uint8_t *GetDataAt(int64_t position, size_t size) const
+    {
+        return nullptr;
+    }
 };
 
 class HeifBufferInputStream : public HeifInputStream {
@@ -50,6 +56,8 @@ public:
 
     bool Seek(int64_t position) override;
 
+    [[nodiscard]] const uint8_t *GetDataAt(int64_t position, size_t size) const override;
+
 private:
     const uint8_t *data_;
     size_t length_;
@@ -844,10 +844,12 @@ uint32_t ExtDecoder::Decode(uint32_t index, DecodeContext &context)
     if (skEncodeFormat == SkEncodedImageFormat::kGIF || skEncodeFormat == SkEncodedImageFormat::kWEBP) {
         return GifDecode(index, context, rowStride);
     }
+    SetHeifDecodeRegion(dstSubset_);
     SkCodec::Result ret = codec_->getPixels(dstInfo_, dstBuffer, rowStride, &dstOptions_);
     if (ret != SkCodec::kSuccess && ResetCodec()) {
         ret = codec_->getPixels(dstInfo_, dstBuffer, rowStride, &dstOptions_); // Try again
     }
+    SetHeifDecodeRegion(SkIRect::MakeEmpty());
     if (ret != SkCodec::kSuccess) {
         IMAGE_LOGE("Decode failed, get pixels failed, ret=%{public}d", ret);
         SetHeifDecodeError(context);
@@ -1802,6 +1804,21 @@ bool ExtDecoder::IsYuv420Format(PixelFormat format) const
     return false;
 }
 
+void ExtDecoder::SetHeifDecodeRegion(const SkIRect &region)
+{
+#ifdef HEIF_HW_DECODE_ENABLE
+    // the crop is applied to the decoded pixels later, tiles outside it need not be decoded at all
+    if (codec_ == nullptr || codec_->getEncodedFormat() != SkEncodedImageFormat::kHEIF ||
+        dstInfo_.dimensions() != info_.dimensions()) {
+        return;
+    }
+    auto decoder = reinterpret_cast<HeifDecoderImpl*>(codec_->getHeifContext());
+    if (decoder != nullptr) {
+        decoder->setDecodeRegion({region.left(), region.top(), region.width(), region.height()});
+    }
+#endif
+}
+
 bool ExtDecoder::IsHeifToYuvDecode(const DecodeContext &context) const
 {
     return codec_->getEncodedFormat() == SkEncodedImageFormat::kHEIF && IsYuv420Format(context.info.pixelFormat);
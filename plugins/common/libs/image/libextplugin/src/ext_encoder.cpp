@@ -15,6 +15,7 @@
 
 #include "ext_encoder.h"
 #include <algorithm>
+#include <future>
 #include <map>
 
 #include "include/core/SkImageEncoder.h"
@@ -49,6 +50,7 @@
 #include "v1_0/cm_color_space.h"
 #include "v1_0/hdr_static_metadata.h"
 #include "vpe_utils.h"
+#include "hdr_gainmap_decomposer.h"
 #include "hdr_helper.h"
 #endif
 #include "color_utils.h"
@@ -105,6 +107,18 @@ namespace {
     constexpr uint8_t GAINMAP_CHANNEL_MULTI = 3;
     constexpr uint8_t GAINMAP_CHANNEL_SINGLE = 1;
     constexpr uint8_t EXIF_PRE_SIZE = 6;
+    struct DisplayPrimaries {
+        float redX;
+        float redY;
+        float greenX;
+        float greenY;
+        float blueX;
+        float blueY;
+    };
+    constexpr DisplayPrimaries BT2020_PRIMARIES = {0.708f, 0.292f, 0.170f, 0.797f, 0.131f, 0.046f};
+    constexpr DisplayPrimaries SRGB_PRIMARIES = {0.640f, 0.330f, 0.300f, 0.600f, 0.150f, 0.060f};
+    constexpr float D65_WHITE_POINT_X = 0.3127f;
+    constexpr float D65_WHITE_POINT_Y = 0.3290f;
 
     // exif/0/0
     constexpr uint8_t EXIF_PRE_TAG[EXIF_PRE_SIZE] = {
@@ -236,7 +250,7 @@ static uint32_t RGBToRGBx(PixelMap *pixelMap, SkImageInfo &skInfo, TmpBufferHold
 {
     holder.buf = std::make_unique<uint8_t[]>(skInfo.computeMinByteSize());
     ExtPixels src = {
-        static_cast<uint8_t*>(pixelMap->GetWritablePixels()),
+        const_cast<uint8_t*>(pixelMap->GetPixels()),
         pixelMap->GetCapacity(), pixelMap->GetWidth()*pixelMap->GetHeight(),
     };
     ExtPixels dst = {
@@ -252,7 +266,7 @@ static bool IsYuvImage(PixelFormat format)
 
 static uint32_t YuvToRgbaSkInfo(ImageInfo info, SkImageInfo &skInfo, uint8_t * dstData, Media::PixelMap *pixelMap)
 {
-    uint8_t *srcData = static_cast<uint8_t*>(pixelMap->GetWritablePixels());
+    uint8_t *srcData = const_cast<uint8_t*>(pixelMap->GetPixels());
     YUVDataInfo yuvInfo;
     pixelMap->GetImageYUVInfo(yuvInfo);
     YuvImageInfo srcInfo = {PixelYuvUtils::ConvertFormat(info.pixelFormat),
@@ -277,7 +291,7 @@ static uint32_t pixelToSkInfo(ImageData &image, SkImageInfo &skInfo, Media::Pixe
     TmpBufferHolder &holder, SkEncodedImageFormat format)
 {
     skInfo = ToSkInfo(pixelMap);
-    image.pixels = static_cast<uint8_t*>(pixelMap->GetWritablePixels());
+    image.pixels = const_cast<uint8_t*>(pixelMap->GetPixels());
     if (format == SkEncodedImageFormat::kJPEG &&
         skInfo.colorType() == SkColorType::kRGB_888x_SkColorType &&
         pixelMap->GetCapacity() < skInfo.computeMinByteSize()) {
@@ -389,6 +403,15 @@ uint32_t ExtEncoder::EncodePicture()
     return EncodeCameraSencePicture(wStream);
 }
 
+void ExtEncoder::Reset()
+{
+    RecycleResources();
+    output_ = nullptr;
+    opts_ = PlEncodeOptions();
+    pixelmap_ = nullptr;
+    picture_ = nullptr;
+}
+
 uint32_t ExtEncoder::FinalizeEncode()
 {
     if ((picture_ == nullptr && pixelmap_ == nullptr) || output_ == nullptr) {
@@ -791,6 +814,15 @@ sk_sp<SkData> ExtEncoder::GetImageEncodeData(sptr<SurfaceBuffer>& surfaceBuffer,
     return stream.detachAsData();
 }
 
+sk_sp<SkData> ExtEncoder::GetImageEncodeData(SkBitmap& bitmap, bool needExif)
+{
+    SkDynamicMemoryWStream stream;
+    if (EncodeImageByBitmap(bitmap, needExif, stream) != SUCCESS) {
+        return nullptr;
+    }
+    return stream.detachAsData();
+}
+
 static uint32_t DecomposeImage(PixelMap* pixelMap, sptr<SurfaceBuffer>& base, sptr<SurfaceBuffer>& gainmap,
     ImagePlugin::HdrMetadata& metadata)
 {
@@ -959,13 +991,85 @@ std::shared_ptr<ImageItem> ExtEncoder::AssembleGainmapImageItem(sptr<SurfaceBuff
 }
 #endif
 
+static HdrTransfer GetHdrTransfer(PixelMap* pixelMap, bool& limitRange)
+{
+    limitRange = false;
+    if (pixelMap->GetPixelFormat() == PixelFormat::RGBA_F16) {
+        return HdrTransfer::LINEAR;
+    }
+#ifdef IMAGE_COLORSPACE_FLAG
+    ColorManager::ColorSpaceName name = pixelMap->InnerGetGrColorSpace().GetColorSpaceName();
+    limitRange = name == ColorManager::BT2020_HLG_LIMIT || name == ColorManager::BT2020_PQ_LIMIT;
+    if (name == ColorManager::BT2020_HLG || name == ColorManager::BT2020_HLG_LIMIT) {
+        return HdrTransfer::HLG;
+    }
+#endif
+    return HdrTransfer::PQ;
+}
+
+// The VPE decomposer reports the static metadata of the source, the CPU one only knows the content peak and
+// the source gamut: BT.2020 for the 10 bit formats, sRGB for linear RGBA_F16.
+static void FillStaticMetadata(PixelFormat format, float peakNits, HdrMetadata& metadata)
+{
+    const DisplayPrimaries& primaries = format == PixelFormat::RGBA_F16 ? SRGB_PRIMARIES : BT2020_PRIMARIES;
+    HdrStaticMetadata staticMetadata = {};
+    staticMetadata.smpte2086.displayPrimaryRed.x = primaries.redX;
+    staticMetadata.smpte2086.displayPrimaryRed.y = primaries.redY;
+    staticMetadata.smpte2086.displayPrimaryGreen.x = primaries.greenX;
+    staticMetadata.smpte2086.displayPrimaryGreen.y = primaries.greenY;
+    staticMetadata.smpte2086.displayPrimaryBlue.x = primaries.blueX;
+    staticMetadata.smpte2086.displayPrimaryBlue.y = primaries.blueY;
+    staticMetadata.smpte2086.whitePoint.x = D65_WHITE_POINT_X;
+    staticMetadata.smpte2086.whitePoint.y = D65_WHITE_POINT_Y;
+    staticMetadata.smpte2086.maxLuminance = peakNits;
+    staticMetadata.smpte2086.minLuminance = 0.0f;
+    staticMetadata.cta861.maxContentLightLevel = peakNits;
+    staticMetadata.cta861.maxFrameAverageLightLevel = 0.0f;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&staticMetadata);
+    metadata.staticMetadata.assign(bytes, bytes + sizeof(HdrStaticMetadata));
+}
+
+uint32_t ExtEncoder::EncodeDualVividByCpu(ExtWStream& outputStream)
+{
+    HdrDecomposeOptions options;
+    options.transfer = GetHdrTransfer(pixelmap_, options.limitRange);
+    options.sdrIsSRGB = pixelmap_->GetToSdrColorSpaceIsSRGB();
+    HdrDecomposeResult result;
+    uint32_t error = HdrGainmapDecomposer::Decompose(pixelmap_, options, result);
+    if (error != SUCCESS) {
+        IMAGE_LOGE("EncodeDualVividByCpu decompose failed, format:%{public}d", pixelmap_->GetPixelFormat());
+        return error;
+    }
+    SkImageInfo baseInfo = GetSkInfo(pixelmap_, false, options.sdrIsSRGB);
+    SkImageInfo gainmapInfo = GetSkInfo(pixelmap_, true, options.sdrIsSRGB);
+    SkBitmap baseBitmap;
+    SkBitmap gainmapBitmap;
+    if (!baseBitmap.installPixels(baseInfo, result.base.data(), baseInfo.minRowBytes()) ||
+        !gainmapBitmap.installPixels(gainmapInfo, result.gainmap.data(), gainmapInfo.minRowBytes())) {
+        IMAGE_LOGE("EncodeDualVividByCpu install pixels failed");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    FillStaticMetadata(pixelmap_->GetPixelFormat(), result.peakNits, result.metadata);
+    auto gainmapTask = std::async(std::launch::async, [this, &gainmapBitmap] {
+        return GetImageEncodeData(gainmapBitmap, false);
+    });
+    sk_sp<SkData> baseImageData = GetImageEncodeData(baseBitmap, opts_.needsPackProperties);
+    sk_sp<SkData> gainMapImageData = gainmapTask.get();
+    return HdrJpegPackerHelper::SpliceHdrStream(baseImageData, gainMapImageData, outputStream, result.metadata);
+}
+
 uint32_t ExtEncoder::EncodeDualVivid(ExtWStream& outputStream)
 {
-    if (!pixelmap_->IsHdr() ||
-        pixelmap_->GetAllocatorType() != AllocatorType::DMA_ALLOC ||
-        (encodeFormat_ != SkEncodedImageFormat::kJPEG && encodeFormat_ != SkEncodedImageFormat::kHEIF)) {
+    bool isJpeg = encodeFormat_ == SkEncodedImageFormat::kJPEG;
+    if (isJpeg && pixelmap_->GetPixelFormat() == PixelFormat::RGBA_F16) {
+        return EncodeDualVividByCpu(outputStream);
+    }
+    if (!pixelmap_->IsHdr() || (!isJpeg && encodeFormat_ != SkEncodedImageFormat::kHEIF)) {
         return ERR_IMAGE_INVALID_PARAMETER;
     }
+    if (pixelmap_->GetAllocatorType() != AllocatorType::DMA_ALLOC) {
+        return isJpeg ? EncodeDualVividByCpu(outputStream) : ERR_IMAGE_INVALID_PARAMETER;
+    }
     bool sdrIsSRGB = pixelmap_->GetToSdrColorSpaceIsSRGB();
     SkImageInfo baseInfo = GetSkInfo(pixelmap_, false, sdrIsSRGB);
     SkImageInfo gainmapInfo = GetSkInfo(pixelmap_, true, sdrIsSRGB);
@@ -985,12 +1089,15 @@ uint32_t ExtEncoder::EncodeDualVivid(ExtWStream& outputStream)
     if (!DecomposeImage(buffers, metadata, false, sdrIsSRGB)) {
         IMAGE_LOGE("EncodeDualVivid decomposeImage failed");
         FreeBaseAndGainMapSurfaceBuffer(baseSptr, gainMapSptr);
-        return IMAGE_RESULT_CREATE_SURFAC_FAILED;
+        return isJpeg ? EncodeDualVividByCpu(outputStream) : IMAGE_RESULT_CREATE_SURFAC_FAILED;
     }
     uint32_t error;
-    if (encodeFormat_ == SkEncodedImageFormat::kJPEG) {
+    if (isJpeg) {
+        auto gainMapTask = std::async(std::launch::async, [this, &gainMapSptr, &gainmapInfo] {
+            return GetImageEncodeData(gainMapSptr, gainmapInfo, false);
+        });
         sk_sp<SkData> baseImageData = GetImageEncodeData(baseSptr, baseInfo, opts_.needsPackProperties);
-        sk_sp<SkData> gainMapImageData = GetImageEncodeData(gainMapSptr, gainmapInfo, false);
+        sk_sp<SkData> gainMapImageData = gainMapTask.get();
         error = HdrJpegPackerHelper::SpliceHdrStream(baseImageData, gainMapImageData, outputStream, metadata);
     } else if (encodeFormat_ == SkEncodedImageFormat::kHEIF) {
         error = EncodeHeifDualHdrImage(baseSptr, gainMapSptr, metadata);
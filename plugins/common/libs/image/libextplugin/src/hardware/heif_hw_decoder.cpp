@@ -47,6 +47,27 @@ bool GridInfo::IsValid() const
 }
 // LCOV_EXCL_STOP
 
+bool GridInfo::GetRegion(uint32_t left, uint32_t top, uint32_t width, uint32_t height, GridRegion &region) const
+{
+    if (!enableGrid || !IsValid() || width == 0 || height == 0 || left >= displayWidth || top >= displayHeight) {
+        return false;
+    }
+    uint32_t right = static_cast<uint32_t>(min(static_cast<uint64_t>(left) + width,
+                                               static_cast<uint64_t>(displayWidth)));
+    uint32_t bottom = static_cast<uint32_t>(min(static_cast<uint64_t>(top) + height,
+                                                static_cast<uint64_t>(displayHeight)));
+    region.firstCol = left / tileWidth;
+    region.firstRow = top / tileHeight;
+    uint32_t endCol = (right - 1) / tileWidth + 1;
+    uint32_t endRow = (bottom - 1) / tileHeight + 1;
+    region.grid = *this;
+    region.grid.cols = endCol - region.firstCol;
+    region.grid.rows = endRow - region.firstRow;
+    region.grid.displayWidth = min(displayWidth, endCol * tileWidth) - region.firstCol * tileWidth;
+    region.grid.displayHeight = min(displayHeight, endRow * tileHeight) - region.firstRow * tileHeight;
+    return true;
+}
+
 HeifHardwareDecoder::HeifDecoderCallback::HeifDecoderCallback(HeifHardwareDecoder* heifDecoder)
     : heifDecoder_(heifDecoder)
 {}
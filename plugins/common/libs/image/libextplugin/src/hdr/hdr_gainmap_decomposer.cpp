@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2024 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hdr_gainmap_decomposer.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <future>
+#include "image_log.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
+
+#undef LOG_TAG
+#define LOG_TAG "HdrGainmapDecomposer"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace Media;
+
+namespace {
+constexpr float SDR_WHITE_NITS = 203.0f;
+constexpr float PQ_PEAK_NITS = 10000.0f;
+constexpr float HLG_PEAK_NITS = 1000.0f;
+constexpr float HLG_SYSTEM_GAMMA = 1.2f;
+constexpr float MAX_RELATIVE_LUMINANCE = PQ_PEAK_NITS / SDR_WHITE_NITS;
+constexpr float KNEE_START = 0.8f;
+constexpr float GAIN_OFFSET = 1.0f / 64.0f;
+constexpr float MIN_GAIN_RANGE = 1.0f / 256.0f;
+constexpr float UINT8_MAX_FLOAT = 255.0f;
+constexpr float HALF_PIXEL = 0.5f;
+constexpr float BLOCK_AVERAGE = 0.25f;
+constexpr uint32_t TRANSFER_LUT_SIZE = 4096;
+constexpr uint32_t OETF_LUT_SIZE = 16384;
+constexpr uint32_t EOTF_8BIT_LUT_SIZE = 256;
+constexpr uint32_t MAX_10BIT_CODE = 1023;
+constexpr uint32_t P010_SHIFT = 6;
+constexpr uint32_t RGBA1010102_SHIFT_G = 10;
+constexpr uint32_t RGBA1010102_SHIFT_B = 20;
+constexpr uint32_t RGB_CHANNELS = 3;
+constexpr uint32_t RGBA_CHANNELS = 4;
+constexpr uint32_t ALPHA_INDEX = 3;
+constexpr uint32_t BLOCK_SIZE = 2;
+constexpr uint32_t MAX_THREAD_NUM = 4;
+constexpr uint32_t MIN_ROWS_PER_THREAD = 64;
+constexpr uint32_t ISO_CHANNEL_NUM = 3;
+
+// BT.2020 non-constant luminance, 10-bit quantisation.
+constexpr float YUV_LIMIT_Y_OFFSET = 64.0f;
+constexpr float YUV_LIMIT_Y_RANGE = 876.0f;
+constexpr float YUV_LIMIT_UV_RANGE = 896.0f;
+constexpr float YUV_UV_OFFSET = 512.0f;
+constexpr float BT2020_CR_TO_R = 1.4746f;
+constexpr float BT2020_CB_TO_G = 0.16455f;
+constexpr float BT2020_CR_TO_G = 0.57135f;
+constexpr float BT2020_CB_TO_B = 1.8814f;
+
+// SMPTE ST 2084.
+constexpr float PQ_M1 = 0.1593017578125f;
+constexpr float PQ_M2 = 78.84375f;
+constexpr float PQ_C1 = 0.8359375f;
+constexpr float PQ_C2 = 18.8515625f;
+constexpr float PQ_C3 = 18.6875f;
+
+// ARIB STD-B67.
+constexpr float HLG_A = 0.17883277f;
+constexpr float HLG_B = 0.28466892f;
+constexpr float HLG_C = 0.55991073f;
+constexpr float HLG_KNEE = 0.5f;
+constexpr float HLG_SCALE = 12.0f;
+constexpr float HLG_LOW_SCALE = 3.0f;
+
+// IEC 61966-2-1.
+constexpr float SRGB_LINEAR_LIMIT = 0.0031308f;
+constexpr float SRGB_ENCODED_LIMIT = 0.04045f;
+constexpr float SRGB_LINEAR_SCALE = 12.92f;
+constexpr float SRGB_GAMMA = 2.4f;
+constexpr float SRGB_A = 0.055f;
+
+using Matrix3 = std::array<float, RGB_CHANNELS * RGB_CHANNELS>;
+using Vector3 = std::array<float, RGB_CHANNELS>;
+
+constexpr Matrix3 IDENTITY = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+constexpr Matrix3 BT2020_TO_P3 = {
+    1.3435f, -0.2822f, -0.0613f,
+    -0.0653f, 1.0758f, -0.0105f,
+    0.0028f, -0.0196f, 1.0168f,
+};
+constexpr Matrix3 BT2020_TO_SRGB = {
+    1.6605f, -0.5876f, -0.0728f,
+    -0.1246f, 1.1329f, -0.0083f,
+    -0.0182f, -0.1006f, 1.1187f,
+};
+constexpr Matrix3 SRGB_TO_P3 = {
+    0.8225f, 0.1774f, 0.0000f,
+    0.0332f, 0.9669f, 0.0000f,
+    0.0171f, 0.0724f, 0.9108f,
+};
+constexpr Vector3 P3_LUMA = {0.2290f, 0.6917f, 0.0793f};
+constexpr Vector3 SRGB_LUMA = {0.2126f, 0.7152f, 0.0722f};
+
+using TransferLut = std::array<float, TRANSFER_LUT_SIZE>;
+
+struct DecodeContext {
+    PixelFormat format = PixelFormat::UNKNOWN;
+    const uint8_t* pixels = nullptr;
+    uint32_t rowStride = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    YUVDataInfo yuvInfo;
+    bool limitRange = false;
+    const TransferLut* eotf = nullptr;
+    Matrix3 gamut = IDENTITY;
+    Vector3 luma = P3_LUMA;
+};
+
+struct ChunkStats {
+    float minGain = FLT_MAX;
+    float maxGain = -FLT_MAX;
+    float peak = 0.0f;
+};
+
+float PqEotf(float encoded)
+{
+    float p = std::pow(encoded, 1.0f / PQ_M2);
+    float linear = std::pow(std::max(p - PQ_C1, 0.0f) / (PQ_C2 - PQ_C3 * p), 1.0f / PQ_M1);
+    return linear * PQ_PEAK_NITS / SDR_WHITE_NITS;
+}
+
+// Per channel approximation of the HLG OOTF at a 1000 nit display, so the three channels stay independent.
+float HlgEotf(float encoded)
+{
+    float scene = (encoded <= HLG_KNEE) ? encoded * encoded / HLG_LOW_SCALE :
+        (std::exp((encoded - HLG_C) / HLG_A) + HLG_B) / HLG_SCALE;
+    return HLG_PEAK_NITS * std::pow(scene, HLG_SYSTEM_GAMMA) / SDR_WHITE_NITS;
+}
+
+float SrgbOetf(float linear)
+{
+    return (linear <= SRGB_LINEAR_LIMIT) ? linear * SRGB_LINEAR_SCALE :
+        (1.0f + SRGB_A) * std::pow(linear, 1.0f / SRGB_GAMMA) - SRGB_A;
+}
+
+float SrgbEotf(float encoded)
+{
+    return (encoded <= SRGB_ENCODED_LIMIT) ? encoded / SRGB_LINEAR_SCALE :
+        std::pow((encoded + SRGB_A) / (1.0f + SRGB_A), SRGB_GAMMA);
+}
+
+TransferLut BuildTransferLut(float (*eotf)(float))
+{
+    TransferLut lut;
+    for (uint32_t i = 0; i < TRANSFER_LUT_SIZE; i++) {
+        lut[i] = eotf(static_cast<float>(i) / (TRANSFER_LUT_SIZE - 1));
+    }
+    return lut;
+}
+
+const TransferLut& GetPqLut()
+{
+    static const TransferLut lut = BuildTransferLut(PqEotf);
+    return lut;
+}
+
+const TransferLut& GetHlgLut()
+{
+    static const TransferLut lut = BuildTransferLut(HlgEotf);
+    return lut;
+}
+
+const std::array<uint8_t, OETF_LUT_SIZE>& GetSrgbOetfLut()
+{
+    static const std::array<uint8_t, OETF_LUT_SIZE> lut = [] {
+        std::array<uint8_t, OETF_LUT_SIZE> table;
+        for (uint32_t i = 0; i < OETF_LUT_SIZE; i++) {
+            float encoded = SrgbOetf(static_cast<float>(i) / (OETF_LUT_SIZE - 1));
+            table[i] = static_cast<uint8_t>(std::min(encoded, 1.0f) * UINT8_MAX_FLOAT + HALF_PIXEL);
+        }
+        return table;
+    }();
+    return lut;
+}
+
+const std::array<float, EOTF_8BIT_LUT_SIZE>& GetSrgbEotfLut()
+{
+    static const std::array<float, EOTF_8BIT_LUT_SIZE> lut = [] {
+        std::array<float, EOTF_8BIT_LUT_SIZE> table;
+        for (uint32_t i = 0; i < EOTF_8BIT_LUT_SIZE; i++) {
+            table[i] = SrgbEotf(static_cast<float>(i) / UINT8_MAX_FLOAT);
+        }
+        return table;
+    }();
+    return lut;
+}
+
+inline uint32_t ToLutIndex(float value, uint32_t lutSize)
+{
+    float clamped = std::min(std::max(0.0f, value), 1.0f);
+    return static_cast<uint32_t>(clamped * (lutSize - 1) + HALF_PIXEL);
+}
+
+inline float HalfToFloat(uint16_t half)
+{
+    constexpr uint32_t signMask = 0x8000;
+    constexpr uint32_t exponentMask = 0x1f;
+    constexpr uint32_t mantissaMask = 0x3ff;
+    constexpr uint32_t mantissaBits = 10;
+    constexpr uint32_t signShift = 16;
+    constexpr uint32_t floatMantissaShift = 13;
+    constexpr uint32_t floatExponentShift = 23;
+    constexpr uint32_t exponentRebias = 112;
+    constexpr uint32_t floatInfExponent = 0xff;
+    constexpr int subnormalExponent = -24;
+    uint32_t sign = (half & signMask) << signShift;
+    uint32_t exponent = (half >> mantissaBits) & exponentMask;
+    uint32_t mantissa = half & mantissaMask;
+    if (exponent == 0) {
+        float value = std::ldexp(static_cast<float>(mantissa), subnormalExponent);
+        return sign != 0 ? -value : value;
+    }
+    uint32_t bits = sign | (mantissa << floatMantissaShift);
+    bits |= (exponent == exponentMask ? floatInfExponent : exponent + exponentRebias) << floatExponentShift;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void DecodeF16Row(const DecodeContext& ctx, uint32_t y, float* rgb)
+{
+    const uint16_t* row = reinterpret_cast<const uint16_t*>(ctx.pixels + static_cast<size_t>(y) * ctx.rowStride);
+    for (uint32_t x = 0; x < ctx.width; x++) {
+        for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+            rgb[x * RGB_CHANNELS + c] = HalfToFloat(row[x * RGBA_CHANNELS + c]);
+        }
+    }
+}
+
+void Decode1010102Row(const DecodeContext& ctx, uint32_t y, float* rgb)
+{
+    const uint32_t* row = reinterpret_cast<const uint32_t*>(ctx.pixels + static_cast<size_t>(y) * ctx.rowStride);
+    const TransferLut& lut = *ctx.eotf;
+    constexpr uint32_t rounding = MAX_10BIT_CODE / 2;
+    for (uint32_t x = 0; x < ctx.width; x++) {
+        uint32_t pixel = row[x];
+        uint32_t codes[RGB_CHANNELS] = {pixel & MAX_10BIT_CODE, (pixel >> RGBA1010102_SHIFT_G) & MAX_10BIT_CODE,
+            (pixel >> RGBA1010102_SHIFT_B) & MAX_10BIT_CODE};
+        for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+            rgb[x * RGB_CHANNELS + c] = lut[(codes[c] * (TRANSFER_LUT_SIZE - 1) + rounding) / MAX_10BIT_CODE];
+        }
+    }
+}
+
+void DecodeP010Row(const DecodeContext& ctx, uint32_t y, float* rgb)
+{
+    const uint16_t* samples = reinterpret_cast<const uint16_t*>(ctx.pixels);
+    const YUVDataInfo& info = ctx.yuvInfo;
+    const uint16_t* yRow = samples + info.yOffset + static_cast<size_t>(y) * info.yStride;
+    const uint16_t* uvRow = samples + info.uvOffset + static_cast<size_t>(y / BLOCK_SIZE) * info.uvStride;
+    uint32_t cbIndex = ctx.format == PixelFormat::YCBCR_P010 ? 0 : 1;
+    float yOffset = ctx.limitRange ? YUV_LIMIT_Y_OFFSET : 0.0f;
+    float yScale = 1.0f / (ctx.limitRange ? YUV_LIMIT_Y_RANGE : static_cast<float>(MAX_10BIT_CODE));
+    float uvScale = 1.0f / (ctx.limitRange ? YUV_LIMIT_UV_RANGE : static_cast<float>(MAX_10BIT_CODE));
+    const TransferLut& lut = *ctx.eotf;
+    for (uint32_t x = 0; x < ctx.width; x++) {
+        const uint16_t* uv = uvRow + (x / BLOCK_SIZE) * BLOCK_SIZE;
+        float luma = (static_cast<float>(yRow[x] >> P010_SHIFT) - yOffset) * yScale;
+        float cb = (static_cast<float>(uv[cbIndex] >> P010_SHIFT) - YUV_UV_OFFSET) * uvScale;
+        float cr = (static_cast<float>(uv[1 - cbIndex] >> P010_SHIFT) - YUV_UV_OFFSET) * uvScale;
+        float* dst = rgb + x * RGB_CHANNELS;
+        dst[0] = lut[ToLutIndex(luma + BT2020_CR_TO_R * cr, TRANSFER_LUT_SIZE)];
+        dst[1] = lut[ToLutIndex(luma - BT2020_CB_TO_G * cb - BT2020_CR_TO_G * cr, TRANSFER_LUT_SIZE)];
+        dst[2] = lut[ToLutIndex(luma + BT2020_CB_TO_B * cb, TRANSFER_LUT_SIZE)];
+    }
+}
+
+// Linear light relative to SDR white, in the gamut of the base image, negatives and non finite values clamped away.
+void DecodeRow(const DecodeContext& ctx, uint32_t y, float* rgb)
+{
+    if (ctx.format == PixelFormat::RGBA_F16) {
+        DecodeF16Row(ctx, y, rgb);
+    } else if (ctx.format == PixelFormat::RGBA_1010102) {
+        Decode1010102Row(ctx, y, rgb);
+    } else {
+        DecodeP010Row(ctx, y, rgb);
+    }
+    const Matrix3& m = ctx.gamut;
+    for (uint32_t x = 0; x < ctx.width; x++) {
+        float* p = rgb + x * RGB_CHANNELS;
+        float r = p[0];
+        float g = p[1];
+        float b = p[2];
+        for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+            float v = m[c * RGB_CHANNELS] * r + m[c * RGB_CHANNELS + 1] * g + m[c * RGB_CHANNELS + 2] * b;
+            p[c] = std::min(std::max(0.0f, v), MAX_RELATIVE_LUMINANCE);
+        }
+    }
+}
+
+inline float ToneMapKnee(float value)
+{
+    if (value <= KNEE_START) {
+        return value;
+    }
+    constexpr float shoulder = 1.0f - KNEE_START;
+    return KNEE_START + shoulder * (1.0f - std::exp(-(value - KNEE_START) / shoulder));
+}
+
+// Tone maps one row into 8-bit base pixels and writes log2(hdr / sdr) of every pixel to gains. Scaling all three
+// channels by the tone curve of the brightest one keeps the hue, so one gain per pixel restores the HDR colour.
+void ToneMapRow(const DecodeContext& ctx, const float* hdr, uint8_t* base, float* gains, float& peak)
+{
+    const auto& oetf = GetSrgbOetfLut();
+    const auto& eotf = GetSrgbEotfLut();
+    const Vector3& w = ctx.luma;
+    for (uint32_t x = 0; x < ctx.width; x++) {
+        const float* p = hdr + x * RGB_CHANNELS;
+        uint8_t* dst = base + x * RGBA_CHANNELS;
+        float maxChannel = std::max(p[0], std::max(p[1], p[2]));
+        peak = std::max(peak, maxChannel);
+        float scale = maxChannel > 0.0f ? ToneMapKnee(maxChannel) / maxChannel : 0.0f;
+        for (uint32_t c = 0; c < RGB_CHANNELS; c++) {
+            dst[c] = oetf[ToLutIndex(p[c] * scale, OETF_LUT_SIZE)];
+        }
+        dst[ALPHA_INDEX] = UINT8_MAX;
+        float hdrLuma = w[0] * p[0] + w[1] * p[1] + w[2] * p[2];
+        float sdrLuma = w[0] * eotf[dst[0]] + w[1] * eotf[dst[1]] + w[2] * eotf[dst[2]];
+        gains[x] = std::log2((hdrLuma + GAIN_OFFSET) / (sdrLuma + GAIN_OFFSET));
+    }
+}
+
+void ProcessRows(const DecodeContext& ctx, uint32_t rowBegin, uint32_t rowEnd, HdrDecomposeResult& result,
+    std::vector<float>& blockGains, ChunkStats& stats)
+{
+    uint32_t gainmapWidth = static_cast<uint32_t>(result.gainmapWidth);
+    uint32_t gainmapHeight = static_cast<uint32_t>(result.gainmapHeight);
+    size_t baseRowBytes = static_cast<size_t>(ctx.width) * RGBA_CHANNELS;
+    std::vector<float> hdr(static_cast<size_t>(ctx.width) * RGB_CHANNELS);
+    std::vector<float> gains[BLOCK_SIZE] = {std::vector<float>(ctx.width), std::vector<float>(ctx.width)};
+    for (uint32_t y = rowBegin; y < rowEnd; y += BLOCK_SIZE) {
+        uint32_t rows = std::min(BLOCK_SIZE, rowEnd - y);
+        for (uint32_t i = 0; i < rows; i++) {
+            DecodeRow(ctx, y + i, hdr.data());
+            ToneMapRow(ctx, hdr.data(), result.base.data() + (y + i) * baseRowBytes, gains[i].data(), stats.peak);
+        }
+        uint32_t blockRow = y / BLOCK_SIZE;
+        if (rows < BLOCK_SIZE || blockRow >= gainmapHeight) {
+            continue;
+        }
+        float* dst = blockGains.data() + static_cast<size_t>(blockRow) * gainmapWidth;
+        for (uint32_t x = 0; x < gainmapWidth; x++) {
+            uint32_t left = x * BLOCK_SIZE;
+            float gain = (gains[0][left] + gains[0][left + 1] + gains[1][left] + gains[1][left + 1]) * BLOCK_AVERAGE;
+            dst[x] = gain;
+            stats.minGain = std::min(stats.minGain, gain);
+            stats.maxGain = std::max(stats.maxGain, gain);
+        }
+    }
+}
+
+// Runs func over [0, rows) in parts of an even number of rows, on up to four threads with the calling thread
+// taking the first part.
+void ParallelRows(uint32_t rows, const std::function<void(uint32_t, uint32_t, uint32_t)>& func)
+{
+    uint32_t threadNum = std::min(MAX_THREAD_NUM, std::max(1u, rows / MIN_ROWS_PER_THREAD));
+    uint32_t step = (rows + threadNum - 1) / threadNum;
+    step += step % BLOCK_SIZE;
+    std::vector<std::future<void>> futures;
+    for (uint32_t i = 1; i < threadNum && i * step < rows; i++) {
+        uint32_t begin = i * step;
+        futures.push_back(std::async(std::launch::async, func, i, begin, std::min(rows, begin + step)));
+    }
+    func(0, 0, std::min(rows, step));
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+bool InitDecodeContext(PixelMap* pixelMap, const HdrDecomposeOptions& options, DecodeContext& ctx)
+{
+    ctx.format = pixelMap->GetPixelFormat();
+    ctx.pixels = pixelMap->GetPixels();
+    ctx.rowStride = static_cast<uint32_t>(pixelMap->GetRowStride());
+    ctx.width = static_cast<uint32_t>(pixelMap->GetWidth());
+    ctx.height = static_cast<uint32_t>(pixelMap->GetHeight());
+    ctx.limitRange = options.limitRange;
+    ctx.luma = options.sdrIsSRGB ? SRGB_LUMA : P3_LUMA;
+    if (ctx.format == PixelFormat::RGBA_F16) {
+        ctx.gamut = options.sdrIsSRGB ? IDENTITY : SRGB_TO_P3;
+        return true;
+    }
+    ctx.gamut = options.sdrIsSRGB ? BT2020_TO_SRGB : BT2020_TO_P3;
+    ctx.eotf = options.transfer == HdrTransfer::HLG ? &GetHlgLut() : &GetPqLut();
+    if (ctx.format == PixelFormat::RGBA_1010102) {
+        return true;
+    }
+    pixelMap->GetImageYUVInfo(ctx.yuvInfo);
+    YUVDataInfo& info = ctx.yuvInfo;
+    if (info.yStride == 0) {
+        info.yStride = ctx.width;
+    }
+    if (info.uvStride == 0) {
+        info.uvStride = ctx.width + ctx.width % BLOCK_SIZE;
+    }
+    if (info.uvOffset == 0) {
+        info.uvOffset = info.yOffset + info.yStride * ctx.height;
+    }
+    return true;
+}
+
+void FillIsoMetadata(const ChunkStats& stats, HdrMetadata& metadata)
+{
+    ISOMetadata& iso = metadata.extendMeta.metaISO;
+    iso.writeVersion = 0;
+    iso.miniVersion = 0;
+    iso.gainmapChannelNum = ISO_CHANNEL_NUM;
+    iso.useBaseColorFlag = 1;
+    iso.baseHeadroom = 0.0f;
+    iso.alternateHeadroom = std::log2(std::max(stats.peak, 1.0f));
+    for (uint32_t c = 0; c < ISO_CHANNEL_NUM; c++) {
+        iso.enhanceClippedThreholdMinGainmap[c] = stats.minGain;
+        iso.enhanceClippedThreholdMaxGainmap[c] = stats.maxGain;
+        iso.enhanceMappingGamma[c] = 1.0f;
+        iso.enhanceMappingBaselineOffset[c] = GAIN_OFFSET;
+        iso.enhanceMappingAlternateOffset[c] = GAIN_OFFSET;
+    }
+    metadata.extendMetaFlag = true;
+}
+} // namespace
+
+bool HdrGainmapDecomposer::IsSupported(PixelFormat format)
+{
+    return format == PixelFormat::RGBA_1010102 || format == PixelFormat::YCBCR_P010 ||
+        format == PixelFormat::YCRCB_P010 || format == PixelFormat::RGBA_F16;
+}
+
+uint32_t HdrGainmapDecomposer::Decompose(PixelMap* pixelMap, const HdrDecomposeOptions& options,
+    HdrDecomposeResult& result)
+{
+    if (pixelMap == nullptr || pixelMap->GetPixels() == nullptr || !IsSupported(pixelMap->GetPixelFormat())) {
+        IMAGE_LOGE("HdrGainmapDecomposer unsupported pixelmap");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    DecodeContext ctx;
+    if (!InitDecodeContext(pixelMap, options, ctx) || ctx.width / BLOCK_SIZE == 0 || ctx.height / BLOCK_SIZE == 0) {
+        IMAGE_LOGE("HdrGainmapDecomposer invalid size %{public}u x %{public}u", ctx.width, ctx.height);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    result.width = static_cast<int32_t>(ctx.width);
+    result.height = static_cast<int32_t>(ctx.height);
+    result.gainmapWidth = static_cast<int32_t>(ctx.width / BLOCK_SIZE);
+    result.gainmapHeight = static_cast<int32_t>(ctx.height / BLOCK_SIZE);
+    size_t gainmapCount = static_cast<size_t>(result.gainmapWidth) * result.gainmapHeight;
+    result.base.resize(static_cast<size_t>(ctx.width) * ctx.height * RGBA_CHANNELS);
+    result.gainmap.resize(gainmapCount * RGBA_CHANNELS);
+    std::vector<float> blockGains(gainmapCount);
+
+    ChunkStats chunkStats[MAX_THREAD_NUM];
+    ParallelRows(ctx.height, [&](uint32_t part, uint32_t begin, uint32_t end) {
+        ProcessRows(ctx, begin, end, result, blockGains, chunkStats[part]);
+    });
+    ChunkStats stats;
+    for (const ChunkStats& chunk : chunkStats) {
+        stats.minGain = std::min(stats.minGain, chunk.minGain);
+        stats.maxGain = std::max(stats.maxGain, chunk.maxGain);
+        stats.peak = std::max(stats.peak, chunk.peak);
+    }
+    stats.maxGain = std::max(stats.maxGain, stats.minGain + MIN_GAIN_RANGE);
+
+    float quantScale = UINT8_MAX_FLOAT / (stats.maxGain - stats.minGain);
+    ParallelRows(static_cast<uint32_t>(result.gainmapHeight), [&](uint32_t, uint32_t begin, uint32_t end) {
+        size_t first = static_cast<size_t>(begin) * result.gainmapWidth;
+        size_t last = static_cast<size_t>(end) * result.gainmapWidth;
+        for (size_t i = first; i < last; i++) {
+            float level = (blockGains[i] - stats.minGain) * quantScale + HALF_PIXEL;
+            uint8_t value = static_cast<uint8_t>(std::min(std::max(level, 0.0f), UINT8_MAX_FLOAT));
+            uint8_t* dst = result.gainmap.data() + i * RGBA_CHANNELS;
+            dst[0] = value;
+            dst[1] = value;
+            dst[2] = value;
+            dst[ALPHA_INDEX] = UINT8_MAX;
+        }
+    });
+    FillIsoMetadata(stats, result.metadata);
+    result.peakNits = stats.peak * SDR_WHITE_NITS;
+    IMAGE_LOGD("HdrGainmapDecomposer gain [%{public}f, %{public}f], peak %{public}f nits",
+        stats.minGain, stats.maxGain, result.peakNits);
+    return SUCCESS;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
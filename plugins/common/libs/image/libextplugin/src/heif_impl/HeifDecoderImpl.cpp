@@ -37,6 +37,7 @@ extern "C" {
 }
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -226,6 +227,25 @@ static PixelFormat SkHeifColorFormat2PixelFormat(SkHeifColorFormat format)
 }
 // LCOV_EXCL_STOP
 
+// Keep the tiles covered by region, in row-major order.
+static bool GetRegionTiles(uint32_t gridCols, const GridRegion &region,
+                           std::vector<std::shared_ptr<HeifImage>> &tileImages)
+{
+    std::vector<std::shared_ptr<HeifImage>> selected;
+    selected.reserve(static_cast<size_t>(region.grid.cols) * region.grid.rows);
+    for (uint32_t row = region.firstRow; row < region.firstRow + region.grid.rows; ++row) {
+        for (uint32_t col = region.firstCol; col < region.firstCol + region.grid.cols; ++col) {
+            size_t index = static_cast<size_t>(row) * gridCols + col;
+            if (index >= tileImages.size() || tileImages[index] == nullptr) {
+                return false;
+            }
+            selected.push_back(tileImages[index]);
+        }
+    }
+    tileImages.swap(selected);
+    return !tileImages.empty();
+}
+
 HeifDecoderImpl::HeifDecoderImpl()
     : outPixelFormat_(PixelFormat::RGBA_8888),
     dstMemory_(nullptr), dstRowStride_(0), dstHwBuffer_(nullptr),
@@ -472,6 +492,7 @@ static bool IsSupportHardwareDecode(const GridInfo &gridInfo)
 bool HeifDecoderImpl::decode(HeifFrameInfo *frameInfo)
 {
     ImageTrace trace("HeifDecoderImpl::decode");
+    PrepareDecodeRegion();
     if (!IsSupportHardwareDecode(gridInfo_)) {
         HevcSoftDecodeParam param {
             gridInfo_, outPixelFormat_,
@@ -491,8 +512,10 @@ bool HeifDecoderImpl::decode(HeifFrameInfo *frameInfo)
         return false;
     }
 
+    // a region decode leaves hwBuffer holding just the selected tiles, place them at their offset
     bool convertRes = IsDirectYUVDecode() ||
-            ConvertHwBufferPixelFormat(hwBuffer, gridInfo_, dstMemory_, dstRowStride_);
+            ConvertHwBufferPixelFormat(hwBuffer, isRegionDecode_ ? gridRegion_.grid : gridInfo_,
+                                       GetRegionDstMemory(), dstRowStride_);
     if (!convertRes) {
         return false;
     }
@@ -575,9 +598,10 @@ bool HeifDecoderImpl::HwDecodeImage(HeifHardwareDecoder *hwDecoder,
     }
 
     GraphicPixelFormat inPixelFormat = GetInPixelFormat(image);
+    const GridInfo &outGridInfo = isPrimary && isRegionDecode_ && imageType == "grid" ? gridRegion_.grid : gridInfo;
     sptr<SurfaceBuffer> hwBuffer =
             isPrimary && IsDirectYUVDecode() ? sptr<SurfaceBuffer>(dstHwBuffer_) :
-            hwDecoder->AllocateOutputBuffer(gridInfo.displayWidth, gridInfo.displayHeight, inPixelFormat);
+            hwDecoder->AllocateOutputBuffer(outGridInfo.displayWidth, outGridInfo.displayHeight, inPixelFormat);
     if (hwBuffer == nullptr) {
         IMAGE_LOGE("decode AllocateOutputBuffer return null");
         ReleaseHwDecoder(hwDecoder, isReuseHwDecoder);
@@ -592,7 +616,7 @@ bool HeifDecoderImpl::HwDecodeImage(HeifHardwareDecoder *hwDecoder,
         "inPixelFormat: %{public}d", gridInfo.displayWidth, gridInfo.displayHeight, imageType.c_str(), inPixelFormat);
     if (imageType == "grid") {
         gridInfo.enableGrid = true;
-        res = HwDecodeGrids(hwDecoder, image, gridInfo, hwBuffer);
+        res = HwDecodeGrids(hwDecoder, image, gridInfo, hwBuffer, isPrimary);
     } else if (imageType == "hvc1") {
         gridInfo.enableGrid = false;
         res = HwDecodeSingleImage(hwDecoder, image, gridInfo, hwBuffer);
@@ -605,7 +629,7 @@ bool HeifDecoderImpl::HwDecodeImage(HeifHardwareDecoder *hwDecoder,
 }
 
 bool HeifDecoderImpl::HwDecodeGrids(HeifHardwareDecoder *hwDecoder, std::shared_ptr<HeifImage> &image,
-                                    GridInfo &gridInfo, sptr<SurfaceBuffer> &hwBuffer)
+                                    GridInfo &fullGridInfo, sptr<SurfaceBuffer> &hwBuffer, bool isPrimary)
 {
     if (hwDecoder == nullptr || image == nullptr) {
         IMAGE_LOGE("HeifDecoderImpl::DecodeGrids hwDecoder or image is nullptr");
@@ -617,6 +641,12 @@ bool HeifDecoderImpl::HwDecodeGrids(HeifHardwareDecoder *hwDecoder, std::shared_
         IMAGE_LOGE("grid image has no tile image");
         return false;
     }
+    bool isRegion = isPrimary && isRegionDecode_;
+    if (isRegion && !GetRegionTiles(fullGridInfo.cols, gridRegion_, tileImages)) {
+        IMAGE_LOGE("grid image has not enough tiles for region");
+        return false;
+    }
+    GridInfo &gridInfo = isRegion ? gridRegion_.grid : fullGridInfo;
     size_t numGrid = tileImages.size();
     std::vector<std::vector<uint8_t>> inputs(numGrid + 1);
 
@@ -712,7 +742,7 @@ bool HeifDecoderImpl::SwDecodeImage(std::shared_ptr<HeifImage> &image, HevcSoftD
     if (imageType == "grid") {
         param.gridInfo.enableGrid = true;
         gridInfo.enableGrid = true;
-        res = SwDecodeGrids(imageFwkExtManager, image, param);
+        res = SwDecodeGrids(imageFwkExtManager, image, param, isPrimary);
     } else if (imageType == "hvc1") {
         param.gridInfo.enableGrid = false;
         gridInfo.enableGrid = false;
@@ -722,7 +752,7 @@ bool HeifDecoderImpl::SwDecodeImage(std::shared_ptr<HeifImage> &image, HevcSoftD
 }
 
 bool HeifDecoderImpl::SwDecodeGrids(ImageFwkExtManager &extManager,
-                                    std::shared_ptr<HeifImage> &image, HevcSoftDecodeParam &param)
+                                    std::shared_ptr<HeifImage> &image, HevcSoftDecodeParam &param, bool isPrimary)
 {
     if (extManager.doHardWareEncodeFunc_ == nullptr && !extManager.LoadImageFwkExtNativeSo()) {
         return false;
@@ -736,6 +766,9 @@ bool HeifDecoderImpl::SwDecodeGrids(ImageFwkExtManager &extManager,
         IMAGE_LOGE("grid image has no tile image");
         return false;
     }
+    if (isPrimary && isRegionDecode_) {
+        return SwDecodeGridRegion(extManager, tileImages, param);
+    }
     size_t numGrid = tileImages.size();
     std::vector<std::vector<uint8_t>> inputs(numGrid);
 
@@ -754,6 +787,58 @@ bool HeifDecoderImpl::SwDecodeGrids(ImageFwkExtManager &extManager,
     return true;
 }
 
+bool HeifDecoderImpl::SwDecodeGridRegion(ImageFwkExtManager &extManager,
+                                         std::vector<std::shared_ptr<HeifImage>> &tileImages,
+                                         HevcSoftDecodeParam &param)
+{
+    ImageTrace trace("HeifDecoderImpl::SwDecodeGridRegion %u x %u", gridRegion_.grid.cols, gridRegion_.grid.rows);
+    // the selected tiles are decoded as a grid of their own, straight into their place in the destination.
+    // hevcSoftwareDecodeFunc_ lives in the external codec library and is not documented as reentrant, so the
+    // region goes through it in a single call like a whole grid does.
+    HevcSoftDecodeParam regionParam = param;
+    std::vector<std::vector<uint8_t>> inputs;
+    if (!PrepareGridRegion(tileImages, param, regionParam, inputs)) {
+        return false;
+    }
+    int32_t retCode = extManager.hevcSoftwareDecodeFunc_(inputs, regionParam);
+    if (retCode != 0) {
+        IMAGE_LOGE("SwDecodeGridRegion decode failed: %{public}d", retCode);
+        return false;
+    }
+    return true;
+}
+
+bool HeifDecoderImpl::PrepareGridRegion(std::vector<std::shared_ptr<HeifImage>> &tileImages,
+                                        const HevcSoftDecodeParam &param, HevcSoftDecodeParam &regionParam,
+                                        std::vector<std::vector<uint8_t>> &inputs)
+{
+    if (!GetRegionTiles(param.gridInfo.cols, gridRegion_, tileImages)) {
+        IMAGE_LOGE("grid image has not enough tiles for region");
+        return false;
+    }
+    inputs.resize(tileImages.size());
+    for (size_t index = 0; index < tileImages.size(); ++index) {
+        parser_->GetItemData(tileImages[index]->GetItemId(),
+                             &inputs[index], index == 0 ? heif_header_data : heif_no_header);
+        ProcessChunkHead(inputs[index].data(), inputs[index].size());
+    }
+
+    const GridInfo &fullGridInfo = param.gridInfo;
+    uint32_t top = gridRegion_.firstRow * fullGridInfo.tileHeight;
+    regionParam.gridInfo = gridRegion_.grid;
+    regionParam.gridInfo.displayHeight =
+        std::min(fullGridInfo.displayHeight, top + gridRegion_.grid.rows * fullGridInfo.tileHeight) - top;
+    size_t offset = static_cast<size_t>(top) * param.dstStride + static_cast<size_t>(gridRegion_.firstCol) *
+        fullGridInfo.tileWidth * static_cast<size_t>(ImageUtils::GetPixelBytes(param.dstPixFmt));
+    if (param.bufferSize != 0 && offset >= param.bufferSize) {
+        IMAGE_LOGE("region offset %{public}zu is out of dst buffer", offset);
+        return false;
+    }
+    regionParam.dstBuffer = param.dstBuffer + offset;
+    regionParam.bufferSize = param.bufferSize != 0 ? param.bufferSize - static_cast<uint32_t>(offset) : 0;
+    return true;
+}
+
 bool HeifDecoderImpl::SwDecodeIdenImage(std::shared_ptr<HeifImage> &image,
                                         HevcSoftDecodeParam &param, GridInfo &gridInfo, bool isPrimary)
 {
@@ -1005,6 +1090,51 @@ void HeifDecoderImpl::setAuxiliaryDstBuffer(uint8_t* dstBuffer, size_t rowStride
     }
 }
 
+void HeifDecoderImpl::setDecodeRegion(const Rect &region)
+{
+    decodeRegion_ = region;
+}
+
+bool HeifDecoderImpl::PrepareDecodeRegion()
+{
+    isRegionDecode_ = false;
+    if (decodeRegion_.left < 0 || decodeRegion_.top < 0 || decodeRegion_.width <= 0 || decodeRegion_.height <= 0) {
+        return false;
+    }
+    // only packed outputs written through dstMemory_ can take tiles at an offset
+    if (dstMemory_ == nullptr || dstHwBuffer_ != nullptr || primaryImage_ == nullptr ||
+        (outPixelFormat_ != PixelFormat::RGBA_8888 && outPixelFormat_ != PixelFormat::BGRA_8888 &&
+        outPixelFormat_ != PixelFormat::RGB_565) || parser_->GetItemType(primaryImage_->GetItemId()) != "grid") {
+        return false;
+    }
+    GridInfo gridInfo = gridInfo_;
+    gridInfo.enableGrid = true;
+    GridRegion region;
+    if (!gridInfo.GetRegion(static_cast<uint32_t>(decodeRegion_.left), static_cast<uint32_t>(decodeRegion_.top),
+        static_cast<uint32_t>(decodeRegion_.width), static_cast<uint32_t>(decodeRegion_.height), region)) {
+        return false;
+    }
+    if (region.grid.cols == gridInfo.cols && region.grid.rows == gridInfo.rows) {
+        return false;
+    }
+    IMAGE_LOGI("HeifDecoderImpl region decode tiles [%{public}u, %{public}u] %{public}u x %{public}u of "
+        "%{public}u x %{public}u", region.firstCol, region.firstRow, region.grid.cols, region.grid.rows,
+        gridInfo.cols, gridInfo.rows);
+    gridRegion_ = region;
+    isRegionDecode_ = true;
+    return true;
+}
+
+uint8_t *HeifDecoderImpl::GetRegionDstMemory()
+{
+    if (!isRegionDecode_) {
+        return dstMemory_;
+    }
+    size_t top = static_cast<size_t>(gridRegion_.firstRow) * gridRegion_.grid.tileHeight;
+    size_t left = static_cast<size_t>(gridRegion_.firstCol) * gridRegion_.grid.tileWidth;
+    return dstMemory_ + top * dstRowStride_ + left * static_cast<size_t>(ImageUtils::GetPixelBytes(outPixelFormat_));
+}
+
 bool HeifDecoderImpl::getScanline(uint8_t *dst)
 {
     // no need to implement
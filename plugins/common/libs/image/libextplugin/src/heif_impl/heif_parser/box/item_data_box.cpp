@@ -87,11 +87,52 @@ heif_error HeifIlocBox::ParseContent(HeifStreamReader &reader)
         ParseExtents(item, reader, indexSize, offsetSize, lengthSize);
         if (!reader.HasError()) {
             items_.push_back(item);
+            itemIndex_.emplace(item.itemId, items_.size() - 1);
         }
     }
     return reader.GetError();
 }
 
+size_t HeifIlocBox::FindItemIndex(heif_item_id itemId) const
+{
+    auto iter = itemIndex_.find(itemId);
+    if (iter != itemIndex_.end() && iter->second < items_.size() && items_[iter->second].itemId == itemId) {
+        return iter->second;
+    }
+    // items_ may have been changed without the index, fall back to a scan
+    size_t idx;
+    for (idx = 0; idx < items_.size(); idx++) {
+        if (items_[idx].itemId == itemId) {
+            break;
+        }
+    }
+    return idx;
+}
+
+const HeifIlocBox::Item *HeifIlocBox::GetItem(heif_item_id itemId) const
+{
+    size_t idx = FindItemIndex(itemId);
+    return idx < items_.size() ? &items_[idx] : nullptr;
+}
+
+heif_error HeifIlocBox::GetDataView(const Item &item, const std::shared_ptr<HeifInputStream> &stream,
+    const uint8_t *&data, size_t &size) const
+{
+    if (stream == nullptr || item.constructionMethod != CONSTRUCTION_METHOD_FILE_OFFSET ||
+        item.extents.size() != 1) {
+        return heif_error_item_data_not_found;
+    }
+    const Extent &extent = item.extents[0];
+    const uint8_t *view = stream->GetDataAt(static_cast<int64_t>(extent.offset + item.baseOffset),
+        static_cast<size_t>(extent.length));
+    if (view == nullptr) {
+        return heif_error_item_data_not_found;
+    }
+    data = view;
+    size = static_cast<size_t>(extent.length);
+    return heif_error_ok;
+}
+
 heif_error HeifIlocBox::ReadData(const Item &item, const std::shared_ptr<HeifInputStream> &stream,
     const std::shared_ptr<HeifIdatBox> &idat, std::vector<uint8_t> *dest) const
 {
@@ -118,18 +159,14 @@ heif_error HeifIlocBox::ReadData(const Item &item, const std::shared_ptr<HeifInp
 
 heif_error HeifIlocBox::AppendData(heif_item_id itemId, const std::vector<uint8_t> &data, uint8_t constructionMethod)
 {
-    size_t idx;
-    for (idx = 0; idx < items_.size(); idx++) {
-        if (items_[idx].itemId == itemId) {
-            break;
-        }
-    }
+    size_t idx = FindItemIndex(itemId);
     if (idx == items_.size()) {
         Item item;
         item.itemId = itemId;
         item.constructionMethod = constructionMethod;
 
         items_.push_back(item);
+        itemIndex_[itemId] = idx;
     }
     Extent extent;
     extent.data = data;
@@ -150,12 +187,7 @@ heif_error HeifIlocBox::UpdateData(heif_item_id itemID, const std::vector<uint8_
     }
 
     // check whether this item ID already exists
-    size_t idx;
-    for (idx = 0; idx < items_.size(); idx++) {
-        if (items_[idx].itemId == itemID) {
-            break;
-        }
-    }
+    size_t idx = FindItemIndex(itemID);
 
     // No item existing return
     if (idx == items_.size()) {
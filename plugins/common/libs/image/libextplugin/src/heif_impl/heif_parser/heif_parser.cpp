@@ -27,6 +27,8 @@ namespace OHOS {
 namespace ImagePlugin {
 
 const auto EXIF_ID = "Exif\0\0";
+// extent lengths come from the file, only trust them for a reserve up to this size
+constexpr uint64_t MAX_ITEM_DATA_RESERVE = 256 * 1024 * 1024;
 
 HeifParser::HeifParser() = default;
 
@@ -214,14 +216,7 @@ heif_error HeifParser::GetItemData(heif_item_id itemId, std::vector<uint8_t> *ou
     }
 
     std::string item_type = infe_box->GetItemType();
-    auto items = ilocBox_->GetItems();
-    const HeifIlocBox::Item *ilocItem = nullptr;
-    for (const auto &item: items) {
-        if (item.itemId == itemId) {
-            ilocItem = &item;
-            break;
-        }
-    }
+    const HeifIlocBox::Item *ilocItem = ilocBox_->GetItem(itemId);
     if (!ilocItem) {
         return heif_error_item_data_not_found;
     }
@@ -236,17 +231,36 @@ heif_error HeifParser::GetItemData(heif_item_id itemId, std::vector<uint8_t> *ou
             return heif_error_item_data_not_found;
         }
         if (option != heif_only_header) {
-            error = ilocBox_->ReadData(*ilocItem, inputStream_, idatBox_, out);
+            error = ReadIlocItemData(*ilocItem, out);
         } else {
             error = heif_error_ok;
         }
     } else {
-        error = ilocBox_->ReadData(*ilocItem, inputStream_, idatBox_, out);
+        error = ReadIlocItemData(*ilocItem, out);
     }
 
     return error;
 }
 
+heif_error HeifParser::ReadIlocItemData(const HeifIlocBox::Item &item, std::vector<uint8_t> *out) const
+{
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    if (ilocBox_->GetDataView(item, inputStream_, data, size) == heif_error_ok) {
+        // append the in-memory payload in one go instead of seek, zero-fill and read
+        out->insert(out->end(), data, data + size);
+        return heif_error_ok;
+    }
+    uint64_t total = 0;
+    for (const auto &extent : item.extents) {
+        total += extent.length;
+    }
+    if (total <= MAX_ITEM_DATA_RESERVE) {
+        out->reserve(out->size() + static_cast<size_t>(total));
+    }
+    return ilocBox_->ReadData(item, inputStream_, idatBox_, out);
+}
+
 void HeifParser::GetTileImages(heif_item_id gridItemId, std::vector<std::shared_ptr<HeifImage>> &out)
 {
     auto infe = GetInfeBox(gridItemId);
@@ -859,11 +873,9 @@ heif_error HeifParser::SetMetadata(const std::shared_ptr<HeifImage> &image, cons
 
 uint8_t HeifParser::GetConstructMethod(const heif_item_id &id)
 {
-    auto items = ilocBox_->GetItems();
-    for (const auto &item: items) {
-        if (item.itemId == id) {
-            return item.constructionMethod;
-        }
+    const HeifIlocBox::Item *item = ilocBox_->GetItem(id);
+    if (item != nullptr) {
+        return item->constructionMethod;
     }
 
     // CONSTRUCTION_METHOD_FILE_OFFSET 0
@@ -891,14 +903,7 @@ void HeifParser::SetTiffOffset()
         return;
     }
 
-    auto items = ilocBox_->GetItems();
-    const HeifIlocBox::Item *ilocItem = nullptr;
-    for (const auto &item: items) {
-        if (item.itemId == exifId) {
-            ilocItem = &item;
-            break;
-        }
-    }
+    const HeifIlocBox::Item *ilocItem = ilocBox_->GetItem(exifId);
     if (!ilocItem) {
         return;
     }
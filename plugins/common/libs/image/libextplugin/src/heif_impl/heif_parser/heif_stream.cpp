@@ -78,6 +78,15 @@ bool HeifBufferInputStream::Seek(int64_t position)
     return true;
 }
 
+const uint8_t *HeifBufferInputStream::GetDataAt(int64_t position, size_t size) const
+{
+    if (data_ == nullptr || position < 0 || static_cast<size_t>(position) > length_ ||
+        size > length_ - static_cast<size_t>(position)) {
+        return nullptr;
+    }
+    return data_ + position;
+}
+
 HeifStreamReader::HeifStreamReader(std::shared_ptr<HeifInputStream> stream, int64_t start, size_t length)
     : inputStream_(std::move(stream)), start_(start)
 {
@@ -21,8 +21,15 @@
 #include "image_system_properties.h"
 #include "securec.h"
 #include "media_errors.h"
+#include "nocopyable.h"
 
 #include <dlfcn.h>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #undef LOG_DOMAIN
 #define LOG_DOMAIN LOG_TAG_DOMAIN_ID_PLUGIN
@@ -45,6 +52,9 @@ static const uint32_t ASTC_MAGIC_ID = 0x5CA1AB13;
 constexpr uint8_t DEFAULT_DIM = 4;
 constexpr uint8_t HIGH_SPEED_PROFILE_MAP_QUALITY = 20; // quality level is 20 for thumbnail
 constexpr uint8_t RGBA_BYTES_PIXEL_LOG2 = 2;
+constexpr uint32_t ASTC_ENC_MAX_THREADS = 4;
+constexpr int32_t ASTC_ENC_MIN_BLOCKS_PER_THREAD = 1024;
+constexpr size_t ASTC_CONTEXT_POOL_MAX_IDLE = 2; // idle contexts kept per configuration
 #ifdef ENABLE_ASTC_ENCODE_BASED_GPU
 constexpr int32_t WIDTH_CL_THRESHOLD = 256;
 constexpr int32_t HEIGHT_CL_THRESHOLD = 256;
@@ -159,40 +169,119 @@ uint32_t GenAstcHeader(uint8_t *header, astcenc_image img, TextureEncodeOptions
     return SUCCESS;
 }
 
-uint32_t InitAstcencConfig(AstcEncoder* work, TextureEncodeOptions* option)
+static uint32_t GetAstcEncMaxThreads()
 {
-    if ((work == nullptr) || (option == nullptr)) {
-        IMAGE_LOGE("astc input work or option is nullptr.");
-        return ERROR;
+    static const uint32_t maxThreads = std::max(1u, std::min(std::thread::hardware_concurrency(),
+        ASTC_ENC_MAX_THREADS));
+    return maxThreads;
+}
+
+// astcenc contexts are costly to set up, so they are kept per (block size, profile, quality profile) and reused.
+// Every pooled context is allocated for GetAstcEncMaxThreads() workers; an encode may use fewer of them.
+class AstcContextPool {
+public:
+    static AstcContextPool &GetInstance()
+    {
+        static AstcContextPool instance;
+        return instance;
     }
-    unsigned int blockX = option->blockX_;
-    unsigned int blockY = option->blockY_;
-    unsigned int blockZ = 1;
 
-    float quality = ASTCENC_PRE_FAST;
-    unsigned int flags = ASTCENC_FLG_SELF_DECOMPRESS_ONLY;
-    astcenc_error status = astcenc_config_init(work->profile, blockX, blockY,
-        blockZ, quality, flags, &work->config);
-    if (status == ASTCENC_ERR_BAD_BLOCK_SIZE) {
-        IMAGE_LOGE("ERROR: block size is invalid");
-        return ERROR;
-    } else if (status == ASTCENC_ERR_BAD_CPU_FLOAT) {
-        IMAGE_LOGE("ERROR: astcenc must not be compiled with fast-math");
-        return ERROR;
-    } else if (status != ASTCENC_SUCCESS) {
-        IMAGE_LOGE("ERROR: config failed");
-        return ERROR;
+    uint32_t Acquire(AstcEncoder *work, const TextureEncodeOptions *option)
+    {
+        PoolKey key {option->blockX_, option->blockY_, work->profile, option->privateProfile_};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = idleContexts_.find(key);
+            if (iter != idleContexts_.end() && !iter->second.empty()) {
+                work->config = iter->second.back().config;
+                work->codec_context = iter->second.back().context;
+                iter->second.pop_back();
+                return SUCCESS;
+            }
+        }
+        return CreateContext(work, option);
+    }
+
+    void Release(AstcEncoder *work, const TextureEncodeOptions *option)
+    {
+        if (work->codec_context == nullptr) {
+            return;
+        }
+        astcenc_context *context = work->codec_context;
+        work->codec_context = nullptr;
+        if (astcenc_compress_reset(context) == ASTCENC_SUCCESS) {
+            PoolKey key {option->blockX_, option->blockY_, work->profile, option->privateProfile_};
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<PooledContext> &contexts = idleContexts_[key];
+            if (contexts.size() < ASTC_CONTEXT_POOL_MAX_IDLE) {
+                contexts.push_back({work->config, context});
+                return;
+            }
+        }
+        astcenc_context_free(context);
+    }
+
+private:
+    using PoolKey = std::tuple<uint8_t, uint8_t, astcenc_profile, QualityProfile>;
+    struct PooledContext {
+        astcenc_config config;
+        astcenc_context *context;
+    };
+
+    AstcContextPool() = default;
+    ~AstcContextPool()
+    {
+        for (auto &iter : idleContexts_) {
+            for (auto &pooled : iter.second) {
+                astcenc_context_free(pooled.context);
+            }
+        }
     }
-    work->config.privateProfile = option->privateProfile_;
-    if (work->config.privateProfile == HIGH_SPEED_PROFILE) {
-        work->config.tune_refinement_limit = 1;
-        work->config.tune_candidate_limit = 1;
-        work->config.tune_partition_count_limit = 1;
+    DISALLOW_COPY_AND_MOVE(AstcContextPool);
+
+    static uint32_t CreateContext(AstcEncoder *work, const TextureEncodeOptions *option)
+    {
+        unsigned int blockX = option->blockX_;
+        unsigned int blockY = option->blockY_;
+        unsigned int blockZ = 1;
+
+        float quality = ASTCENC_PRE_FAST;
+        unsigned int flags = ASTCENC_FLG_SELF_DECOMPRESS_ONLY;
+        astcenc_error status = astcenc_config_init(work->profile, blockX, blockY,
+            blockZ, quality, flags, &work->config);
+        if (status == ASTCENC_ERR_BAD_BLOCK_SIZE) {
+            IMAGE_LOGE("ERROR: block size is invalid");
+            return ERROR;
+        } else if (status == ASTCENC_ERR_BAD_CPU_FLOAT) {
+            IMAGE_LOGE("ERROR: astcenc must not be compiled with fast-math");
+            return ERROR;
+        } else if (status != ASTCENC_SUCCESS) {
+            IMAGE_LOGE("ERROR: config failed");
+            return ERROR;
+        }
+        work->config.privateProfile = option->privateProfile_;
+        if (work->config.privateProfile == HIGH_SPEED_PROFILE) {
+            work->config.tune_refinement_limit = 1;
+            work->config.tune_candidate_limit = 1;
+            work->config.tune_partition_count_limit = 1;
+        }
+        if (astcenc_context_alloc(&work->config, GetAstcEncMaxThreads(), &work->codec_context) != ASTCENC_SUCCESS) {
+            return ERROR;
+        }
+        return SUCCESS;
     }
-    if (astcenc_context_alloc(&work->config, 1, &work->codec_context) != ASTCENC_SUCCESS) {
+
+    std::mutex mutex_;
+    std::map<PoolKey, std::vector<PooledContext>> idleContexts_;
+};
+
+uint32_t InitAstcencConfig(AstcEncoder* work, TextureEncodeOptions* option)
+{
+    if ((work == nullptr) || (option == nullptr)) {
+        IMAGE_LOGE("astc input work or option is nullptr.");
         return ERROR;
     }
-    return SUCCESS;
+    return AstcContextPool::GetInstance().Acquire(work, option);
 }
 
 void extractDimensions(std::string &format, TextureEncodeOptions &param)
@@ -262,7 +351,7 @@ bool CheckQuality(int32_t *mseIn[RGBA_COM], int blockNum, int blockXYZ)
 }
 #endif
 
-static void FreeMem(AstcEncoder *work)
+static void FreeMem(AstcEncoder *work, const TextureEncodeOptions &param)
 {
     if (!work) {
         return;
@@ -281,10 +370,7 @@ static void FreeMem(AstcEncoder *work)
         free(work->image_.data);
         work->image_.data = nullptr;
     }
-    if (work->codec_context != nullptr) {
-        astcenc_context_free(work->codec_context);
-        work->codec_context = nullptr;
-    }
+    AstcContextPool::GetInstance().Release(work, &param);
     work->data_out_ = nullptr;
 }
 
@@ -322,6 +408,33 @@ static bool InitMem(AstcEncoder *work, TextureEncodeOptions param)
     return true;
 }
 
+// Splits the blocks of one image across worker threads; astcenc hands out blocks to each thread_index itself.
+static astcenc_error CompressImageParallel(AstcEncoder &work, TextureEncodeOptions &param)
+{
+    auto compress = [&work, &param](unsigned int threadIndex) {
+        return astcenc_compress_image(work.codec_context, &work.image_, &work.swizzle_,
+            work.data_out_ + TEXTURE_HEAD_BYTES, param.astcBytes - TEXTURE_HEAD_BYTES,
+#if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
+            work.calQualityEnable, work.mse,
+#endif
+            threadIndex);
+    };
+    uint32_t threadCount = std::min(GetAstcEncMaxThreads(),
+        static_cast<uint32_t>(std::max(param.blocksNum / ASTC_ENC_MIN_BLOCKS_PER_THREAD, 1)));
+    std::vector<std::future<astcenc_error>> workers;
+    for (uint32_t threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+        workers.emplace_back(std::async(std::launch::async, compress, threadIndex));
+    }
+    astcenc_error error = compress(0);
+    for (auto &worker : workers) {
+        astcenc_error workerError = worker.get();
+        if (error == ASTCENC_SUCCESS) {
+            error = workerError;
+        }
+    }
+    return error;
+}
+
 bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer)
 {
     if ((pixmapIn == nullptr) || (astcBuffer == nullptr)) {
@@ -330,27 +443,22 @@ bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pix
     }
     AstcEncoder work;
     if (!InitMem(&work, param)) {
-        FreeMem(&work);
+        FreeMem(&work, param);
         return false;
     }
     if (InitAstcencConfig(&work, &param) != SUCCESS) {
         IMAGE_LOGE("astc InitAstcencConfig failed");
-        FreeMem(&work);
+        FreeMem(&work, param);
         return false;
     }
     work.image_.data[0] = pixmapIn;
     work.data_out_ = astcBuffer;
     if (GenAstcHeader(work.data_out_, work.image_, param) != SUCCESS) {
         IMAGE_LOGE("astc GenAstcHeader failed");
-        FreeMem(&work);
+        FreeMem(&work, param);
         return false;
     }
-    work.error_ = astcenc_compress_image(work.codec_context, &work.image_, &work.swizzle_,
-        work.data_out_ + TEXTURE_HEAD_BYTES, param.astcBytes - TEXTURE_HEAD_BYTES,
-#if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
-        work.calQualityEnable, work.mse,
-#endif
-        0);
+    work.error_ = CompressImageParallel(work, param);
 #if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
     if ((ASTCENC_SUCCESS != work.error_) ||
         (work.calQualityEnable && !CheckQuality(work.mse, param.blocksNum, param.blockX_ * param.blockY_))) {
@@ -358,10 +466,10 @@ bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pix
     if (ASTCENC_SUCCESS != work.error_) {
 #endif
         IMAGE_LOGE("astc compress failed");
-        FreeMem(&work);
+        FreeMem(&work, param);
         return false;
     }
-    FreeMem(&work);
+    FreeMem(&work, param);
     return true;
 }
 
@@ -480,7 +588,7 @@ uint32_t AstcCodec::AstcSoftwareEncode(TextureEncodeOptions &param, bool enableQ
 {
     ImageInfo imageInfo;
     astcPixelMap_->GetImageInfo(imageInfo);
-    uint8_t *pixmapIn = static_cast<uint8_t *>(astcPixelMap_->GetWritablePixels());
+    uint8_t *pixmapIn = const_cast<uint8_t *>(astcPixelMap_->GetPixels());
     uint32_t stride = static_cast<uint32_t>(astcPixelMap_->GetRowStride()) >> RGBA_BYTES_PIXEL_LOG2;
     if (!InitAstcEncPara(param, imageInfo.size.width, imageInfo.size.height, static_cast<int32_t>(stride), astcOpts_)) {
         IMAGE_LOGE("InitAstcEncPara failed");
@@ -525,7 +633,7 @@ uint32_t AstcCodec::ASTCEncode()
     ImageInfo imageInfo;
     astcPixelMap_->GetImageInfo(imageInfo);
     TextureEncodeOptions param;
-    uint8_t *pixmapIn = static_cast<uint8_t *>(astcPixelMap_->GetWritablePixels());
+    uint8_t *pixmapIn = const_cast<uint8_t *>(astcPixelMap_->GetPixels());
     int32_t stride = astcPixelMap_->GetRowStride() >> RGBA_BYTES_PIXEL_LOG2;
     if (!InitAstcEncPara(param, imageInfo.size.width, imageInfo.size.height, stride, astcOpts_)) {
         IMAGE_LOGE("InitAstcEncPara failed");
@@ -44,6 +44,28 @@ typedef struct ColorSubdivMap {
     ColorCoordinate *coordinate;
 } ColorSubdivMap;
 
+typedef struct GifFrameRect {
+    uint16_t left;
+    uint16_t top;
+    uint16_t width;
+    uint16_t height;
+} GifFrameRect;
+
+// LZW coder state of one frame; each frame is coded into its own output buffer so frames can be coded in parallel.
+typedef struct LZWContext {
+    int lastCode;
+    int eofCode;
+    int runningCode;
+    int clearCode;
+    int runningBits;
+    int maxCode;
+    int crntShiftState;
+    uint32_t crntShiftDWord;
+    uint32_t dictionary[DICTIONARY_SIZE];
+    uint8_t outputLZWBuffer[256];
+    std::vector<uint8_t> *output;
+} LZWContext;
+
 class GifEncoder : public AbsImageEncoder, public OHOS::MultimediaPlugin::PluginClassBase {
 public:
     GifEncoder();
@@ -52,45 +74,36 @@ public:
     uint32_t AddImage(Media::PixelMap &pixelMap) override;
     uint32_t AddPicture(Media::Picture &picture) override;
     uint32_t FinalizeEncode() override;
+    void Reset() override;
     bool Write(const uint8_t* data, size_t data_size);
 
 private:
     DISALLOW_COPY_AND_MOVE(GifEncoder);
     uint32_t DoEncode();
     uint32_t WriteFileInfo();
-    uint32_t WriteFrameInfo(int index);
-    uint32_t processFrame(int index);
-    uint32_t colorQuantize(int index, uint16_t width, uint16_t height,
-                           uint8_t *outputBuffer, ColorType *outputColorMap);
-    uint32_t separateRGB(int index, uint16_t width, uint16_t height,
-                         uint8_t *redBuffer, uint8_t *greenBuffer, uint8_t *blueBuffer);
-    uint32_t doColorQuantize(uint16_t width, uint16_t height,
+    uint32_t EncodeFrames(std::vector<std::vector<uint8_t>> &frames);
+    uint32_t EncodeFrame(int index, std::vector<uint8_t> &frameData);
+    bool CanOptimizeFrame(int index);
+    uint8_t GetDisposalType(int index);
+    uint32_t GetFramePixels(int index, std::vector<uint32_t> &pixels);
+    void WriteFrameInfo(int index, const GifFrameRect &rect, bool hasTransparency, std::vector<uint8_t> &frameData);
+    uint32_t doColorQuantize(uint32_t pixelCount,
                              const uint8_t *redInput, const uint8_t *greenInput, const uint8_t *blueInput,
-                             uint8_t *outputBuffer, ColorType *outputColorMap);
-    uint32_t BuildColorSubdivMap(ColorSubdivMap *colorSubdivMap, uint32_t *colorSubdivMapSize);
+                             uint8_t *outputBuffer, ColorType *outputColorMap, uint32_t maxColors);
+    uint32_t BuildColorSubdivMap(ColorSubdivMap *colorSubdivMap, uint32_t *colorSubdivMapSize, uint32_t maxColors);
     int SortCmpRtn(const void *Entry1, const void *Entry2);
-    void InitDictionary();
-    int IsInDictionary(uint32_t Key);
-    void AddToDictionary(uint32_t Key, int Code);
-    uint32_t LZWEncodeFrame(uint8_t *outputBuffer, uint16_t width, uint16_t height);
-    uint32_t LZWEncode(uint8_t *buffer, int length);
-    uint32_t LZWWriteOut(int Code);
-    uint32_t LZWBufferOutput(int c);
+    void InitDictionary(LZWContext &context);
+    int IsInDictionary(LZWContext &context, uint32_t Key);
+    void AddToDictionary(LZWContext &context, uint32_t Key, int Code);
+    uint32_t LZWEncodeFrame(LZWContext &context, uint8_t *outputBuffer, uint16_t width, uint16_t height);
+    uint32_t LZWEncode(LZWContext &context, uint8_t *buffer, int length);
+    uint32_t LZWWriteOut(LZWContext &context, int Code);
+    uint32_t LZWBufferOutput(LZWContext &context, int c);
 
 private:
     OutputDataStream *outputStream_ {nullptr};
     std::vector<Media::PixelMap*> pixelMaps_;
     PlEncodeOptions encodeOpts_;
-    int lastCode_;
-    int eofCode_;
-    int runningCode_;
-    int clearCode_;
-    int runningBits_;
-    int maxCode_;
-    int crntShiftState_;
-    uint32_t crntShiftDWord_;
-    uint32_t dictionary_[DICTIONARY_SIZE];
-    uint8_t outputLZWBuffer_[256];
 };
 
 } // namespace ImagePlugin
@@ -17,7 +17,12 @@
 #include "image_trace.h"
 #include "media_errors.h"
 #include "securec.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <thread>
 #undef LOG_DOMAIN
 #define LOG_DOMAIN LOG_TAG_DOMAIN_ID_PLUGIN
 
@@ -52,12 +57,19 @@ const int FIRST_CODE = 4097;
 const int DEFAULT_DELAY_TIME = 100;
 const int DEFAULT_DISPOSAL_TYPE = 1;
 const int DISPOSAL_METHOD_SHIFT_BIT = 2;
+const int DISPOSAL_RESTORE_BACKGROUND = 2;
+const int TRANSPARENT_COLOR_FLAG = 0x01;
+const int TRANSPARENT_COLOR_INDEX = COLOR_MAP_SIZE - 1;
+const uint8_t GIF_TRAILER = 0x3B;
+const uint32_t ARGB_RGB_MASK = 0x00FFFFFF;
+const uint32_t GIF_ENCODE_MAX_THREADS = 4;
 
 const uint8_t GIF89_STAMP[] = {0x47, 0x49, 0x46, 0x38, 0x39, 0x61};
 const uint8_t APPLICATION_IDENTIFIER[] = {0x4E, 0x45, 0x54, 0x53, 0x43, 0x41, 0x50, 0x45};
 const uint8_t APPLICATION_AUTENTICATION_CODE[] = {0x32, 0x2E, 0x30};
 
-static int g_sortRGBAxis = 0;
+// frames are quantized on several threads, each needs its own sort axis for qsort
+static thread_local int g_sortRGBAxis = 0;
 
 #pragma pack(1)
 typedef struct LogicalScreenDescriptor {
@@ -106,6 +118,12 @@ typedef struct ColorInput {
 } ColorInput;
 #pragma pack()
 
+static void AppendBytes(std::vector<uint8_t> &output, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    output.insert(output.end(), bytes, bytes + size);
+}
+
 GifEncoder::GifEncoder()
 {
     IMAGE_LOGD("create IN");
@@ -155,6 +173,13 @@ uint32_t GifEncoder::AddPicture(Media::Picture &picture)
     return ERR_IMAGE_ENCODE_FAILED;
 }
 
+void GifEncoder::Reset()
+{
+    pixelMaps_.clear();
+    outputStream_ = nullptr;
+    encodeOpts_ = PlEncodeOptions();
+}
+
 uint32_t GifEncoder::FinalizeEncode()
 {
     ImageTrace imageTrace("GifEncoder::FinalizeEncode");
@@ -179,18 +204,57 @@ uint32_t GifEncoder::DoEncode()
 {
     IMAGE_LOGD("DoEncode IN");
 
-    WriteFileInfo();
+    std::vector<std::vector<uint8_t>> frames(pixelMaps_.size());
+    uint32_t errorCode = EncodeFrames(frames);
+    if (errorCode != SUCCESS) {
+        return errorCode;
+    }
 
-    for (int index = 0; index < pixelMaps_.size(); index++) {
-        InitDictionary();
-        WriteFrameInfo(index);
-        processFrame(index);
+    errorCode = WriteFileInfo();
+    if (errorCode != SUCCESS) {
+        return errorCode;
+    }
+    for (const auto &frame : frames) {
+        if (!Write(frame.data(), frame.size())) {
+            IMAGE_LOGE("Write to buffer error.");
+            return ERR_IMAGE_ENCODE_FAILED;
+        }
+    }
+    if (!Write(&GIF_TRAILER, sizeof(GIF_TRAILER))) {
+        IMAGE_LOGE("Write to buffer error.");
+        return ERR_IMAGE_ENCODE_FAILED;
     }
 
     IMAGE_LOGD("DoEncode OUT");
     return SUCCESS;
 }
 
+uint32_t GifEncoder::EncodeFrames(std::vector<std::vector<uint8_t>> &frames)
+{
+    uint32_t threadCount = std::min({std::max(std::thread::hardware_concurrency(), 1u), GIF_ENCODE_MAX_THREADS,
+        static_cast<uint32_t>(frames.size())});
+    std::atomic<size_t> nextFrame {0};
+    std::atomic<bool> failed {false};
+    auto worker = [this, &frames, &nextFrame, &failed]() {
+        size_t index;
+        while (!failed.load() && (index = nextFrame.fetch_add(1)) < frames.size()) {
+            if (EncodeFrame(static_cast<int>(index), frames[index]) != SUCCESS) {
+                IMAGE_LOGE("Failed to encode frame %{public}zu.", index);
+                failed.store(true);
+            }
+        }
+    };
+    std::vector<std::future<void>> workers;
+    for (uint32_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto &future : workers) {
+        future.wait();
+    }
+    return failed.load() ? ERR_IMAGE_ENCODE_FAILED : SUCCESS;
+}
+
 uint32_t GifEncoder::WriteFileInfo()
 {
     if (!Write(GIF89_STAMP, sizeof(GIF89_STAMP))) {
@@ -234,139 +298,165 @@ uint32_t GifEncoder::WriteFileInfo()
     return SUCCESS;
 }
 
-uint32_t GifEncoder::WriteFrameInfo(int index)
+uint8_t GifEncoder::GetDisposalType(int index)
 {
-    GraphicControlExtension gce;
-    memset_s(&gce, sizeof(GraphicControlExtension), 0, sizeof(GraphicControlExtension));
-    gce.extensionIntroducer = EXTENSION_INTRODUCER;
-    gce.graphicControlLabel = GRAPHIC_CONTROL_LABEL;
-    gce.blockSize = 0x04;
-    gce.packedFields = 0x00;
-    gce.packedFields |= (((index < encodeOpts_.disposalTypes.size() ?
-        encodeOpts_.disposalTypes[index] : DEFAULT_DISPOSAL_TYPE) & 0x07) << DISPOSAL_METHOD_SHIFT_BIT);
-    gce.delayTime = index < encodeOpts_.delayTimes.size() ? encodeOpts_.delayTimes[index] : DEFAULT_DELAY_TIME;
-    gce.transparentColorIndex = 0x00;
-    gce.blockTerminator = 0x00;
-    if (!Write((const uint8_t*)&gce, sizeof(GraphicControlExtension))) {
-        IMAGE_LOGE("Write to buffer error.");
-        return ERR_IMAGE_ENCODE_FAILED;
-    }
+    return (index < encodeOpts_.disposalTypes.size() ?
+        encodeOpts_.disposalTypes[index] : DEFAULT_DISPOSAL_TYPE) & 0x07;
+}
 
-    ImageDescriptor id;
-    memset_s(&id, sizeof(ImageDescriptor), 0, sizeof(ImageDescriptor));
-    id.imageSeparator = IMAGE_SEPARATOR;
-    id.imageLeftPosition = 0x0000;
-    id.imageTopPosition = 0x0000;
-    id.imageWidth = static_cast<uint16_t>(pixelMaps_[index]->GetWidth());
-    id.imageHeight = static_cast<uint16_t>(pixelMaps_[index]->GetHeight());
-    id.packedFields = 0x87;
-    if (!Write((const uint8_t*)&id, sizeof(ImageDescriptor))) {
-        IMAGE_LOGE("Write to buffer error.");
-        return ERR_IMAGE_ENCODE_FAILED;
+// A frame may be stored as a difference to its predecessor only when the predecessor stays on the canvas
+// and restoring this frame to the background would not clear more than the stored rectangle.
+bool GifEncoder::CanOptimizeFrame(int index)
+{
+    if (!encodeOpts_.optimizeFrames || index <= 0) {
+        return false;
+    }
+    if (pixelMaps_[index]->GetWidth() != pixelMaps_[index - 1]->GetWidth() ||
+        pixelMaps_[index]->GetHeight() != pixelMaps_[index - 1]->GetHeight()) {
+        return false;
     }
+    return GetDisposalType(index - 1) <= DEFAULT_DISPOSAL_TYPE &&
+        GetDisposalType(index) != DISPOSAL_RESTORE_BACKGROUND;
+}
 
+uint32_t GifEncoder::GetFramePixels(int index, std::vector<uint32_t> &pixels)
+{
+    int32_t width = pixelMaps_[index]->GetWidth();
+    int32_t height = pixelMaps_[index]->GetHeight();
+    pixels.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (!pixelMaps_[index]->GetARGB32Color(x, y, pixels[y * width + x])) {
+                IMAGE_LOGE("Failed to get rgb value.");
+                return ERR_IMAGE_ENCODE_FAILED;
+            }
+        }
+    }
     return SUCCESS;
 }
 
-uint32_t GifEncoder::processFrame(int index)
+static GifFrameRect GetChangedRect(const std::vector<uint32_t> &current, const std::vector<uint32_t> &previous,
+    uint16_t width, uint16_t height)
 {
-    ColorType *colorMap = (ColorType *)malloc(sizeof(ColorType) * COLOR_MAP_SIZE);
-    if (colorMap == NULL) {
-        IMAGE_LOGE("Failed to allocate memory.");
-        return ERR_IMAGE_ENCODE_FAILED;
-    }
-    uint16_t width = static_cast<uint16_t>(pixelMaps_[index]->GetWidth());
-    uint16_t height = static_cast<uint16_t>(pixelMaps_[index]->GetHeight());
-    uint64_t frameSize = width * height;
-    uint8_t *colorBuffer = (uint8_t *)malloc(frameSize);
-    if (colorBuffer == NULL) {
-        IMAGE_LOGE("Failed to allocate memory.");
-        free(colorMap);
-        return ERR_IMAGE_ENCODE_FAILED;
-    }
-    if (colorQuantize(index, width, height, colorBuffer, colorMap)) {
-        IMAGE_LOGE("Failed to quantize color.");
-        free(colorBuffer);
-        free(colorMap);
-        return ERR_IMAGE_ENCODE_FAILED;
-    }
-    for (int j = 0; j < COLOR_MAP_SIZE; j++) {
-        Write(&(colorMap[j].red), 1);
-        Write(&(colorMap[j].green), 1);
-        Write(&(colorMap[j].blue), 1);
+    int left = width;
+    int top = height;
+    int right = -1;
+    int bottom = -1;
+    for (int y = 0; y < height; y++) {
+        const uint32_t *curRow = current.data() + y * width;
+        const uint32_t *prevRow = previous.data() + y * width;
+        for (int x = 0; x < width; x++) {
+            if (((curRow[x] ^ prevRow[x]) & ARGB_RGB_MASK) != 0) {
+                left = std::min(left, x);
+                right = std::max(right, x);
+                top = std::min(top, y);
+                bottom = y;
+            }
+        }
     }
-
-    if (LZWEncodeFrame(colorBuffer, width, height)) {
-        IMAGE_LOGE("Failed to encode frame.");
-        free(colorBuffer);
-        free(colorMap);
-        return ERR_IMAGE_ENCODE_FAILED;
+    if (right < 0) {
+        // nothing changed, keep a single transparent pixel so the frame still carries its delay
+        return {0, 0, 1, 1};
     }
-
-    free(colorBuffer);
-    free(colorMap);
-
-    return SUCCESS;
+    return {static_cast<uint16_t>(left), static_cast<uint16_t>(top),
+        static_cast<uint16_t>(right - left + 1), static_cast<uint16_t>(bottom - top + 1)};
 }
 
-uint32_t GifEncoder::colorQuantize(int index, uint16_t width, uint16_t height,
-                                   uint8_t *outputBuffer, ColorType *outputColorMap)
+uint32_t GifEncoder::EncodeFrame(int index, std::vector<uint8_t> &frameData)
 {
-    uint8_t *redBuffer = NULL;
-    uint8_t *greenBuffer = NULL;
-    uint8_t *blueBuffer = NULL;
-    uint64_t frameSize = width * height;
-    if ((redBuffer = (uint8_t *)malloc(frameSize)) == NULL ||
-        (greenBuffer = (uint8_t *)malloc(frameSize)) == NULL ||
-        (blueBuffer = (uint8_t *)malloc(frameSize)) == NULL) {
-        IMAGE_LOGE("Failed to allocate memory.");
+    uint16_t width = static_cast<uint16_t>(pixelMaps_[index]->GetWidth());
+    uint16_t height = static_cast<uint16_t>(pixelMaps_[index]->GetHeight());
+    std::vector<uint32_t> pixels;
+    if (GetFramePixels(index, pixels) != SUCCESS) {
         return ERR_IMAGE_ENCODE_FAILED;
     }
+    GifFrameRect rect = {0, 0, width, height};
+    std::vector<uint32_t> previous;
+    bool optimize = CanOptimizeFrame(index);
+    if (optimize) {
+        if (GetFramePixels(index - 1, previous) != SUCCESS) {
+            return ERR_IMAGE_ENCODE_FAILED;
+        }
+        rect = GetChangedRect(pixels, previous, width, height);
+    }
+
+    uint32_t rectSize = static_cast<uint32_t>(rect.width) * rect.height;
+    std::vector<uint8_t> redBuffer(rectSize);
+    std::vector<uint8_t> greenBuffer(rectSize);
+    std::vector<uint8_t> blueBuffer(rectSize);
+    std::vector<bool> changed(rectSize, true);
+    uint32_t pixelCount = 0;
+    for (uint32_t y = 0; y < rect.height; y++) {
+        for (uint32_t x = 0; x < rect.width; x++) {
+            size_t pos = static_cast<size_t>(rect.top + y) * width + rect.left + x;
+            if (optimize && ((pixels[pos] ^ previous[pos]) & ARGB_RGB_MASK) == 0) {
+                changed[y * rect.width + x] = false;
+                continue;
+            }
+            redBuffer[pixelCount] = pixelMaps_[index]->GetARGB32ColorR(pixels[pos]);
+            greenBuffer[pixelCount] = pixelMaps_[index]->GetARGB32ColorG(pixels[pos]);
+            blueBuffer[pixelCount] = pixelMaps_[index]->GetARGB32ColorB(pixels[pos]);
+            pixelCount++;
+        }
+    }
 
-    if (separateRGB(index, width, height, redBuffer, greenBuffer, blueBuffer)) {
-        IMAGE_LOGE("Failed to separate RGB, aborted.");
-        free(redBuffer);
-        free(greenBuffer);
-        free(blueBuffer);
+    bool hasTransparency = pixelCount < rectSize;
+    ColorType colorMap[COLOR_MAP_SIZE];
+    memset_s(colorMap, sizeof(colorMap), 0, sizeof(colorMap));
+    std::vector<uint8_t> quantized(pixelCount);
+    if (pixelCount > 0 && doColorQuantize(pixelCount, redBuffer.data(), greenBuffer.data(), blueBuffer.data(),
+        quantized.data(), colorMap, hasTransparency ? TRANSPARENT_COLOR_INDEX : COLOR_MAP_SIZE)) {
+        IMAGE_LOGE("Failed to quantize color.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
+    std::vector<uint8_t> colorBuffer(rectSize);
+    for (uint32_t i = 0, j = 0; i < rectSize; i++) {
+        colorBuffer[i] = changed[i] ? quantized[j++] : TRANSPARENT_COLOR_INDEX;
+    }
 
-    if (doColorQuantize(width, height, redBuffer, greenBuffer, blueBuffer, outputBuffer, outputColorMap)) {
-        IMAGE_LOGE("Failed to quantize buffer, aborted.");
-        free(redBuffer);
-        free(greenBuffer);
-        free(blueBuffer);
+    WriteFrameInfo(index, rect, hasTransparency, frameData);
+    AppendBytes(frameData, colorMap, sizeof(colorMap));
+    auto context = std::make_unique<LZWContext>();
+    context->output = &frameData;
+    InitDictionary(*context);
+    if (LZWEncodeFrame(*context, colorBuffer.data(), rect.width, rect.height)) {
+        IMAGE_LOGE("Failed to encode frame.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
-
-    free(redBuffer);
-    free(greenBuffer);
-    free(blueBuffer);
-
     return SUCCESS;
 }
 
-uint32_t GifEncoder::separateRGB(int index, uint16_t width, uint16_t height,
-                                 uint8_t *redBuffer, uint8_t *greenBuffer, uint8_t *blueBuffer)
+void GifEncoder::WriteFrameInfo(int index, const GifFrameRect &rect, bool hasTransparency,
+    std::vector<uint8_t> &frameData)
 {
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            uint32_t pixelColor;
-            if (!pixelMaps_[index]->GetARGB32Color(x, y, pixelColor)) {
-                IMAGE_LOGE("Failed to get rgb value.");
-                return ERR_IMAGE_ENCODE_FAILED;
-            }
-            redBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorR(pixelColor);
-            greenBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorG(pixelColor);
-            blueBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorB(pixelColor);
-        }
+    GraphicControlExtension gce;
+    memset_s(&gce, sizeof(GraphicControlExtension), 0, sizeof(GraphicControlExtension));
+    gce.extensionIntroducer = EXTENSION_INTRODUCER;
+    gce.graphicControlLabel = GRAPHIC_CONTROL_LABEL;
+    gce.blockSize = 0x04;
+    gce.packedFields = 0x00;
+    gce.packedFields |= GetDisposalType(index) << DISPOSAL_METHOD_SHIFT_BIT;
+    gce.delayTime = index < encodeOpts_.delayTimes.size() ? encodeOpts_.delayTimes[index] : DEFAULT_DELAY_TIME;
+    gce.transparentColorIndex = 0x00;
+    if (hasTransparency) {
+        gce.packedFields |= TRANSPARENT_COLOR_FLAG;
+        gce.transparentColorIndex = TRANSPARENT_COLOR_INDEX;
     }
+    gce.blockTerminator = 0x00;
+    AppendBytes(frameData, &gce, sizeof(GraphicControlExtension));
 
-    return SUCCESS;
+    ImageDescriptor id;
+    memset_s(&id, sizeof(ImageDescriptor), 0, sizeof(ImageDescriptor));
+    id.imageSeparator = IMAGE_SEPARATOR;
+    id.imageLeftPosition = rect.left;
+    id.imageTopPosition = rect.top;
+    id.imageWidth = rect.width;
+    id.imageHeight = rect.height;
+    id.packedFields = 0x87;
+    AppendBytes(frameData, &id, sizeof(ImageDescriptor));
 }
 
-void InitColorCube(ColorCoordinate *colorCoordinate, uint16_t width, uint16_t height,
-                   ColorInput *colorInput)
+void InitColorCube(ColorCoordinate *colorCoordinate, uint32_t pixelCount, ColorInput *colorInput)
 {
     for (int i = 0; i < COLOR_ARRAY_SIZE; i++) {
         colorCoordinate[i].rgb[R_IN_RGB] = (i >> RED_COORDINATE) & 0x1F;
@@ -375,7 +465,7 @@ void InitColorCube(ColorCoordinate *colorCoordinate, uint16_t width, uint16_t he
         colorCoordinate[i].pixelNum = 0;
     }
 
-    for (int i = 0; i < static_cast<int>(width * height); i++) {
+    for (uint32_t i = 0; i < pixelCount; i++) {
         uint16_t index = ((colorInput->redInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << RED_COORDINATE) +
                  ((colorInput->greenInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << GREEN_COORDINATE) +
                  ((colorInput->blueInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << BLUE_COORDINATE);
@@ -383,7 +473,7 @@ void InitColorCube(ColorCoordinate *colorCoordinate, uint16_t width, uint16_t he
     }
 }
 
-void InitColorSubdivMap(ColorSubdivMap* colorSubdivMap, uint16_t width, uint16_t height)
+void InitColorSubdivMap(ColorSubdivMap* colorSubdivMap, uint32_t pixelCount)
 {
     for (int i = 0; i < COLOR_OF_GIF; i++) {
         for (int j = 0; j < NUM_OF_RGB; j++) {
@@ -394,7 +484,7 @@ void InitColorSubdivMap(ColorSubdivMap* colorSubdivMap, uint16_t width, uint16_t
         colorSubdivMap[i].pixelNum = 0;
         colorSubdivMap[i].colorNum = 0;
     }
-    colorSubdivMap[0].pixelNum = ((long)width) * height;
+    colorSubdivMap[0].pixelNum = static_cast<long>(pixelCount);
 }
 
 void InitForQuantize(ColorCoordinate *colorCoordinate, ColorSubdivMap* colorSubdivMap)
@@ -416,9 +506,9 @@ void InitForQuantize(ColorCoordinate *colorCoordinate, ColorSubdivMap* colorSubd
     coordinate->next = NULL;
 }
 
-uint32_t GifEncoder::doColorQuantize(uint16_t width, uint16_t height,
+uint32_t GifEncoder::doColorQuantize(uint32_t pixelCount,
                                      const uint8_t *redInput, const uint8_t *greenInput, const uint8_t *blueInput,
-                                     uint8_t *outputBuffer, ColorType *outputColorMap)
+                                     uint8_t *outputBuffer, ColorType *outputColorMap, uint32_t maxColors)
 {
     uint32_t colorSubdivMapSize = 1;
     ColorSubdivMap colorSubdivMap[COLOR_OF_GIF];
@@ -432,11 +522,11 @@ uint32_t GifEncoder::doColorQuantize(uint16_t width, uint16_t height,
     colorInput.redInput = redInput;
     colorInput.greenInput = greenInput;
     colorInput.blueInput = blueInput;
-    InitColorCube(colorCoordinate, width, height, &colorInput);
-    InitColorSubdivMap(colorSubdivMap, width, height);
+    InitColorCube(colorCoordinate, pixelCount, &colorInput);
+    InitColorSubdivMap(colorSubdivMap, pixelCount);
     InitForQuantize(colorCoordinate, colorSubdivMap);
 
-    if (BuildColorSubdivMap(colorSubdivMap, &colorSubdivMapSize)) {
+    if (BuildColorSubdivMap(colorSubdivMap, &colorSubdivMapSize, maxColors)) {
         free(colorCoordinate);
         return ERR_IMAGE_ENCODE_FAILED;
     }
@@ -462,7 +552,7 @@ uint32_t GifEncoder::doColorQuantize(uint16_t width, uint16_t height,
             outputColorMap[i].blue = (blue << (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) / colorSubdivMap[i].colorNum;
         }
     }
-    for (int i = 0; i < ((long)width) * height; i++) {
+    for (uint32_t i = 0; i < pixelCount; i++) {
         uint32_t index = ((redInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << RED_COORDINATE) +
             ((greenInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << GREEN_COORDINATE) +
             ((blueInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << BLUE_COORDINATE);
@@ -550,12 +640,13 @@ void SubdivColorByPartition(ColorCoordinate *colorCoordinate, ColorSubdivMap *co
     colorSubdivMap[index].rgbWidth[g_sortRGBAxis] = maxColor - colorSubdivMap[index].rgbMin[g_sortRGBAxis];
 }
 
-uint32_t GifEncoder::BuildColorSubdivMap(ColorSubdivMap *colorSubdivMap, uint32_t *colorSubdivMapSize)
+uint32_t GifEncoder::BuildColorSubdivMap(ColorSubdivMap *colorSubdivMap, uint32_t *colorSubdivMapSize,
+                                         uint32_t maxColors)
 {
     int index = 0;
     ColorCoordinate **sortArray;
 
-    while (*colorSubdivMapSize < COLOR_MAP_SIZE) {
+    while (*colorSubdivMapSize < maxColors) {
         index = PrepareSort(colorSubdivMap, *colorSubdivMapSize);
         if (index < 0) {
             return SUCCESS;
@@ -580,158 +671,158 @@ uint32_t GifEncoder::BuildColorSubdivMap(ColorSubdivMap *colorSubdivMap, uint32_
     return SUCCESS;
 }
 
-void GifEncoder::InitDictionary()
+void GifEncoder::InitDictionary(LZWContext &context)
 {
-    lastCode_ = FIRST_CODE;
-    clearCode_ = CLEAR_CODE;
-    eofCode_ = clearCode_ + 1;
-    runningCode_ = eofCode_ + 1;
-    runningBits_ = BITS_IN_BYTE + 1;
-    maxCode_ = 1 << runningBits_;
-    crntShiftState_ = 0;
-    crntShiftDWord_ = 0;
-    memset_s(dictionary_, sizeof(uint32_t) * DICTIONARY_SIZE, 0xFF, sizeof(uint32_t) * DICTIONARY_SIZE);
+    context.lastCode = FIRST_CODE;
+    context.clearCode = CLEAR_CODE;
+    context.eofCode = context.clearCode + 1;
+    context.runningCode = context.eofCode + 1;
+    context.runningBits = BITS_IN_BYTE + 1;
+    context.maxCode = 1 << context.runningBits;
+    context.crntShiftState = 0;
+    context.crntShiftDWord = 0;
+    context.outputLZWBuffer[0] = 0;
+    memset_s(context.dictionary, sizeof(uint32_t) * DICTIONARY_SIZE, 0xFF, sizeof(uint32_t) * DICTIONARY_SIZE);
 }
 
-int GifEncoder::IsInDictionary(uint32_t Key)
+int GifEncoder::IsInDictionary(LZWContext &context, uint32_t Key)
 {
     int key = ((Key >> LZ_BITS) ^ Key) & 0x1FFF;
     uint32_t DKey;
-    while ((DKey = (dictionary_[key] >> LZ_BITS)) != 0xFFFFFL) {
+    while ((DKey = (context.dictionary[key] >> LZ_BITS)) != 0xFFFFFL) {
         if (Key == DKey) {
-            return (dictionary_[key] & 0x0FFF);
+            return (context.dictionary[key] & 0x0FFF);
         }
         key = (key + 1) & 0x1FFF;
     }
     return -1;
 }
  
-void GifEncoder::AddToDictionary(uint32_t Key, int Code)
+void GifEncoder::AddToDictionary(LZWContext &context, uint32_t Key, int Code)
 {
     int key = ((Key >> LZ_BITS) ^ Key) & 0x1FFF;
-    while ((dictionary_[key] >> LZ_BITS) != 0xFFFFFL) {
+    while ((context.dictionary[key] >> LZ_BITS) != 0xFFFFFL) {
         key = (key + 1) & 0x1FFF;
     }
-    dictionary_[key] = (Key << LZ_BITS) | (Code & 0x0FFF);
+    context.dictionary[key] = (Key << LZ_BITS) | (Code & 0x0FFF);
 }
 
-uint32_t GifEncoder::LZWEncodeFrame(uint8_t *outputBuffer, uint16_t width, uint16_t height)
+uint32_t GifEncoder::LZWEncodeFrame(LZWContext &context, uint8_t *outputBuffer, uint16_t width, uint16_t height)
 {
     uint8_t *pTmp = outputBuffer;
     uint8_t bitsPerPixel = BITS_IN_BYTE;
-    Write((const uint8_t*)&bitsPerPixel, 1);
-    LZWWriteOut(clearCode_);
+    AppendBytes(*context.output, &bitsPerPixel, 1);
+    LZWWriteOut(context, context.clearCode);
     for (int j = 0; j < height; j++) {
-        if (LZWEncode(pTmp, width)) {
+        if (LZWEncode(context, pTmp, width)) {
             IMAGE_LOGE("Failed to encode, aborted.");
             return ERR_IMAGE_ENCODE_FAILED;
         }
         pTmp += width;
     }
-    if (LZWWriteOut(lastCode_)) {
+    if (LZWWriteOut(context, context.lastCode)) {
         IMAGE_LOGE("Failed to write lastCode, aborted.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
-    if (LZWWriteOut(eofCode_)) {
+    if (LZWWriteOut(context, context.eofCode)) {
         IMAGE_LOGE("Failed to write EOFCode, aborted.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
-    if (LZWWriteOut(FLUSH_OUTPUT)) {
+    if (LZWWriteOut(context, FLUSH_OUTPUT)) {
         IMAGE_LOGE("Failed to write flushCode, aborted.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
     return SUCCESS;
 }
 
-uint32_t GifEncoder::LZWEncode(uint8_t *buffer, int length)
+uint32_t GifEncoder::LZWEncode(LZWContext &context, uint8_t *buffer, int length)
 {
     int i = 0;
     int curChar;
-    if (lastCode_ == FIRST_CODE) {
+    if (context.lastCode == FIRST_CODE) {
         curChar = buffer[i++];
     } else {
-        curChar = lastCode_;
+        curChar = context.lastCode;
     }
     while (i < length) {
         uint8_t Pixel = buffer[i++];
         int newChar;
         uint32_t newKey = (((uint32_t)curChar) << BITS_IN_BYTE) + Pixel;
-        if ((newChar = IsInDictionary(newKey)) >= 0) {
+        if ((newChar = IsInDictionary(context, newKey)) >= 0) {
             curChar = newChar;
             continue;
         }
-        if (LZWWriteOut(curChar)) {
+        if (LZWWriteOut(context, curChar)) {
             IMAGE_LOGE("Failed to write.");
             return ERR_IMAGE_ENCODE_FAILED;
         }
         curChar = Pixel;
-        if (runningCode_ >= LZ_MAX_CODE) {
-            if (LZWWriteOut(clearCode_)) {
+        if (context.runningCode >= LZ_MAX_CODE) {
+            if (LZWWriteOut(context, context.clearCode)) {
                 IMAGE_LOGE("Failed to write.");
                 return ERR_IMAGE_ENCODE_FAILED;
             }
-            runningCode_ = eofCode_ + 1;
-            runningBits_ = BITS_IN_BYTE + 1;
-            maxCode_ = 1 << runningBits_;
-            memset_s(dictionary_, sizeof(uint32_t) * DICTIONARY_SIZE, 0xFF, sizeof(uint32_t) * DICTIONARY_SIZE);
+            context.runningCode = context.eofCode + 1;
+            context.runningBits = BITS_IN_BYTE + 1;
+            context.maxCode = 1 << context.runningBits;
+            memset_s(context.dictionary, sizeof(uint32_t) * DICTIONARY_SIZE, 0xFF, sizeof(uint32_t) * DICTIONARY_SIZE);
         } else {
-            AddToDictionary(newKey, runningCode_++);
+            AddToDictionary(context, newKey, context.runningCode++);
         }
     }
-    lastCode_ = curChar;
+    context.lastCode = curChar;
     return SUCCESS;
 }
 
-uint32_t GifEncoder::LZWWriteOut(int Code)
+uint32_t GifEncoder::LZWWriteOut(LZWContext &context, int Code)
 {
     uint32_t ret = SUCCESS;
     if (Code == FLUSH_OUTPUT) {
-        while (crntShiftState_ > 0) {
-            if (LZWBufferOutput(crntShiftDWord_ & 0xFF)) {
+        while (context.crntShiftState > 0) {
+            if (LZWBufferOutput(context, context.crntShiftDWord & 0xFF)) {
                 ret = ERROR;
             }
-            crntShiftDWord_ >>= BITS_IN_BYTE;
-            crntShiftState_ -= BITS_IN_BYTE;
+            context.crntShiftDWord >>= BITS_IN_BYTE;
+            context.crntShiftState -= BITS_IN_BYTE;
         }
-        crntShiftState_ = 0;
-        if (LZWBufferOutput(FLUSH_OUTPUT)) {
+        context.crntShiftState = 0;
+        if (LZWBufferOutput(context, FLUSH_OUTPUT)) {
             ret = ERROR;
         }
     } else {
-        crntShiftDWord_ |= ((long)Code) << crntShiftState_;
-        crntShiftState_ += runningBits_;
-        while (crntShiftState_ >= BITS_IN_BYTE) {
-            if (LZWBufferOutput(crntShiftDWord_ & 0xFF)) {
+        context.crntShiftDWord |= ((long)Code) << context.crntShiftState;
+        context.crntShiftState += context.runningBits;
+        while (context.crntShiftState >= BITS_IN_BYTE) {
+            if (LZWBufferOutput(context, context.crntShiftDWord & 0xFF)) {
                 ret = ERROR;
             }
-            crntShiftDWord_ >>= BITS_IN_BYTE;
-            crntShiftState_ -= BITS_IN_BYTE;
+            context.crntShiftDWord >>= BITS_IN_BYTE;
+            context.crntShiftState -= BITS_IN_BYTE;
         }
     }
-    if (runningCode_ >= maxCode_ && Code <= LZ_MAX_CODE) {
-        maxCode_ = 1 << ++runningBits_;
+    if (context.runningCode >= context.maxCode && Code <= LZ_MAX_CODE) {
+        context.maxCode = 1 << ++context.runningBits;
     }
     return ret;
 }
 
-uint32_t GifEncoder::LZWBufferOutput(int character)
+uint32_t GifEncoder::LZWBufferOutput(LZWContext &context, int character)
 {
+    if (context.output == nullptr) {
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
     if (character == FLUSH_OUTPUT) {
-        if (outputLZWBuffer_[0] != 0 && !Write(outputLZWBuffer_, outputLZWBuffer_[0] + 1)) {
-            return ERR_IMAGE_ENCODE_FAILED;
-        }
-        outputLZWBuffer_[0] = 0;
-        if (!Write(outputLZWBuffer_, 1)) {
-            return ERR_IMAGE_ENCODE_FAILED;
+        if (context.outputLZWBuffer[0] != 0) {
+            AppendBytes(*context.output, context.outputLZWBuffer, context.outputLZWBuffer[0] + 1);
         }
+        context.outputLZWBuffer[0] = 0;
+        AppendBytes(*context.output, context.outputLZWBuffer, 1);
     } else {
-        if (outputLZWBuffer_[0] == 0xFF) {
-            if (!Write(outputLZWBuffer_, outputLZWBuffer_[0] + 1)) {
-                return ERR_IMAGE_ENCODE_FAILED;
-            }
-            outputLZWBuffer_[0] = 0;
+        if (context.outputLZWBuffer[0] == 0xFF) {
+            AppendBytes(*context.output, context.outputLZWBuffer, context.outputLZWBuffer[0] + 1);
+            context.outputLZWBuffer[0] = 0;
         }
-        outputLZWBuffer_[++outputLZWBuffer_[0]] = character;
+        context.outputLZWBuffer[++context.outputLZWBuffer[0]] = character;
     }
     return SUCCESS;
 }
@@ -34,6 +34,7 @@ public:
     uint32_t AddImage(Media::PixelMap &pixelMap) override;
     uint32_t AddPicture(Media::Picture &picture) override;
     uint32_t FinalizeEncode() override;
+    void Reset() override;
 
 private:
     DISALLOW_COPY_AND_MOVE(JpegEncoder);
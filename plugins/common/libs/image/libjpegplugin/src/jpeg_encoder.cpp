@@ -156,6 +156,15 @@ uint32_t JpegEncoder::AddPicture(Media::Picture &picture)
     return ERR_IMAGE_ENCODE_FAILED;
 }
 
+void JpegEncoder::Reset()
+{
+    // a failed encode longjmps out in the middle of a compression cycle, return the struct to its start state
+    jpeg_abort_compress(&encodeInfo_);
+    pixelMaps_.clear();
+    dstMgr_.outputStream = nullptr;
+    encodeOpts_ = PlEncodeOptions();
+}
+
 uint32_t JpegEncoder::FinalizeEncode()
 {
     ImageTrace imageTrace("JpegEncoder::FinalizeEncode");
@@ -14,6 +14,7 @@
  */
 #ifndef RAW_DECODER_H
 #define RAW_DECODER_H
+#include <vector>
 #include "plugin_class_base.h"
 #include "abs_image_decoder.h"
 namespace OHOS {
@@ -46,6 +47,16 @@ private:
     uint32_t DoDecodeHeader();
     uint32_t DoDecodeHeaderByPiex();
 
+    struct RawPreview {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        Size size;
+    };
+    void AddPreview(uint32_t offset, uint32_t length, uint32_t width, uint32_t height);
+    size_t SelectPreview(const Size &desiredSize) const;
+    size_t SelectPreview(const PixelDecodeOptions &opts) const;
+    uint32_t CreatePreviewDecoder(size_t index);
+
     uint32_t DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info);
     uint32_t DoGetImageSize(uint32_t index, Size &size);
 
@@ -73,6 +84,9 @@ private:
     // PIEX used.
     std::unique_ptr<InputDataStream> jpegStream_;
     std::unique_ptr<AbsImageDecoder> jpegDecoder_;
+    // embedded jpeg previews, largest first
+    std::vector<RawPreview> previews_;
+    size_t previewIndex_ {0};
 };
 } // namespace ImagePlugin
 } // namespace OHOS
@@ -31,6 +31,31 @@ public:
 private:
     InputDataStream *inputStream_ {nullptr};
 };
+
+// Read-only view of [offset, offset + length) of another stream, used to decode an embedded preview in place.
+class RawSubStream : public InputDataStream {
+public:
+    RawSubStream(InputDataStream &sourceStream, uint32_t offset, uint32_t length);
+    ~RawSubStream() override = default;
+
+    bool Read(uint32_t desiredSize, DataStreamBuffer &outData) override;
+    bool Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    bool Peek(uint32_t desiredSize, DataStreamBuffer &outData) override;
+    bool Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize) override;
+    uint32_t Tell() override;
+    bool Seek(uint32_t position) override;
+    uint32_t GetStreamType() override;
+    uint8_t *GetDataPtr() override;
+    size_t GetStreamSize() override;
+
+private:
+    bool SeekSource();
+
+    InputDataStream *inputStream_ {nullptr};
+    uint32_t offset_ {0};
+    uint32_t length_ {0};
+    uint32_t position_ {0};
+};
 } // namespace ImagePlugin
 } // namespace OHOS
 #endif // RAW_STREAM_H
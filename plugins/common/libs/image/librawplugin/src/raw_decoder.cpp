@@ -14,7 +14,9 @@
  */
 #include "raw_decoder.h"
 
-#include "buffer_source_stream.h"
+#include <algorithm>
+#include <cmath>
+
 #include "image_log.h"
 #include "image_trace.h"
 #include "jpeg_decoder.h"
@@ -32,6 +34,8 @@ using namespace MultimediaPlugin;
 using namespace Media;
 namespace {
 constexpr uint32_t RAW_IMAGE_NUM = 1;
+// previews whose aspect ratio differs more than this from the main preview are letterboxed or cropped
+constexpr double PREVIEW_ASPECT_TOLERANCE = 0.01;
 }
 
 RawDecoder::RawDecoder()
@@ -68,6 +72,8 @@ void RawDecoder::Reset()
     // PIEX used.
     jpegStream_ = nullptr;
     jpegDecoder_ = nullptr;
+    previews_.clear();
+    previewIndex_ = 0;
 
     IMAGE_LOGD("Reset OUT");
 }
@@ -261,39 +267,101 @@ uint32_t RawDecoder::DoDecodeHeaderByPiex()
         return Media::ERR_IMAGE_DATA_ABNORMAL;
     }
 
-    piex::Image piexImage;
-    bool hasImage = false;
+    previews_.clear();
+    previewIndex_ = 0;
     if (error == piex::Error::kOk) {
-        if ((imageData.preview.format == piex::Image::kJpegCompressed) && (imageData.preview.length > 0)) {
-            piexImage = imageData.preview;
-            hasImage = true;
+        for (const piex::Image &image : {imageData.preview, imageData.thumbnail}) {
+            if ((image.format == piex::Image::kJpegCompressed) && (image.length > 0)) {
+                AddPreview(image.offset, image.length, image.width, image.height);
+            }
         }
     }
 
-    if (!hasImage) {
+    if (previews_.empty()) {
         IMAGE_LOGD("DoDecodeHeaderByPiex OUT 2");
         return Media::SUCCESS;
     }
 
-    uint32_t size = piexImage.length;
-    std::unique_ptr<uint8_t[]> data = std::make_unique<uint8_t[]>(size);
-    error = rawStream_->GetData(piexImage.offset, size, data.get());
-    if (error != piex::Error::kOk) {
-        IMAGE_LOGE("DoDecodeHeaderByPiex getdata fail");
-        return Media::ERR_IMAGE_MALLOC_ABNORMAL;
+    std::stable_sort(previews_.begin(), previews_.end(), [](const RawPreview &lhs, const RawPreview &rhs) {
+        return static_cast<int64_t>(lhs.size.width) * lhs.size.height >
+            static_cast<int64_t>(rhs.size.width) * rhs.size.height;
+    });
+    uint32_t ret = CreatePreviewDecoder(0);
+
+    IMAGE_LOGD("DoDecodeHeaderByPiex OUT");
+    return ret;
+}
+
+void RawDecoder::AddPreview(uint32_t offset, uint32_t length, uint32_t width, uint32_t height)
+{
+    if (inputStream_ == nullptr) {
+        return;
     }
+    size_t streamSize = inputStream_->GetStreamSize();
+    if (streamSize != 0 && static_cast<uint64_t>(offset) + length > streamSize) {
+        IMAGE_LOGE("AddPreview preview [%{public}u, +%{public}u) is out of stream", offset, length);
+        return;
+    }
+    RawPreview preview;
+    preview.offset = offset;
+    preview.length = length;
+    preview.size.width = static_cast<int32_t>(width);
+    preview.size.height = static_cast<int32_t>(height);
+    if (width == 0 || height == 0) {
+        // piex does not always know the dimensions, read them from the jpeg header in place
+        RawSubStream stream(*inputStream_, offset, length);
+        JpegDecoder decoder;
+        decoder.SetSource(stream);
+        if (decoder.GetImageSize(0, preview.size) != Media::SUCCESS) {
+            IMAGE_LOGE("AddPreview get preview size fail");
+            return;
+        }
+    }
+    previews_.push_back(preview);
+}
 
-    jpegStream_ = BufferSourceStream::CreateSourceStream(data.get(), size);
-    if (!jpegStream_) {
-        IMAGE_LOGE("DoDecodeHeaderByPiex create sourcestream fail");
-        return Media::ERR_IMAGE_MALLOC_ABNORMAL;
+size_t RawDecoder::SelectPreview(const Size &desiredSize) const
+{
+    if (previews_.empty() || desiredSize.width <= 0 || desiredSize.height <= 0) {
+        return 0;
     }
+    const Size &mainSize = previews_[0].size;
+    size_t selected = 0;
+    for (size_t index = 1; index < previews_.size(); index++) {
+        const Size &size = previews_[index].size;
+        double aspectDiff = static_cast<double>(size.width) * mainSize.height -
+            static_cast<double>(mainSize.width) * size.height;
+        bool sameAspect = std::abs(aspectDiff) <=
+            PREVIEW_ASPECT_TOLERANCE * static_cast<double>(mainSize.width) * size.height;
+        if (sameAspect && size.width >= desiredSize.width && size.height >= desiredSize.height) {
+            selected = index;
+        }
+    }
+    return selected;
+}
+
+size_t RawDecoder::SelectPreview(const PixelDecodeOptions &opts) const
+{
+    // CropRect is given in the coordinates of the full size preview, so a cropped decode keeps that preview
+    if (opts.CropRect.width > 0 && opts.CropRect.height > 0) {
+        return 0;
+    }
+    return SelectPreview(opts.desiredSize);
+}
 
-    data = nullptr;
+uint32_t RawDecoder::CreatePreviewDecoder(size_t index)
+{
+    if (index >= previews_.size() || inputStream_ == nullptr) {
+        return Media::ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    const RawPreview &preview = previews_[index];
+    IMAGE_LOGI("CreatePreviewDecoder use preview %{public}zu of %{public}zu, size=(%{public}u, %{public}u)",
+        index, previews_.size(), preview.size.width, preview.size.height);
+    jpegDecoder_ = nullptr;
+    jpegStream_ = std::make_unique<RawSubStream>(*inputStream_, preview.offset, preview.length);
     jpegDecoder_ = std::make_unique<JpegDecoder>();
     jpegDecoder_->SetSource(*(jpegStream_.get()));
-
-    IMAGE_LOGD("DoDecodeHeaderByPiex OUT");
+    previewIndex_ = index;
     return Media::SUCCESS;
 }
 
@@ -302,6 +370,11 @@ uint32_t RawDecoder::DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions
     IMAGE_LOGD("DoSetDecodeOptions IN index=%{public}u", index);
     uint32_t ret;
     opts_ = opts;
+    // previews are ordered largest first, so the last one still covering desiredSize is the cheapest to decode
+    size_t previewIndex = SelectPreview(opts);
+    if (!previews_.empty() && previewIndex != previewIndex_) {
+        CreatePreviewDecoder(previewIndex);
+    }
     if (jpegDecoder_ != nullptr) {
         IMAGE_LOGI("DoSetDecodeOptions, set decode options for JpegDecoder");
         ret = jpegDecoder_->SetDecodeOptions(index, opts_, info_);
@@ -78,5 +78,101 @@ piex::Error RawStream::GetData(const size_t offset, const size_t length, uint8_t
 
     return piex::kOk;
 }
+
+RawSubStream::RawSubStream(InputDataStream &sourceStream, uint32_t offset, uint32_t length)
+    : inputStream_(&sourceStream), offset_(offset), length_(length)
+{}
+
+bool RawSubStream::SeekSource()
+{
+    uint32_t sourcePosition = offset_ + position_;
+    if (inputStream_->Tell() != sourcePosition && !inputStream_->Seek(sourcePosition)) {
+        IMAGE_LOGE("RawSubStream seek source to %{public}u fail", sourcePosition);
+        return false;
+    }
+    return true;
+}
+
+bool RawSubStream::Peek(uint32_t desiredSize, DataStreamBuffer &outData)
+{
+    if (desiredSize == 0 || position_ >= length_) {
+        return false;
+    }
+    uint32_t remaining = length_ - position_;
+    uint8_t *sourceData = inputStream_->GetDataPtr();
+    if (sourceData != nullptr) {
+        outData.inputStreamBuffer = sourceData + offset_ + position_;
+        outData.bufferSize = remaining;
+        outData.dataSize = desiredSize < remaining ? desiredSize : remaining;
+        return true;
+    }
+    if (!SeekSource() || !inputStream_->Peek(desiredSize < remaining ? desiredSize : remaining, outData)) {
+        return false;
+    }
+    outData.bufferSize = outData.bufferSize < remaining ? outData.bufferSize : remaining;
+    outData.dataSize = outData.dataSize < remaining ? outData.dataSize : remaining;
+    return true;
+}
+
+bool RawSubStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
+{
+    if (!Peek(desiredSize, outData)) {
+        return false;
+    }
+    position_ += outData.dataSize;
+    return true;
+}
+
+bool RawSubStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (desiredSize == 0 || outBuffer == nullptr || desiredSize > bufferSize || position_ >= length_) {
+        return false;
+    }
+    uint32_t remaining = length_ - position_;
+    desiredSize = desiredSize < remaining ? desiredSize : remaining;
+    if (!SeekSource() || !inputStream_->Peek(desiredSize, outBuffer, bufferSize, readSize)) {
+        return false;
+    }
+    return true;
+}
+
+bool RawSubStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize)
+{
+    if (!Peek(desiredSize, outBuffer, bufferSize, readSize)) {
+        return false;
+    }
+    position_ += readSize;
+    return true;
+}
+
+uint32_t RawSubStream::Tell()
+{
+    return position_;
+}
+
+bool RawSubStream::Seek(uint32_t position)
+{
+    if (position > length_) {
+        return false;
+    }
+    position_ = position;
+    return true;
+}
+
+uint32_t RawSubStream::GetStreamType()
+{
+    return inputStream_->GetStreamType();
+}
+
+uint8_t *RawSubStream::GetDataPtr()
+{
+    uint8_t *sourceData = inputStream_->GetDataPtr();
+    return sourceData != nullptr ? sourceData + offset_ : nullptr;
+}
+
+size_t RawSubStream::GetStreamSize()
+{
+    return length_;
+}
 } // namespace ImagePlugin
 } // namespace OHOS
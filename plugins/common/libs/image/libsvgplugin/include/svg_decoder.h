@@ -15,6 +15,8 @@
 #ifndef SVG_DECODER_H
 #define SVG_DECODER_H
 
+#include <memory>
+
 #include "abs_image_decoder.h"
 #include "nocopyable.h"
 #include "plugin_class_base.h"
@@ -33,6 +35,8 @@ namespace OHOS {
 namespace ImagePlugin {
 using namespace Media;
 
+struct SvgDomEntry;
+
 class SvgDecoder : public AbsImageDecoder, public OHOS::MultimediaPlugin::PluginClassBase {
 public:
     SvgDecoder();
@@ -50,6 +54,8 @@ private:
     bool AllocBuffer(DecodeContext &context);
     bool BuildStream();
     bool BuildDom();
+    bool SelectDom();
+    std::shared_ptr<SvgDomEntry> AcquireDom(int64_t fillColor, int64_t strokeColor);
     uint32_t DoDecodeHeader();
     uint32_t DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info);
     uint32_t DoGetImageSize(uint32_t index, Size &size);
@@ -74,6 +80,13 @@ private:
     sk_sp<SkSVGDOM> svgDom_;
     SkSize svgSize_ {0, 0};
 
+    // svgDom_ is owned by domEntry_, which may be shared with other decoders through the DOM cache,
+    // so its size is only changed under domEntry_->renderMutex and replayed before each render.
+    std::shared_ptr<SvgDomEntry> domEntry_;
+    uint64_t sourceHash_ {0};
+    SkSize renderSize_ {0, 0};
+    float resizePercentage_ {0};
+
     PixelDecodeOptions opts_;
 };
 } // namespace ImagePlugin
@@ -15,9 +15,15 @@
 
 #include "svg_decoder.h"
 
+#include <cstring>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <tuple>
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "image_trace.h"
 #include "image_log.h"
@@ -47,6 +53,12 @@ const std::string SVG_FILL_COLOR_ATTR = "fill";
 const std::string SVG_STROKE_COLOR_ATTR = "stroke";
 static constexpr uint32_t DEFAULT_RESIZE_PERCENTAGE = 100;
 static constexpr float FLOAT_HALF = 0.5f;
+static constexpr int64_t SVG_NO_COLOR_OVERRIDE = -1;
+static constexpr size_t SVG_DOM_CACHE_MAX_BYTES = 16 * 1024 * 1024;
+// parsed nodes take several times the space of the markup they came from
+static constexpr size_t SVG_DOM_COST_PER_SOURCE_BYTE = 8;
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
 
 static inline uint32_t Float2UInt32(float val)
 {
@@ -203,8 +215,85 @@ SkImageInfo MakeImageInfo(const PixelDecodeOptions &opts)
     return SkImageInfo::Make(width, height, colorType, alphaType);
 }
 // LCOV_EXCL_STOP
+
+uint64_t HashSource(const uint8_t *data, size_t length)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
 } // namespace
 
+struct SvgDomEntry {
+    sk_sp<SkData> source;
+    sk_sp<SkSVGDOM> dom;
+    SkSize size {0, 0}; // container size right after parsing
+    std::mutex renderMutex;
+};
+
+// Process-wide LRU of parsed DOMs keyed by source hash, source length and fill/stroke overrides. A hit is only
+// returned when the cached source bytes match, so a hash collision costs a parse but never a wrong image.
+class SvgDomCache {
+public:
+    using Key = std::tuple<uint64_t, size_t, int64_t, int64_t>;
+
+    static SvgDomCache &GetInstance()
+    {
+        static SvgDomCache instance;
+        return instance;
+    }
+
+    std::shared_ptr<SvgDomEntry> Find(const Key &key, const uint8_t *data, size_t length)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = index_.find(key);
+        if (iter == index_.end()) {
+            return nullptr;
+        }
+        const sk_sp<SkData> &source = iter->second->second->source;
+        if (source->size() != length || memcmp(source->data(), data, length) != 0) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, iter->second);
+        return iter->second->second;
+    }
+
+    void Insert(const Key &key, const std::shared_ptr<SvgDomEntry> &entry)
+    {
+        size_t cost = entry->source->size() * SVG_DOM_COST_PER_SOURCE_BYTE;
+        if (cost > SVG_DOM_CACHE_MAX_BYTES) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = index_.find(key);
+        if (iter != index_.end()) {
+            usedBytes_ -= iter->second->second->source->size() * SVG_DOM_COST_PER_SOURCE_BYTE;
+            entries_.erase(iter->second);
+            index_.erase(iter);
+        }
+        while (!entries_.empty() && usedBytes_ + cost > SVG_DOM_CACHE_MAX_BYTES) {
+            usedBytes_ -= entries_.back().second->source->size() * SVG_DOM_COST_PER_SOURCE_BYTE;
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, entry);
+        index_[key] = entries_.begin();
+        usedBytes_ += cost;
+    }
+
+private:
+    SvgDomCache() = default;
+    ~SvgDomCache() = default;
+    DISALLOW_COPY_AND_MOVE(SvgDomCache);
+
+    std::mutex mutex_;
+    std::list<std::pair<Key, std::shared_ptr<SvgDomEntry>>> entries_;
+    std::map<Key, std::list<std::pair<Key, std::shared_ptr<SvgDomEntry>>>::iterator> index_;
+    size_t usedBytes_ {0};
+};
+
 SvgDecoder::SvgDecoder()
 {
     IMAGE_LOGD("[Create] IN");
@@ -240,15 +329,15 @@ void SvgDecoder::Reset()
 
     state_ = SvgDecodingState::UNDECIDED;
 
-    if (svgDom_) {
-        svgDom_->setContainerSize(svgSize_);
-    }
-
     svgDom_ = nullptr;
+    domEntry_ = nullptr;
     svgStream_ = nullptr;
     inputStreamPtr_ = nullptr;
 
     svgSize_.setEmpty();
+    renderSize_.setEmpty();
+    resizePercentage_ = DEFAULT_RESIZE_PERCENTAGE;
+    sourceHash_ = 0;
 
     PixelDecodeOptions opts;
     opts_ = opts;
@@ -401,7 +490,7 @@ bool SvgDecoder::AllocBuffer(DecodeContext &context)
 
     bool ret = true;
     if (context.pixelsBuffer.buffer == nullptr) {
-        auto svgSize = svgDom_->containerSize();
+        auto svgSize = renderSize_;
         if (svgSize.isEmpty()) {
             IMAGE_LOGE("[AllocBuffer] size is empty.");
             return false;
@@ -472,6 +561,36 @@ static void SetSVGColor(SkSVGNode* node, uint32_t color, std::string colorAttr)
     SetSVGColor(node, "#" + newValue, colorAttr);
 }
 
+std::shared_ptr<SvgDomEntry> SvgDecoder::AcquireDom(int64_t fillColor, int64_t strokeColor)
+{
+    auto data = static_cast<const uint8_t *>(svgStream_->getMemoryBase());
+    size_t length = svgStream_->getLength();
+    SvgDomCache::Key key {sourceHash_, length, fillColor, strokeColor};
+    auto entry = SvgDomCache::GetInstance().Find(key, data, length);
+    if (entry != nullptr) {
+        IMAGE_LOGD("[AcquireDom] reuse cached DOM.");
+        return entry;
+    }
+
+    entry = std::make_shared<SvgDomEntry>();
+    entry->source = SkData::MakeWithCopy(data, length);
+    SkMemoryStream stream(entry->source);
+    entry->dom = SkSVGDOM::MakeFromStream(stream);
+    if (entry->dom == nullptr) {
+        IMAGE_LOGE("[AcquireDom] DOM is null.");
+        return nullptr;
+    }
+    entry->size = entry->dom->containerSize();
+    if (fillColor != SVG_NO_COLOR_OVERRIDE) {
+        SetSVGColor(entry->dom->getRoot(), static_cast<uint32_t>(fillColor), SVG_FILL_COLOR_ATTR);
+    }
+    if (strokeColor != SVG_NO_COLOR_OVERRIDE) {
+        SetSVGColor(entry->dom->getRoot(), static_cast<uint32_t>(strokeColor), SVG_STROKE_COLOR_ATTR);
+    }
+    SvgDomCache::GetInstance().Insert(key, entry);
+    return entry;
+}
+
 bool SvgDecoder::BuildDom()
 {
     IMAGE_LOGD("[BuildDom] IN");
@@ -481,17 +600,21 @@ bool SvgDecoder::BuildDom()
         return false;
     }
 
-    svgDom_ = SkSVGDOM::MakeFromStream(*(svgStream_.get()));
-    if (svgDom_ == nullptr) {
+    sourceHash_ = HashSource(static_cast<const uint8_t *>(svgStream_->getMemoryBase()), svgStream_->getLength());
+    domEntry_ = AcquireDom(SVG_NO_COLOR_OVERRIDE, SVG_NO_COLOR_OVERRIDE);
+    if (domEntry_ == nullptr) {
         IMAGE_LOGE("[BuildDom] DOM is null.");
         return false;
     }
+    svgDom_ = domEntry_->dom;
 
-    svgSize_ = svgDom_->containerSize();
+    svgSize_ = domEntry_->size;
     if (svgSize_.isEmpty()) {
         IMAGE_LOGE("[BuildDom] size is empty.");
         return false;
     }
+    renderSize_ = svgSize_;
+    resizePercentage_ = DEFAULT_RESIZE_PERCENTAGE;
 
     auto width = Float2UInt32(svgSize_.width());
     auto height = Float2UInt32(svgSize_.height());
@@ -500,6 +623,26 @@ bool SvgDecoder::BuildDom()
     return true;
 }
 
+// Fill and stroke overrides are baked into their own cached DOM instead of rewriting the shared tree per decode.
+bool SvgDecoder::SelectDom()
+{
+    int64_t fillColor = opts_.plFillColor.isValidColor ?
+        static_cast<int64_t>(opts_.plFillColor.color & SVG_COLOR_MASK) : SVG_NO_COLOR_OVERRIDE;
+    int64_t strokeColor = opts_.plStrokeColor.isValidColor ?
+        static_cast<int64_t>(opts_.plStrokeColor.color & SVG_COLOR_MASK) : SVG_NO_COLOR_OVERRIDE;
+    if (svgStream_ == nullptr) {
+        IMAGE_LOGE("[SelectDom] Stream is null.");
+        return false;
+    }
+    auto entry = AcquireDom(fillColor, strokeColor);
+    if (entry == nullptr) {
+        return false;
+    }
+    domEntry_ = entry;
+    svgDom_ = entry->dom;
+    return true;
+}
+
 uint32_t SvgDecoder::DoDecodeHeader()
 {
     IMAGE_LOGD("[DoDecodeHeader] IN");
@@ -529,8 +672,12 @@ uint32_t SvgDecoder::DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions
     }
 
     opts_ = opts;
+    if (!SelectDom()) {
+        IMAGE_LOGE("[DoSetDecodeOptions] select DOM failed.");
+        return Media::ERROR;
+    }
 
-    auto svgSize = svgDom_->containerSize();
+    auto svgSize = svgSize_;
     if (svgSize.isEmpty()) {
         IMAGE_LOGE("[DoSetDecodeOptions] size is empty.");
         return Media::ERROR;
@@ -543,13 +690,19 @@ uint32_t SvgDecoder::DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions
     }
 
     if (opts_.plSVGResize.isValidPercentage) {
-        svgDom_->setResizePercentage(opts_.plSVGResize.resizePercentage * scaleFitDesired);
+        resizePercentage_ = opts_.plSVGResize.resizePercentage * scaleFitDesired;
     } else {
-        svgDom_->setResizePercentage(DEFAULT_RESIZE_PERCENTAGE * scaleFitDesired);
+        resizePercentage_ = DEFAULT_RESIZE_PERCENTAGE * scaleFitDesired;
+    }
+    {
+        std::lock_guard<std::mutex> lock(domEntry_->renderMutex);
+        svgDom_->setContainerSize(svgSize_);
+        svgDom_->setResizePercentage(resizePercentage_);
+        renderSize_ = svgDom_->containerSize();
     }
 
-    opts_.desiredSize.width = static_cast<int32_t>(Float2UInt32(svgDom_->containerSize().width()));
-    opts_.desiredSize.height = static_cast<int32_t>(Float2UInt32(svgDom_->containerSize().height()));
+    opts_.desiredSize.width = static_cast<int32_t>(Float2UInt32(renderSize_.width()));
+    opts_.desiredSize.height = static_cast<int32_t>(Float2UInt32(renderSize_.height()));
 
     info.size.width = opts_.desiredSize.width;
     info.size.height = opts_.desiredSize.height;
@@ -574,7 +727,7 @@ uint32_t SvgDecoder::DoGetImageSize(uint32_t index, Size &size)
         return Media::ERROR;
     }
 
-    auto svgSize = svgDom_->containerSize();
+    auto svgSize = renderSize_;
     if (svgSize.isEmpty()) {
         IMAGE_LOGE("[DoGetImageSize] size is empty.");
         return Media::ERROR;
@@ -591,19 +744,11 @@ uint32_t SvgDecoder::DoDecode(uint32_t index, DecodeContext &context)
 {
     IMAGE_LOGD("[DoDecode] IN index=%{public}u", index);
 
-    if (svgDom_ == nullptr) {
+    if (svgDom_ == nullptr || domEntry_ == nullptr) {
         IMAGE_LOGE("[DoDecode] DOM is null.");
         return Media::ERROR;
     }
 
-    if (opts_.plFillColor.isValidColor) {
-        SetSVGColor(svgDom_->getRoot(), opts_.plFillColor.color, SVG_FILL_COLOR_ATTR);
-    }
-
-    if (opts_.plStrokeColor.isValidColor) {
-        SetSVGColor(svgDom_->getRoot(), opts_.plStrokeColor.color, SVG_STROKE_COLOR_ATTR);
-    }
-
     if (!AllocBuffer(context)) {
         IMAGE_LOGE("[DoDecode] alloc buffer failed.");
         return Media::ERR_IMAGE_MALLOC_ABNORMAL;
@@ -625,7 +770,13 @@ uint32_t SvgDecoder::DoDecode(uint32_t index, DecodeContext &context)
         return Media::ERROR;
     }
     canvas->clear(SK_ColorTRANSPARENT);
-    svgDom_->render(canvas.get());
+    {
+        // other decoders may have resized the shared DOM since DoSetDecodeOptions
+        std::lock_guard<std::mutex> lock(domEntry_->renderMutex);
+        svgDom_->setContainerSize(svgSize_);
+        svgDom_->setResizePercentage(resizePercentage_);
+        svgDom_->render(canvas.get());
+    }
 
     bool result = canvas->readPixels(imageInfo, pixels, rowBytes, 0, 0);
     if (!result) {
@@ -18,6 +18,7 @@
 
 #include "abs_image_decoder.h"
 #include "input_data_stream.h"
+#include "multimedia_templates.h"
 #include "plugin_class_base.h"
 #include "webp/decode.h"
 #include "webp/demux.h"
@@ -65,6 +66,8 @@ private:
     bool PreDecodeProc(DecodeContext &context, WebPDecoderConfig &config, bool isIncremental);
     uint32_t DoCommonDecode(DecodeContext &context);
     uint32_t DoIncrementalDecode(ProgDecodeContext &context);
+    uint32_t CreateIncrementalDecoder(DecodeContext &context);
+    void ReleaseIncrementalDecoder();
     void FinishOldDecompress();
     bool IsDataEnough();
     // private members
@@ -78,6 +81,11 @@ private:
     WebpDecodingState state_ = WebpDecodingState::UNDECIDED;
     PixelDecodeOptions opts_;
     PixelFormat outputFormat_ = PixelFormat::UNKNOWN;
+    // incremental decoding state kept across promotes, so each promote only decodes the newly arrived bytes
+    MultiMedia::TAutoCallProc<WebPIDecoder, WebPIDelete> idec_ { nullptr };
+    WebPDecBuffer idecOutput_ {};
+    void *idecPixels_ = nullptr;  // pixels idec_ writes into
+    size_t idecFedSize_ = 0;      // stream bytes already appended to idec_
 };
 } // namespace ImagePlugin
 } // namespace OHOS
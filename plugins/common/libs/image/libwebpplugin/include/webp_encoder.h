@@ -30,6 +30,7 @@ public:
     uint32_t AddImage(Media::PixelMap &pixelMap) override;
     uint32_t AddPicture(Media::Picture &picture) override;
     uint32_t FinalizeEncode() override;
+    void Reset() override;
     bool Write(const uint8_t* data, size_t data_size);
 
 private:
@@ -38,7 +39,16 @@ private:
     uint32_t SetEncodeConfig(Media::PixelMap &pixelMap, WebPConfig &webpConfig, WebPPicture &webpPicture);
     uint32_t DoEncode(Media::PixelMap &pixelMap, WebPConfig &webpConfig, WebPPicture &webpPicture);
     uint32_t DoEncodeForICC(Media::PixelMap &pixelMap);
+    uint32_t DoEncodeAnimation();
+    bool PrepareFrames(std::vector<WebPPicture> &pictures, size_t start, size_t end);
+    void ComposeFrame(WebPPicture &picture, std::vector<uint32_t> &canvas, uint8_t disposalType);
+    uint16_t GetDelayTime(size_t index);
+    uint8_t GetDisposalType(size_t index);
     bool DoTransform(Media::PixelMap &pixelMap, char* dst, int componentsNum);
+    bool ImportPixels(Media::PixelMap &pixelMap, WebPPicture &webpPicture);
+    bool DoImportDirect(Media::PixelMap &pixelMap, WebPPicture &webpPicture);
+    bool DoImportConverted(Media::PixelMap &pixelMap, WebPPicture &webpPicture);
+    bool DoImportTransformed(Media::PixelMap &pixelMap, WebPPicture &webpPicture);
 
 private:
     Media::ColorSpace GetColorSpace(Media::PixelMap &pixelMap);
@@ -46,6 +56,7 @@ private:
     Media::AlphaType GetAlphaType(Media::PixelMap &pixelMap);
     bool GetIcc(Media::PixelMap &pixelMap);
     bool IsOpaque(Media::PixelMap &pixelMap);
+    int32_t GetComponentsNum(Media::PixelMap &pixelMap);
 
 private:
     static bool DoTransformMemcpy(Media::PixelMap &pixelMap, char* dst, int componentsNum);
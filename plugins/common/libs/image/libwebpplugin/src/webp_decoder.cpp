@@ -309,40 +309,77 @@ uint32_t WebpDecoder::DoCommonDecode(DecodeContext &context)
     return ERR_IMAGE_DECODE_FAILED;
 }
 
-uint32_t WebpDecoder::DoIncrementalDecode(ProgDecodeContext &context) __attribute__((no_sanitize("cfi")))
+uint32_t WebpDecoder::CreateIncrementalDecoder(DecodeContext &context)
 {
     WebPDecoderConfig config;
-    if (!PreDecodeProc(context.decodeContext, config, true)) {
+    if (!PreDecodeProc(context, config, true)) {
         IMAGE_LOGE("prepare increment decode failed.");
         return ERR_IMAGE_MALLOC_ABNORMAL;
     }
-
-    TAutoCallProc<WebPDecBuffer, WebPFreeDecBuffer> webpOutput(&config.output);
-    TAutoCallProc<WebPIDecoder, WebPIDelete> idec(WebPINewDecoder(&config.output));
-    if (idec == nullptr) {
+    // WebPINewDecoder keeps the address of the output description, so it lives in a member
+    idecOutput_ = config.output;
+    idec_.reset(WebPINewDecoder(&idecOutput_));
+    if (idec_ == nullptr) {
         IMAGE_LOGE("incremental code:idec is null.");
+        WebPFreeDecBuffer(&idecOutput_);
         return ERR_IMAGE_DECODE_FAILED;
     }
+    idecPixels_ = context.pixelsBuffer.buffer;
+    idecFedSize_ = 0;
+    return SUCCESS;
+}
 
-    dataBuffer_ = { nullptr, 0, 0 };
-    stream_->Seek(0);
-    if (!stream_->Read(stream_->GetStreamSize(), dataBuffer_)) {
-        IMAGE_LOGE("incremental:read data failed.");
-        return ERR_IMAGE_DECODE_FAILED;
+void WebpDecoder::ReleaseIncrementalDecoder()
+{
+    if (idec_ != nullptr) {
+        idec_.reset(nullptr);
+        WebPFreeDecBuffer(&idecOutput_);
     }
-    if (dataBuffer_.inputStreamBuffer == nullptr || dataBuffer_.dataSize == 0) {
-        IMAGE_LOGE("incremental:data is null.");
-        return ERR_IMAGE_DECODE_FAILED;
+    idecPixels_ = nullptr;
+    idecFedSize_ = 0;
+}
+
+uint32_t WebpDecoder::DoIncrementalDecode(ProgDecodeContext &context) __attribute__((no_sanitize("cfi")))
+{
+    if (idec_ != nullptr && context.decodeContext.pixelsBuffer.buffer != idecPixels_) {
+        // the rows decoded so far are not in the pixels we are given now, start over
+        IMAGE_LOGD("incremental:output pixels changed, restart decoding.");
+        ReleaseIncrementalDecoder();
+    }
+    if (idec_ == nullptr) {
+        uint32_t ret = CreateIncrementalDecoder(context.decodeContext);
+        if (ret != SUCCESS) {
+            return ret;
+        }
     }
 
-    VP8StatusCode status = WebPIUpdate(idec, dataBuffer_.inputStreamBuffer, static_cast<size_t>(dataBuffer_.dataSize));
+    VP8StatusCode status = VP8_STATUS_SUSPENDED;
+    size_t streamSize = stream_->GetStreamSize();
+    if (streamSize > idecFedSize_) {
+        dataBuffer_ = { nullptr, 0, 0 };
+        if (!stream_->Seek(static_cast<uint32_t>(idecFedSize_)) ||
+            !stream_->Read(static_cast<uint32_t>(streamSize - idecFedSize_), dataBuffer_)) {
+            IMAGE_LOGE("incremental:read data failed.");
+            ReleaseIncrementalDecoder();
+            return ERR_IMAGE_DECODE_FAILED;
+        }
+        if (dataBuffer_.inputStreamBuffer == nullptr || dataBuffer_.dataSize == 0) {
+            IMAGE_LOGE("incremental:data is null.");
+            ReleaseIncrementalDecoder();
+            return ERR_IMAGE_DECODE_FAILED;
+        }
+        // WebPIAppend copies the new bytes, the decoder resumes where the previous promote stopped
+        status = WebPIAppend(idec_, dataBuffer_.inputStreamBuffer, static_cast<size_t>(dataBuffer_.dataSize));
+        idecFedSize_ += dataBuffer_.dataSize;
+    }
     if (status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED) {
         IMAGE_LOGE("incremental:webp status exception,status:%{public}d.", status);
+        ReleaseIncrementalDecoder();
         return ERR_IMAGE_DECODE_FAILED;
     }
     if (status == VP8_STATUS_SUSPENDED) {
         int32_t curHeight = 0;
-        if (WebPIDecGetRGB(idec, &curHeight, nullptr, nullptr, nullptr) == nullptr) {
+        if (WebPIDecGetRGB(idec_, &curHeight, nullptr, nullptr, nullptr) == nullptr) {
             IMAGE_LOGD("refresh image failed, current height:%{public}d.", curHeight);
         }
         if (curHeight > 0 && webpSize_.height != 0) {
@@ -351,10 +388,9 @@ uint32_t WebpDecoder::DoIncrementalDecode(ProgDecodeContext &context) __attribut
         }
         return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
     }
-    if (status == VP8_STATUS_OK) {
-        context.totalProcessProgress = context.FULL_PROGRESS;
-        state_ = WebpDecodingState::IMAGE_DECODED;
-    }
+    context.totalProcessProgress = context.FULL_PROGRESS;
+    state_ = WebpDecodingState::IMAGE_DECODED;
+    ReleaseIncrementalDecoder();
     return SUCCESS;
 }
 
@@ -384,6 +420,7 @@ bool WebpDecoder::PreDecodeProc(DecodeContext &context, WebPDecoderConfig &confi
 
 void WebpDecoder::Reset()
 {
+    ReleaseIncrementalDecoder();
     stream_->Seek(0);
     dataBuffer_ = { nullptr, 0, 0 };
     webpSize_ = { 0, 0 };
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 #include "webp_encoder.h"
+#include <algorithm>
+#include <future>
 #include "webp/mux.h"
 #include "image_log.h"
 #include "image_trace.h"
@@ -31,8 +33,69 @@ using namespace MultimediaPlugin;
 using namespace Media;
 namespace {
 constexpr uint32_t WEBP_IMAGE_NUM = 1;
+constexpr uint32_t WEBP_FRAME_NUM_MAX = 1024;
+constexpr uint32_t WEBP_FRAME_PREPARE_MAX = 4; // frames converted at once, one per thread
+constexpr int WEBP_DELAY_TIME_UNIT_MS = 10; // delayTimes are in 10ms units like gif
+constexpr uint16_t DEFAULT_DELAY_TIME = 100;
+constexpr uint8_t DEFAULT_DISPOSAL_TYPE = 1;
+constexpr uint8_t DISPOSAL_TYPE_BACKGROUND = 2;
+constexpr uint8_t DISPOSAL_TYPE_PREVIOUS = 3;
+constexpr uint32_t ARGB_ALPHA_SHIFT = 24;
+constexpr uint32_t ARGB_CHANNEL_BITS = 8;
+constexpr uint32_t ARGB_CHANNEL_MASK = 0xFF;
+constexpr uint32_t ARGB_COLOR_CHANNELS = 3;
 constexpr uint32_t COMPONENT_NUM_3 = 3;
 constexpr uint32_t COMPONENT_NUM_4 = 4;
+constexpr int WEBP_METHOD_MAX = 6;
+// below this many pixels the worker thread costs more than it saves
+constexpr uint64_t WEBP_MULTI_THREAD_MIN_PIXELS = 512 * 512;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+// libwebp keeps ARGB as native uint32_t, which is BGRA_8888 in memory on little endian
+constexpr bool ARGB_IS_BGRA = true;
+#else
+constexpr bool ARGB_IS_BGRA = false;
+#endif
+
+// owns the pictures of the frames being prepared, WebPPictureFree is safe on initialized or freed pictures
+struct WebPFramePictures {
+    explicit WebPFramePictures(size_t count) : pictures(count)
+    {
+        for (auto &picture : pictures) {
+            WebPPictureInit(&picture);
+        }
+    }
+    ~WebPFramePictures()
+    {
+        for (auto &picture : pictures) {
+            WebPPictureFree(&picture);
+        }
+    }
+    std::vector<WebPPicture> pictures;
+};
+
+// source-over of two unpremultiplied ARGB pixels
+uint32_t BlendOver(uint32_t src, uint32_t dst)
+{
+    uint32_t srcAlpha = src >> ARGB_ALPHA_SHIFT;
+    uint32_t dstAlpha = dst >> ARGB_ALPHA_SHIFT;
+    if (srcAlpha == ARGB_CHANNEL_MASK || dstAlpha == 0) {
+        return src;
+    }
+    if (srcAlpha == 0) {
+        return dst;
+    }
+    uint32_t srcWeight = srcAlpha * ARGB_CHANNEL_MASK;
+    uint32_t dstWeight = dstAlpha * (ARGB_CHANNEL_MASK - srcAlpha);
+    uint32_t outWeight = srcWeight + dstWeight;
+    uint32_t out = ((outWeight + ARGB_CHANNEL_MASK / 2) / ARGB_CHANNEL_MASK) << ARGB_ALPHA_SHIFT;
+    for (uint32_t channel = 0; channel < ARGB_COLOR_CHANNELS; channel++) {
+        uint32_t shift = channel * ARGB_CHANNEL_BITS;
+        uint32_t srcColor = (src >> shift) & ARGB_CHANNEL_MASK;
+        uint32_t dstColor = (dst >> shift) & ARGB_CHANNEL_MASK;
+        out |= ((srcColor * srcWeight + dstColor * dstWeight + outWeight / 2) / outWeight) << shift;
+    }
+    return out;
+}
 } // namespace
 
 static int StreamWriter(const uint8_t* data, size_t data_size, const WebPPicture* const picture)
@@ -79,8 +142,9 @@ uint32_t WebpEncoder::AddImage(Media::PixelMap &pixelMap)
     ImageTrace imageTrace("WebpEncoder::AddImage");
     IMAGE_LOGD("AddImage IN");
 
-    if (pixelMaps_.size() >= WEBP_IMAGE_NUM) {
-        IMAGE_LOGE("AddImage, add pixel map out of range=%{public}u.", WEBP_IMAGE_NUM);
+    uint32_t imageNum = std::min(std::max(encodeOpts_.numberHint, WEBP_IMAGE_NUM), WEBP_FRAME_NUM_MAX);
+    if (pixelMaps_.size() >= imageNum) {
+        IMAGE_LOGE("AddImage, add pixel map out of range=%{public}u.", imageNum);
         return ERR_IMAGE_ADD_PIXEL_MAP_FAILED;
     }
 
@@ -96,6 +160,18 @@ uint32_t WebpEncoder::AddPicture(Media::Picture &picture)
     return ERR_IMAGE_ENCODE_FAILED;
 }
 
+void WebpEncoder::Reset()
+{
+    pixelMaps_.clear();
+    outputStream_ = nullptr;
+    encodeOpts_ = PlEncodeOptions();
+    memoryStream_.reset();
+    componentsNum_ = 0;
+    iccValid_ = false;
+    iccBytes_ = nullptr;
+    iccSize_ = 0;
+}
+
 uint32_t WebpEncoder::FinalizeEncode()
 {
     ImageTrace imageTrace("WebpEncoder::FinalizeEncode");
@@ -109,6 +185,10 @@ uint32_t WebpEncoder::FinalizeEncode()
     IMAGE_LOGD("FinalizeEncode, quality=%{public}u, numberHint=%{public}u",
         encodeOpts_.quality, encodeOpts_.numberHint);
 
+    if (pixelMaps_.size() > WEBP_IMAGE_NUM) {
+        return DoEncodeAnimation();
+    }
+
     uint32_t errorCode = ERROR;
 
     Media::PixelMap &pixelMap = *(pixelMaps_[0]);
@@ -251,11 +331,7 @@ uint32_t WebpEncoder::SetEncodeConfig(Media::PixelMap &pixelMap, WebPConfig &web
         return ERR_IMAGE_UNKNOWN_FORMAT;
     }
 
-    if (GetPixelFormat(pixelMap) == PixelFormat::RGBA_F16) {
-        componentsNum_ = COMPONENT_NUM_4;
-    } else {
-        componentsNum_ = IsOpaque(pixelMap) ? COMPONENT_NUM_3 : COMPONENT_NUM_4;
-    }
+    componentsNum_ = GetComponentsNum(pixelMap);
     IMAGE_LOGD("SetEncodeConfig, componentsNum=%{public}u", componentsNum_);
 
     if (!WebPConfigPreset(&webpConfig, WEBP_PRESET_DEFAULT, encodeOpts_.quality)) {
@@ -267,6 +343,11 @@ uint32_t WebpEncoder::SetEncodeConfig(Media::PixelMap &pixelMap, WebPConfig &web
 
     webpConfig.lossless = 1; // Lossless encoding (0=lossy(default), 1=lossless).
     webpConfig.method = 0; // quality/speed trade-off (0=fast, 6=slower-better)
+    if (encodeOpts_.effort >= 0) {
+        webpConfig.method = std::min(static_cast<int>(encodeOpts_.effort), WEBP_METHOD_MAX);
+    }
+    uint64_t pixelCount = static_cast<uint64_t>(pixelMap.GetWidth()) * static_cast<uint64_t>(pixelMap.GetHeight());
+    webpConfig.thread_level = (encodeOpts_.multiThread && pixelCount >= WEBP_MULTI_THREAD_MIN_PIXELS) ? 1 : 0;
     webpPicture.use_argb = 1; // Main flag for encoder selecting between ARGB or YUV input.
 
     webpPicture.width = pixelMap.GetWidth(); // dimensions (less or equal to WEBP_MAX_DIMENSION)
@@ -276,38 +357,19 @@ uint32_t WebpEncoder::SetEncodeConfig(Media::PixelMap &pixelMap, WebPConfig &web
 
     auto colorSpace = GetColorSpace(pixelMap);
     IMAGE_LOGD("SetEncodeConfig, "
-        "width=%{public}u, height=%{public}u, colorspace=%{public}d, componentsNum=%{public}d.",
-        webpPicture.width, webpPicture.height, colorSpace, componentsNum_);
+        "width=%{public}u, height=%{public}u, colorspace=%{public}d, componentsNum=%{public}d,"
+        " method=%{public}d, threadLevel=%{public}d.", webpPicture.width, webpPicture.height, colorSpace,
+        componentsNum_, webpConfig.method, webpConfig.thread_level);
 
     IMAGE_LOGD("SetEncodeConfig OUT");
     return SUCCESS;
 }
 
 uint32_t WebpEncoder::DoEncode(Media::PixelMap &pixelMap, WebPConfig &webpConfig, WebPPicture &webpPicture)
-    __attribute__((no_sanitize("cfi")))
 {
     IMAGE_LOGD("DoEncode IN");
 
-    const int width = pixelMap.GetWidth();
-    const int height = webpPicture.height;
-    const int rgbStride = width * componentsNum_;
-    const int rgbSize = rgbStride * height;
-    IMAGE_LOGD("DoEncode, width=%{public}d, height=%{public}d, componentsNum=%{public}d,"
-        " rgbStride=%{public}d, rgbSize=%{public}d", width, height, componentsNum_, rgbStride, rgbSize);
-
-    std::unique_ptr<uint8_t[]> rgb = std::make_unique<uint8_t[]>(rgbSize);
-    if (!DoTransform(pixelMap, reinterpret_cast<char*>(&rgb[0]), componentsNum_)) {
-        IMAGE_LOGE("DoEncode, transform issue.");
-        return ERROR;
-    }
-
-    auto importProc = WebPPictureImportRGB;
-    if (componentsNum_ != COMPONENT_NUM_3) {
-        importProc = (IsOpaque(pixelMap)) ? WebPPictureImportRGBX : WebPPictureImportRGBA;
-    }
-
-    IMAGE_LOGD("DoEncode, importProc");
-    if (!importProc(&webpPicture, &rgb[0], rgbStride)) {
+    if (!ImportPixels(pixelMap, webpPicture)) {
         IMAGE_LOGE("DoEncode, import issue.");
         return ERROR;
     }
@@ -331,6 +393,265 @@ uint32_t WebpEncoder::DoEncode(Media::PixelMap &pixelMap, WebPConfig &webpConfig
     return SUCCESS;
 }
 
+bool WebpEncoder::ImportPixels(Media::PixelMap &pixelMap, WebPPicture &webpPicture)
+{
+    PixelFormat pixelFormat = GetPixelFormat(pixelMap);
+    AlphaType alphaType = GetAlphaType(pixelMap);
+    IMAGE_LOGD("ImportPixels, pixelFormat=%{public}u, alphaType=%{public}d", pixelFormat, alphaType);
+
+    bool is8888 = (pixelFormat == PixelFormat::RGBA_8888) || (pixelFormat == PixelFormat::BGRA_8888);
+    if (is8888 && ((alphaType == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE) ||
+        (alphaType == AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL))) {
+        return DoImportDirect(pixelMap, webpPicture);
+    }
+
+    // Opaque F16 and ARGB may carry arbitrary alpha bytes that libwebp must ignore, so they keep the RGB path.
+    bool canConvert = (is8888 && (alphaType == AlphaType::IMAGE_ALPHA_TYPE_PREMUL)) ||
+        (((pixelFormat == PixelFormat::RGBA_F16) || (pixelFormat == PixelFormat::ARGB_8888)) &&
+        ((alphaType == AlphaType::IMAGE_ALPHA_TYPE_PREMUL) || (alphaType == AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL))) ||
+        ((pixelFormat == PixelFormat::RGB_565) && IsOpaque(pixelMap));
+    if (ARGB_IS_BGRA && canConvert) {
+        return DoImportConverted(pixelMap, webpPicture);
+    }
+
+    return DoImportTransformed(pixelMap, webpPicture);
+}
+
+// RGBA and BGRA rows that are already unpremultiplied go to libwebp as they are, with no intermediate buffer.
+bool WebpEncoder::DoImportDirect(Media::PixelMap &pixelMap, WebPPicture &webpPicture)
+    __attribute__((no_sanitize("cfi")))
+{
+    IMAGE_LOGD("DoImportDirect IN");
+
+    const uint8_t *srcPixels = pixelMap.GetPixels();
+    const int stride = pixelMap.GetRowStride();
+    if ((srcPixels == nullptr) || (stride <= 0)) {
+        IMAGE_LOGE("DoImportDirect, address issue.");
+        return false;
+    }
+
+    bool isRgba = (GetPixelFormat(pixelMap) == PixelFormat::RGBA_8888);
+    auto importProc = isRgba ? WebPPictureImportRGBA : WebPPictureImportBGRA;
+    if (IsOpaque(pixelMap)) {
+        importProc = isRgba ? WebPPictureImportRGBX : WebPPictureImportBGRX;
+    }
+    if (!importProc(&webpPicture, srcPixels, stride)) {
+        IMAGE_LOGE("DoImportDirect, import issue, error=%{public}d.", webpPicture.error_code);
+        return false;
+    }
+
+    IMAGE_LOGD("DoImportDirect OUT");
+    return true;
+}
+
+// Any other format is converted by the pixel convert adapter straight into the picture's ARGB plane.
+bool WebpEncoder::DoImportConverted(Media::PixelMap &pixelMap, WebPPicture &webpPicture)
+{
+    IMAGE_LOGD("DoImportConverted IN");
+
+    if (!WebPPictureAlloc(&webpPicture) || (webpPicture.argb == nullptr)) {
+        IMAGE_LOGE("DoImportConverted, alloc issue, error=%{public}d.", webpPicture.error_code);
+        return false;
+    }
+
+    PixelFormat pixelFormat = GetPixelFormat(pixelMap);
+    AlphaType srcAlphaType = (pixelFormat == PixelFormat::RGB_565) ?
+        AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL : GetAlphaType(pixelMap);
+    const void *srcPixels = pixelMap.GetPixels();
+    uint32_t srcRowBytes = static_cast<uint32_t>(pixelMap.GetRowStride());
+    const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(), pixelFormat, srcAlphaType);
+
+    void *dstPixels = webpPicture.argb;
+    uint32_t dstRowBytes = static_cast<uint32_t>(webpPicture.argb_stride) * COMPONENT_NUM_4;
+    const ImageInfo dstInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
+        PixelFormat::BGRA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
+
+    ShowTransformParam(srcInfo, srcRowBytes, dstInfo, dstRowBytes, COMPONENT_NUM_4);
+
+    if (srcPixels == nullptr) {
+        IMAGE_LOGE("DoImportConverted, address issue.");
+        return false;
+    }
+
+    const Position dstPos;
+    if (!PixelConvertAdapter::WritePixelsConvert(srcPixels, srcRowBytes, srcInfo,
+        dstPixels, dstPos, dstRowBytes, dstInfo)) {
+        IMAGE_LOGE("DoImportConverted, pixel convert in adapter failed.");
+        return false;
+    }
+
+    IMAGE_LOGD("DoImportConverted OUT");
+    return true;
+}
+
+bool WebpEncoder::DoImportTransformed(Media::PixelMap &pixelMap, WebPPicture &webpPicture)
+    __attribute__((no_sanitize("cfi")))
+{
+    IMAGE_LOGD("DoImportTransformed IN");
+
+    const int width = pixelMap.GetWidth();
+    const int height = webpPicture.height;
+    const int32_t componentsNum = GetComponentsNum(pixelMap);
+    const int rgbStride = width * componentsNum;
+    const int rgbSize = rgbStride * height;
+    IMAGE_LOGD("DoImportTransformed, width=%{public}d, height=%{public}d, componentsNum=%{public}d,"
+        " rgbStride=%{public}d, rgbSize=%{public}d", width, height, componentsNum, rgbStride, rgbSize);
+
+    std::unique_ptr<uint8_t[]> rgb = std::make_unique<uint8_t[]>(rgbSize);
+    if (!DoTransform(pixelMap, reinterpret_cast<char*>(&rgb[0]), componentsNum)) {
+        IMAGE_LOGE("DoImportTransformed, transform issue.");
+        return false;
+    }
+
+    auto importProc = WebPPictureImportRGB;
+    if (componentsNum != static_cast<int32_t>(COMPONENT_NUM_3)) {
+        importProc = (IsOpaque(pixelMap)) ? WebPPictureImportRGBX : WebPPictureImportRGBA;
+    }
+
+    if (!importProc(&webpPicture, &rgb[0], rgbStride)) {
+        IMAGE_LOGE("DoImportTransformed, import issue.");
+        return false;
+    }
+
+    IMAGE_LOGD("DoImportTransformed OUT");
+    return true;
+}
+
+// Each pixel map is one full frame of the animation. Frames are converted into WebP pictures a few at a time
+// on parallel threads, then handed in order to WebPAnimEncoder, which stores only the rectangles that change.
+uint32_t WebpEncoder::DoEncodeAnimation()
+{
+    ImageTrace imageTrace("WebpEncoder::DoEncodeAnimation");
+    IMAGE_LOGD("DoEncodeAnimation IN, frames=%{public}zu", pixelMaps_.size());
+
+    const int width = pixelMaps_[0]->GetWidth();
+    const int height = pixelMaps_[0]->GetHeight();
+    bool needCompose = false;
+    for (auto pixelMap : pixelMaps_) {
+        if (pixelMap->GetWidth() != width || pixelMap->GetHeight() != height) {
+            IMAGE_LOGE("DoEncodeAnimation, frame size mismatch.");
+            return ERR_IMAGE_INVALID_PARAMETER;
+        }
+        needCompose = needCompose || !IsOpaque(*pixelMap);
+    }
+
+    WebPAnimEncoderOptions animOptions;
+    if (!WebPAnimEncoderOptionsInit(&animOptions)) {
+        IMAGE_LOGE("DoEncodeAnimation, options init issue.");
+        return ERROR;
+    }
+    animOptions.anim_params.loop_count = encodeOpts_.loop;
+    animOptions.minimize_size = 1;
+    std::unique_ptr<WebPAnimEncoder, decltype(&WebPAnimEncoderDelete)> animEncoder(
+        WebPAnimEncoderNew(width, height, &animOptions), WebPAnimEncoderDelete);
+    if (animEncoder == nullptr) {
+        IMAGE_LOGE("DoEncodeAnimation, new encoder issue.");
+        return ERROR;
+    }
+
+    WebPConfig webpConfig;
+    WebPFramePictures frames(pixelMaps_.size());
+    for (size_t index = 0; index < pixelMaps_.size(); index++) {
+        uint32_t errorCode = SetEncodeConfig(*pixelMaps_[index], webpConfig, frames.pictures[index]);
+        if (errorCode != SUCCESS) {
+            IMAGE_LOGE("DoEncodeAnimation, config failed=%{public}u, frame=%{public}zu.", errorCode, index);
+            return errorCode;
+        }
+    }
+
+    std::vector<uint32_t> canvas(needCompose ? static_cast<size_t>(width) * height : 0, 0);
+    int timestamp = 0;
+    for (size_t start = 0; start < pixelMaps_.size(); start += WEBP_FRAME_PREPARE_MAX) {
+        size_t end = std::min(start + WEBP_FRAME_PREPARE_MAX, pixelMaps_.size());
+        if (!PrepareFrames(frames.pictures, start, end)) {
+            return ERROR;
+        }
+        for (size_t index = start; index < end; index++) {
+            WebPPicture &picture = frames.pictures[index];
+            if (needCompose) {
+                ComposeFrame(picture, canvas, GetDisposalType(index));
+            }
+            if (!WebPAnimEncoderAdd(animEncoder.get(), &picture, timestamp, &webpConfig)) {
+                IMAGE_LOGE("DoEncodeAnimation, add frame %{public}zu issue, %{public}s.", index,
+                    WebPAnimEncoderGetError(animEncoder.get()));
+                return ERROR;
+            }
+            WebPPictureFree(&picture);
+            timestamp += GetDelayTime(index) * WEBP_DELAY_TIME_UNIT_MS;
+        }
+    }
+
+    WebPData webpData;
+    WebPDataInit(&webpData);
+    if (!WebPAnimEncoderAdd(animEncoder.get(), nullptr, timestamp, nullptr) ||
+        !WebPAnimEncoderAssemble(animEncoder.get(), &webpData)) {
+        IMAGE_LOGE("DoEncodeAnimation, assemble issue, %{public}s.", WebPAnimEncoderGetError(animEncoder.get()));
+        WebPDataClear(&webpData);
+        return ERROR;
+    }
+    bool written = outputStream_->Write(webpData.bytes, webpData.size);
+    WebPDataClear(&webpData);
+    if (!written) {
+        IMAGE_LOGE("DoEncodeAnimation, write issue.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+
+    IMAGE_LOGD("DoEncodeAnimation OUT");
+    return SUCCESS;
+}
+
+bool WebpEncoder::PrepareFrames(std::vector<WebPPicture> &pictures, size_t start, size_t end)
+{
+    std::vector<std::future<bool>> results;
+    for (size_t index = start + 1; index < end; index++) {
+        results.emplace_back(std::async(std::launch::async, [this, &pictures, index] {
+            return ImportPixels(*pixelMaps_[index], pictures[index]);
+        }));
+    }
+    bool isSuccess = ImportPixels(*pixelMaps_[start], pictures[start]);
+    for (auto &result : results) {
+        isSuccess = result.get() && isSuccess;
+    }
+    if (!isSuccess) {
+        IMAGE_LOGE("PrepareFrames, import frames [%{public}zu, %{public}zu) issue.", start, end);
+    }
+    return isSuccess;
+}
+
+// The pixel maps are drawn over what the previous frames leave behind, as gif frames are. WebPAnimEncoder takes
+// whole canvases, so blend the frame onto the canvas first, then apply its disposal to the canvas.
+void WebpEncoder::ComposeFrame(WebPPicture &picture, std::vector<uint32_t> &canvas, uint8_t disposalType)
+{
+    std::vector<uint32_t> previous;
+    if (disposalType == DISPOSAL_TYPE_PREVIOUS) {
+        previous = canvas;
+    }
+    const size_t width = static_cast<size_t>(picture.width);
+    for (int y = 0; y < picture.height; y++) {
+        uint32_t *row = picture.argb + static_cast<size_t>(y) * picture.argb_stride;
+        uint32_t *canvasRow = canvas.data() + static_cast<size_t>(y) * width;
+        for (size_t x = 0; x < width; x++) {
+            row[x] = BlendOver(row[x], canvasRow[x]);
+            canvasRow[x] = row[x];
+        }
+    }
+    if (disposalType == DISPOSAL_TYPE_BACKGROUND) {
+        std::fill(canvas.begin(), canvas.end(), 0);
+    } else if (disposalType == DISPOSAL_TYPE_PREVIOUS) {
+        canvas.swap(previous);
+    }
+}
+
+uint16_t WebpEncoder::GetDelayTime(size_t index)
+{
+    return index < encodeOpts_.delayTimes.size() ? encodeOpts_.delayTimes[index] : DEFAULT_DELAY_TIME;
+}
+
+uint8_t WebpEncoder::GetDisposalType(size_t index)
+{
+    return index < encodeOpts_.disposalTypes.size() ? encodeOpts_.disposalTypes[index] : DEFAULT_DISPOSAL_TYPE;
+}
+
 uint32_t WebpEncoder::DoEncodeForICC(Media::PixelMap &pixelMap)
 {
     IMAGE_LOGD("DoEncodeForICC IN");
@@ -397,6 +718,14 @@ bool WebpEncoder::IsOpaque(Media::PixelMap &pixelMap)
     return (GetAlphaType(pixelMap) == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
 }
 
+int32_t WebpEncoder::GetComponentsNum(Media::PixelMap &pixelMap)
+{
+    if (GetPixelFormat(pixelMap) == PixelFormat::RGBA_F16) {
+        return COMPONENT_NUM_4;
+    }
+    return IsOpaque(pixelMap) ? COMPONENT_NUM_3 : COMPONENT_NUM_4;
+}
+
 bool WebpEncoder::DoTransformMemcpy(Media::PixelMap &pixelMap, char* dst, int componentsNum)
 {
     IMAGE_LOGD("DoTransformMemcpy IN");
@@ -34,8 +34,11 @@ struct PlEncodeOptions {
     uint16_t loop = 0;
     std::vector<uint16_t> delayTimes;
     std::vector<uint8_t> disposalTypes;
+    bool optimizeFrames = false;
     bool needsPackProperties = false;
     bool isEditScene = false;
+    int8_t effort = -1;
+    bool multiThread = false;
 };
 
 class AbsImageEncoder {
@@ -47,6 +50,9 @@ public:
     virtual uint32_t AddPicture(Media::Picture &picture) = 0;
     virtual uint32_t FinalizeEncode() = 0;
 
+    // drop the streams, images and options of the last encode so that the encoder can be reused.
+    virtual void Reset() {}
+
     // define multiple subservices for this interface
     static constexpr uint16_t SERVICE_DEFAULT = 0;
 };